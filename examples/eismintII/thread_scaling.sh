@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Copyright (C) 2026 The PISM Authors
+
+# Measures the speedup of column-wise computations (energy balance, age, SIA) due to
+# OpenMP threads. Requires PISM built with Pism_USE_OPENMP.
+#
+# Usage: thread_scaling.sh [number of MPI ranks] [max. number of threads per rank] [grid size]
+#
+# For example, "thread_scaling.sh 2 8 121" runs EISMINT II experiment A on a 121x121 grid
+# using 2 MPI ranks and 1, 2, 4, 8 threads per rank.
+
+set -e  # exit on error
+
+NN=${1:-1}
+MAX_THREADS=${2:-4}
+MHOR=${3:-121}
+
+PISM_MPIDO=${PISM_MPIDO:-"mpiexec -n"}
+
+# Note: each MPI rank should be able to use MAX_THREADS cores. With Open MPI, add
+# "--bind-to none" or "--map-by slot:PE=N" to PISM_MPIDO.
+export OMP_PROC_BIND=${OMP_PROC_BIND:-close}
+
+options="-eisII A -Mx $MHOR -My $MHOR -Mz 61 -Lz 5000 -y 5000 -energy enthalpy -age -verbose 1"
+
+printf "%8s %8s %12s %8s\n" "ranks" "threads" "time (s)" "speedup"
+
+T=1
+while [ $T -le $MAX_THREADS ]; do
+  start=$(date +%s.%N)
+  $PISM_MPIDO $NN pism $options -threads $T -o thread_scaling_$T.nc > /dev/null
+  end=$(date +%s.%N)
+
+  elapsed=$(echo "$end - $start" | bc -l)
+  if [ $T -eq 1 ]; then
+    reference=$elapsed
+  fi
+
+  printf "%8d %8d %12.2f %8.2f\n" $NN $T $elapsed $(echo "$reference / $elapsed" | bc -l)
+
+  T=$((2 * T))
+done
@@ -60,14 +60,15 @@ void AgeColumnSystem::init(int i, int j, double thickness) {
   coarse_to_fine(m_age3, m_i-1, m_j, &m_A_w[0]);
 }
 
-//! First-order upwind scheme with implicit in the vertical: one column solve.
+//! First-order upwind scheme with implicit in the vertical: set up the system.
 /*!
   The PDE being solved is
   \f[ \frac{\partial \tau}{\partial t} + \frac{\partial}{\partial x}\left(u \tau\right) + \frac{\partial}{\partial y}\left(v \tau\right) + \frac{\partial}{\partial z}\left(w \tau\right) = 1. \f]
- */
-void AgeColumnSystem::solve(std::vector<double> &x) {
 
-  TridiagonalSystem &S = *m_solver;
+  `System` is TridiagonalSystem or TridiagonalSystemBatch::System.
+ */
+template <class System>
+void AgeColumnSystem::assemble_system(System &S) const {
 
   // set up system: 0 <= k < m_ks
   for (unsigned int k = 0; k < m_ks; k++) {
@@ -115,6 +116,17 @@ void AgeColumnSystem::solve(std::vector<double> &x) {
     S.D(m_ks) = 1.0;   // ignore U[m_ks]
     S.RHS(m_ks) = 0.0;  // age zero at surface
   }
+}
+
+//! First-order upwind scheme with implicit in the vertical: one column solve.
+/*!
+  See assemble_system() for the PDE being solved.
+ */
+void AgeColumnSystem::solve(std::vector<double> &x) {
+
+  TridiagonalSystem &S = *m_solver;
+
+  assemble_system(S);
 
   // solve it
   try {
@@ -134,4 +146,35 @@ void AgeColumnSystem::solve(std::vector<double> &x) {
   }
 }
 
+//! Set up the system for the current column in the slot `b` of a `batch`.
+/*!
+  Marks the slot as unused if the current column has no ice.
+ */
+void AgeColumnSystem::assemble(TridiagonalSystemBatch &batch, unsigned int b) const {
+  if (m_ks == 0) {
+    batch.set_size(b, 0);
+    return;
+  }
+
+  auto S = batch.system(b);
+  assemble_system(S);
+
+  batch.set_size(b, m_ks + 1);
+}
+
+//! Get the solution of the system in the slot `b` of a solved `batch`.
+/*!
+  Sets the age of ice above the surface to zero.
+ */
+void AgeColumnSystem::extract_solution(const TridiagonalSystemBatch &batch, unsigned int b,
+                                       std::vector<double> &x) const {
+  unsigned int N = batch.size(b);
+
+  batch.solution(b, x.data());
+
+  for (unsigned int k = N; k < x.size(); k++) {
+    x[k] = 0.0;
+  }
+}
+
 } // end of namespace pism
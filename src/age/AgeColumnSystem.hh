@@ -38,7 +38,14 @@ public:
   void init(int i, int j, double thickness);
 
   void solve(std::vector<double> &x);
+
+  void assemble(TridiagonalSystemBatch &batch, unsigned int b) const;
+  void extract_solution(const TridiagonalSystemBatch &batch, unsigned int b,
+                        std::vector<double> &x) const;
 protected:
+  template <class System>
+  void assemble_system(System &S) const;
+
   const array::Array3D &m_age3;
   double m_nu;
   std::vector<double> m_A, m_A_n, m_A_e, m_A_s, m_A_w;
@@ -19,8 +19,12 @@
 
 #include "pism/age/AgeModel.hh"
 #include "pism/age/AgeColumnSystem.hh"
+#include "pism/util/array/ActiveColumns.hh"
+#include "pism/util/array/Array3D.hh"
+#include "pism/util/array/CellType.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/threading.hh"
 #include <memory>
 
 namespace pism {
@@ -29,7 +33,7 @@ AgeModelInputs::AgeModelInputs(const array::Scalar *thickness,
                                const array::Array3D *u,
                                const array::Array3D *v,
                                const array::Array3D *w)
-  : ice_thickness(thickness), u3(u), v3(v), w3(w) {
+  : ice_thickness(thickness), u3(u), v3(v), w3(w), cell_type(NULL) {
   // empty
 }
 
@@ -38,6 +42,7 @@ AgeModelInputs::AgeModelInputs() {
   u3            = NULL;
   v3            = NULL;
   w3            = NULL;
+  cell_type     = NULL;
 }
 
 static void check_input(const array::Array *ptr, const char *name) {
@@ -67,6 +72,7 @@ AgeModel::AgeModel(std::shared_ptr<const Grid> grid,
     .units("s");
 
   m_ice_age.metadata()["valid_min"] = {0.0};
+  m_ice_age.use_single_precision(array::single_precision_requested(*m_config, "age"));
 
   m_work.metadata().units("s");
 }
@@ -103,7 +109,7 @@ velocity.  We use a finely-spaced, equally-spaced vertical grid in the
 calculation.  Note that the columnSystemCtx methods coarse_to_fine() and
 fine_to_coarse() interpolate back and forth between this fine grid and
 the storage grid.  The storage grid may or may not be equally-spaced.  See
-AgeColumnSystem::solve() for the actual method.
+AgeColumnSystem::assemble_system() for the actual method.
  */
 void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
 
@@ -119,54 +125,92 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
     &v3 = *inputs.v3,
     &w3 = *inputs.w3;
 
-  AgeColumnSystem system(m_grid->z(), "age",
-                         m_grid->dx(), m_grid->dy(), dt,
-                         m_ice_age, u3, v3, w3); // linear system to solve in each column
+  // linear systems to solve in each column, batches of systems and space for solutions,
+  // one per thread
+  const int n_threads = max_threads(*m_config);
+  std::vector<std::unique_ptr<AgeColumnSystem> > systems(n_threads);
+  for (int k = 0; k < n_threads; ++k) {
+    systems[k].reset(new AgeColumnSystem(m_grid->z(), "age",
+                                         m_grid->dx(), m_grid->dy(), dt,
+                                         m_ice_age, u3, v3, w3));
+  }
 
-  size_t Mz_fine = system.z().size();
-  std::vector<double> x(Mz_fine);   // space for solution
+  size_t Mz_fine = systems[0]->z().size();
+  std::vector<std::vector<double> > solutions(n_threads, std::vector<double>(Mz_fine));
+  std::vector<std::unique_ptr<TridiagonalSystemBatch> > batches(n_threads);
+  for (int k = 0; k < n_threads; ++k) {
+    batches[k].reset(new TridiagonalSystemBatch(Mz_fine));
+  }
 
   array::AccessScope list{&ice_thickness, &u3, &v3, &w3, &m_ice_age, &m_work};
 
   unsigned int Mz = m_grid->Mz();
 
-  ParallelSection loop(m_grid->com);
-  try {
-    for (auto p = m_grid->points(); p; p.next()) {
-      const int i = p.i(), j = p.j();
+  // Systems in a block of columns are set up first and then solved together (see
+  // TridiagonalSystemBatch).
+  auto update_block = [&](int i_start, int i_end, int j, int thread) {
+    auto &system = *systems[thread];
+    auto &batch  = *batches[thread];
+    auto &x      = solutions[thread];
 
+    for (int i = i_start; i < i_end; ++i) {
       system.init(i, j, ice_thickness(i, j));
 
-      if (system.ks() == 0) {
+      system.assemble(batch, i - i_start);
+    }
+
+    try {
+      batch.solve(i_end - i_start);
+    } catch (RuntimeError &e) {
+      e.add_context("solving tri-diagonal systems (AgeColumnSystem) at i = %d...%d, j = %d",
+                    i_start, i_end - 1, j);
+      throw;
+    }
+
+    for (int i = i_start; i < i_end; ++i) {
+      if (batch.size(i - i_start) == 0) {
         // if no ice, set the entire column to zero age
         m_work.set_column(i, j, 0.0);
-      } else {
-        // general case: solve advection PDE
-
-        // solve the system for this column; call checks that params set
-        system.solve(x);
-
-        // put solution in array::Array3D
-        system.fine_to_coarse(x, i, j, m_work);
-
-        // Ensure that the age of the ice is non-negative.
-        //
-        // FIXME: this is a kludge. We need to ensure that our numerical method has the maximum
-        // principle instead. (We may still need this for correctness, though.)
-        double *column = m_work.get_column(i, j);
-        for (unsigned int k = 0; k < Mz; ++k) {
-          if (column[k] < 0.0) {
-            column[k] = 0.0;
-          }
+        continue;
+      }
+
+      system.extract_solution(batch, i - i_start, x);
+
+      // put solution in array::Array3D
+      system.fine_to_coarse(x, i, j, m_work);
+
+      // Ensure that the age of the ice is non-negative.
+      //
+      // FIXME: this is a kludge. We need to ensure that our numerical method has the maximum
+      // principle instead. (We may still need this for correctness, though.)
+      double *column = m_work.get_column(i, j);
+      for (unsigned int k = 0; k < Mz; ++k) {
+        if (column[k] < 0.0) {
+          column[k] = 0.0;
         }
       }
     }
-  } catch (...) {
-    loop.failed();
+  };
+
+  const unsigned int batch_size = batches[0]->batch_size();
+
+  ParallelSection loop(m_grid->com);
+  if (inputs.cell_type != nullptr) {
+    const auto &columns = inputs.cell_type->active_columns();
+
+    // inactive columns are ice-free: set them to zero age
+    for (auto p = columns.inactive_points(); p; p.next()) {
+      m_work.set_column(p.i(), p.j(), 0.0);
+    }
+
+    for_each_block(columns.runs(), batch_size, n_threads, loop, update_block);
+  } else {
+    for_each_block(*m_grid, batch_size, n_threads, loop, update_block);
   }
   loop.check();
 
   m_ice_age.copy_from(m_work);
+  m_ice_age.compact();
 }
 
 const array::Array3D & AgeModel::age() const {
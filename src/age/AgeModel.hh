@@ -39,6 +39,8 @@ public:
   const array::Array3D *u3;
   const array::Array3D *v3;
   const array::Array3D *w3;
+  //! optional; if set, only active columns are updated (see CellType::active_columns())
+  const array::CellType *cell_type;
 };
 
 class AgeModel : public Component {
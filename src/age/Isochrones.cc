@@ -86,6 +86,8 @@ static std::shared_ptr<array::Array3D> allocate_layer_thickness(std::shared_ptr<
                                                  array::WITHOUT_GHOSTS, times);
 
   result->metadata().long_name("thicknesses of isochronal layers").units("m");
+  result->use_single_precision(
+      array::single_precision_requested(*grid->ctx()->config(), "isochrones"));
 
   auto z_description =
       pism::printf("times for isochrones in '%s'; earliest deposition times for layers in '%s'",
@@ -729,6 +731,8 @@ void Isochrones::update(double t, double dt, const array::Array3D &u, const arra
       }
     }
   }
+
+  m_layer_thickness->compact();
 }
 
 MaxTimestep Isochrones::max_timestep_impl(double t) const {
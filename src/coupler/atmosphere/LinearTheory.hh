@@ -0,0 +1,75 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_LINEARTHEORY_H
+#define PISM_LINEARTHEORY_H
+
+#include <complex>
+
+namespace pism {
+
+class Config;
+
+namespace atmosphere {
+
+//! Transfer function and post-processing used by the linear model of orographic
+//! precipitation [@ref SmithBarstad2004], [@ref SmithBarstadBonneau2005].
+/*!
+ * This class contains the physics shared by OrographicPrecipitationSerial and
+ * OrographicPrecipitationParallel.
+ */
+class LinearTheory {
+public:
+  LinearTheory(const Config &config);
+
+  std::complex<double> operator()(double kx, double ky) const;
+
+  double post_process(double P) const;
+private:
+  // regularization
+  double m_eps;
+
+  //! truncate
+  bool m_truncate;
+  //! precipitation scale factor
+  double m_precip_scale_factor;
+  //! background precipitation
+  double m_background_precip_pre, m_background_precip_post;
+  //! cloud conversion time
+  double m_tau_c;
+  //! cloud fallout time
+  double m_tau_f;
+  //! water vapor scale height
+  double m_Hw;
+  //! moist stability frequency
+  double m_Nm;
+  //! Coriolis force
+  double m_f;
+  //! uplift sensitivity factor
+  double m_Cw;
+  //! horizontal wind component
+  double m_u;
+  //! vertical wind component
+  double m_v;
+};
+
+} // end of namespace atmosphere
+} // end of namespace pism
+
+#endif /* PISM_LINEARTHEORY_H */
@@ -18,6 +18,7 @@
 
 #include "pism/coupler/atmosphere/OrographicPrecipitation.hh"
 
+#include "pism/coupler/atmosphere/OrographicPrecipitationParallel.hh"
 #include "pism/coupler/atmosphere/OrographicPrecipitationSerial.hh"
 #include "pism/coupler/util/options.hh"
 #include "pism/geometry/Geometry.hh"
@@ -33,8 +34,6 @@ OrographicPrecipitation::OrographicPrecipitation(std::shared_ptr<const Grid> gri
 
   m_precipitation = allocate_precipitation(grid);
 
-  m_work0 = m_precipitation->allocate_proc0_copy();
-
   const int
     Mx = m_grid->Mx(),
     My = m_grid->My(),
@@ -42,6 +41,13 @@ OrographicPrecipitation::OrographicPrecipitation(std::shared_ptr<const Grid> gri
     Nx = m_grid->periodicity() & grid::X_PERIODIC ? Mx : Z * (Mx - 1) + 1,
     Ny = m_grid->periodicity() & grid::Y_PERIODIC ? My : Z * (My - 1) + 1;
 
+  if (m_config->get_flag("atmosphere.orographic_precipitation.parallel")) {
+    m_parallel_model.reset(new OrographicPrecipitationParallel(grid, Nx, Ny));
+    return;
+  }
+
+  m_work0 = m_precipitation->allocate_proc0_copy();
+
   ParallelSection rank0(m_grid->com);
   try {
     if (m_grid->rank() == 0) {
@@ -82,22 +88,26 @@ void OrographicPrecipitation::init_impl(const Geometry &geometry) {
 void OrographicPrecipitation::update_impl(const Geometry &geometry, double t, double dt) {
   m_input_model->update(geometry, t, dt);
 
-  geometry.ice_surface_elevation.put_on_proc0(*m_work0);
-
-  ParallelSection rank0(m_grid->com);
-  try {
-    if (m_grid->rank() == 0) { // processor zero updates the precipitation
-      m_serial_model->update(*m_work0);
-
-      PetscErrorCode ierr = VecCopy(m_serial_model->precipitation(), *m_work0);
-      PISM_CHK(ierr, "VecCopy");
+  if (m_parallel_model) {
+    m_parallel_model->update(geometry.ice_surface_elevation, *m_precipitation);
+  } else {
+    geometry.ice_surface_elevation.put_on_proc0(*m_work0);
+
+    ParallelSection rank0(m_grid->com);
+    try {
+      if (m_grid->rank() == 0) { // processor zero updates the precipitation
+        m_serial_model->update(*m_work0);
+
+        PetscErrorCode ierr = VecCopy(m_serial_model->precipitation(), *m_work0);
+        PISM_CHK(ierr, "VecCopy");
+      }
+    } catch (...) {
+      rank0.failed();
     }
-  } catch (...) {
-    rank0.failed();
-  }
-  rank0.check();
+    rank0.check();
 
-  m_precipitation->get_from_proc0(*m_work0);
+    m_precipitation->get_from_proc0(*m_work0);
+  }
 
   // convert from mm/s to kg / (m^2 s):
   double water_density = m_config->get_number("constants.fresh_water.density");
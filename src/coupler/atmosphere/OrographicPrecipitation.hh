@@ -28,6 +28,7 @@ class Geometry;
 namespace atmosphere {
 
 class OrographicPrecipitationSerial;
+class OrographicPrecipitationParallel;
 
 class OrographicPrecipitation : public AtmosphereModel {
 public:
@@ -56,6 +57,10 @@ protected:
 
   //! Serial orographic precipitation model.
   std::unique_ptr<OrographicPrecipitationSerial> m_serial_model;
+
+  //! Distributed orographic precipitation model (used if
+  //! atmosphere.orographic_precipitation.parallel is set).
+  std::unique_ptr<OrographicPrecipitationParallel> m_parallel_model;
 };
 
 } // end of namespace atmosphere
@@ -0,0 +1,173 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/coupler/atmosphere/OrographicPrecipitationParallel.hh"
+
+#include <algorithm>      // std::copy()
+#include <cassert>        // assert()
+#include <cmath>          // std::exp()
+#include <gsl/gsl_math.h> // M_PI
+
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/DistributedFFT.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/fftw_utilities.hh" // fftfreq()
+#include "pism/util/pism_utilities.hh" // GlobalSum()
+
+namespace pism {
+namespace atmosphere {
+
+/*!
+ * @param[in] grid PISM's grid
+ * @param[in] Nx extended grid size in the X direction
+ * @param[in] Ny extended grid size in the Y direction
+ */
+OrographicPrecipitationParallel::OrographicPrecipitationParallel(std::shared_ptr<const Grid> grid,
+                                                                 int Nx, int Ny)
+  : m_grid(grid),
+    m_model(*grid->ctx()->config()),
+    m_Nx(Nx),
+    m_Ny(Ny) {
+
+  auto config = grid->ctx()->config();
+
+  auto wisdom_file = config->get_string("atmosphere.orographic_precipitation.fftw_wisdom_file");
+  if (not wisdom_file.empty()) {
+    grid->ctx()->log()->message(2, "  Using FFTW wisdom file '%s'...\n", wisdom_file.c_str());
+  }
+
+  m_fft.reset(new DistributedFFT(grid->com, m_Nx, m_Ny, wisdom_file));
+
+  const int
+    Mx = grid->Mx(),
+    My = grid->My();
+  m_center.reset(new FFTEmbedding(*grid, *m_fft, (m_Nx - Mx) / 2, (m_Ny - My) / 2));
+
+  auto &fft = *m_fft;
+
+  // initialize the Gaussian filter (see OrographicPrecipitationSerial)
+  std::vector<std::complex<double> > G_hat(fft.spectrum_size(), 1.0);
+  {
+    double
+      dx    = grid->dx(),
+      dy    = grid->dy(),
+      sigma = config->get_number("atmosphere.orographic_precipitation.smoothing_standard_deviation");
+
+    if (sigma > 0.0) {
+      int
+        Nx2 = m_Nx / 2,
+        Ny2 = m_Ny / 2;
+
+      double sum = 0.0;
+      for (int i = fft.xs(); i < fft.xs() + fft.xm(); i++) {
+        for (int j = 0; j < m_Ny; j++) {
+          int
+            p = i <= Nx2 ? i : m_Nx - i,
+            q = j <= Ny2 ? j : m_Ny - j;
+          double
+            x = p * dx,
+            y = q * dy;
+
+          double G = std::exp(-0.5 * (x * x + y * y) / (sigma * sigma));
+          sum += G;
+
+          fft.space(i, j) = G;
+        }
+      }
+
+      // normalize:
+      sum = GlobalSum(grid->com, sum);
+      assert(sum > 0.0);
+      for (int i = fft.xs(); i < fft.xs() + fft.xm(); i++) {
+        for (int j = 0; j < m_Ny; j++) {
+          fft.space(i, j) /= sum;
+        }
+      }
+
+      // compute FFT of the Gaussian
+      fft.forward();
+      std::copy(fft.spectrum(), fft.spectrum() + fft.spectrum_size(), G_hat.begin());
+    }
+  }
+
+  // The transfer function does not depend on the surface elevation, so we pre-compute it
+  // here, combining it with the Gaussian filter.
+  {
+    auto kx = fftfreq(m_Nx, grid->dx() / (2.0 * M_PI));
+    auto ky = fftfreq(m_Ny, grid->dy() / (2.0 * M_PI));
+
+    m_transfer.resize(fft.spectrum_size());
+
+    int k = 0;
+    for (int j = fft.ys(); j < fft.ys() + fft.ym(); j++) {
+      for (int i = 0; i < m_Nx; i++) {
+        m_transfer[k] = G_hat[k] * m_model(kx[i], ky[j]);
+        ++k;
+      }
+    }
+  }
+}
+
+OrographicPrecipitationParallel::~OrographicPrecipitationParallel() {
+  // empty, but implemented here to be able to use forward declarations of DistributedFFT
+  // and FFTEmbedding in the header
+}
+
+/*!
+ * Update precipitation.
+ *
+ * @param[in] surface_elevation surface elevation
+ * @param[out] result precipitation (mm/s)
+ */
+void OrographicPrecipitationParallel::update(const array::Scalar &surface_elevation,
+                                             array::Scalar &result) {
+  auto &fft = *m_fft;
+
+  // Compute fft2(surface_elevation)
+  {
+    fft.clear_space();
+    m_center->set_real_part(surface_elevation, 1.0, fft);
+    fft.forward();
+  }
+
+  // FFT(h) * FFT(Gaussian) * (transfer function)
+  {
+    auto *P_hat = fft.spectrum();
+    for (int k = 0; k < fft.spectrum_size(); ++k) {
+      P_hat[k] *= m_transfer[k];
+    }
+  }
+
+  fft.inverse();
+
+  m_center->get_real_part(fft, 1.0 / (m_Nx * m_Ny), result);
+
+  array::AccessScope list{&result};
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    result(i, j) = m_model.post_process(result(i, j));
+  }
+}
+
+} // end of namespace atmosphere
+} // end of namespace pism
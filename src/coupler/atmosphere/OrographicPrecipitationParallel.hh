@@ -0,0 +1,80 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_OROGRAPHICPRECIPITATIONPARALLEL_H
+#define PISM_OROGRAPHICPRECIPITATIONPARALLEL_H
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "pism/coupler/atmosphere/LinearTheory.hh"
+
+namespace pism {
+
+class Grid;
+class DistributedFFT;
+class FFTEmbedding;
+
+namespace array {
+class Scalar;
+} // end of namespace array
+
+namespace atmosphere {
+
+//! Distributed implementation of the linear model of orographic precipitation [@ref
+//! SmithBarstad2004], [@ref SmithBarstadBonneau2005].
+/*!
+ * This class implements the same method as OrographicPrecipitationSerial, but uses the
+ * domain decomposition of PISM's grid instead of gathering the surface elevation on rank
+ * 0. Fourier transforms on the extended grid are computed using DistributedFFT.
+ *
+ * Results match ones computed by OrographicPrecipitationSerial up to round-off.
+ */
+class OrographicPrecipitationParallel {
+public:
+  OrographicPrecipitationParallel(std::shared_ptr<const Grid> grid, int Nx, int Ny);
+  ~OrographicPrecipitationParallel();
+
+  void update(const array::Scalar &surface_elevation, array::Scalar &result);
+
+private:
+  std::shared_ptr<const Grid> m_grid;
+
+  //! the linear model of orographic precipitation
+  LinearTheory m_model;
+
+  // extended grid size
+  int m_Nx;
+  int m_Ny;
+
+  std::unique_ptr<DistributedFFT> m_fft;
+
+  //! the physical grid in the center of the extended grid
+  std::unique_ptr<FFTEmbedding> m_center;
+
+  //! FFT(Gaussian) times the transfer function of the linear model (Fourier space
+  //! values owned by this rank, see DistributedFFT)
+  std::vector<std::complex<double> > m_transfer;
+};
+
+} // end of namespace atmosphere
+} // end of namespace pism
+
+#endif /* PISM_OROGRAPHICPRECIPITATIONPARALLEL_H */
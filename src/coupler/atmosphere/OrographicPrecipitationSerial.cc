@@ -18,7 +18,7 @@
 
 #include "pism/coupler/atmosphere/OrographicPrecipitationSerial.hh"
 
-#include <complex> // std::complex<double>, std::sqrt()
+#include <complex> // std::complex<double>
 #include <gsl/gsl_math.h> // M_PI
 #include <cassert>        // assert()
 #include <cmath>          // std::exp()
@@ -44,9 +44,7 @@ OrographicPrecipitationSerial::OrographicPrecipitationSerial(const Config &confi
                                                              int Mx, int My,
                                                              double dx, double dy,
                                                              int Nx, int Ny)
-  : m_Mx(Mx), m_My(My), m_Nx(Nx), m_Ny(Ny) {
-
-  m_eps = 1.0e-18;
+  : m_model(config), m_Mx(Mx), m_My(My), m_Nx(Nx), m_Ny(Ny) {
 
   // derive more parameters
   {
@@ -57,33 +55,6 @@ OrographicPrecipitationSerial::OrographicPrecipitationSerial(const Config &confi
     m_ky = fftfreq(m_Ny, dy / (2.0 * M_PI));
   }
 
-  {
-    m_background_precip_pre  = config.get_number("atmosphere.orographic_precipitation.background_precip_pre", "mm/s");
-    m_background_precip_post = config.get_number("atmosphere.orographic_precipitation.background_precip_post", "mm/s");
-
-    m_precip_scale_factor = config.get_number("atmosphere.orographic_precipitation.scale_factor");
-    m_tau_c               = config.get_number("atmosphere.orographic_precipitation.conversion_time");
-    m_tau_f               = config.get_number("atmosphere.orographic_precipitation.fallout_time");
-    m_Hw                  = config.get_number("atmosphere.orographic_precipitation.water_vapor_scale_height");
-    m_Nm                  = config.get_number("atmosphere.orographic_precipitation.moist_stability_frequency");
-    m_wind_speed          = config.get_number("atmosphere.orographic_precipitation.wind_speed");
-    m_wind_direction      = config.get_number("atmosphere.orographic_precipitation.wind_direction");
-    m_gamma               = config.get_number("atmosphere.orographic_precipitation.lapse_rate");
-    m_Theta_m             = config.get_number("atmosphere.orographic_precipitation.moist_adiabatic_lapse_rate");
-    m_rho_Sref            = config.get_number("atmosphere.orographic_precipitation.reference_density");
-    m_latitude            = config.get_number("atmosphere.orographic_precipitation.coriolis_latitude");
-    m_truncate            = config.get_flag("atmosphere.orographic_precipitation.truncate");
-
-
-    // derived constants
-    m_f = 2.0 * 7.2921e-5 * sin(m_latitude * M_PI / 180.0);
-
-    m_u = -sin(m_wind_direction * 2.0 * M_PI / 360.0) * m_wind_speed;
-    m_v = -cos(m_wind_direction * 2.0 * M_PI / 360.0) * m_wind_speed;
-
-    m_Cw = m_rho_Sref * m_Theta_m / m_gamma;
-  }
-
   // memory allocation
   {
     PetscErrorCode ierr = 0;
@@ -192,15 +163,6 @@ Vec OrographicPrecipitationSerial::precipitation() const {
  * @param[in] surface_elevation surface on the physical (Mx*My) grid
  */
 void OrographicPrecipitationSerial::update(petsc::Vec &surface_elevation) {
-  // solves:
-  // Phat(k,l) = (Cw * i * sigma * Hhat(k,l)) /
-  //             (1 - i * m * Hw) * (1 + i * sigma * tauc) * (1 + i * sigma * tauf);
-  // see equation (49) in
-  // R. B. Smith and I. Barstad, 2004:
-  // A Linear Theory of Orographic Precipitation. J. Atmos. Sci. 61, 1377-1391.
-
-  std::complex<double> I(0.0, 1.0);
-
   // Compute fft2(surface_elevation)
   {
     clear_fftw_array(m_fftw_input, m_Nx, m_Ny);
@@ -227,45 +189,7 @@ void OrographicPrecipitationSerial::update(petsc::Vec &surface_elevation) {
         // FFT(h) * FFT(Gaussian), i.e. FFT(smoothed ice surface elevation)
         const auto &h_hat = fftw_output(i, j) * G_hat(i, j);
 
-        double sigma = m_u * kx + m_v * ky;
-
-        // See equation (6) in [@ref SmithBarstadBonneau2005]
-        std::complex<double> m;
-        {
-          double denominator = sigma * sigma - m_f * m_f;
-
-          // avoid dividing by zero:
-          if (fabs(denominator) < m_eps) {
-            denominator = denominator >= 0 ? m_eps : -m_eps;
-          }
-
-          double m_squared = (m_Nm * m_Nm - sigma * sigma) * (kx * kx + ky * ky) / denominator;
-
-          // Note: this is a *complex* square root.
-          m = std::sqrt(std::complex<double>(m_squared));
-
-          if (m_squared >= 0.0 and sigma != 0.0) {
-            m *= sigma > 0.0 ? 1.0 : -1.0;
-          }
-        }
-
-        // avoid dividing by zero:
-        double delta = 0.0;
-        if (std::abs(1.0 - I * m * m_Hw) < m_eps) {
-          delta = m_eps;
-        }
-
-        // See equation (49) in [@ref SmithBarstad2004] or equation (3) in [@ref
-        // SmithBarstadBonneau2005].
-        auto P_hat = h_hat * (m_Cw * I * sigma /
-                              ((1.0 - I * m * m_Hw + delta) *
-                               (1.0 + I * sigma * m_tau_c) *
-                               (1.0 + I * sigma * m_tau_f)));
-        // Note: sigma, m_tau_c, and m_tau_f are purely real, so the second and the third
-        // factors in the denominator are never zero.
-        //
-        // The first factor (1 - i m H_w) *could* be zero. Here we check if it is and
-        // "regularize" if necessary.
+        auto P_hat = h_hat * m_model(kx, ky);
 
         fftw_input(i, j) = P_hat;
       }
@@ -285,12 +209,7 @@ void OrographicPrecipitationSerial::update(petsc::Vec &surface_elevation) {
   petsc::VecArray2D p(m_precipitation, m_Mx, m_My);
   for (int i = 0; i < m_Mx; i++) {
     for (int j = 0; j < m_My; j++) {
-      p(i, j) += m_background_precip_pre;
-      if (m_truncate) {
-        p(i, j) = std::max(p(i, j), 0.0);
-      }
-      p(i, j) *= m_precip_scale_factor;
-      p(i, j) += m_background_precip_post;
+      p(i, j) = m_model.post_process(p(i, j));
     }
   }
 }
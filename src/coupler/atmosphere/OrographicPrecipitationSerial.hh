@@ -22,6 +22,7 @@
 #include <vector>
 #include <fftw3.h>
 
+#include "pism/coupler/atmosphere/LinearTheory.hh"
 #include "pism/util/petscwrappers/Vec.hh"
 
 namespace pism {
@@ -45,48 +46,13 @@ public:
   void update(petsc::Vec &surface_elevation);
 
 private:
-  // regularization
-  double m_eps;
+  //! the linear model of orographic precipitation
+  LinearTheory m_model;
 
   // grid size
   int m_Mx;
   int m_My;
 
-  //! truncate
-  bool m_truncate;
-  //! precipitation scale factor
-  double m_precip_scale_factor;
-  //! background precipitation
-  double m_background_precip_pre, m_background_precip_post;
-  //! cloud conversion time
-  double m_tau_c;
-  //! cloud fallout time
-  double m_tau_f;
-  //! water vapor scale height
-  double m_Hw;
-  //! moist stability frequency
-  double m_Nm;
-  //! wind direction
-  double m_wind_direction;
-  //! wind speed
-  double m_wind_speed;
-  //! moist adiabatic lapse rate
-  double m_Theta_m;
-  //! moist lapse rate
-  double m_gamma;
-  //! reference density
-  double m_rho_Sref;
-  //! Coriolis force
-  double m_f;
-  //! uplift sensitivity factor
-  double m_Cw;
-  //! latitude for Coriolis force
-  double m_latitude;
-  //! horizontal wind component
-  double m_u;
-  //! vertical wind component
-  double m_v;
-
   // extended grid size
   int m_Nx;
   int m_Ny;
@@ -17,7 +17,9 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
-#include <algorithm> // max_element
+#include <algorithm> // max_element, stable_sort
+#include <deque>
+#include <vector>
 #include "pism/coupler/ocean/PicoGeometry.hh"
 #include "pism/util/connected_components/label_components.hh"
 #include "pism/util/array/CellType.hh"
@@ -313,7 +315,7 @@ void PicoGeometry::compute_lakes(const array::CellType &cell_type, array::Scalar
 
     // identify "floating" areas that are not connected to the open ocean as defined above
     profiling().begin("ocean.lakes.label");
-    connected_components::label_isolated(m_tmp, reachable_from_domain_edge);
+    connected_components::label_isolated_union_find(m_tmp, reachable_from_domain_edge);
     profiling().end("ocean.lakes.label");
 
     result.copy_from(m_tmp);
@@ -351,7 +353,7 @@ void PicoGeometry::compute_ice_rises(const array::CellType &cell_type, bool excl
 
     profiling().begin("ocean.ice_rises.label");
     if (exclude_ice_rises) {
-      connected_components::label(m_tmp);
+      connected_components::label_union_find(m_tmp);
 
       relabel(AREA_THRESHOLD, m_config->get_number("ocean.pico.maximum_ice_rise_area", "m2"),
               m_tmp);
@@ -406,7 +408,7 @@ void PicoGeometry::compute_continental_shelf_mask(const array::Scalar &bed_eleva
     // use "iceberg identification" to label parts *not* connected to the continental ice
     // sheet
     profiling().begin("ocean.continental_shelf_mask.label");
-    connected_components::label_isolated(m_tmp, 2);
+    connected_components::label_isolated_union_find(m_tmp, 2);
     profiling().end("ocean.continental_shelf_mask.label");
 
     // At this point areas with bed > threshold are 1, everything else is zero.
@@ -458,7 +460,7 @@ void PicoGeometry::compute_ice_shelf_mask(const array::Scalar &ice_rise_mask,
     }
 
     profiling().begin("ocean.ice_shelf_mask.label");
-    connected_components::label(m_tmp);
+    connected_components::label_union_find(m_tmp);
     profiling().end("ocean.ice_shelf_mask.label");
 
     // remove ice rises and lakes
@@ -502,7 +504,7 @@ void PicoGeometry::compute_ocean_mask(const array::CellType &cell_type, array::S
     }
 
     profiling().begin("ocean.ocean_mask.label");
-    connected_components::label(m_tmp);
+    connected_components::label_union_find(m_tmp);
     profiling().end("ocean.ocean_mask.label");
 
     relabel(BY_AREA, 0.0, m_tmp);
@@ -843,6 +845,92 @@ void PicoGeometry::compute_distances_cf(const array::Scalar1 &ocean_mask,
   profiling().end("ocean.eikonal_equation");
 }
 
+namespace {
+
+//! A grid point and its (tentative) distance label.
+struct LabeledPoint {
+  int label;
+  int i;
+  int j;
+};
+
+/*!
+ * Propagate distance labels from all labeled points (including ghosts) to points owned
+ * by this process, assigning labels to unlabeled points and reducing labels that are too
+ * large.
+ *
+ * Processes labeled points in the order of increasing labels (breadth-first search with
+ * multiple sources that may have different labels), so each point is re-labeled at most
+ * once per call.
+ *
+ * Returns true if the label of at least one owned point changed.
+ */
+bool propagate_labels(const Grid &grid, array::Scalar1 &mask) {
+  const int
+    xs = grid.xs(),
+    xm = grid.xm(),
+    ys = grid.ys(),
+    ym = grid.ym();
+
+  // labeled points in the sub-domain and its halo, sorted by label
+  std::vector<LabeledPoint> seeds;
+  for (auto p = grid.points(1); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    int label = mask.as_int(i, j);
+    if (label > 0) {
+      seeds.push_back({label, i, j});
+    }
+  }
+  std::stable_sort(seeds.begin(), seeds.end(),
+                   [](const LabeledPoint &a, const LabeledPoint &b) {
+                     return a.label < b.label;
+                   });
+
+  // points re-labeled during this call (labels in this queue are non-decreasing)
+  std::deque<LabeledPoint> queue;
+
+  const int di[] = {1, -1, 0, 0};
+  const int dj[] = {0, 0, 1, -1};
+
+  bool changed = false;
+  size_t s = 0;
+  while (s < seeds.size() or not queue.empty()) {
+    LabeledPoint P;
+    if (queue.empty() or (s < seeds.size() and seeds[s].label <= queue.front().label)) {
+      P = seeds[s++];
+    } else {
+      P = queue.front();
+      queue.pop_front();
+    }
+
+    if (mask.as_int(P.i, P.j) != P.label) {
+      // this point was re-labeled after it was added
+      continue;
+    }
+
+    for (int n = 0; n < 4; ++n) {
+      const int i = P.i + di[n], j = P.j + dj[n];
+
+      if (i < xs or i >= xs + xm or j < ys or j >= ys + ym) {
+        // labels of points owned by other processes are updated by their owners
+        continue;
+      }
+
+      int label = mask.as_int(i, j);
+      if (label == 0 or label > P.label + 1) {
+        mask(i, j) = P.label + 1;
+        queue.push_back({P.label + 1, i, j});
+        changed = true;
+      }
+    }
+  }
+
+  return changed;
+}
+
+} // end of anonymous namespace
+
 /*!
  * Find an approximate solution of the Eikonal equation on a given domain.
  *
@@ -856,11 +944,14 @@ void PicoGeometry::compute_distances_cf(const array::Scalar1 &ocean_mask,
  * generic ice shelf locations with zeros, set neighbors of the grounding line to 1, and
  * the rest of the grid with -1 or some other negative number.
  *
- * Note that this implementation updates ghosts *every* iteration. We could speed this
- * up by checking if a point at a boundary of the processor sub-domain was updated and
- * update ghosts in those cases only.
+ * On return each point within the domain that can be reached from the "wave front"
+ * contains one plus the length of the shortest path (using steps in `x` and `y`
+ * directions) to the front. Unreachable points remain zero.
  *
- * FIXME: replace this with a better algorithm.
+ * Each process propagates labels through its sub-domain until there is nothing left to
+ * update and only then exchanges ghosts. The number of ghost updates and global
+ * reductions is proportional to the number of sub-domain boundaries crossed by shortest
+ * paths instead of the maximum distance.
  */
 void eikonal_equation(array::Scalar1 &mask) {
 
@@ -868,6 +959,29 @@ void eikonal_equation(array::Scalar1 &mask) {
 
   auto grid = mask.grid();
 
+  double continue_loop = 1;
+  while (continue_loop != 0) {
+
+    continue_loop = propagate_labels(*grid, mask) ? 1 : 0;
+
+    mask.update_ghosts();
+
+    continue_loop = GlobalMax(grid->com, continue_loop);
+  }
+}
+
+/*!
+ * Reference implementation of eikonal_equation().
+ *
+ * Performs one sweep over the grid per distance label, updating ghosts and performing a
+ * global reduction after each sweep. Used to test eikonal_equation().
+ */
+void eikonal_equation_sweeps(array::Scalar1 &mask) {
+
+  assert(mask.stencil_width() > 0);
+
+  auto grid = mask.grid();
+
   double current_label = 1;
   double continue_loop = 1;
   while (continue_loop != 0) {
@@ -30,6 +30,8 @@ namespace ocean {
 
 void eikonal_equation(array::Scalar1 &mask);
 
+void eikonal_equation_sweeps(array::Scalar1 &mask);
+
 /*!
  * This class isolates geometric computations performed by the PICO ocean model.
  */
@@ -0,0 +1,228 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "\nPISM_EIKONAL_BENCH\n"
+  "  Compares implementations of the distance computation used by PICO (one grid sweep\n"
+  "  per distance label and breadth-first search within sub-domains) using ice geometry\n"
+  "  read from a file: checks that results agree and reports the time used by each.\n\n";
+
+#include <petsc.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "pism/coupler/ocean/PicoGeometry.hh"
+#include "pism/util/Config.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/pism_utilities.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+
+namespace pism {
+
+enum CellKind { GROUNDED = 0, FLOATING = 1, OCEAN = 2 };
+
+/*!
+ * Classify cells using the flotation criterion (assuming zero sea level).
+ */
+static void classify(const Config &config, const array::Scalar &ice_thickness,
+                     const array::Scalar &bed_elevation, array::Scalar1 &result) {
+  auto grid = result.grid();
+
+  double alpha = (config.get_number("constants.ice.density") /
+                  config.get_number("constants.sea_water.density"));
+
+  array::AccessScope list{ &ice_thickness, &bed_elevation, &result };
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    double
+      H = ice_thickness(i, j),
+      b = bed_elevation(i, j);
+
+    if (H > 0.0) {
+      result(i, j) = alpha * H > -b ? GROUNDED : FLOATING;
+    } else {
+      result(i, j) = b < 0.0 ? OCEAN : GROUNDED;
+    }
+  }
+  result.update_ghosts();
+}
+
+/*!
+ * Set up the mask used to compute distances to the grounding line (`grounding_line ==
+ * true`) or to the calving front, using the same rules as PicoGeometry.
+ */
+static void set_mask(const array::Scalar1 &cell_kind, bool grounding_line,
+                     array::Scalar1 &mask) {
+  auto grid = mask.grid();
+
+  array::AccessScope list{ &cell_kind, &mask };
+
+  mask.set(-1);
+
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (cell_kind.as_int(i, j) != FLOATING) {
+      continue;
+    }
+
+    bool front = false;
+    if (grounding_line) {
+      auto B = cell_kind.box_int(i, j);
+      front = (B.n == GROUNDED or B.ne == GROUNDED or B.e == GROUNDED or
+               B.se == GROUNDED or B.s == GROUNDED or B.sw == GROUNDED or
+               B.w == GROUNDED or B.nw == GROUNDED);
+    } else {
+      auto S = cell_kind.star_int(i, j);
+      front = (S.n == OCEAN or S.e == OCEAN or S.s == OCEAN or S.w == OCEAN);
+    }
+
+    mask(i, j) = front ? 1 : 0;
+  }
+  mask.update_ghosts();
+}
+
+/*!
+ * Compute distances using `method` `repeat` times and return the time per call.
+ */
+static double time_distances(int repeat, const array::Scalar1 &cell_kind,
+                             bool grounding_line, array::Scalar1 &mask,
+                             const std::function<void(array::Scalar1 &)> &method) {
+  double T = 0.0;
+  for (int r = 0; r < repeat; ++r) {
+    set_mask(cell_kind, grounding_line, mask);
+
+    array::AccessScope list{ &mask };
+
+    MPI_Barrier(mask.grid()->com);
+    double T0 = MPI_Wtime();
+    method(mask);
+    MPI_Barrier(mask.grid()->com);
+    T += MPI_Wtime() - T0;
+  }
+  return T / repeat;
+}
+
+//! Return the number of grid cells where `a` and `b` differ.
+static int n_different(const array::Scalar &a, const array::Scalar &b) {
+  auto grid = a.grid();
+
+  array::AccessScope list{ &a, &b };
+
+  int result = 0;
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+    if (a(i, j) != b(i, j)) {
+      result += 1;
+    }
+  }
+  return GlobalSum(grid->com, result);
+}
+
+} // end of namespace pism
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  try {
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_eikonal_bench");
+    auto log = ctx->log();
+
+    std::string usage =
+      "  pism_eikonal_bench -i input.nc [-repeat R]\n"
+      "where\n"
+      "  -i         input file containing ice thickness (thk) and bed elevation (topg)\n"
+      "  -repeat    number of repetitions used for timing (default: 3)\n";
+
+    bool stop = show_usage_check_req_opts(*log, "pism_eikonal_bench", {"-i"}, usage);
+    if (stop) {
+      return 0;
+    }
+
+    options::String input_file("-i", "input file name");
+    options::Integer repeat("-repeat", "number of repetitions", 3);
+
+    if (repeat < 1) {
+      throw RuntimeError(PISM_ERROR_LOCATION, "-repeat has to be positive");
+    }
+
+    File file(com, input_file, io::PISM_NETCDF3, io::PISM_READONLY);
+
+    auto grid = Grid::FromFile(ctx, file, {"thk"}, grid::CELL_CENTER);
+
+    array::Scalar ice_thickness(grid, "thk"), bed_elevation(grid, "topg");
+    ice_thickness.metadata(0).long_name("land ice thickness").units("m");
+    bed_elevation.metadata(0).long_name("bedrock surface elevation").units("m");
+
+    ice_thickness.regrid(file, io::Default::Nil());
+    bed_elevation.regrid(file, io::Default::Nil());
+
+    array::Scalar1 cell_kind(grid, "cell_kind");
+    classify(*ctx->config(), ice_thickness, bed_elevation, cell_kind);
+
+    log->message(1, "Grid: %d x %d, %d MPI processes\n",
+                 (int)grid->Mx(), (int)grid->My(), (int)grid->size());
+    log->message(1, "%16s  %16s  %16s\n", "distance to", "sweeps (s)", "BFS (s)");
+
+    int n_failures = 0;
+    for (bool grounding_line : {true, false}) {
+      array::Scalar1 sweeps(grid, "sweeps"), bfs(grid, "bfs");
+
+      double
+        T_sweeps = time_distances(repeat, cell_kind, grounding_line, sweeps,
+                                  ocean::eikonal_equation_sweeps),
+        T_bfs    = time_distances(repeat, cell_kind, grounding_line, bfs,
+                                  ocean::eikonal_equation);
+
+      const char *name = grounding_line ? "grounding line" : "calving front";
+
+      log->message(1, "%16s  %16.4f  %16.4f (max. distance: %d)\n", name, T_sweeps, T_bfs,
+                   static_cast<int>(array::max(bfs)));
+
+      int n = n_different(sweeps, bfs);
+      if (n != 0) {
+        log->message(1, "FAILURE: distances to the %s differ (%d)\n", name, n);
+        n_failures += 1;
+      }
+    }
+
+    if (n_failures > 0) {
+      return 1;
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
@@ -31,6 +31,7 @@
 #include "pism/util/array/CellType.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/threading.hh"
 #include "pism/util/Vars.hh"
 #include "pism/util/array/Forcing.hh"
 
@@ -277,7 +278,7 @@ void DEBMSimple::update_impl(const Geometry &geometry, double t, double dt) {
   int N = static_cast<int>(timeseries_length(dt));
 
   const double dtseries = dt / N;
-  std::vector<double> ts(N), T(N), S(N), P(N), Alb(N);
+  std::vector<double> ts(N);
   std::vector<DEBMSimpleOrbitalParameters> orbital(N);
 
   for (int k = 0; k < N; ++k) {
@@ -288,6 +289,21 @@ void DEBMSimple::update_impl(const Geometry &geometry, double t, double dt) {
     orbital[k] = m_model.orbital_parameters(ts[k]);
   }
 
+  // pre-compute times at which the snow depth is reset (these do not depend on the
+  // map-plane location either)
+  std::vector<bool> reset_snow_depth(N, false);
+  {
+    double next_snow_depth_reset = m_next_balance_year_start;
+    for (int k = 0; k < N; ++k) {
+      if (ts[k] >= next_snow_depth_reset) {
+        reset_snow_depth[k] = true;
+        while (next_snow_depth_reset <= ts[k]) {
+          next_snow_depth_reset = time().increment_date(next_snow_depth_reset, 1);
+        }
+      }
+    }
+  }
+
   // update standard deviation time series
   m_air_temp_sd->update(t, dt);
   m_air_temp_sd->init_interpolation(ts);
@@ -328,163 +344,193 @@ void DEBMSimple::update_impl(const Geometry &geometry, double t, double dt) {
   m_atmosphere->init_timeseries(ts);
   m_atmosphere->begin_pointwise_access();
 
-  ParallelSection loop(m_grid->com);
-  try {
-    for (auto p = m_grid->points(); p; p.next()) {
-      const int i = p.i(), j = p.j();
+  const int
+    xs = m_grid->xs(),
+    xm = m_grid->xm(),
+    ys = m_grid->ys(),
+    ym = m_grid->ym();
+
+  // Atmosphere models use temporary storage shared by all grid points, so air temperature
+  // and precipitation time series are fetched by one thread, a row of the grid at a time,
+  // before the row is processed by all threads.
+  std::vector<std::vector<double> >
+    T_row(xm, std::vector<double>(N)),
+    P_row(xm, std::vector<double>(N));
+
+  // standard deviation of air temperature and albedo time series used by each thread
+  const int n_threads = max_threads(*m_config);
+  std::vector<std::vector<double> >
+    S_storage(n_threads, std::vector<double>(N)),
+    Alb_storage(n_threads, std::vector<double>(N));
+
+  // Gets air temperature and precipitation time series at (i, j) from an atmosphere
+  // model and its modifiers.
+  auto get_inputs = [&](int i, int j, std::vector<double> &T, std::vector<double> &P) {
+    m_atmosphere->temp_time_series(i, j, T);
+
+    if (not mask.ice_free_ocean(i, j)) {
+      m_atmosphere->precip_time_series(i, j, P);
+    }
+  };
 
-      double latitude = geometry.latitude(i, j);
+  // Computes the mass balance at (i, j).
+  auto process_point = [&](int i, int j, int thread) {
+    auto &T = T_row[i - xs], &P = P_row[i - xs];
+    auto &S = S_storage[thread], &Alb = Alb_storage[thread];
 
-      // Get the temperature time series from an atmosphere model and its modifiers
-      m_atmosphere->temp_time_series(i, j, T);
+    double latitude = geometry.latitude(i, j);
 
-      if (mask.ice_free_ocean(i, j)) {
-        // ignore precipitation over ice-free ocean
+    if (mask.ice_free_ocean(i, j)) {
+      // ignore precipitation over ice-free ocean
+      for (int k = 0; k < N; ++k) {
+        P[k] = 0.0;
+      }
+    } else {
+      // elsewhere, use temperature time series to remove rainfall from precipitation and
+      // convert to m/s ice equivalent.
+      for (int k = 0; k < N; ++k) {
+        P[k] = snow_accumulation(T[k],  // air temperature (input)
+                                 P[k] / ice_density); // precipitation rate (input, gets overwritten)
+      }
+    }
+
+    if ((bool)m_input_albedo) {
+      m_input_albedo->interp(i, j, Alb);
+    }
+
+    // standard deviation of daily variability of air temperature
+    {
+      // interpolate temperature standard deviation time series
+      //
+      // Note: this works when m_air_temp_sd is constant in time.
+      m_air_temp_sd->interp(i, j, S);
+
+      if (sigmalapserate != 0.0) {
+        // apply standard deviation lapse rate on top of prescribed values
         for (int k = 0; k < N; ++k) {
-          P[k] = 0.0;
+          S[k] += sigmalapserate * (latitude - sigmabaselat);
         }
-      } else {
-        // elsewhere, get precipitation from the atmosphere model
-        m_atmosphere->precip_time_series(i, j, P);
-
-        // Use temperature time series to remove rainfall from precipitation and convert to
-        // m/s ice equivalent.
+        (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+      } else if (m_sd_use_param and mask.icy(i, j)) {
+        // apply standard deviation parameterization over ice if in use
         for (int k = 0; k < N; ++k) {
-          P[k] = snow_accumulation(T[k],  // air temperature (input)
-                                   P[k] / ice_density); // precipitation rate (input, gets overwritten)
+          S[k] = std::max(m_sd_param_a * (T[k] - melting_point) + m_sd_param_b, 0.0);
         }
+        (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
       }
+    }
 
-      if ((bool)m_input_albedo) {
-        m_input_albedo->interp(i, j, Alb);
-      }
+    {
+      // make copies of firn and snow depth values at this point to avoid accessing 2D
+      // fields in the inner loop
+      double
+        ice_thickness = H(i, j),
+        snow          = m_snow_depth(i, j),
+        surfelev      = surface_altitude(i, j),
+        albedo        = m_surface_albedo(i, j);
+
+      auto cell_type = static_cast<MaskValue>(mask.as_int(i, j));
+
+      double
+        A   = 0.0,            // accumulation
+        M   = 0.0,            // melt
+        R   = 0.0,            // runoff
+        SMB = 0.0,            // resulting mass balance
+        Mi  = 0.0,            // insolation melt contribution
+        Mt  = 0.0,            // temperature melt contribution
+        Mc  = 0.0,            // offset melt contribution
+        Al  = 0.0;            // albedo
+
+      // beginning of the loop over small time steps:
+      for (int k = 0; k < N; ++k) {
+
+        if (reset_snow_depth[k]) {
+          snow = 0.0;
+        }
 
-      // standard deviation of daily variability of air temperature
-      {
-        // interpolate temperature standard deviation time series
-        //
-        // Note: this works when m_air_temp_sd is constant in time.
-        m_air_temp_sd->interp(i, j, S);
-
-        if (sigmalapserate != 0.0) {
-          // apply standard deviation lapse rate on top of prescribed values
-          for (int k = 0; k < N; ++k) {
-            S[k] += sigmalapserate * (latitude - sigmabaselat);
-          }
-          (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
-        } else if (m_sd_use_param and mask.icy(i, j)) {
-          // apply standard deviation parameterization over ice if in use
-          for (int k = 0; k < N; ++k) {
-            S[k] = std::max(m_sd_param_a * (T[k] - melting_point) + m_sd_param_b, 0.0);
-          }
-          (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+        auto accumulation = P[k] * dtseries;
+
+        DEBMSimpleMelt melt_info{};
+        if (not mask::ice_free_ocean(cell_type)) {
+
+          melt_info = m_model.melt(orbital[k].solar_declination,
+                                   orbital[k].distance_factor,
+                                   dtseries,
+                                   S[k],
+                                   T[k],
+                                   surfelev,
+                                   latitude,
+                                   (bool)m_input_albedo ? Alb[k] : albedo);
         }
-      }
 
-      {
-        double next_snow_depth_reset = m_next_balance_year_start;
-
-        // make copies of firn and snow depth values at this point to avoid accessing 2D
-        // fields in the inner loop
-        double
-          ice_thickness = H(i, j),
-          snow          = m_snow_depth(i, j),
-          surfelev      = surface_altitude(i, j),
-          albedo        = m_surface_albedo(i, j);
-
-        auto cell_type = static_cast<MaskValue>(mask.as_int(i, j));
-
-        double
-          A   = 0.0,            // accumulation
-          M   = 0.0,            // melt
-          R   = 0.0,            // runoff
-          SMB = 0.0,            // resulting mass balance
-          Mi  = 0.0,            // insolation melt contribution
-          Mt  = 0.0,            // temperature melt contribution
-          Mc  = 0.0,            // offset melt contribution
-          Al  = 0.0;            // albedo
-
-        // beginning of the loop over small time steps:
-        for (int k = 0; k < N; ++k) {
+        auto changes = m_model.step(ice_thickness,
+                                    melt_info.total_melt,
+                                    snow,
+                                    accumulation);
 
-          if (ts[k] >= next_snow_depth_reset) {
-            snow = 0.0;
-            while (next_snow_depth_reset <= ts[k]) {
-              next_snow_depth_reset = time().increment_date(next_snow_depth_reset, 1);
-            }
-          }
-
-          auto accumulation = P[k] * dtseries;
-
-          DEBMSimpleMelt melt_info{};
-          if (not mask::ice_free_ocean(cell_type)) {
-
-            melt_info = m_model.melt(orbital[k].solar_declination,
-                                     orbital[k].distance_factor,
-                                     dtseries,
-                                     S[k],
-                                     T[k],
-                                     surfelev,
-                                     latitude,
-                                     (bool)m_input_albedo ? Alb[k] : albedo);
-          }
-
-          auto changes = m_model.step(ice_thickness,
-                                      melt_info.total_melt,
-                                      snow,
-                                      accumulation);
-
-          if ((bool) m_input_albedo) {
-            albedo = Alb[k];
-          } else {
-            albedo = m_model.albedo(changes.melt / dtseries, cell_type);
-          }
-
-          // update ice thickness
-          ice_thickness += changes.smb;
-          assert(ice_thickness >= 0);
-          // update snow depth
-          snow += changes.snow_depth;
-          assert(snow >= 0);
-          // update total accumulation, melt, and runoff
-          {
-            A   += accumulation;
-            M   += changes.melt;
-            Mt  += melt_info.temperature_melt;
-            Mi  += melt_info.insolation_melt;
-            Mc  += melt_info.offset_melt;
-            R   += changes.runoff;
-            SMB += changes.smb;
-            Al  += albedo;
-          }
-        } // end of the time-stepping loop
-
-        // set firn and snow depths
-        m_snow_depth(i, j)     = snow;
-        m_surface_albedo(i, j) = Al / N;
-        m_transmissivity(i, j) = m_model.atmosphere_transmissivity(surfelev);
-
-        // set melt terms at this point, converting
-        // from "meters, ice equivalent" to "kg / m^2"
-        m_temperature_driven_melt(i, j) = Mt * ice_density;
-        m_insolation_driven_melt(i, j)  = Mi * ice_density;
-        m_offset_melt(i, j)         = Mc * ice_density;
-
-        // set total accumulation, melt, and runoff, and SMB at this point, converting
-        // from "meters, ice equivalent" to "kg / m^2"
+        if ((bool) m_input_albedo) {
+          albedo = Alb[k];
+        } else {
+          albedo = m_model.albedo(changes.melt / dtseries, cell_type);
+        }
+
+        // update ice thickness
+        ice_thickness += changes.smb;
+        assert(ice_thickness >= 0);
+        // update snow depth
+        snow += changes.snow_depth;
+        assert(snow >= 0);
+        // update total accumulation, melt, and runoff
         {
-          (*m_accumulation)(i, j) = A * ice_density;
-          (*m_melt)(i, j)         = M * ice_density;
-          (*m_runoff)(i, j)       = R * ice_density;
-          // m_mass_flux (unlike m_accumulation, m_melt, and m_runoff), is a
-          // rate. m * (kg / m^3) / second = kg / m^2 / second
-          m_mass_flux(i, j) = SMB * ice_density / dt;
+          A   += accumulation;
+          M   += changes.melt;
+          Mt  += melt_info.temperature_melt;
+          Mi  += melt_info.insolation_melt;
+          Mc  += melt_info.offset_melt;
+          R   += changes.runoff;
+          SMB += changes.smb;
+          Al  += albedo;
         }
+      } // end of the time-stepping loop
+
+      // set firn and snow depths
+      m_snow_depth(i, j)     = snow;
+      m_surface_albedo(i, j) = Al / N;
+      m_transmissivity(i, j) = m_model.atmosphere_transmissivity(surfelev);
+
+      // set melt terms at this point, converting
+      // from "meters, ice equivalent" to "kg / m^2"
+      m_temperature_driven_melt(i, j) = Mt * ice_density;
+      m_insolation_driven_melt(i, j)  = Mi * ice_density;
+      m_offset_melt(i, j)         = Mc * ice_density;
+
+      // set total accumulation, melt, and runoff, and SMB at this point, converting
+      // from "meters, ice equivalent" to "kg / m^2"
+      {
+        (*m_accumulation)(i, j) = A * ice_density;
+        (*m_melt)(i, j)         = M * ice_density;
+        (*m_runoff)(i, j)       = R * ice_density;
+        // m_mass_flux (unlike m_accumulation, m_melt, and m_runoff), is a
+        // rate. m * (kg / m^3) / second = kg / m^2 / second
+        m_mass_flux(i, j) = SMB * ice_density / dt;
       }
+    }
+
+    if (mask.ice_free_ocean(i, j)) {
+      m_snow_depth(i, j) = 0.0; // snow over the ocean does not stick
+    }
+  };
 
-      if (mask.ice_free_ocean(i, j)) {
-        m_snow_depth(i, j) = 0.0; // snow over the ocean does not stick
+  ParallelSection loop(m_grid->com);
+  try {
+    for (int j = ys; j < ys + ym; ++j) {
+      for (int i = xs; i < xs + xm; ++i) {
+        get_inputs(i, j, T_row[i - xs], P_row[i - xs]);
       }
+
+      parallel_for(xm, 0, n_threads, loop, [&](int n, int thread) {
+        process_point(xs + n, j, thread);
+      });
     }
   } catch (...) {
     loop.failed();
@@ -20,6 +20,7 @@
 
 #include "pism/coupler/surface/TemperatureIndex.hh"
 #include "pism/coupler/surface/localMassBalance.hh"
+#include "pism/pism_parameters.hh"
 #include "pism/util/Grid.hh"
 #include "pism/util/Time.hh"
 #include "pism/coupler/AtmosphereModel.hh"
@@ -27,6 +28,7 @@
 
 #include "pism/util/error_handling.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/threading.hh"
 #include "pism/util/array/CellType.hh"
 #include "pism/geometry/Geometry.hh"
 #include "pism/util/array/Forcing.hh"
@@ -51,6 +53,12 @@ TemperatureIndex::TemperatureIndex(std::shared_ptr<const Grid> g,
   m_sd_param_a                 = m_config->get_number("surface.pdd.std_dev.param_a");
   m_sd_param_b                 = m_config->get_number("surface.pdd.std_dev.param_b");
 
+  // Check valid ranges of parameters used during time steps. (Time-stepping code uses
+  // Config::parameters() and does not do this.)
+  m_config->get_number("surface.mass_balance_year_start_day");
+  m_config->get_number("surface.pdd.std_dev.lapse_lat_rate");
+  m_config->get_number("surface.pdd.std_dev.lapse_lat_base");
+
   bool use_fausto_params     = m_config->get_flag("surface.pdd.fausto.enabled");
 
   auto method = m_config->get_string("surface.pdd.method");
@@ -63,6 +71,12 @@ TemperatureIndex::TemperatureIndex(std::shared_ptr<const Grid> g,
     m_mbscheme.reset(new PDDMassBalance(m_config, m_sys));
   }
 
+  // Process blocks of grid points at once if the PDD scheme supports it.
+  m_batch_size = 0;
+  if (method == "expectation_integral") {
+    m_batch_size = static_cast<unsigned int>(m_config->get_number("surface.pdd.batch_size"));
+  }
+
   if (use_fausto_params) {
     m_faustogreve.reset(new FaustoGrevePDDObject(m_grid));
     m_base_pddStdDev = 2.53;
@@ -132,6 +146,19 @@ void TemperatureIndex::init_impl(const Geometry &geometry) {
                    "  Computing number of positive degree-days by: %s.\n",
                    m_mbscheme->method().c_str());
 
+    if (m_batch_size > 0) {
+      const auto &integrand =
+        static_cast<const PDDMassBalance *>(m_mbscheme.get())->integrand();
+
+      m_log->message(3, "  Processing up to %d grid points at a time.\n", (int)m_batch_size);
+      if (integrand.max_error() > 0.0) {
+        m_log->message(3,
+                       "  Using a table with %d intervals to evaluate the PDD integrand"
+                       " (max. error: %.1e * sigma).\n",
+                       (int)integrand.table_size(), integrand.max_error());
+      }
+    }
+
     if (m_faustogreve) {
       m_log->message(2,
                      "  Setting PDD parameters from [Faustoetal2009].\n");
@@ -219,7 +246,7 @@ MaxTimestep TemperatureIndex::max_timestep_impl(double my_t) const {
 double TemperatureIndex::compute_next_balance_year_start(double time) {
   // compute the time corresponding to the beginning of the next balance year
   double
-    balance_year_start_day = m_config->get_number("surface.mass_balance_year_start_day"),
+    balance_year_start_day = m_config->parameters().surface.mass_balance_year_start_day,
     one_day                = units::convert(m_sys, 1.0, "days", "seconds"),
     year_start             = this->time().calendar_year_start(time),
     balance_year_start     = year_start + (balance_year_start_day - 1.0) * one_day;
@@ -245,11 +272,26 @@ void TemperatureIndex::update_impl(const Geometry &geometry, double t, double dt
   auto N = static_cast<int>(m_mbscheme->get_timeseries_length(dt));
 
   const double dtseries = dt / N;
-  std::vector<double> ts(N), T(N), S(N), P(N), PDDs(N);
+  std::vector<double> ts(N);
   for (int k = 0; k < N; ++k) {
     ts[k] = t + k * dtseries;
   }
 
+  // Times at which the snow depth is reset do not depend on the location, so we find
+  // them here instead of doing this at each grid point.
+  std::vector<bool> reset_snow_depth(N, false);
+  {
+    double next_snow_depth_reset = m_next_balance_year_start;
+    for (int k = 0; k < N; ++k) {
+      if (ts[k] >= next_snow_depth_reset) {
+        reset_snow_depth[k] = true;
+        while (next_snow_depth_reset <= ts[k]) {
+          next_snow_depth_reset = time().increment_date(next_snow_depth_reset, 1);
+        }
+      }
+    }
+  }
+
   // update standard deviation time series
   if (m_sd_file_set) {
     m_air_temp_sd->update(t, dt);
@@ -263,9 +305,11 @@ void TemperatureIndex::update_impl(const Geometry &geometry, double t, double dt
                                &m_firn_depth, &m_snow_depth,
                                m_accumulation.get(), m_melt.get(), m_runoff.get()};
 
+  const auto &params = m_config->parameters();
+
   const double
-    sigmalapserate = m_config->get_number("surface.pdd.std_dev.lapse_lat_rate"),
-    sigmabaselat   = m_config->get_number("surface.pdd.std_dev.lapse_lat_base");
+    sigmalapserate = params.surface.pdd.std_dev.lapse_lat_rate,
+    sigmabaselat   = params.surface.pdd.std_dev.lapse_lat_base;
 
   const array::Scalar *latitude = &geometry.latitude;
   if ((fausto_greve != nullptr) or sigmalapserate != 0.0) {
@@ -280,164 +324,265 @@ void TemperatureIndex::update_impl(const Geometry &geometry, double t, double dt
     fausto_greve->update_temp_mj(*surface_altitude, *latitude, *longitude);
   }
 
-  LocalMassBalance::DegreeDayFactors ddf = m_base_ddf;
-
   m_atmosphere->init_timeseries(ts);
 
   m_atmosphere->begin_pointwise_access();
 
-  const double ice_density = m_config->get_number("constants.ice.density");
-
-  ParallelSection loop(m_grid->com);
-  try {
-    for (auto p = m_grid->points(); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      // the temperature time series from the AtmosphereModel and its modifiers
+  const double ice_density = params.constants.ice.density;
+
+  // Random PDD schemes share a random number generator, so they have to use one thread.
+  const int n_threads =
+    params.surface.pdd.method == "expectation_integral" ?
+    max_threads(*m_config) : 1;
+
+  const int
+    xs = m_grid->xs(),
+    xm = m_grid->xm(),
+    ys = m_grid->ys(),
+    ym = m_grid->ym();
+
+  // Atmosphere models and the Fausto-Greve parameterization use temporary storage shared
+  // by all grid points, so inputs of the PDD model are fetched by one thread, a row of
+  // the grid at a time, before the row is processed by all threads.
+  std::vector<std::vector<double> >
+    T_row(xm, std::vector<double>(N)),
+    S_row(xm, std::vector<double>(N)),
+    P_row(xm, std::vector<double>(N));
+  std::vector<LocalMassBalance::DegreeDayFactors> ddf_row(xm);
+
+  // PDD time series used by each thread
+  std::vector<std::vector<double> > PDDs_storage(n_threads, std::vector<double>(N));
+
+  // Gets inputs of the PDD model at (i, j): air temperature, its standard deviation,
+  // precipitation rate (converted to meters per second, ice equivalent) and degree day
+  // factors.
+  auto get_inputs = [&](int i, int j, std::vector<double> &T, std::vector<double> &S,
+                        std::vector<double> &P, LocalMassBalance::DegreeDayFactors &ddf) {
+    ddf = m_base_ddf;
+
+    if (mask.ice_free_ocean(i, j)) {
+      // ignore precipitation over ice-free ocean (the air temperature is not used there)
+      for (int k = 0; k < N; ++k) {
+        P[k] = 0.0;
+      }
+    } else {
+      // elsewhere, get the temperature and precipitation time series from the
+      // AtmosphereModel and its modifiers
       m_atmosphere->temp_time_series(i, j, T);
+      m_atmosphere->precip_time_series(i, j, P);
+    }
 
-      if (mask.ice_free_ocean(i, j)) {
-        // ignore precipitation over ice-free ocean
-        for (int k = 0; k < N; ++k) {
-          P[k] = 0.0;
-        }
-      } else {
-        // elsewhere, get precipitation from the atmosphere model
-        m_atmosphere->precip_time_series(i, j, P);
+    // interpolate temperature standard deviation time series
+    if (m_sd_file_set) {
+      m_air_temp_sd->interp(i, j, S);
+    } else {
+      double tmp = (*m_air_temp_sd)(i, j);
+      for (int k = 0; k < N; ++k) {
+        S[k] = tmp;
       }
+    }
+
+    if (fausto_greve != nullptr) {
+      // we have been asked to set mass balance parameters according to
+      //   formula (6) in [\ref Faustoetal2009]; they overwrite ddf set above
+      ddf = fausto_greve->degree_day_factors(i, j, (*latitude)(i, j));
+    }
 
-      // convert precipitation from "kg m-2 second-1" to "m second-1" (PDDMassBalance expects
-      // accumulation in m/second ice equivalent)
+    // convert precipitation from "kg m-2 second-1" to "m second-1" (PDDMassBalance expects
+    // accumulation in m/second ice equivalent)
+    for (int k = 0; k < N; ++k) {
+      P[k] = P[k] / ice_density;
+      // kg / (m^2 * second) / (kg / m^3) = m / second
+    }
+
+    // apply standard deviation lapse rate on top of prescribed values
+    if (sigmalapserate != 0.0) {
+      double lat = (*latitude)(i, j);
       for (int k = 0; k < N; ++k) {
-        P[k] = P[k] / ice_density;
-        // kg / (m^2 * second) / (kg / m^3) = m / second
+        S[k] += sigmalapserate * (lat - sigmabaselat);
       }
+      (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+    }
 
-      // interpolate temperature standard deviation time series
-      if (m_sd_file_set) {
-        m_air_temp_sd->interp(i, j, S);
-      } else {
-        double tmp = (*m_air_temp_sd)(i, j);
-        for (int k = 0; k < N; ++k) {
-          S[k] = tmp;
+    // apply standard deviation param over ice if in use
+    if (m_sd_use_param and mask.icy(i, j)) {
+      for (int k = 0; k < N; ++k) {
+        S[k] = m_sd_param_a * (T[k] - 273.15) + m_sd_param_b;
+        if (S[k] < 0.0) {
+          S[k] = 0.0 ;
         }
       }
+      (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+    }
+  };
+
+  // Sets outputs at (i, j), converting totals from "meters, ice equivalent" to "kg / m^2".
+  auto set_outputs = [&](int i, int j, double A, double M, double R, double SMB,
+                         double firn, double snow) {
+    if (mask.ice_free_ocean(i, j)) {
+      firn = 0.0;  // no firn in the ocean
+      snow = 0.0;  // snow over the ocean does not stick
+    }
+
+    m_firn_depth(i, j) = firn;
+    m_snow_depth(i, j) = snow;
 
-      if (fausto_greve != nullptr) {
-        // we have been asked to set mass balance parameters according to
-        //   formula (6) in [\ref Faustoetal2009]; they overwrite ddf set above
-        ddf = fausto_greve->degree_day_factors(i, j, (*latitude)(i, j));
+    (*m_accumulation)(i, j) = A * ice_density;
+    (*m_melt)(i, j)         = M * ice_density;
+    (*m_runoff)(i, j)       = R * ice_density;
+    // m_mass_flux (unlike m_accumulation, m_melt, and m_runoff), is a
+    // rate. m * (kg / m^3) / second = kg / m^2 / second
+    m_mass_flux(i, j) = SMB * ice_density / dt;
+  };
+
+  const int B        = std::max(m_batch_size, 1U);
+  const int n_blocks = (xm + B - 1) / B;
+
+  std::vector<PDDBatch> batches;
+  std::vector<std::vector<int> > i_storage;
+  if (m_batch_size > 0) {
+    batches.resize(n_threads, PDDBatch(N, B));
+    i_storage.resize(n_threads, std::vector<int>(B));
+  }
+
+  // Processes columns i_start, ..., i_end - 1 in the current row, using a batch of the
+  // PDD model.
+  auto process_block = [&](int i_start, int i_end, int j, int thread) {
+    // m_batch_size is positive only if m_mbscheme is a PDDMassBalance (see the
+    // constructor)
+    const auto *pdd = static_cast<const PDDMassBalance *>(m_mbscheme.get());
+
+    auto &batch = batches[thread];
+    auto &i_index = i_storage[thread];
+
+    batch.size = 0;
+    for (int i = i_start; i < i_end; ++i) {
+      if (mask.ice_free_ocean(i, j)) {
+        // No melt and no accumulation over ice-free ocean: skip the PDD model.
+        set_outputs(i, j, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+        continue;
       }
 
-      // apply standard deviation lapse rate on top of prescribed values
-      if (sigmalapserate != 0.0) {
-        double lat = (*latitude)(i, j);
-        for (int k = 0; k < N; ++k) {
-          S[k] += sigmalapserate * (lat - sigmabaselat);
-        }
-        (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+      const auto &T = T_row[i - xs], &S = S_row[i - xs], &P = P_row[i - xs];
+      const auto &ddf = ddf_row[i - xs];
+
+      const unsigned int p = batch.size;
+      batch.size += 1;
+      i_index[p] = i;
+
+      for (int k = 0; k < N; ++k) {
+        batch.T[k * B + p] = T[k];
+        batch.S[k * B + p] = S[k];
+        batch.P[k * B + p] = P[k];
       }
 
-      // apply standard deviation param over ice if in use
-      if (m_sd_use_param and mask.icy(i, j)) {
-        for (int k = 0; k < N; ++k) {
-          S[k] = m_sd_param_a * (T[k] - 273.15) + m_sd_param_b;
-          if (S[k] < 0.0) {
-            S[k] = 0.0 ;
-          }
-        }
-        (*m_air_temp_sd)(i, j) = S[0]; // ensure correct SD reporting
+      batch.ddf_snow[p]          = ddf.snow;
+      batch.ddf_ice[p]           = ddf.ice;
+      batch.refreeze_fraction[p] = ddf.refreeze_fraction;
+
+      batch.ice[p]  = H(i, j);
+      batch.firn[p] = m_firn_depth(i, j);
+      batch.snow[p] = m_snow_depth(i, j);
+    }
+
+    pdd->update(dtseries, reset_snow_depth, batch);
+
+    for (unsigned int p = 0; p < batch.size; ++p) {
+      set_outputs(i_index[p], j, batch.accumulation[p], batch.melt[p], batch.runoff[p],
+                  batch.smb[p], batch.firn[p], batch.snow[p]);
+    }
+  };
+
+  // Processes the column (i, j).
+  auto process_point = [&](int i, int j, int thread) {
+    auto &T = T_row[i - xs], &S = S_row[i - xs], &P = P_row[i - xs];
+    auto &PDDs = PDDs_storage[thread];
+    const auto &ddf = ddf_row[i - xs];
+
+    // Use temperature time series, the "positive" threshhold, and
+    // the standard deviation of the daily variability to get the
+    // number of positive degree days (PDDs)
+    if (mask.ice_free_ocean(i, j)) {
+      for (int k = 0; k < N; ++k) {
+        PDDs[k] = 0.0;
       }
+    } else {
+      m_mbscheme->get_PDDs(dtseries, S, T, // inputs
+                           PDDs);          // output
+    }
 
-      // Use temperature time series, the "positive" threshhold, and
-      // the standard deviation of the daily variability to get the
-      // number of positive degree days (PDDs)
-      if (mask.ice_free_ocean(i, j)) {
-        for (int k = 0; k < N; ++k) {
-          PDDs[k] = 0.0;
-        }
-      } else {
-        m_mbscheme->get_PDDs(dtseries, S, T, // inputs
-                             PDDs);          // output
+    // Use temperature time series to remove rainfall from precipitation
+    m_mbscheme->get_snow_accumulation(T,  // air temperature (input)
+                                      P); // precipitation rate (input-output)
+
+    // Use degree-day factors, the number of PDDs, and the snow precipitation to get
+    // surface mass balance (and diagnostics: accumulation, melt, runoff)
+
+    // make copies of firn and snow depth values at this point to avoid accessing 2D
+    // fields in the inner loop
+    double
+      ice  = H(i, j),
+      firn = m_firn_depth(i, j),
+      snow = m_snow_depth(i, j);
+
+    // accumulation, melt, runoff over this time-step
+    double
+      A   = 0.0,
+      M   = 0.0,
+      R   = 0.0,
+      SMB = 0.0;
+
+    for (int k = 0; k < N; ++k) {
+      if (reset_snow_depth[k]) {
+        snow = 0.0;
       }
 
-      // Use temperature time series to remove rainfall from precipitation
-      m_mbscheme->get_snow_accumulation(T,  // air temperature (input)
-                                        P); // precipitation rate (input-output)
+      const double accumulation = P[k] * dtseries;
+
+      LocalMassBalance::Changes changes;
+      changes = m_mbscheme->step(ddf, PDDs[k],
+                                 ice, firn, snow, accumulation);
+
+      // update ice thickness
+      ice += changes.smb;
+      assert(ice >= 0);
+
+      // update firn depth
+      firn += changes.firn_depth;
+      assert(firn >= 0);
 
-      // Use degree-day factors, the number of PDDs, and the snow precipitation to get surface mass
-      // balance (and diagnostics: accumulation, melt, runoff)
+      // update snow depth
+      snow += changes.snow_depth;
+      assert(snow >= 0);
+
+      // update total accumulation, melt, and runoff
       {
-        double next_snow_depth_reset = m_next_balance_year_start;
-
-        // make copies of firn and snow depth values at this point to avoid accessing 2D
-        // fields in the inner loop
-        double
-          ice  = H(i, j),
-          firn = m_firn_depth(i, j),
-          snow = m_snow_depth(i, j);
-
-        // accumulation, melt, runoff over this time-step
-        double
-          A   = 0.0,
-          M   = 0.0,
-          R   = 0.0,
-          SMB = 0.0;
-
-        for (int k = 0; k < N; ++k) {
-          if (ts[k] >= next_snow_depth_reset) {
-            snow = 0.0;
-            while (next_snow_depth_reset <= ts[k]) {
-              next_snow_depth_reset = time().increment_date(next_snow_depth_reset, 1);
-            }
-          }
-
-          const double accumulation = P[k] * dtseries;
-
-          LocalMassBalance::Changes changes;
-          changes = m_mbscheme->step(ddf, PDDs[k],
-                                     ice, firn, snow, accumulation);
-
-          // update ice thickness
-          ice += changes.smb;
-          assert(ice >= 0);
-
-          // update firn depth
-          firn += changes.firn_depth;
-          assert(firn >= 0);
-
-          // update snow depth
-          snow += changes.snow_depth;
-          assert(snow >= 0);
-
-          // update total accumulation, melt, and runoff
-          {
-            A   += accumulation;
-            M   += changes.melt;
-            R   += changes.runoff;
-            SMB += changes.smb;
-          }
-        } // end of the time-stepping loop
-
-        // set firn and snow depths
-        m_firn_depth(i, j) = firn;
-        m_snow_depth(i, j) = snow;
-
-        // set total accumulation, melt, and runoff, and SMB at this point, converting
-        // from "meters, ice equivalent" to "kg / m^2"
-        {
-          (*m_accumulation)(i, j)          = A * ice_density;
-          (*m_melt)(i, j)                  = M * ice_density;
-          (*m_runoff)(i, j)                = R * ice_density;
-          // m_mass_flux (unlike m_accumulation, m_melt, and m_runoff), is a
-          // rate. m * (kg / m^3) / second = kg / m^2 / second
-          m_mass_flux(i, j) = SMB * ice_density / dt;
-        }
+        A   += accumulation;
+        M   += changes.melt;
+        R   += changes.runoff;
+        SMB += changes.smb;
       }
+    } // end of the time-stepping loop
 
-      if (mask.ice_free_ocean(i, j)) {
-        m_firn_depth(i, j) = 0.0;  // no firn in the ocean
-        m_snow_depth(i, j) = 0.0;  // snow over the ocean does not stick
+    set_outputs(i, j, A, M, R, SMB, firn, snow);
+  };
+
+  ParallelSection loop(m_grid->com);
+  try {
+    for (int j = ys; j < ys + ym; ++j) {
+      for (int i = xs; i < xs + xm; ++i) {
+        get_inputs(i, j, T_row[i - xs], S_row[i - xs], P_row[i - xs], ddf_row[i - xs]);
+      }
+
+      if (m_batch_size > 0) {
+        parallel_for(n_blocks, 0, n_threads, loop, [&](int n, int thread) {
+          const int i_start = xs + n * B;
+          process_block(i_start, std::min(i_start + B, xs + xm), j, thread);
+        });
+      } else {
+        parallel_for(xm, 0, n_threads, loop, [&](int n, int thread) {
+          process_point(xs + n, j, thread);
+        });
       }
     }
   } catch (...) {
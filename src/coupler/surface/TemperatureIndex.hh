@@ -104,6 +104,10 @@ protected:
   //! total runoff during the last time step
   std::shared_ptr<array::Scalar> m_runoff;
 
+  //! number of grid points processed at once by PDDMassBalance::update(); zero if
+  //! grid points are processed one at a time
+  unsigned int m_batch_size;
+
   bool m_sd_use_param, m_sd_file_set;
   double m_sd_param_a, m_sd_param_b;
 };
@@ -29,6 +29,7 @@
 #include "pism/util/Grid.hh"
 #include "pism/util/Context.hh"
 #include "pism/util/VariableMetadata.hh"
+#include "pism/util/error_handling.hh"
 
 namespace pism {
 namespace surface {
@@ -52,7 +53,8 @@ std::string LocalMassBalance::method() const {
 }
 
 PDDMassBalance::PDDMassBalance(Config::ConstPtr config, units::System::Ptr system)
-  : LocalMassBalance(config, system) {
+  : LocalMassBalance(config, system),
+    m_integrand(config->get_number("surface.pdd.calov_greve_max_error")) {
   precip_as_snow     = m_config->get_flag("surface.pdd.interpret_precip_as_snow");
   Tmin               = m_config->get_number("surface.pdd.air_temp_all_precip_as_snow");
   Tmax               = m_config->get_number("surface.pdd.air_temp_all_precip_as_rain");
@@ -91,7 +93,7 @@ This integral is used for the expected number of positive degree days. The user
 length `dt` instead of a whole year as stated in \ref CalovGreve05 . If `sigma` is zero,
 return the positive part of `TacC`.
  */
-static double CalovGreveIntegrand(double sigma, double TacC) {
+double CalovGreveIntegrand::exact(double sigma, double TacC) {
 
   if (sigma == 0) {
     return std::max(TacC, 0.0);
@@ -101,6 +103,97 @@ static double CalovGreveIntegrand(double sigma, double TacC) {
   return (sigma / sqrt(2.0 * M_PI)) * exp(-Z*Z) + (TacC / 2.0) * erfc(-Z);
 }
 
+/*!
+ * Set up the table approximating the integrand with the error of at most `sigma *
+ * max_error`. Use `max_error == 0` to evaluate the integrand exactly.
+ */
+CalovGreveIntegrand::CalovGreveIntegrand(double max_error)
+  : m_max_error(max_error), m_L(0.0), m_dx(0.0), m_dx_inv(0.0) {
+
+  if (max_error == 0.0) {
+    return;
+  }
+
+  // the table size is proportional to max_error^(-1/4); smaller errors are dominated by
+  // rounding
+  if (not (max_error >= 1e-12)) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid maximum error of the Calov-Greve integrand: %e"
+                                  " (it has to be zero or at least 1e-12)",
+                                  max_error);
+  }
+
+  // PDF and CDF of the standard normal distribution
+  auto phi = [](double x) { return exp(-0.5 * x * x) / sqrt(2.0 * M_PI); };
+  auto Phi = [](double x) { return 0.5 * erfc(-x / sqrt(2.0)); };
+
+  // error outside [-L, L]
+  m_L = 1.0;
+  while (phi(m_L) / (1.0 + m_L * m_L) > 0.5 * max_error) {
+    m_L += 0.25;
+  }
+
+  // interpolation error
+  const unsigned int n_intervals =
+    static_cast<unsigned int>(ceil(2.0 * m_L / pow(192.0 * max_error / phi(0.0), 0.25)));
+
+  m_dx     = 2.0 * m_L / n_intervals;
+  m_dx_inv = 1.0 / m_dx;
+
+  m_coefficients.resize(4 * n_intervals);
+  for (unsigned int k = 0; k < n_intervals; ++k) {
+    const double
+      x0 = -m_L + k * m_dx,
+      x1 = -m_L + (k + 1) * m_dx,
+      g0 = exact(1.0, x0),
+      g1 = exact(1.0, x1),
+      // derivatives with respect to the normalized coordinate t = (x - x0) / dx
+      d0 = Phi(x0) * m_dx,
+      d1 = Phi(x1) * m_dx;
+
+    // cubic Hermite interpolant in the monomial basis
+    double *c = &m_coefficients[4 * k];
+    c[0] = g0;
+    c[1] = d0;
+    c[2] = 3.0 * (g1 - g0) - 2.0 * d0 - d1;
+    c[3] = 2.0 * (g0 - g1) + d0 + d1;
+  }
+}
+
+/*!
+ * Set `result[k] = scale * I(sigma[k], T[k] - T_threshold)` for `k = 0, ..., n - 1`.
+ */
+void CalovGreveIntegrand::evaluate(unsigned int n, const double *sigma, const double *T,
+                                   double T_threshold, double scale, double *result) const {
+  if (m_max_error > 0.0) {
+    for (unsigned int k = 0; k < n; ++k) {
+      result[k] = scale * approximate(sigma[k], T[k] - T_threshold);
+    }
+  } else {
+    for (unsigned int k = 0; k < n; ++k) {
+      result[k] = scale * exact(sigma[k], T[k] - T_threshold);
+    }
+  }
+}
+
+//! Upper bound of the approximation error, relative to the standard deviation.
+double CalovGreveIntegrand::max_error() const {
+  return m_max_error;
+}
+
+//! Number of intervals in the table (zero if the integrand is evaluated exactly).
+unsigned int CalovGreveIntegrand::table_size() const {
+  return static_cast<unsigned int>(m_coefficients.size() / 4);
+}
+
+PDDBatch::PDDBatch(unsigned int n, unsigned int c)
+  : N(n), capacity(c), size(0),
+    T(n * c), S(n * c), P(n * c), PDDs(n * c),
+    ddf_snow(c), ddf_ice(c), refreeze_fraction(c),
+    ice(c), firn(c), snow(c),
+    accumulation(c), melt(c), runoff(c), smb(c) {
+  // empty
+}
 
 //! Compute the expected number of positive degree days from the input temperature time-series.
 /**
@@ -123,11 +216,33 @@ void PDDMassBalance::get_PDDs(double dt_series,
   const size_t N = S.size();
 
   for (unsigned int k = 0; k < N; ++k) {
-    PDDs[k] = h_days * CalovGreveIntegrand(S[k], T[k] - pdd_threshold_temp);
+    PDDs[k] = h_days * m_integrand(S[k], T[k] - pdd_threshold_temp);
   }
 }
 
 
+//! Solid (snow) accumulation rate corresponding to the air temperature `T` and the
+//! precipitation rate `P`. See PDDMassBalance::get_snow_accumulation().
+static inline double snow_accumulation(bool precip_as_snow, double Tmin, double Tmax,
+                                       double T, double P) {
+  // do not allow negative precipitation
+  if (P < 0.0) {
+    return 0.0;
+  }
+
+  // Following \ref Hock2005b we employ a linear transition from Tmin to Tmax
+  if (precip_as_snow || T <= Tmin) { // T <= Tmin, all precip is snow
+    return P;
+  }
+
+  if (T < Tmax) { // linear transition from Tmin to Tmax
+    return P * ((Tmax - T) / (Tmax - Tmin));
+  }
+
+  // T >= Tmax, all precip is rain -- ignore it
+  return 0.0;
+}
+
 //! \brief Extract snow accumulation from mixed (snow and rain)
 //! precipitation using the temperature time-series.
 /** Uses the temperature time-series to determine whether the
@@ -150,57 +265,26 @@ void PDDMassBalance::get_snow_accumulation(const std::vector<double> &T,
   assert(T.size() == P.size());
   const size_t N = T.size();
 
-  // Following \ref Hock2005b we employ a linear transition from Tmin to Tmax
   for (unsigned int i = 0; i < N; i++) {
-    // do not allow negative precipitation
-    if (P[i] < 0.0) {
-      P[i] = 0.0;
-      continue;
-    }
-
-    if (precip_as_snow || T[i] <= Tmin) { // T <= Tmin, all precip is snow
-      // no change
-    } else if (T[i] < Tmax) { // linear transition from Tmin to Tmax
-      P[i] *= (Tmax - T[i]) / (Tmax - Tmin);
-    } else { // T >= Tmax, all precip is rain -- ignore it
-      P[i] = 0.0;
-    }
+    P[i] = snow_accumulation(precip_as_snow, Tmin, Tmax, T[i], P[i]);
   }
-
 }
 
 
-//! \brief Compute the surface mass balance at a location from the number of positive
-//! degree days and the accumulation amount in a time interval.
-/*!
- * This is a PDD scheme. The input parameter `ddf.snow` is a rate of
- * melting per positive degree day for snow.
- *
- * `accumulation` has units "meter / second".
- *
- * - a fraction of the melted snow and ice refreezes, conceptualized
- *   as superimposed ice, and this is controlled by parameter \c
- *   ddf.refreeze_fraction
- *
- * - the excess number of PDDs is used to melt both the ice that came
- *   from refreeze and then any ice which is already present.
- *
- * Ice melts at a constant rate per positive degree day, controlled by
- * parameter `ddf.ice`.
- *
- * The scheme here came from EISMINT-Greenland [\ref RitzEISMINT], but
- * is influenced by R. Hock (personal communication).
- */
-PDDMassBalance::Changes PDDMassBalance::step(const DegreeDayFactors &ddf,
-                                             double PDDs,
-                                             double thickness,
-                                             double old_firn_depth,
-                                             double old_snow_depth,
-                                             double accumulation) {
+//! Implementation of PDDMassBalance::step(), shared with PDDMassBalance::update().
+static inline LocalMassBalance::Changes step_impl(bool refreeze_ice_melt,
+                                                  double ddf_snow,
+                                                  double ddf_ice,
+                                                  double refreeze_fraction,
+                                                  double PDDs,
+                                                  double thickness,
+                                                  double old_firn_depth,
+                                                  double old_snow_depth,
+                                                  double accumulation) {
   double
     firn_depth      = old_firn_depth,
     snow_depth      = old_snow_depth,
-    max_snow_melted = PDDs * ddf.snow,
+    max_snow_melted = PDDs * ddf_snow,
     firn_melted     = 0.0,
     snow_melted     = 0.0,
     excess_pdds     = 0.0;
@@ -246,19 +330,19 @@ PDDMassBalance::Changes PDDMassBalance::step(const DegreeDayFactors &ddf,
     // positive degree days available to melt ice.
     firn_melted = firn_depth;
     snow_melted = snow_depth;
-    excess_pdds = PDDs - ((firn_melted + snow_melted) / ddf.snow); // units: K day
+    excess_pdds = PDDs - ((firn_melted + snow_melted) / ddf_snow); // units: K day
   }
 
   double
-    ice_melted              = std::min(excess_pdds * ddf.ice, ice_thickness),
+    ice_melted              = std::min(excess_pdds * ddf_ice, ice_thickness),
     melt                    = snow_melted + firn_melted + ice_melted,
     ice_created_by_refreeze = 0.0;
 
   if (refreeze_ice_melt) {
-    ice_created_by_refreeze = melt * ddf.refreeze_fraction;
+    ice_created_by_refreeze = melt * refreeze_fraction;
   } else {
     // Should this only be snow melted?
-    ice_created_by_refreeze = (firn_melted + snow_melted) * ddf.refreeze_fraction;
+    ice_created_by_refreeze = (firn_melted + snow_melted) * refreeze_fraction;
   }
 
   const double runoff = melt - ice_created_by_refreeze;
@@ -273,7 +357,7 @@ PDDMassBalance::Changes PDDMassBalance::step(const DegreeDayFactors &ddf,
 
   const double smb = accumulation - runoff;
 
-  Changes result;
+  LocalMassBalance::Changes result;
   // Ensure that we never generate negative ice thicknesses. As far as I can tell the code
   // above guarantees that thickness + smb >= 0 *in exact arithmetic*. The check below
   // should make sure that we don't get bitten by rounding errors.
@@ -288,6 +372,109 @@ PDDMassBalance::Changes PDDMassBalance::step(const DegreeDayFactors &ddf,
   return result;
 }
 
+//! \brief Compute the surface mass balance at a location from the number of positive
+//! degree days and the accumulation amount in a time interval.
+/*!
+ * This is a PDD scheme. The input parameter `ddf.snow` is a rate of
+ * melting per positive degree day for snow.
+ *
+ * `accumulation` has units "meter / second".
+ *
+ * - a fraction of the melted snow and ice refreezes, conceptualized
+ *   as superimposed ice, and this is controlled by parameter \c
+ *   ddf.refreeze_fraction
+ *
+ * - the excess number of PDDs is used to melt both the ice that came
+ *   from refreeze and then any ice which is already present.
+ *
+ * Ice melts at a constant rate per positive degree day, controlled by
+ * parameter `ddf.ice`.
+ *
+ * The scheme here came from EISMINT-Greenland [\ref RitzEISMINT], but
+ * is influenced by R. Hock (personal communication).
+ */
+PDDMassBalance::Changes PDDMassBalance::step(const DegreeDayFactors &ddf,
+                                             double PDDs,
+                                             double thickness,
+                                             double old_firn_depth,
+                                             double old_snow_depth,
+                                             double accumulation) {
+  return step_impl(refreeze_ice_melt, ddf.snow, ddf.ice, ddf.refreeze_fraction, PDDs,
+                   thickness, old_firn_depth, old_snow_depth, accumulation);
+}
+
+/*!
+ * Run the PDD model at all locations in `batch`: compute PDDs, remove rain from
+ * precipitation and take `batch.N` steps of the model (see step()).
+ *
+ * `batch.P` has to contain the precipitation rate as ice-equivalent thickness per second;
+ * it is replaced by the snow accumulation rate.
+ *
+ * Given the same inputs, results are the same as those produced by calling
+ * get_PDDs(), get_snow_accumulation() and step() at each location.
+ *
+ * @param[in] dt_series length of the step for the time series, in seconds
+ * @param[in] reset_snow_depth flags (one per step) indicating that the snow depth should
+ *                             be set to zero at the beginning of the step
+ * @param[in,out] batch inputs, the model state and outputs
+ */
+void PDDMassBalance::update(double dt_series, const std::vector<bool> &reset_snow_depth,
+                            PDDBatch &batch) const {
+  assert(dt_series > 0.0);
+  assert(reset_snow_depth.size() == batch.N);
+
+  const unsigned int n = batch.size, B = batch.capacity;
+  const double h_days = dt_series / m_seconds_per_day;
+
+  for (unsigned int k = 0; k < batch.N; ++k) {
+    m_integrand.evaluate(n, &batch.S[k * B], &batch.T[k * B], pdd_threshold_temp, h_days,
+                         &batch.PDDs[k * B]);
+
+    const double *T = &batch.T[k * B];
+    double *P = &batch.P[k * B];
+    for (unsigned int p = 0; p < n; ++p) {
+      P[p] = snow_accumulation(precip_as_snow, Tmin, Tmax, T[p], P[p]);
+    }
+  }
+
+  for (unsigned int p = 0; p < n; ++p) {
+    batch.accumulation[p] = 0.0;
+    batch.melt[p]         = 0.0;
+    batch.runoff[p]       = 0.0;
+    batch.smb[p]          = 0.0;
+  }
+
+  for (unsigned int k = 0; k < batch.N; ++k) {
+    if (reset_snow_depth[k]) {
+      for (unsigned int p = 0; p < n; ++p) {
+        batch.snow[p] = 0.0;
+      }
+    }
+
+    const double *P = &batch.P[k * B], *PDDs = &batch.PDDs[k * B];
+    for (unsigned int p = 0; p < n; ++p) {
+      const double accumulation = P[p] * dt_series;
+
+      auto changes = step_impl(refreeze_ice_melt, batch.ddf_snow[p], batch.ddf_ice[p],
+                               batch.refreeze_fraction[p], PDDs[p], batch.ice[p],
+                               batch.firn[p], batch.snow[p], accumulation);
+
+      batch.ice[p]  += changes.smb;
+      batch.firn[p] += changes.firn_depth;
+      batch.snow[p] += changes.snow_depth;
+
+      batch.accumulation[p] += accumulation;
+      batch.melt[p]         += changes.melt;
+      batch.runoff[p]       += changes.runoff;
+      batch.smb[p]          += changes.smb;
+    }
+  }
+}
+
+const CalovGreveIntegrand &PDDMassBalance::integrand() const {
+  return m_integrand;
+}
+
 struct PDDrandMassBalance::Impl {
   gsl_rng *rng;
 };
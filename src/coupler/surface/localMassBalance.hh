@@ -19,12 +19,96 @@
 #ifndef __localMassBalance_hh
 #define __localMassBalance_hh
 
+#include <algorithm>            // std::max, std::min
+#include <vector>
+
 #include "pism/util/array/Scalar.hh"  // only needed for FaustoGrevePDDObject
 #include "pism/util/ConfigInterface.hh" // needed to get Config::ConstPtr
 
 namespace pism {
 namespace surface {
 
+//! The integrand in the expected number of positive degree days [\ref CalovGreve05].
+/*!
+ * Evaluates
+ *
+ * \f[ I(\sigma, T) = \frac{\sigma}{\sqrt{2\pi}}\,\exp\left(-\frac{T^2}{2\sigma^2}\right)
+ *       + \frac{T}{2}\,\mathrm{erfc}\left(-\frac{T}{\sqrt{2}\,\sigma}\right)
+ *     = \sigma\, g(T / \sigma), \quad g(x) = \phi(x) + x\,\Phi(x), \f]
+ *
+ * where \f$\phi\f$ and \f$\Phi\f$ are the PDF and the CDF of the standard normal
+ * distribution.
+ *
+ * If `max_error` is positive, \f$g\f$ is approximated using piecewise cubic Hermite
+ * interpolation of tabulated values of \f$g\f$ and \f$g' = \Phi\f$ on
+ * \f$[-L, L]\f$; outside of this interval \f$g(x) \approx \max(x, 0)\f$. The spacing
+ * of the table and \f$L\f$ are chosen so that
+ *
+ * \f[ |\tilde I(\sigma, T) - I(\sigma, T)| \le \sigma \cdot \mathtt{max\_error} \f]
+ *
+ * (up to rounding errors): the interpolation error is at most \f$h^4 \max|g^{(4)}| / 384\f$
+ * with \f$\max|g^{(4)}| = \max|\phi''| = \phi(0)\f$, and the error outside of
+ * \f$[-L, L]\f$ is at most \f$\phi(L) / (1 + L^2)\f$. Each of these is at most
+ * `max_error / 2`.
+ *
+ * If `max_error` is zero, the integrand is evaluated using `exp()` and `erfc()`.
+ */
+class CalovGreveIntegrand {
+public:
+  CalovGreveIntegrand(double max_error);
+
+  double operator()(double sigma, double T) const;
+
+  void evaluate(unsigned int n, const double *sigma, const double *T, double T_threshold,
+                double scale, double *result) const;
+
+  double max_error() const;
+  unsigned int table_size() const;
+
+  static double exact(double sigma, double T);
+private:
+  double approximate(double sigma, double T) const;
+
+  double m_max_error;
+  //! the table covers [-m_L, m_L]
+  double m_L;
+  //! table spacing and its reciprocal
+  double m_dx, m_dx_inv;
+  //! coefficients of cubic polynomials (in powers of `(x - x_i) / dx`), 4 per interval
+  std::vector<double> m_coefficients;
+};
+
+inline double CalovGreveIntegrand::approximate(double sigma, double T) const {
+  if (not (sigma > 0.0)) {
+    return std::max(T, 0.0);
+  }
+
+  const double x = T / sigma;
+  if (x <= -m_L) {
+    return 0.0;
+  }
+  if (x >= m_L) {
+    return T;
+  }
+
+  const double s = (x + m_L) * m_dx_inv;
+  // guard against rounding: x < m_L, but s could be equal to the number of intervals
+  const unsigned int
+    n_intervals = static_cast<unsigned int>(m_coefficients.size() / 4),
+    k           = std::min(static_cast<unsigned int>(s), n_intervals - 1);
+
+  const double
+    t  = s - k,
+    *c = &m_coefficients[4 * k];
+
+  return sigma * (c[0] + t * (c[1] + t * (c[2] + t * c[3])));
+}
+
+//! Evaluate the integrand at a single point. Uses the table if `max_error() > 0`.
+inline double CalovGreveIntegrand::operator()(double sigma, double T) const {
+  return m_max_error > 0.0 ? approximate(sigma, T) : exact(sigma, T);
+}
+
 //! \brief Base class for a model which computes surface mass flux rate (ice
 //! thickness per time) from precipitation and temperature.
 /*!
@@ -122,6 +206,42 @@ protected:
 };
 
 
+//! Inputs, state and outputs of the PDD model at a block of locations.
+/*!
+ * Time series are stored as "structures of arrays": values at the same time are adjacent,
+ * i.e. `T[k * capacity + p]` is the air temperature at the time `k` and the location
+ * `p`. This way PDDMassBalance::update() processes all locations at a given time in tight
+ * loops.
+ *
+ * Only the first `size` locations are used.
+ */
+struct PDDBatch {
+  PDDBatch(unsigned int N, unsigned int capacity);
+
+  //! number of points in time series
+  unsigned int N;
+  //! maximum number of locations
+  unsigned int capacity;
+  //! number of locations in use
+  unsigned int size;
+
+  //! inputs: air temperature [kelvin], its standard deviation [kelvin] and precipitation
+  //! rate [m second-1, ice equivalent]; all have `N * capacity` elements
+  std::vector<double> T, S, P;
+  //! expected number of positive degree days in each sub-interval [K day]
+  std::vector<double> PDDs;
+
+  //! degree day factors at each location
+  std::vector<double> ddf_snow, ddf_ice, refreeze_fraction;
+
+  //! model state (input and output): ice thickness, firn depth and snow depth [meters]
+  std::vector<double> ice, firn, snow;
+
+  //! outputs: total accumulation, melt, runoff and surface mass balance [meters, ice
+  //! equivalent]
+  std::vector<double> accumulation, melt, runoff, smb;
+};
+
 //! A PDD implementation which computes the local mass balance based on an expectation integral.
 /*!
   The expected number of positive degree days is computed by an integral in \ref CalovGreve05.
@@ -150,7 +270,13 @@ public:
                double snow_depth,
                double accumulation);
 
+  void update(double dt_series, const std::vector<bool> &reset_snow_depth,
+              PDDBatch &batch) const;
+
+  const CalovGreveIntegrand &integrand() const;
 protected:
+  //! the integrand in the expected number of positive degree days
+  CalovGreveIntegrand m_integrand;
   //! interpret all the precipitation as snow (no rain)
   bool precip_as_snow;
   //! refreeze melted ice
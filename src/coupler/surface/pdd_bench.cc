@@ -0,0 +1,322 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "\nPISM_PDD_BENCH\n"
+  "  Compares the batched PDD model (PDDMassBalance::update()) to the scalar one\n"
+  "  (get_PDDs(), get_snow_accumulation() and step() at each location) using synthetic\n"
+  "  inputs: checks the accuracy of the tabulated Calov-Greve integrand and reports\n"
+  "  timing.\n"
+  "  With the integrand evaluated exactly (surface.pdd.calov_greve_max_error = 0)\n"
+  "  batched results are expected to match scalar ones exactly.\n\n";
+
+#include <petsc.h>
+
+#include <algorithm>            // std::max
+#include <cmath>
+#include <vector>
+
+#include "pism/coupler/surface/localMassBalance.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+
+namespace pism {
+namespace surface {
+
+//! Synthetic inputs and the model state at `n` locations.
+struct Inputs {
+  Inputs(unsigned int n, unsigned int N, const LocalMassBalance::DegreeDayFactors &factors)
+    : T(n, std::vector<double>(N)), S(n, std::vector<double>(N)),
+      P(n, std::vector<double>(N)), ice(n), firn(n), snow(n), ddf(factors) {
+
+    for (unsigned int p = 0; p < n; ++p) {
+      const double
+        s         = p / std::max(n - 1.0, 1.0),
+        T_mean    = 245.0 + 35.0 * s,          // kelvin
+        amplitude = 10.0 + 10.0 * (1.0 - s),   // kelvin
+        // every 10th location has no temperature variability
+        sigma     = (p % 10 == 0) ? 0.0 : 1.0 + 5.0 * s;
+
+      for (unsigned int k = 0; k < N; ++k) {
+        const double phase = 2.0 * M_PI * (k + 0.5) / N;
+        T[p][k] = T_mean - amplitude * cos(phase);
+        S[p][k] = sigma;
+        // 0.1 -- 1.1 meters per year, ice equivalent
+        P[p][k] = (0.1 + 1.0 * s) / (365.0 * 86400.0);
+      }
+
+      ice[p]  = 3000.0 * (1.0 - s);
+      firn[p] = 1.0 * s;
+      snow[p] = 0.1 * (1.0 - s);
+    }
+  }
+
+  std::vector<std::vector<double> > T, S, P;
+  std::vector<double> ice, firn, snow;
+  LocalMassBalance::DegreeDayFactors ddf;
+};
+
+//! Outputs at `n` locations.
+struct Outputs {
+  Outputs(unsigned int n, unsigned int N)
+    : PDDs(n, std::vector<double>(N)), smb(n), melt(n), firn(n), snow(n) {
+    // empty
+  }
+
+  std::vector<std::vector<double> > PDDs;
+  std::vector<double> smb, melt, firn, snow;
+};
+
+/*!
+ * Run the scalar implementation: process one location at a time.
+ */
+static void run_scalar(PDDMassBalance &model, double dt_series,
+                       const std::vector<bool> &reset_snow_depth, const Inputs &inputs,
+                       Outputs &result) {
+  const unsigned int N = reset_snow_depth.size();
+
+  std::vector<double> P(N);
+
+  for (unsigned int p = 0; p < inputs.ice.size(); ++p) {
+    P = inputs.P[p];
+
+    model.get_PDDs(dt_series, inputs.S[p], inputs.T[p], result.PDDs[p]);
+    model.get_snow_accumulation(inputs.T[p], P);
+
+    double
+      ice  = inputs.ice[p],
+      firn = inputs.firn[p],
+      snow = inputs.snow[p],
+      M    = 0.0,
+      SMB  = 0.0;
+
+    for (unsigned int k = 0; k < N; ++k) {
+      if (reset_snow_depth[k]) {
+        snow = 0.0;
+      }
+
+      auto changes = model.step(inputs.ddf, result.PDDs[p][k], ice, firn, snow,
+                                P[k] * dt_series);
+      ice  += changes.smb;
+      firn += changes.firn_depth;
+      snow += changes.snow_depth;
+      M    += changes.melt;
+      SMB  += changes.smb;
+    }
+
+    result.smb[p]  = SMB;
+    result.melt[p] = M;
+    result.firn[p] = firn;
+    result.snow[p] = snow;
+  }
+}
+
+/*!
+ * Run the batched implementation using blocks of `batch_size` locations.
+ */
+static void run_batched(const PDDMassBalance &model, double dt_series,
+                        const std::vector<bool> &reset_snow_depth, unsigned int batch_size,
+                        const Inputs &inputs, Outputs &result) {
+  const unsigned int
+    N = reset_snow_depth.size(),
+    n = inputs.ice.size(),
+    B = batch_size;
+
+  PDDBatch batch(N, B);
+
+  for (unsigned int start = 0; start < n; start += B) {
+    batch.size = std::min(B, n - start);
+
+    for (unsigned int p = 0; p < batch.size; ++p) {
+      const unsigned int q = start + p;
+      for (unsigned int k = 0; k < N; ++k) {
+        batch.T[k * B + p] = inputs.T[q][k];
+        batch.S[k * B + p] = inputs.S[q][k];
+        batch.P[k * B + p] = inputs.P[q][k];
+      }
+      batch.ddf_snow[p]          = inputs.ddf.snow;
+      batch.ddf_ice[p]           = inputs.ddf.ice;
+      batch.refreeze_fraction[p] = inputs.ddf.refreeze_fraction;
+      batch.ice[p]               = inputs.ice[q];
+      batch.firn[p]              = inputs.firn[q];
+      batch.snow[p]              = inputs.snow[q];
+    }
+
+    model.update(dt_series, reset_snow_depth, batch);
+
+    for (unsigned int p = 0; p < batch.size; ++p) {
+      const unsigned int q = start + p;
+      for (unsigned int k = 0; k < N; ++k) {
+        result.PDDs[q][k] = batch.PDDs[k * B + p];
+      }
+      result.smb[q]  = batch.smb[p];
+      result.melt[q] = batch.melt[p];
+      result.firn[q] = batch.firn[p];
+      result.snow[q] = batch.snow[p];
+    }
+  }
+}
+
+static double max_difference(const std::vector<double> &a, const std::vector<double> &b) {
+  double result = 0.0;
+  for (size_t k = 0; k < a.size(); ++k) {
+    result = std::max(result, std::abs(a[k] - b[k]));
+  }
+  return result;
+}
+
+} // end of namespace surface
+} // end of namespace pism
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+  using namespace pism::surface;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  try {
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_pdd_bench");
+    auto config = ctx->config();
+    auto log = ctx->log();
+    auto sys = ctx->unit_system();
+
+    std::string usage =
+      "  pism_pdd_bench [-n N] [-repeat R] [-surface.pdd.batch_size B]\n"
+      "                 [-surface.pdd.calov_greve_max_error E]\n"
+      "where\n"
+      "  -n             number of locations (default: 10000)\n"
+      "  -repeat        number of repetitions used for timing (default: 10)\n";
+
+    bool stop = show_usage_check_req_opts(*log, "pism_pdd_bench", {}, usage);
+    if (stop) {
+      return 0;
+    }
+
+    options::Integer
+      n("-n", "number of locations", 10000),
+      repeat("-repeat", "number of repetitions", 10);
+
+    const auto batch_size = static_cast<unsigned int>(config->get_number("surface.pdd.batch_size"));
+    const double max_error = config->get_number("surface.pdd.calov_greve_max_error");
+
+    if (n < 1 or repeat < 1 or batch_size < 1) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "-n, -repeat and surface.pdd.batch_size have to be positive");
+    }
+
+    // the scalar implementation evaluates the integrand exactly
+    config->set_number("surface.pdd.calov_greve_max_error", 0.0);
+    PDDMassBalance scalar(config, sys);
+    config->set_number("surface.pdd.calov_greve_max_error", max_error);
+    PDDMassBalance batched(config, sys);
+
+    // one year
+    const double dt = 365.0 * 86400.0;
+    const unsigned int N = scalar.get_timeseries_length(dt);
+    const double dt_series = dt / N, h_days = dt_series / 86400.0;
+
+    // reset snow depth half-way through the year
+    std::vector<bool> reset_snow_depth(N, false);
+    reset_snow_depth[N / 2] = true;
+
+    LocalMassBalance::DegreeDayFactors ddf;
+    ddf.snow              = config->get_number("surface.pdd.factor_snow");
+    ddf.ice               = config->get_number("surface.pdd.factor_ice");
+    ddf.refreeze_fraction = config->get_number("surface.pdd.refreeze");
+
+    Inputs inputs(n, N, ddf);
+    Outputs result_scalar(n, N), result_batched(n, N);
+
+    double T_scalar = 0.0, T_batched = 0.0;
+    for (int r = 0; r < repeat; ++r) {
+      double T0 = MPI_Wtime();
+      run_scalar(scalar, dt_series, reset_snow_depth, inputs, result_scalar);
+      double T1 = MPI_Wtime();
+      run_batched(batched, dt_series, reset_snow_depth, batch_size, inputs, result_batched);
+      double T2 = MPI_Wtime();
+
+      T_scalar  += T1 - T0;
+      T_batched += T2 - T1;
+    }
+
+    // Check the error bound: |PDD_batched - PDD_scalar| <= h_days * sigma * max_error, up
+    // to rounding errors.
+    double max_PDD_error = 0.0, max_relative_PDD_error = 0.0;
+    bool success = true;
+    for (int p = 0; p < n; ++p) {
+      for (unsigned int k = 0; k < N; ++k) {
+        const double
+          exact = result_scalar.PDDs[p][k],
+          error = std::abs(result_batched.PDDs[p][k] - exact),
+          scale = h_days * inputs.S[p][k],
+          bound = scale * max_error + 16.0 * 2.2e-16 * std::max(std::abs(exact), scale);
+
+        max_PDD_error = std::max(max_PDD_error, error);
+        if (scale > 0.0) {
+          max_relative_PDD_error = std::max(max_relative_PDD_error, error / scale);
+        }
+
+        success = success and error <= bound;
+      }
+    }
+
+    const double
+      smb_diff  = max_difference(result_scalar.smb, result_batched.smb),
+      melt_diff = max_difference(result_scalar.melt, result_batched.melt),
+      firn_diff = max_difference(result_scalar.firn, result_batched.firn),
+      snow_diff = max_difference(result_scalar.snow, result_batched.snow);
+
+    if (max_error == 0.0) {
+      // batched results should be identical to scalar ones
+      success = success and max_PDD_error == 0.0 and smb_diff == 0.0 and melt_diff == 0.0 and
+        firn_diff == 0.0 and snow_diff == 0.0;
+    }
+
+    log->message(1,
+                 "%d locations, %d steps, batch size %d, Calov-Greve table: %d intervals\n",
+                 (int)n, (int)N, (int)batch_size, (int)batched.integrand().table_size());
+    log->message(1, "time (ms): scalar %.3f, batched %.3f, ratio %.2f\n",
+                 T_scalar * 1e3, T_batched * 1e3, T_scalar / std::max(T_batched, 1e-16));
+    log->message(1,
+                 "max. PDD error: %.3e K day (%.3e * h * sigma; bound: %.3e * h * sigma)\n",
+                 max_PDD_error, max_relative_PDD_error, max_error);
+    log->message(1,
+                 "max. differences (m, ice equivalent): SMB %.3e, melt %.3e,"
+                 " firn depth %.3e, snow depth %.3e\n",
+                 smb_diff, melt_diff, firn_diff, snow_diff);
+    log->message(1, "%s\n", success ? "OK" : "FAIL");
+
+    if (not success) {
+      log->message(1, "Batched and scalar PDD implementations do not agree.\n");
+      return 1;
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/fftw_utilities.hh"
 #include "pism/earth/LingleClarkSerial.hh"
+#include "pism/earth/LingleClarkParallel.hh"
 #include "pism/util/Context.hh"
 #include <memory>
 
@@ -44,7 +45,11 @@ LingleClark::LingleClark(std::shared_ptr<const Grid> grid)
           "total (viscous and elastic) displacement in the Lingle-Clark bed deformation model")
       .units("meters");
 
-  m_work0 = m_total_displacement.allocate_proc0_copy();
+  bool parallel = m_config->get_flag("bed_deformation.lc.parallel");
+
+  if (not parallel) {
+    m_work0 = m_total_displacement.allocate_proc0_copy();
+  }
 
   m_relief.metadata(0)
       .long_name("bed relief relative to the modeled bed displacement")
@@ -56,7 +61,6 @@ LingleClark::LingleClark(std::shared_ptr<const Grid> grid)
       .long_name(
           "elastic part of the displacement in the Lingle-Clark bed deformation model; see :cite:`BLKfastearth`")
       .units("meters");
-  m_elastic_displacement0 = m_elastic_displacement.allocate_proc0_copy();
 
   const int
     Mx = m_grid->Mx(),
@@ -86,6 +90,13 @@ LingleClark::LingleClark(std::shared_ptr<const Grid> grid)
   // do not point to auxiliary coordinates "lon" and "lat".
   m_viscous_displacement->metadata()["coordinates"] = "";
 
+  if (parallel) {
+    m_parallel_model.reset(new LingleClarkParallel(m_grid, m_extended_grid,
+                                                   use_elastic_model));
+    return;
+  }
+
+  m_elastic_displacement0 = m_elastic_displacement.allocate_proc0_copy();
   m_viscous_displacement0 = m_viscous_displacement->allocate_proc0_copy();
 
   ParallelSection rank0(m_grid->com);
@@ -121,6 +132,21 @@ void LingleClark::bootstrap_impl(const array::Scalar &bed_elevation,
                                  const array::Scalar &ice_thickness,
                                  const array::Scalar &sea_level_elevation) {
 
+  if (m_parallel_model) {
+    m_load.set(0.0);
+    accumulate_load(bed_elevation, ice_thickness, sea_level_elevation, 1.0, m_load);
+
+    m_parallel_model->bootstrap(m_load, bed_uplift);
+
+    m_viscous_displacement->copy_from(m_parallel_model->viscous_displacement());
+    m_elastic_displacement.copy_from(m_parallel_model->elastic_displacement());
+    m_total_displacement.copy_from(m_parallel_model->total_displacement());
+
+    // compute bed relief
+    m_topg.add(-1.0, m_total_displacement, m_relief);
+    return;
+  }
+
   auto load_proc0 = m_load.allocate_proc0_copy();
 
   auto &total_displacement = *m_work0;
@@ -174,6 +200,11 @@ void LingleClark::bootstrap_impl(const array::Scalar &bed_elevation,
 std::shared_ptr<array::Scalar> LingleClark::elastic_load_response_matrix() const {
   std::shared_ptr<array::Scalar> result(new array::Scalar(m_extended_grid, "lrm"));
 
+  if (m_parallel_model) {
+    m_parallel_model->load_response_matrix(*result);
+    return result;
+  }
+
   int
     Nx = m_extended_grid->Mx(),
     Ny = m_extended_grid->My();
@@ -229,9 +260,13 @@ void LingleClark::init_impl(const InputOptions &opts, const array::Scalar &ice_t
   regrid("Lingle-Clark bed deformation model",
          m_elastic_displacement, REGRID_WITHOUT_REGRID_VARS);
 
-  // Now that viscous displacement and elastic displacement are finally initialized,
-  // put them on rank 0 and initialize the serial model itself.
-  {
+  if (m_parallel_model) {
+    m_parallel_model->init(*m_viscous_displacement, m_elastic_displacement);
+
+    m_total_displacement.copy_from(m_parallel_model->total_displacement());
+  } else {
+    // Now that viscous displacement and elastic displacement are finally initialized,
+    // put them on rank 0 and initialize the serial model itself.
     m_viscous_displacement->put_on_proc0(*m_viscous_displacement0);
     m_elastic_displacement.put_on_proc0(*m_work0);
 
@@ -249,9 +284,9 @@ void LingleClark::init_impl(const InputOptions &opts, const array::Scalar &ice_t
       rank0.failed();
     }
     rank0.check();
-  }
 
-  m_total_displacement.get_from_proc0(*m_work0);
+    m_total_displacement.get_from_proc0(*m_work0);
+  }
 
   // compute bed relief
   m_topg.add(-1.0, m_total_displacement, m_relief);
@@ -279,6 +314,18 @@ const array::Scalar& LingleClark::relief() const {
 void LingleClark::step(const array::Scalar &load_thickness,
                        double dt) {
 
+  if (m_parallel_model) {
+    m_parallel_model->step(dt, load_thickness);
+
+    m_viscous_displacement->copy_from(m_parallel_model->viscous_displacement());
+    m_elastic_displacement.copy_from(m_parallel_model->elastic_displacement());
+    m_total_displacement.copy_from(m_parallel_model->total_displacement());
+
+    // Update bed elevation using bed displacement and relief.
+    m_total_displacement.add(1.0, m_relief, m_topg);
+    return;
+  }
+
   load_thickness.put_on_proc0(*m_work0);
 
   ParallelSection rank0(m_grid->com);
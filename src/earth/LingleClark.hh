@@ -28,8 +28,9 @@ namespace pism {
 namespace bed {
 
 class LingleClarkSerial;
+class LingleClarkParallel;
 
-//! A wrapper class around LingleClarkSerial.
+//! A wrapper class around LingleClarkSerial and LingleClarkParallel.
 class LingleClark : public BedDef {
 public:
   LingleClark(std::shared_ptr<const Grid> g);
@@ -74,6 +75,10 @@ protected:
   //! Serial viscoelastic bed deformation model.
   std::unique_ptr<LingleClarkSerial> m_serial_model;
 
+  //! Distributed viscoelastic bed deformation model (used if
+  //! bed_deformation.lc.parallel is set).
+  std::unique_ptr<LingleClarkParallel> m_parallel_model;
+
   //! extended grid for the viscous plate displacement
   std::shared_ptr<Grid> m_extended_grid;
 
@@ -0,0 +1,498 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::copy, std::min, std::max
+#include <cmath>                // sqrt
+#include <gsl/gsl_math.h>       // M_PI
+
+#include "pism/earth/LingleClarkParallel.hh"
+
+#include "pism/earth/LoadResponseMatrixCache.hh"
+#include "pism/earth/greens.hh"
+#include "pism/earth/matlablike.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/DistributedFFT.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/fftw_utilities.hh" // fftfreq()
+#include "pism/util/pism_utilities.hh" // GlobalSum()
+
+namespace pism {
+namespace bed {
+
+/*!
+ * @param[in] grid PISM's grid
+ * @param[in] extended_grid extended grid used by the spectral method
+ * @param[in] include_elastic include elastic deformation component
+ */
+LingleClarkParallel::LingleClarkParallel(std::shared_ptr<const Grid> grid,
+                                         std::shared_ptr<const Grid> extended_grid,
+                                         bool include_elastic)
+  : m_grid(grid),
+    m_extended_grid(extended_grid),
+    m_Uv(extended_grid, "viscous_bed_displacement"),
+    m_Ue(grid, "elastic_bed_displacement"),
+    m_U(grid, "bed_displacement"),
+    m_t_infty(1e16),            // around 317 million years
+    m_log(grid->ctx()->log()) {
+
+  auto config = grid->ctx()->config();
+
+  m_include_elastic = include_elastic;
+
+  if (include_elastic) {
+    // See the comment in LingleClarkSerial's constructor.
+    if (config->get_number("bed_deformation.lc.grid_size_factor") < 2) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "bed_deformation.lc.elastic_model"
+                                    " requires bed_deformation.lc.grid_size_factor > 1");
+    }
+  }
+
+  // grid parameters
+  m_Mx = grid->Mx();
+  m_My = grid->My();
+  m_dx = grid->dx();
+  m_dy = grid->dy();
+  m_Nx = extended_grid->Mx();
+  m_Ny = extended_grid->My();
+
+  m_load_density   = config->get_number("constants.ice.density");
+  m_mantle_density = config->get_number("bed_deformation.mantle_density");
+  m_eta            = config->get_number("bed_deformation.mantle_viscosity");
+  m_D              = config->get_number("bed_deformation.lithosphere_flexural_rigidity");
+
+  m_standard_gravity = config->get_number("constants.standard_gravity");
+
+  m_cache_directory = config->get_string("bed_deformation.lc.lrm_cache_directory");
+
+  // derive more parameters
+  m_Lx = 0.5 * (m_Nx - 1.0) * m_dx;
+  m_Ly = 0.5 * (m_Ny - 1.0) * m_dy;
+
+  m_fft.reset(new DistributedFFT(grid->com, m_Nx, m_Ny));
+
+  m_center.reset(new FFTEmbedding(*grid, *m_fft, (m_Nx - m_Mx) / 2, (m_Ny - m_My) / 2));
+  m_corner.reset(new FFTEmbedding(*grid, *m_fft, 0, 0));
+  m_extended.reset(new FFTEmbedding(*extended_grid, *m_fft, 0, 0));
+  if (include_elastic) {
+    m_elastic.reset(new FFTEmbedding(*grid, *m_fft, m_Nx / 2, m_Ny / 2));
+  }
+
+  m_loadhat.resize(m_fft->spectrum_size());
+  m_lrm_hat.resize(m_fft->spectrum_size());
+
+  precompute_coefficients();
+}
+
+LingleClarkParallel::~LingleClarkParallel() {
+  // empty, but implemented here to be able to use forward declarations of DistributedFFT
+  // and FFTEmbedding in the header
+}
+
+const array::Scalar& LingleClarkParallel::total_displacement() const {
+  return m_U;
+}
+
+const array::Scalar& LingleClarkParallel::viscous_displacement() const {
+  return m_Uv;
+}
+
+const array::Scalar& LingleClarkParallel::elastic_displacement() const {
+  return m_Ue;
+}
+
+/*!
+ * Compute the load response matrix and put it in the physical space of `m_fft`.
+ *
+ * Each rank computes its own rows of the matrix, using the same symmetry as
+ * LingleClarkSerial::compute_load_response_matrix() to reduce the number of integrals
+ * that have to be evaluated. Resulting values are identical to the serial version.
+ *
+ * If the matrix is cached (see LoadResponseMatrixCache), each rank reads the rows it
+ * needs from the cache file instead.
+ */
+void LingleClarkParallel::compute_load_response_matrix() {
+
+  int Nx2 = m_Nx / 2;
+  int Ny2 = m_Ny / 2;
+
+  auto &LRM = *m_fft;
+
+  std::unique_ptr<LoadResponseMatrixCache> cache;
+  bool cache_hit = false;
+  if (not m_cache_directory.empty()) {
+    cache.reset(new LoadResponseMatrixCache(m_cache_directory, m_dx, m_dy, m_Nx, m_Ny));
+
+    // use the cache only if all ranks can read it
+    int miss = cache->open() ? 0 : 1;
+    cache_hit = GlobalSum(m_grid->com, miss) == 0;
+  }
+
+  greens_elastic G;
+  ge_data ge_data {m_dx, m_dy, 0, 0, &G};
+
+  for (int i = LRM.xs(); i < LRM.xs() + LRM.xm(); ++i) {
+    // "right" half mirrors the "left" half (see LingleClarkSerial)
+    int i_left = i <= Nx2 ? i : 2 * Nx2 - i;
+
+    for (int j = 0; j <= Ny2; ++j) {
+      if (cache_hit) {
+        LRM.space(i, j) = (*cache)(i_left, j);
+      } else {
+        ge_data.p = Nx2 - i_left;
+        ge_data.q = Ny2 - j;
+
+        LRM.space(i, j) = dblquad_cubature(ge_integrand,
+                                           -m_dx / 2, m_dx / 2,
+                                           -m_dy / 2, m_dy / 2,
+                                           1.0e-8, &ge_data);
+      }
+    }
+
+    // "bottom" half
+    for (int j = Ny2 + 1; j < m_Ny; ++j) {
+      LRM.space(i, j) = LRM.space(i, 2 * Ny2 - j);
+    }
+  }
+
+  if (cache_hit) {
+    m_log->message(2, "\n     load response matrix cache hit: %s\n",
+                   cache->filename().c_str());
+  } else if (cache) {
+    // Rows i <= Nx2 of all ranks together form the top left quarter of the matrix.
+    int
+      row_start = LRM.xs(),
+      row_count = std::max(std::min(LRM.xs() + LRM.xm(), Nx2 + 1) - row_start, 0);
+
+    std::vector<double> rows(row_count * (Ny2 + 1));
+    for (int i = row_start; i < row_start + row_count; ++i) {
+      for (int j = 0; j <= Ny2; ++j) {
+        rows[(i - row_start) * (Ny2 + 1) + j] = LRM.space(i, j).real();
+      }
+    }
+
+    bool saved = cache->save(m_grid->com, row_start, row_count, rows.data());
+
+    m_log->message(2, "\n     load response matrix cache miss: %s (%s)\n",
+                   cache->filename().c_str(), saved ? "saved" : "failed to save");
+  }
+}
+
+/*!
+ * Compute the load response matrix and put it in `result` (on the extended grid).
+ *
+ * This method is used for testing only.
+ */
+void LingleClarkParallel::load_response_matrix(array::Scalar &result) {
+  compute_load_response_matrix();
+  m_extended->get_real_part(*m_fft, 1.0, result);
+}
+
+/**
+ * Pre-compute coefficients used by the model.
+ */
+void LingleClarkParallel::precompute_coefficients() {
+
+  m_cx = fftfreq(m_Nx, m_Lx / (m_Nx * M_PI));
+  m_cy = fftfreq(m_Ny, m_Ly / (m_Ny * M_PI));
+
+  if (m_include_elastic) {
+    m_log->message(2, "     computing spherical elastic load response matrix ...");
+    {
+      compute_load_response_matrix();
+      // Compute fft2(LRM) and save it in m_lrm_hat
+      m_fft->forward();
+      std::copy(m_fft->spectrum(), m_fft->spectrum() + m_fft->spectrum_size(),
+                m_lrm_hat.begin());
+    }
+    m_log->message(2, " done\n");
+  }
+}
+
+/*!
+ * Solve the "uplift problem". See LingleClarkSerial::uplift_problem() for details.
+ *
+ * @param[in] load_thickness load thickness, meters
+ * @param[in] bed_uplift bed uplift, m/second
+ * @param[out] output viscous displacement on the extended grid
+ */
+void LingleClarkParallel::uplift_problem(const array::Scalar &load_thickness,
+                                         const array::Scalar &bed_uplift,
+                                         array::Scalar &output) {
+  auto &fft = *m_fft;
+
+  // Compute fft2(-load_density * g * load_thickness)
+  {
+    fft.clear_space();
+    m_center->set_real_part(load_thickness, - m_load_density * m_standard_gravity, fft);
+    fft.forward();
+    // Save fft2(-load_density * g * load_thickness) in loadhat.
+    std::copy(fft.spectrum(), fft.spectrum() + fft.spectrum_size(), m_loadhat.begin());
+  }
+
+  // fft2(uplift)
+  {
+    fft.clear_space();
+    m_center->set_real_part(bed_uplift, 1.0, fft);
+    fft.forward();
+  }
+
+  {
+    int k = 0;
+    for (int j = fft.ys(); j < fft.ys() + fft.ym(); j++) {
+      for (int i = 0; i < m_Nx; i++) {
+        const double
+          C = m_cx[i]*m_cx[i] + m_cy[j]*m_cy[j],
+          A = - 2.0 * m_eta * sqrt(C),
+          B = m_mantle_density * m_standard_gravity + m_D * C * C;
+
+        auto &uplift_hat = fft.spectrum(i, j);
+
+        uplift_hat = (m_loadhat[k] + A * uplift_hat) / B;
+        ++k;
+      }
+    }
+  }
+
+  fft.inverse();
+  m_extended->get_real_part(fft, 1.0 / (m_Nx * m_Ny), output);
+
+  tweak(load_thickness, output);
+}
+
+/*! Initialize using provided load thickness and the bed uplift rate.
+ *
+ * See LingleClarkSerial::bootstrap().
+ *
+ * @param[in] thickness load thickness, meters
+ * @param[in] uplift initial bed uplift on the PISM grid
+ *
+ * Sets m_Uv, m_Ue, m_U.
+ */
+void LingleClarkParallel::bootstrap(const array::Scalar &thickness,
+                                    const array::Scalar &uplift) {
+
+  // compute viscous displacement
+  uplift_problem(thickness, uplift, m_Uv);
+
+  if (m_include_elastic) {
+    compute_elastic_response(thickness, m_Ue);
+  } else {
+    m_Ue.set(0.0);
+  }
+
+  update_displacement(m_Uv, m_Ue, m_U);
+}
+
+/*!
+ * Initialize using provided plate displacement.
+ *
+ * @param[in] viscous_displacement initial viscous plate displacement (meters) on the extended grid
+ * @param[in] elastic_displacement initial viscous plate displacement (meters) on the regular grid
+ *
+ * Sets m_Uv, m_Ue, m_U.
+ */
+void LingleClarkParallel::init(const array::Scalar &viscous_displacement,
+                               const array::Scalar &elastic_displacement) {
+  m_Uv.copy_from(viscous_displacement);
+
+  if (m_include_elastic) {
+    m_Ue.copy_from(elastic_displacement);
+  } else {
+    m_Ue.set(0.0);
+  }
+
+  update_displacement(m_Uv, m_Ue, m_U);
+}
+
+/*!
+ * Perform a time step.
+ *
+ * See LingleClarkSerial::step() for details.
+ *
+ * @param[in] dt time step length
+ * @param[in] H load thickness on the physical (Mx*My) grid
+ */
+void LingleClarkParallel::step(double dt, const array::Scalar &H) {
+  auto &fft = *m_fft;
+
+  if (dt > 0.0) {
+    // Compute fft2(-load_density * g * dt * H)
+    {
+      fft.clear_space();
+      m_center->set_real_part(H, - m_load_density * m_standard_gravity * dt, fft);
+      fft.forward();
+
+      // Save fft2(-load_density * g * H * dt) in loadhat.
+      std::copy(fft.spectrum(), fft.spectrum() + fft.spectrum_size(), m_loadhat.begin());
+    }
+
+    // Compute fft2(u).
+    // no need to clear the physical space: all values are overwritten
+    {
+      m_extended->set_real_part(m_Uv, 1.0, fft);
+      fft.forward();
+    }
+
+    // frhs = right.*fft2(uun) + fft2(dt*sszz);
+    // uun1 = real(ifft2(frhs./left));
+    {
+      int k = 0;
+      for (int j = fft.ys(); j < fft.ys() + fft.ym(); j++) {
+        for (int i = 0; i < m_Nx; i++) {
+          const double
+            C     = m_cx[i]*m_cx[i] + m_cy[j]*m_cy[j],
+            part1 = 2.0 * m_eta * sqrt(C),
+            part2 = (dt / 2.0) * (m_mantle_density * m_standard_gravity + m_D * C * C),
+            A = part1 - part2,
+            B = part1 + part2;
+
+          auto &u_hat = fft.spectrum(i, j);
+
+          u_hat = (m_loadhat[k] + A * u_hat) / B;
+          ++k;
+        }
+      }
+    }
+
+    fft.inverse();
+    m_extended->get_real_part(fft, 1.0 / (m_Nx * m_Ny), m_Uv);
+
+    // Now tweak. (See the "correction" in section 5 of BuelerLingleBrown.)
+    tweak(H, m_Uv);
+  } else {
+    // zero time step: viscous displacement is zero
+    m_Uv.set(0.0);
+  }
+
+  // now compute elastic response if desired
+  if (m_include_elastic) {
+    compute_elastic_response(H, m_Ue);
+  }
+
+  update_displacement(m_Uv, m_Ue, m_U);
+}
+
+/*!
+ * Compute elastic response to the load H
+ *
+ * @param[in] H load thickness (ice equivalent meters)
+ * @param[out] dE elastic plate displacement
+ */
+void LingleClarkParallel::compute_elastic_response(const array::Scalar &H,
+                                                   array::Scalar &dE) {
+  auto &fft = *m_fft;
+
+  // Compute fft2(load_density * H)
+  //
+  // Note that here the load is placed in the corner of the array on the extended grid.
+  fft.clear_space();
+  m_corner->set_real_part(H, m_load_density, fft);
+  fft.forward();
+
+  // fft2(m_response_matrix) * fft2(load_density*H)
+  {
+    auto *load_hat = fft.spectrum();
+    for (int k = 0; k < fft.spectrum_size(); ++k) {
+      load_hat[k] *= m_lrm_hat[k];
+    }
+  }
+
+  // Compute the inverse transform and extract the elastic response (at offsets Nx/2 and
+  // Ny/2).
+  fft.inverse();
+  m_elastic->get_real_part(fft, 1.0 / (m_Nx * m_Ny), dE);
+}
+
+/*! Compute total displacement by combining viscous and elastic contributions.
+ *
+ * @param[in] Uv viscous displacement on the extended grid
+ * @param[in] Ue elastic displacement
+ * @param[out] U total displacement
+ */
+void LingleClarkParallel::update_displacement(const array::Scalar &Uv,
+                                              const array::Scalar &Ue,
+                                              array::Scalar &U) {
+  // Use the physical space of m_fft to extract the central part of the extended grid.
+  m_extended->set_real_part(Uv, 1.0, *m_fft);
+  m_center->get_real_part(*m_fft, 1.0, U);
+
+  U.add(1.0, Ue);
+}
+
+/*!
+ * Modify the plate displacement to correct for the effect of imposing periodic boundary conditions
+ * at a finite distance.
+ *
+ * See LingleClarkSerial::tweak() and Section 5 in [@ref BuelerLingleBrown].
+ *
+ * @param[in] load_thickness thickness of the load (used to compute the corresponding disc volume)
+ * @param[in,out] U viscous plate displacement on the extended grid
+ */
+void LingleClarkParallel::tweak(const array::Scalar &load_thickness, array::Scalar &U) {
+
+  // find average value along "distant" boundary of [-Lx, Lx]X[-Ly, Ly]
+  double average = 0.0;
+  {
+    array::AccessScope list{&U};
+
+    for (auto p = m_extended_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      // note: the corner (0, 0) is counted twice, same as in LingleClarkSerial
+      if (j == 0) {
+        average += U(i, j);
+      }
+      if (i == 0) {
+        average += U(i, j);
+      }
+    }
+    average = GlobalSum(m_grid->com, average);
+  }
+
+  average /= (double) (m_Nx + m_Ny);
+
+  double shift = 0.0;
+
+  {
+    const double L_average = (m_Lx + m_Ly) / 2.0;
+    const double R         = L_average * (2.0 / 3.0);
+
+    double H_sum = array::sum(load_thickness);
+
+    // compute disc thickness by dividing its volume by the area
+    const double H = (H_sum * m_dx * m_dy) / (M_PI * R * R);
+
+    shift = viscDisc(m_t_infty,                        // time in seconds
+                     H,                                // disc thickness
+                     R,                                // disc radius
+                     L_average,                        // compute deflection at this radius
+                     m_mantle_density, m_load_density, // mantle and load densities
+                     m_standard_gravity,               //
+                     m_D,                              // flexural rigidity
+                     m_eta);                           // mantle viscosity
+  }
+
+  U.shift(shift - average);
+}
+
+} // end of namespace bed
+} // end of namespace pism
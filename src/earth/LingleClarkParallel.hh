@@ -0,0 +1,151 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_LINGLECLARKPARALLEL_H
+#define PISM_LINGLECLARKPARALLEL_H
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/Logger.hh"
+
+namespace pism {
+
+class Grid;
+class DistributedFFT;
+class FFTEmbedding;
+
+namespace bed {
+
+//! Distributed implementation of the bed deformation model described in [@ref BLKfastearth].
+/*!
+ * This class implements the same method as LingleClarkSerial, but uses the domain
+ * decomposition of PISM's grid instead of gathering the load on rank 0. Fourier
+ * transforms on the extended grid are computed using DistributedFFT.
+ *
+ * Results match ones computed by LingleClarkSerial up to round-off.
+ */
+class LingleClarkParallel {
+public:
+  LingleClarkParallel(std::shared_ptr<const Grid> grid,
+                      std::shared_ptr<const Grid> extended_grid,
+                      bool include_elastic);
+  ~LingleClarkParallel();
+
+  void init(const array::Scalar &viscous_displacement,
+            const array::Scalar &elastic_displacement);
+
+  void bootstrap(const array::Scalar &thickness, const array::Scalar &uplift);
+
+  void step(double dt_seconds, const array::Scalar &H);
+
+  const array::Scalar &total_displacement() const;
+
+  const array::Scalar &viscous_displacement() const;
+
+  const array::Scalar &elastic_displacement() const;
+
+  void load_response_matrix(array::Scalar &result);
+private:
+  void compute_load_response_matrix();
+
+  void compute_elastic_response(const array::Scalar &H, array::Scalar &dE);
+
+  void uplift_problem(const array::Scalar &load_thickness, const array::Scalar &bed_uplift,
+                      array::Scalar &output);
+
+  void precompute_coefficients();
+
+  void update_displacement(const array::Scalar &Uv, const array::Scalar &Ue,
+                           array::Scalar &U);
+
+  void tweak(const array::Scalar &load_thickness, array::Scalar &U);
+
+  std::shared_ptr<const Grid> m_grid;
+  std::shared_ptr<const Grid> m_extended_grid;
+
+  bool m_include_elastic;
+  // grid size
+  int m_Mx;
+  int m_My;
+  // grid spacing
+  double m_dx;
+  double m_dy;
+  //! load density (for computing load from its thickness)
+  double m_load_density;
+  //! mantle density
+  double m_mantle_density;
+  //! mantle viscosity
+  double m_eta;
+  //! lithosphere flexural rigidity
+  double m_D;
+
+  // acceleration due to gravity
+  double m_standard_gravity;
+
+  //! directory used to cache the load response matrix (empty: do not cache)
+  std::string m_cache_directory;
+
+  // size of the extended grid
+  int m_Nx;
+  int m_Ny;
+
+  // half-lengths of the extended (FFT, spectral) computational domain
+  double m_Lx;
+  double m_Ly;
+
+  // Coefficients of derivatives in Fourier space
+  std::vector<double> m_cx, m_cy;
+
+  // viscous displacement on the extended grid
+  array::Scalar m_Uv;
+
+  // elastic plate displacement
+  array::Scalar m_Ue;
+
+  // total (viscous and elastic) plate displacement
+  array::Scalar m_U;
+
+  std::unique_ptr<DistributedFFT> m_fft;
+
+  //! the physical grid in the center of the extended grid
+  std::unique_ptr<FFTEmbedding> m_center;
+  //! the physical grid in the corner of the extended grid
+  std::unique_ptr<FFTEmbedding> m_corner;
+  //! the physical grid at offsets (Nx/2, Ny/2) (used to extract the elastic response)
+  std::unique_ptr<FFTEmbedding> m_elastic;
+  //! the extended grid itself
+  std::unique_ptr<FFTEmbedding> m_extended;
+
+  // Fourier space data owned by this rank (see DistributedFFT)
+  std::vector<std::complex<double> > m_loadhat;
+  std::vector<std::complex<double> > m_lrm_hat;
+
+  const double m_t_infty;
+
+  Logger::ConstPtr m_log;
+};
+
+} // end of namespace bed
+} // end of namespace pism
+
+#endif /* PISM_LINGLECLARKPARALLEL_H */
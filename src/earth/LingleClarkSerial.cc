@@ -18,12 +18,14 @@
 
 #include <cassert>
 #include <cmath>                // sqrt
+#include <memory>               // std::unique_ptr
 #include <fftw3.h>
 #include <gsl/gsl_math.h>       // M_PI
 
 #include "pism/earth/matlablike.hh"
 #include "pism/earth/greens.hh"
 #include "pism/earth/LingleClarkSerial.hh"
+#include "pism/earth/LoadResponseMatrixCache.hh"
 
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/error_handling.hh"
@@ -82,6 +84,8 @@ LingleClarkSerial::LingleClarkSerial(Logger::ConstPtr log,
 
   m_standard_gravity = config.get_number("constants.standard_gravity");
 
+  m_cache_directory = config.get_string("bed_deformation.lc.lrm_cache_directory");
+
   // derive more parameters
   m_Lx        = 0.5 * (m_Nx - 1.0) * m_dx;
   m_Ly        = 0.5 * (m_Ny - 1.0) * m_dy;
@@ -159,25 +163,57 @@ void LingleClarkSerial::compute_load_response_matrix(fftw_complex *output) {
 
   FFTWArray LRM(output, m_Nx, m_Ny);
 
-  greens_elastic G;
-  ge_data ge_data {m_dx, m_dy, 0, 0, &G};
-
   int Nx2 = m_Nx / 2;
   int Ny2 = m_Ny / 2;
 
-  // Top half
-  for (int j = 0; j <= Ny2; ++j) {
-    // Top left quarter
+  std::unique_ptr<LoadResponseMatrixCache> cache;
+  if (not m_cache_directory.empty()) {
+    cache.reset(new LoadResponseMatrixCache(m_cache_directory, m_dx, m_dy, m_Nx, m_Ny));
+  }
+
+  // Top left quarter
+  if (cache and cache->open()) {
+    m_log->message(2, "\n     load response matrix cache hit: %s\n",
+                   cache->filename().c_str());
+
     for (int i = 0; i <= Nx2; ++i) {
-      ge_data.p = Nx2 - i;
-      ge_data.q = Ny2 - j;
+      for (int j = 0; j <= Ny2; ++j) {
+        LRM(i, j) = (*cache)(i, j);
+      }
+    }
+  } else {
+    greens_elastic G;
+    ge_data ge_data {m_dx, m_dy, 0, 0, &G};
+
+    for (int j = 0; j <= Ny2; ++j) {
+      for (int i = 0; i <= Nx2; ++i) {
+        ge_data.p = Nx2 - i;
+        ge_data.q = Ny2 - j;
+
+        LRM(i, j) = dblquad_cubature(ge_integrand,
+                                     -m_dx / 2, m_dx / 2,
+                                     -m_dy / 2, m_dy / 2,
+                                     1.0e-8, &ge_data);
+      }
+    }
+
+    if (cache) {
+      std::vector<double> rows((Nx2 + 1) * (Ny2 + 1));
+      for (int i = 0; i <= Nx2; ++i) {
+        for (int j = 0; j <= Ny2; ++j) {
+          rows[i * (Ny2 + 1) + j] = LRM(i, j).real();
+        }
+      }
 
-      LRM(i, j) = dblquad_cubature(ge_integrand,
-                                   -m_dx / 2, m_dx / 2,
-                                   -m_dy / 2, m_dy / 2,
-                                   1.0e-8, &ge_data);
+      bool saved = cache->save(MPI_COMM_SELF, 0, Nx2 + 1, rows.data());
+
+      m_log->message(2, "\n     load response matrix cache miss: %s (%s)\n",
+                     cache->filename().c_str(), saved ? "saved" : "failed to save");
     }
+  }
 
+  // Top half
+  for (int j = 0; j <= Ny2; ++j) {
     // Top right quarter
     //
     // Note: Nx2 = m_Nx / 2 (using integer division!), so
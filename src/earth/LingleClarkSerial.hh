@@ -19,6 +19,7 @@
 #ifndef LINGLECLARKSERIAL_H
 #define LINGLECLARKSERIAL_H
 
+#include <string>
 #include <vector>
 #include <fftw3.h>
 
@@ -103,6 +104,9 @@ private:
   // acceleration due to gravity
   double m_standard_gravity;
 
+  //! directory used to cache the load response matrix (empty: do not cache)
+  std::string m_cache_directory;
+
   // size of the extended grid
   int m_Nx;
   int m_Ny;
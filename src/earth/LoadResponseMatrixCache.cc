@@ -0,0 +1,243 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstdio>               // std::rename, std::remove
+#include <cstdlib>              // mkstemp
+#include <cstring>              // memcmp, memset, strncpy
+#include <vector>
+
+#include <fcntl.h>              // open
+#include <sys/mman.h>           // mmap, munmap
+#include <sys/stat.h>           // fstat, fchmod
+#include <unistd.h>             // close
+
+#include "pism/earth/LoadResponseMatrixCache.hh"
+#include "pism/earth/greens.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+namespace bed {
+
+// Increment this if the way the load response matrix is computed changes.
+static const double format_version = 1.0;
+
+// Relative tolerance used by dblquad_cubature() when computing the matrix.
+static const double tolerance = 1.0e-8;
+
+// Change this if the format of cache files changes.
+static const char magic[8] = "PISMLR2";
+
+LoadResponseMatrixCache::LoadResponseMatrixCache(const std::string &directory,
+                                                 double dx, double dy, int Nx, int Ny)
+  : m_dx(dx), m_dy(dy), m_Nx(Nx), m_Ny(Ny),
+    m_data(NULL), m_size(0), m_values(NULL) {
+
+  // everything the load response matrix depends on
+  m_description = {format_version, tolerance, dx, dy, (double)Nx, (double)Ny};
+  {
+    auto G = greens_elastic::parameters();
+    m_description.insert(m_description.end(), G.begin(), G.end());
+  }
+
+  static_assert(sizeof(double) == 2 * sizeof(uint32_t),
+                "LoadResponseMatrixCache requires sizeof(double) == 2 * sizeof(uint32_t)");
+  m_key = fletcher64((const uint32_t*)m_description.data(), m_description.size() * 2);
+
+  m_filename = pism::printf("%s/pism_lc_lrm_%016llx.bin",
+                            directory.c_str(), (unsigned long long)m_key);
+}
+
+LoadResponseMatrixCache::~LoadResponseMatrixCache() {
+  if (m_data != NULL) {
+    munmap(m_data, m_size);
+  }
+}
+
+const std::string& LoadResponseMatrixCache::filename() const {
+  return m_filename;
+}
+
+LoadResponseMatrixCache::Header LoadResponseMatrixCache::header() const {
+  Header result;
+  memset(&result, 0, sizeof(Header));
+
+  memcpy(result.magic, magic, sizeof(magic));
+  result.key      = m_key;
+  result.key_size = m_description.size();
+  result.dx       = m_dx;
+  result.dy       = m_dy;
+  result.Nx       = m_Nx;
+  result.Ny       = m_Ny;
+
+  return result;
+}
+
+//! Offset of the matrix in a cache file, in bytes.
+size_t LoadResponseMatrixCache::data_offset() const {
+  return sizeof(Header) + sizeof(double) * m_description.size();
+}
+
+//! Expected size of a cache file, in bytes.
+size_t LoadResponseMatrixCache::file_size() const {
+  return data_offset() + sizeof(double) * (m_Nx / 2 + 1) * (m_Ny / 2 + 1);
+}
+
+/*!
+ * Memory-map the cache file.
+ *
+ * Returns `true` on success ("cache hit") and `false` if the file does not exist or does
+ * not match the current grid and the Green's function ("cache miss").
+ *
+ * Not collective: the caller is responsible for making sure that all ranks agree.
+ */
+bool LoadResponseMatrixCache::open() {
+  if (m_data != NULL) {
+    return true;
+  }
+
+  int fd = ::open(m_filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat file_info;
+  if (fstat(fd, &file_info) != 0 or (size_t)file_info.st_size != file_size()) {
+    close(fd);
+    return false;
+  }
+
+  void *data = mmap(NULL, file_size(), PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping remains valid after the file descriptor is closed
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  // compare full descriptions of the matrix: keys are checksums and may collide
+  Header expected = header();
+  if (memcmp(data, &expected, sizeof(Header)) != 0 or
+      memcmp((const char*)data + sizeof(Header), m_description.data(),
+             sizeof(double) * m_description.size()) != 0) {
+    munmap(data, file_size());
+    return false;
+  }
+
+  m_data   = data;
+  m_size   = file_size();
+  m_values = (const double*)((const char*)data + data_offset());
+
+  return true;
+}
+
+/*!
+ * Save rows `row_start <= i < row_start + row_count` of the top left quarter of the load
+ * response matrix. Each row contains `Ny/2 + 1` values.
+ *
+ * Collective: taken together, ranks in `com` have to provide all `Nx/2 + 1` rows.
+ *
+ * Writes to a uniquely named temporary file and then renames it to make sure that a
+ * partially written file is never used and that concurrent runs writing the same matrix
+ * do not corrupt each other's files.
+ *
+ * Returns `true` on success. Failure to write the cache is not an error: the caller
+ * should report it and continue.
+ */
+bool LoadResponseMatrixCache::save(MPI_Comm com, int row_start, int row_count,
+                                   const double *rows) const {
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  // create a unique temporary file on rank 0 (in the cache directory, so that rename()
+  // below is atomic) and broadcast its name
+  std::vector<char> tmp_filename(m_filename.begin(), m_filename.end());
+  for (char c : std::string(".XXXXXX")) {
+    tmp_filename.push_back(c);
+  }
+  tmp_filename.push_back('\0');
+
+  int created = 0;
+  if (rank == 0) {
+    int fd = mkstemp(tmp_filename.data());
+    if (fd >= 0) {
+      // mkstemp() uses 0600; cached files should be readable by others sharing the cache
+      fchmod(fd, 0644);
+      close(fd);
+      created = 1;
+    }
+  }
+
+  MPI_Bcast(&created, 1, MPI_INT, 0, com);
+  if (not created) {
+    return false;
+  }
+  MPI_Bcast(tmp_filename.data(), (int)tmp_filename.size(), MPI_CHAR, 0, com);
+
+  MPI_File file;
+  int stat = MPI_File_open(com, tmp_filename.data(), MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
+  if (stat != MPI_SUCCESS) {
+    if (rank == 0) {
+      std::remove(tmp_filename.data());
+    }
+    return false;
+  }
+
+  int success = 1;
+
+  if (rank == 0) {
+    Header h = header();
+    stat = MPI_File_write_at(file, 0, &h, sizeof(Header), MPI_BYTE, MPI_STATUS_IGNORE);
+    success = success and (stat == MPI_SUCCESS);
+
+    stat = MPI_File_write_at(file, sizeof(Header), m_description.data(),
+                             (int)m_description.size(), MPI_DOUBLE, MPI_STATUS_IGNORE);
+    success = success and (stat == MPI_SUCCESS);
+  }
+
+  {
+    int row_length = m_Ny / 2 + 1;
+    MPI_Offset offset = data_offset() + sizeof(double) * (MPI_Offset)row_start * row_length;
+
+    stat = MPI_File_write_at_all(file, offset, rows, row_count * row_length, MPI_DOUBLE,
+                                 MPI_STATUS_IGNORE);
+    success = success and (stat == MPI_SUCCESS);
+  }
+
+  stat = MPI_File_close(&file);
+  success = success and (stat == MPI_SUCCESS);
+
+  MPI_Allreduce(MPI_IN_PLACE, &success, 1, MPI_INT, MPI_LAND, com);
+
+  if (rank == 0) {
+    if (success) {
+      success = (std::rename(tmp_filename.data(), m_filename.c_str()) == 0);
+    }
+
+    if (not success) {
+      std::remove(tmp_filename.data());
+    }
+  }
+
+  MPI_Bcast(&success, 1, MPI_INT, 0, com);
+
+  return success;
+}
+
+} // end of namespace bed
+} // end of namespace pism
@@ -0,0 +1,99 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_LOADRESPONSEMATRIXCACHE_H
+#define PISM_LOADRESPONSEMATRIXCACHE_H
+
+#include <cstddef>              // size_t
+#include <cstdint>              // uint64_t
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+namespace pism {
+namespace bed {
+
+/*!
+ * On-disk cache of the elastic load response matrix used by the Lingle-Clark model.
+ *
+ * Stores the top left quarter of the matrix, i.e. values for `0 <= i <= Nx/2` and
+ * `0 <= j <= Ny/2` (see LingleClarkSerial::compute_load_response_matrix()); the rest is
+ * obtained using symmetry.
+ *
+ * The file name contains a checksum of everything the matrix depends on: grid spacing,
+ * the size of the extended grid and the tabulated Green's function, so it is safe to use
+ * the same cache directory for different runs. Files store these parameters, too, and a
+ * cached matrix is used only if they match (checksums may collide).
+ *
+ * Cached files are memory-mapped: each rank reads only the part it needs.
+ */
+class LoadResponseMatrixCache {
+public:
+  LoadResponseMatrixCache(const std::string &directory,
+                          double dx, double dy, int Nx, int Ny);
+  ~LoadResponseMatrixCache();
+
+  const std::string& filename() const;
+
+  bool open();
+
+  //! Cached value at `(i, j)`. Requires a successful open().
+  inline double operator()(int i, int j) const {
+    return m_values[i * (m_Ny / 2 + 1) + j];
+  }
+
+  bool save(MPI_Comm com, int row_start, int row_count, const double *rows) const;
+private:
+  // A cache file contains the header, `key_size` numbers describing the matrix (see
+  // `m_description`) and the matrix itself.
+  struct Header {
+    char magic[8];
+    uint64_t key;
+    uint64_t key_size;
+    double dx, dy;
+    int32_t Nx, Ny;
+  };
+
+  Header header() const;
+  size_t data_offset() const;
+  size_t file_size() const;
+
+  double m_dx, m_dy;
+  int m_Nx, m_Ny;
+  //! everything the load response matrix depends on
+  std::vector<double> m_description;
+  //! checksum of `m_description`
+  uint64_t m_key;
+  std::string m_filename;
+
+  // memory-mapped file
+  void *m_data;
+  size_t m_size;
+  const double *m_values;
+
+  // disable copy constructor and the assignment operator:
+  LoadResponseMatrixCache(const LoadResponseMatrixCache &other);
+  LoadResponseMatrixCache& operator=(const LoadResponseMatrixCache&);
+};
+
+} // end of namespace bed
+} // end of namespace pism
+
+#endif /* PISM_LOADRESPONSEMATRIXCACHE_H */
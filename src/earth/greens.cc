@@ -69,6 +69,17 @@ double greens_elastic::operator()(double r) {
   return gsl_spline_eval(spline, r / 1.0e3, acc) / (r * 1.0e12);
 }
 
+/*!
+ * Returns distances (in km) followed by corresponding values of the Green's function.
+ *
+ * Used to detect changes in the Green's function when caching results that depend on it.
+ */
+std::vector<double> greens_elastic::parameters() {
+  std::vector<double> result(rmkm, rmkm + N);
+  result.insert(result.end(), GE, GE + N);
+  return result;
+}
+
 const double greens_elastic::rmkm[greens_elastic::N] =
   {0.0,    0.011,    0.111,  1.112,  2.224,  3.336,  4.448,  6.672,  8.896,  11.12,
    17.79,  22.24,    27.80,  33.36,  44.48,  55.60,  66.72,  88.96,  111.2,  133.4,
@@ -21,6 +21,7 @@
 
 #include <gsl/gsl_interp.h>  // for gsl_interp_accel
 #include <gsl/gsl_spline.h>  // for gsl_spline
+#include <vector>
 
 namespace pism {
 namespace bed {
@@ -38,6 +39,9 @@ public:
   greens_elastic();
   ~greens_elastic();
   double operator()(double r);
+
+  //! Tabulated data defining this Green's function.
+  static std::vector<double> parameters();
 private:
   static const int N = 42;
   static const double rmkm[N];
@@ -23,6 +23,7 @@
 #include "pism/util/MaxTimestep.hh"
 #include "pism/util/array/Array3D.hh"
 #include "pism/energy/BedrockColumn.hh"
+#include "pism/util/threading.hh"
 #include <memory>
 
 namespace pism {
@@ -80,6 +81,7 @@ BTU_Full::BTU_Full(std::shared_ptr<const Grid> g, const BTUGrid &grid)
   }
 
   m_column = std::make_shared<BedrockColumn>("bedrock_column", *m_config, vertical_spacing(), Mz());
+  m_batch = std::make_shared<TridiagonalSystemBatch>(Mz());
 }
 
 
@@ -168,16 +170,21 @@ void BTU_Full::update_impl(const array::Scalar &bedrock_top_temperature,
 
   array::AccessScope list{m_temp.get(), &m_bottom_surface_flux, &bedrock_top_temperature};
 
+  // Columns in a block are solved together (see TridiagonalSystemBatch).
   ParallelSection loop(m_grid->com);
-  try {
-    for (auto p = m_grid->points(); p; p.next()) {
-      const int i = p.i(), j = p.j();
+  for_each_block(*m_grid, m_batch->batch_size(), 1, loop,
+                 [&](int i_start, int i_end, int j, int /* thread */) {
+    for (int i = i_start; i < i_end; ++i) {
+      m_column->assemble(dt, m_bottom_surface_flux(i, j), bedrock_top_temperature(i, j),
+                         m_temp->get_column(i, j), *m_batch, i - i_start);
+    }
 
+    m_batch->solve(i_end - i_start);
+
+    for (int i = i_start; i < i_end; ++i) {
       double *T = m_temp->get_column(i, j);
 
-      m_column->solve(dt, m_bottom_surface_flux(i, j), bedrock_top_temperature(i, j),
-                      T,  // input
-                      T); // output
+      m_batch->solution(i - i_start, T);
 
       // Check that T is positive:
       for (unsigned int k = 0; k < m_Mbz; ++k) {
@@ -188,9 +195,7 @@ void BTU_Full::update_impl(const array::Scalar &bedrock_top_temperature,
         }
       }
     }
-  } catch (...) {
-    loop.failed();
-  }
+  });
   loop.check();
 
   update_flux_through_top_surface();
@@ -25,6 +25,8 @@
 
 namespace pism {
 
+class TridiagonalSystemBatch;
+
 namespace energy {
 
 class BedrockColumn;
@@ -127,6 +129,8 @@ protected:
   void update_flux_through_top_surface();
 
   std::shared_ptr<BedrockColumn> m_column;
+
+  std::shared_ptr<TridiagonalSystemBatch> m_batch;
 };
 
 } // end of namespace energy
@@ -39,6 +39,40 @@ BedrockColumn::BedrockColumn(const std::string& prefix,
   m_D   = m_k / (rho * c);
 }
 
+/*!
+ * Set up the system corresponding to one time step.
+ *
+ * @param[in] R `D * dt / dz^2`
+ * @param[in] G temperature gradient at the bottom surface
+ * @param[in] dz vertical spacing
+ * @param[in] M system size
+ * @param[in] T_top temperature at the top surface
+ * @param[in] T_old current temperature in the column
+ * @param[out] S tridiagonal system (TridiagonalSystem or TridiagonalSystemBatch::System)
+ */
+template <class System>
+static void assemble_system(double R, double G, double dz, unsigned int M,
+                            double T_top, const double *T_old, System &S) {
+  S.L(0)   = 0.0;                 // not used
+  S.D(0)   = 1.0 + 2.0 * R;
+  S.U(0)   = -2.0 * R;
+  S.RHS(0) = T_old[0] - 2.0 * G * dz * R;
+
+  unsigned int N = M - 1;
+
+  for (unsigned int k = 1; k < N; ++k) {
+    S.L(k)   = -R;
+    S.D(k)   = 1.0 + 2.0 * R;
+    S.U(k)   = -R;
+    S.RHS(k) = T_old[k];
+  }
+
+  S.L(N)   = 0.0;
+  S.D(N)   = 1.0;
+  S.U(N)   = 0.0;                 // not used
+  S.RHS(N) = T_top;
+}
+
 /*!
  * Advance the heat equation in time.
  *
@@ -56,26 +90,28 @@ void BedrockColumn::solve(double dt, double Q_bottom, double T_top,
   double R = m_D * dt / (m_dz * m_dz);
   double G = -Q_bottom / m_k;
 
-  m_system.L(0)   = 0.0;                 // not used
-  m_system.D(0)   = 1.0 + 2.0 * R;
-  m_system.U(0)   = -2.0 * R;
-  m_system.RHS(0) = T_old[0] - 2.0 * G * m_dz * R;
+  assemble_system(R, G, m_dz, m_M, T_top, T_old, m_system);
 
-  unsigned int N = m_M - 1;
+  m_system.solve(m_M, T_new);
+}
 
-  for (unsigned int k = 1; k < N; ++k) {
-    m_system.L(k)   = -R;
-    m_system.D(k)   = 1.0 + 2.0 * R;
-    m_system.U(k)   = -R;
-    m_system.RHS(k) = T_old[k];
-  }
+/*!
+ * Set up the system corresponding to one time step in the slot `b` of a `batch`.
+ *
+ * Arguments are the same as in solve(). Once `batch` is solved, the new temperature is
+ * available using `batch.solution(b, T_new)`.
+ */
+void BedrockColumn::assemble(double dt, double Q_bottom, double T_top, const double *T_old,
+                             TridiagonalSystemBatch &batch, unsigned int b) const {
+  assert(batch.max_system_size() >= m_M);
 
-  m_system.L(N)   = 0.0;
-  m_system.D(N)   = 1.0;
-  m_system.U(N)   = 0.0;                 // not used
-  m_system.RHS(N) = T_top;
+  double R = m_D * dt / (m_dz * m_dz);
+  double G = -Q_bottom / m_k;
 
-  m_system.solve(m_M, T_new);
+  auto S = batch.system(b);
+  assemble_system(R, G, m_dz, m_M, T_top, T_old, S);
+
+  batch.set_size(b, m_M);
 }
 
 /*!
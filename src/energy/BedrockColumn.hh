@@ -49,6 +49,9 @@ public:
              const std::vector<double> &T_old,
              std::vector<double> &result);
 
+  void assemble(double dt, double Q_bottom, double T_top, const double *T_old,
+                TridiagonalSystemBatch &batch, unsigned int b) const;
+
 private:
   // temperature diffusivity coefficient
   double m_D;
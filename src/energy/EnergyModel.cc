@@ -128,6 +128,8 @@ EnergyModel::EnergyModel(std::shared_ptr<const Grid> grid,
     m_basal_melt_rate.metadata()["comment"] = "positive basal melt rate corresponds to ice loss";
   }
 
+  m_ice_enthalpy.use_single_precision(array::single_precision_requested(*m_config, "enthalpy"));
+
   // a 3d work vector
   m_work.metadata(0).long_name("usually new values of temperature or enthalpy during time step");
 }
@@ -253,6 +255,7 @@ void EnergyModel::update(double t, double dt, const Inputs &inputs) {
     this->update_impl(t, dt, inputs);
 
     m_ice_enthalpy.copy_from(m_work);
+    m_ice_enthalpy.compact();
   }
   profiling().end("ice_energy");
 
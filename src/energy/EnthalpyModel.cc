@@ -17,14 +17,18 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <memory>             // std::unique_ptr
+
 #include "pism/energy/EnthalpyModel.hh"
 #include "pism/energy/DrainageCalculator.hh"
 #include "pism/energy/enthSystem.hh"
 #include "pism/energy/utilities.hh"
 #include "pism/util/Context.hh"
 #include "pism/util/EnthalpyConverter.hh"
+#include "pism/util/array/ActiveColumns.hh"
 #include "pism/util/array/CellType.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/threading.hh"
 
 namespace pism {
 namespace energy {
@@ -99,7 +103,10 @@ AschwandenBuelerKhroulevBlatter].
 This method updates array::Array3D m_work and array::Scalar basal_melt_rate.
 No communication of ghosts is done for any of these fields.
 
-We use an instance of enthSystemCtx.
+We use an instance of enthSystemCtx per thread (see for_each_point()).
+
+Only columns listed in the index of active columns (see array::CellType::active_columns())
+are solved for; in the rest of the domain there is no ice.
 
 Regarding drainage, see [\ref AschwandenBuelerKhroulevBlatter] and references therein.
  */
@@ -138,12 +145,32 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
   const array::Scalar1 &ice_thickness = *inputs.ice_thickness;
 
-  energy::enthSystemCtx system(m_grid->z(), "energy.enthalpy", m_grid->dx(), m_grid->dy(), dt,
-                               *m_config, m_ice_enthalpy, u3, v3, w3, strain_heating3, EC);
+  // column systems, batches of column systems, work space and counters used by each
+  // thread (each column in a batch needs its own enthSystemCtx)
+  const int n_threads = max_threads(*m_config);
+  std::vector<std::vector<std::unique_ptr<energy::enthSystemCtx> > > systems(n_threads);
+  std::vector<std::unique_ptr<TridiagonalSystemBatch> > batches(n_threads);
+  for (int k = 0; k < n_threads; ++k) {
+    do {
+      systems[k].emplace_back(new energy::enthSystemCtx(m_grid->z(), "energy.enthalpy",
+                                                        m_grid->dx(), m_grid->dy(), dt,
+                                                        *m_config, m_ice_enthalpy, u3, v3, w3,
+                                                        strain_heating3, EC));
+      if (not batches[k]) {
+        batches[k].reset(new TridiagonalSystemBatch(systems[k][0]->z().size()));
+      }
+    } while (systems[k].size() < batches[k]->batch_size());
+  }
 
-  const size_t Mz_fine = system.z().size();
-  const double dz = system.dz();
-  std::vector<double> Enthnew(Mz_fine); // new enthalpy in column
+  const unsigned int batch_size = batches[0]->batch_size();
+  const size_t Mz_fine = systems[0][0]->z().size();
+  const double dz = systems[0][0]->dz();
+  // new enthalpy in column
+  std::vector<std::vector<double> > Enthnew_storage(n_threads, std::vector<double>(Mz_fine));
+  // enthalpy at the top of the ice in each column of a batch
+  std::vector<std::vector<double> > Enth_ks_storage(n_threads, std::vector<double>(batch_size));
+  std::vector<EnergyModelStats> stats(n_threads);
+  std::vector<unsigned int> liquifiedCount(n_threads, 0);
 
   array::AccessScope list{&ice_surface_temp, &shelf_base_temp, &surface_liquid_fraction,
       &ice_thickness, &basal_frictional_heating, &basal_heat_flux, &till_water_thickness,
@@ -152,12 +179,37 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
   double margin_threshold = m_config->get_number("energy.margin_ice_thickness_limit");
 
-  unsigned int liquifiedCount = 0;
+  const auto &columns = cell_type.active_columns();
 
-  ParallelSection loop(m_grid->com);
-  try {
-    for (auto pt = m_grid->points(); pt; pt.next()) {
-      const int i = pt.i(), j = pt.j();
+  // Inactive columns (ice-free and not next to ice) are thinner than the ice-free
+  // thickness standard. If it is below dz they have ks == 0, so we set enthalpy to its
+  // value at the ice surface and the basal melt rate to zero (see the ice-free case
+  // below). Otherwise we process all the columns.
+  const bool skip_inactive =
+      m_config->get_number("geometry.ice_free_thickness_standard") < dz;
+
+  if (skip_inactive) {
+    for (auto p = columns.inactive_points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double Enth_ks = EC->enthalpy_permissive(ice_surface_temp(i, j),
+                                                     surface_liquid_fraction(i, j),
+                                                     EC->pressure(ice_thickness(i, j)));
+      m_work.set_column(i, j, Enth_ks);
+      m_basal_melt_rate(i, j) = 0.0;
+    }
+  }
+
+  // Systems in a block of columns are set up first and then solved together (see
+  // TridiagonalSystemBatch). Results are post-processed after that.
+  auto update_block = [&](int i_start, int i_end, int j, int thread) {
+    auto &batch   = *batches[thread];
+    auto &Enthnew = Enthnew_storage[thread];
+    auto &Enth_ks = Enth_ks_storage[thread];
+
+    for (int i = i_start; i < i_end; ++i) {
+      const unsigned int b = i - i_start;
+      auto &system = *systems[thread][b];
 
       const double H = ice_thickness(i, j);
 
@@ -170,23 +222,25 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
         depth_ks = H - system.ks() * dz,
         p_ks     = EC->pressure(depth_ks); // FIXME issue #15
 
-      const double Enth_ks = EC->enthalpy_permissive(ice_surface_temp(i, j),
-                                                     surface_liquid_fraction(i, j), p_ks);
+      Enth_ks[b] = EC->enthalpy_permissive(ice_surface_temp(i, j),
+                                           surface_liquid_fraction(i, j), p_ks);
 
       const bool ice_free_column = (system.ks() == 0);
 
       // deal completely with columns with no ice; enthalpy and basal_melt_rate need setting
       if (ice_free_column) {
-        m_work.set_column(i, j, Enth_ks);
+        m_work.set_column(i, j, Enth_ks[b]);
         // The floating basal melt rate will be set later; cover this
         // case and set to zero for now. Also, there is no basal melt
         // rate on ice free land and ice free ocean
         m_basal_melt_rate(i, j) = 0.0;
+        // mark this slot as unused
+        batch.set_size(b, 0);
         continue;
       } // end of if (ice_free_column)
 
       if (system.lambda() < 1.0) {
-        m_stats.reduced_accuracy_counter += 1; // count columns with lambda < 1
+        stats[thread].reduced_accuracy_counter += 1; // count columns with lambda < 1
       }
 
       const bool
@@ -194,9 +248,9 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
         base_is_warm       = system.Enth(0) >= system.Enth_s(0),
         above_base_is_warm = system.Enth(1) >= system.Enth_s(1);
 
-      // set boundary conditions and update enthalpy
+      // set boundary conditions
       {
-        system.set_surface_dirichlet_bc(Enth_ks);
+        system.set_surface_dirichlet_bc(Enth_ks[b]);
 
         // determine lowest-level equation at bottom of ice; see
         // decision chart in the source code browser and page
@@ -226,10 +280,43 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
           }
         }
 
-        // solve the system
-        system.solve(Enthnew);
+        // set up the system
+        system.assemble(batch, b);
+      }
+    }
 
+    // solve systems in all columns of this block
+    try {
+      batch.solve(i_end - i_start);
+    } catch (RuntimeError &e) {
+      e.add_context("solving tri-diagonal systems (enthSystemCtx) at i = %d...%d, j = %d",
+                    i_start, i_end - 1, j);
+      for (int i = i_start; i < i_end; ++i) {
+        const unsigned int b = i - i_start;
+
+        if (batch.size(b) > 0 and batch.zero_pivot(b) != 0) {
+          e.add_context("solving the tri-diagonal system (enthSystemCtx) at (%d,%d)\n"
+                        "saving system to m-file... ", i, j);
+          systems[thread][b]->save_failed_system();
+        }
       }
+      throw;
+    }
+
+    for (int i = i_start; i < i_end; ++i) {
+      const unsigned int b = i - i_start;
+
+      if (batch.size(b) == 0) {
+        // ice-free column
+        continue;
+      }
+
+      auto &system = *systems[thread][b];
+
+      const double H = ice_thickness(i, j);
+      const bool is_floating = cell_type.ocean(i, j);
+
+      system.extract_solution(batch, b, Enthnew);
 
       // post-process (drainage and bulge-limiting)
       double Hdrainedtotal = 0.0;
@@ -246,7 +333,7 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
               L     = EC->L(T_m);
 
             if (Enthnew[k] >= system.Enth_s(k) + 0.5 * L) {
-              liquifiedCount++; // count these rare events...
+              liquifiedCount[thread]++; // count these rare events...
               Enthnew[k] = system.Enth_s(k) + 0.5 * L; //  but lose the energy
             }
 
@@ -264,12 +351,12 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
         }
 
         // apply bulge limiter
-        const double lowerEnthLimit = Enth_ks - bulgeEnthMax;
+        const double lowerEnthLimit = Enth_ks[b] - bulgeEnthMax;
         for (unsigned int k=0; k < system.ks(); k++) {
           if (Enthnew[k] < lowerEnthLimit) {
             // Count grid points which have very large cold limit advection bulge... enthalpy not
             // too low.
-            m_stats.bulge_counter += 1;
+            stats[thread].bulge_counter += 1;
             Enthnew[k] = lowerEnthLimit;
           }
         }
@@ -337,12 +424,23 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
       system.fine_to_coarse(Enthnew, i, j, m_work);
     }
-  } catch (...) {
-    loop.failed();
+  };
+
+  ParallelSection loop(m_grid->com);
+  if (skip_inactive) {
+    for_each_block(columns.runs(), batch_size, n_threads, loop, update_block);
+  } else {
+    for_each_block(*m_grid, batch_size, n_threads, loop, update_block);
   }
   loop.check();
 
-  m_stats.liquified_ice_volume = ((double) liquifiedCount) * dz * m_grid->cell_area();
+  unsigned int liquified_total = 0;
+  for (int k = 0; k < n_threads; ++k) {
+    m_stats += stats[k];
+    liquified_total += liquifiedCount[k];
+  }
+
+  m_stats.liquified_ice_volume = ((double) liquified_total) * dz * m_grid->cell_area();
 }
 
 void EnthalpyModel::define_model_state_impl(const File &output) const {
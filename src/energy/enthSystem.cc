@@ -481,6 +481,30 @@ void enthSystemCtx::solve(std::vector<double> &result) {
 
   TridiagonalSystem &S = *m_solver;
 
+  assemble_system(S);
+
+  // Solve it; note drainage is not addressed yet and post-processing may occur
+  try {
+    S.solve(m_ks + 1, result);
+  }
+  catch (RuntimeError &e) {
+    e.add_context("solving the tri-diagonal system (enthSystemCtx) at (%d,%d)\n"
+                  "saving system to m-file... ", m_i, m_j);
+    reportColumnZeroPivotErrorMFile(m_ks + 1);
+    throw;
+  }
+
+  finalize(result);
+}
+
+/*!
+ * Set up the system for the current column (see solve() for details).
+ *
+ * `System` is TridiagonalSystem or TridiagonalSystemBatch::System.
+ */
+template <class System>
+void enthSystemCtx::assemble_system(System &S) const {
+
 #if (Pism_DEBUG==1)
   checkReadyToSolve();
   if (std::isnan(m_D0) || std::isnan(m_U0) || std::isnan(m_B0)) {
@@ -545,18 +569,12 @@ void enthSystemCtx::solve(std::vector<double> &result) {
     S.U(m_ks) = m_U_ks;
   }
   S.RHS(m_ks) = m_B_ks;
+}
 
-  // Solve it; note drainage is not addressed yet and post-processing may occur
-  try {
-    S.solve(m_ks + 1, result);
-  }
-  catch (RuntimeError &e) {
-    e.add_context("solving the tri-diagonal system (enthSystemCtx) at (%d,%d)\n"
-                  "saving system to m-file... ", m_i, m_j);
-    reportColumnZeroPivotErrorMFile(m_ks + 1);
-    throw;
-  }
-
+/*!
+ * Set enthalpy above the ice surface after solving the system for the current column.
+ */
+void enthSystemCtx::finalize(std::vector<double> &result) {
   // air above
   for (unsigned int k = m_ks+1; k < result.size(); k++) {
     result[k] = m_B_ks;
@@ -575,6 +593,41 @@ void enthSystemCtx::solve(std::vector<double> &result) {
 #endif
 }
 
+/*!
+ * Set up the system for the current column in the slot `b` of a `batch`.
+ *
+ * Once `batch` is solved, use extract_solution() to get the new enthalpy. This allows
+ * solving systems in many columns at once (see TridiagonalSystemBatch); each column needs
+ * its own enthSystemCtx instance.
+ */
+void enthSystemCtx::assemble(TridiagonalSystemBatch &batch, unsigned int b) const {
+  auto S = batch.system(b);
+  assemble_system(S);
+
+  batch.set_size(b, m_ks + 1);
+}
+
+//! Get the solution of the system in the slot `b` of a solved `batch`.
+void enthSystemCtx::extract_solution(const TridiagonalSystemBatch &batch, unsigned int b,
+                                     std::vector<double> &result) {
+  result.resize(m_z.size());
+
+  batch.solution(b, result.data());
+
+  finalize(result);
+}
+
+/*!
+ * Save the system for the current column to an m-file after a failure of a batched solve.
+ *
+ * TridiagonalSystemBatch::solve() overwrites coefficients, so this re-assembles the
+ * system before saving it.
+ */
+void enthSystemCtx::save_failed_system() {
+  assemble_system(*m_solver);
+  reportColumnZeroPivotErrorMFile(m_ks + 1);
+}
+
 void enthSystemCtx::save_system(std::ostream &output, unsigned int system_size) const {
   m_solver->save_system(output, system_size);
   pism::TridiagonalSystem::save_vector(output, m_R, system_size, m_solver->prefix() + "_R");
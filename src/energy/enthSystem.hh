@@ -66,6 +66,11 @@ public:
 
   void solve(std::vector<double> &result);
 
+  void assemble(TridiagonalSystemBatch &batch, unsigned int b) const;
+  void extract_solution(const TridiagonalSystemBatch &batch, unsigned int b,
+                        std::vector<double> &result);
+  void save_failed_system();
+
   double lambda() const {
     return m_lambda;
   }
@@ -114,6 +119,10 @@ protected:
 
   void assemble_R();
   void checkReadyToSolve() const;
+
+  template <class System>
+  void assemble_system(System &S) const;
+  void finalize(std::vector<double> &result);
 };
 
 } // end of namespace energy
@@ -0,0 +1,223 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "\nPISM_TRIDIAGONAL_BENCH\n"
+  "  Compares batched (TridiagonalSystemBatch) and column-by-column (TridiagonalSystem)\n"
+  "  solvers of tridiagonal systems in vertical columns: checks that solutions agree\n"
+  "  and reports time per column, including the time needed to set up systems.\n\n";
+
+#include <petsc.h>
+
+#include <cmath>
+#include <vector>
+
+#include "pism/util/ColumnSystem.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+
+namespace pism {
+
+/*!
+ * Inputs of implicit vertical diffusion problems in `n_columns` columns with up to `Mz`
+ * levels.
+ *
+ * The number of levels in the ice varies smoothly from column to column, similar to
+ * the number of levels in the ice in neighboring columns of an ice sheet. Every 16th
+ * column is ice-free.
+ */
+struct Columns {
+  Columns(unsigned int n_columns, unsigned int max_size)
+    : Mz(max_size), size(n_columns), R(n_columns * Mz), T(n_columns * Mz) {
+    for (unsigned int c = 0; c < n_columns; ++c) {
+      size[c] = c % 16 == 15 ? 0 : 1 + (unsigned int)((Mz - 1) * (0.75 + 0.25 * cos(0.1 * c)));
+
+      for (unsigned int k = 0; k < Mz; ++k) {
+        R[c * Mz + k] = 0.5 + 0.25 * sin(0.3 * k + c);
+        T[c * Mz + k] = 240.0 + 30.0 * k / Mz;
+      }
+    }
+  }
+
+  //! Set up the system in the column `c`.
+  template <class System>
+  void assemble(unsigned int c, System &S) const {
+    const unsigned int n = size[c];
+    const double *r = &R[c * Mz], *t = &T[c * Mz];
+
+    S.D(0)   = 1.0 + 2.0 * r[0];
+    S.U(0)   = -2.0 * r[0];
+    S.RHS(0) = t[0] + r[0];
+    for (unsigned int k = 1; k + 1 < n; ++k) {
+      const double
+        R_minus = 0.5 * (r[k - 1] + r[k]),
+        R_plus  = 0.5 * (r[k] + r[k + 1]);
+
+      S.L(k)   = -R_minus - 0.05;
+      S.D(k)   = 1.0 + R_minus + R_plus + 0.05;
+      S.U(k)   = -R_plus;
+      S.RHS(k) = t[k];
+    }
+    if (n > 1) {
+      S.L(n - 1)   = 0.0;
+      S.D(n - 1)   = 1.0;
+      S.RHS(n - 1) = t[n - 1];
+    }
+  }
+
+  unsigned int Mz;
+  std::vector<unsigned int> size;
+  std::vector<double> R, T;
+};
+
+/*!
+ * Solves systems in all columns, one at a time, and returns the time used.
+ */
+static double solve_scalar(const Columns &C, int repeat, std::vector<double> &result) {
+  const unsigned int n_columns = C.size.size();
+  TridiagonalSystem system(C.Mz, "scalar");
+
+  double T0 = MPI_Wtime();
+  for (int r = 0; r < repeat; ++r) {
+    for (unsigned int c = 0; c < n_columns; ++c) {
+      if (C.size[c] == 0) {
+        continue;
+      }
+      C.assemble(c, system);
+      system.solve(C.size[c], &result[c * C.Mz]);
+    }
+  }
+  return MPI_Wtime() - T0;
+}
+
+/*!
+ * Solves systems in all columns using batches of `batch_size` columns and returns the
+ * time used.
+ */
+static double solve_batched(const Columns &C, int repeat, unsigned int batch_size,
+                            std::vector<double> &result) {
+  const unsigned int n_columns = C.size.size();
+  TridiagonalSystemBatch batch(C.Mz, batch_size);
+
+  double T0 = MPI_Wtime();
+  for (int r = 0; r < repeat; ++r) {
+    for (unsigned int start = 0; start < n_columns; start += batch_size) {
+      const unsigned int end = std::min(start + batch_size, n_columns);
+
+      for (unsigned int c = start; c < end; ++c) {
+        auto S = batch.system(c - start);
+        C.assemble(c, S);
+        batch.set_size(c - start, C.size[c]);
+      }
+
+      batch.solve(end - start);
+
+      for (unsigned int c = start; c < end; ++c) {
+        batch.solution(c - start, &result[c * C.Mz]);
+      }
+    }
+  }
+  return MPI_Wtime() - T0;
+}
+
+} // end of namespace pism
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  try {
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_tridiagonal_bench");
+    auto log = ctx->log();
+
+    std::string usage =
+      "  pism_tridiagonal_bench [-Mz N] [-columns C] [-batch_size B] [-repeat R]\n"
+      "where\n"
+      "  -Mz            maximum system size (default: 101)\n"
+      "  -columns       number of columns (default: 4096)\n"
+      "  -batch_size    number of columns in a batch (default: 32)\n"
+      "  -repeat        number of repetitions used for timing (default: 20)\n";
+
+    bool stop = show_usage_check_req_opts(*log, "pism_tridiagonal_bench", {}, usage);
+    if (stop) {
+      return 0;
+    }
+
+    options::Integer
+      Mz("-Mz", "maximum system size", 101),
+      n_columns("-columns", "number of columns", 4096),
+      batch_size("-batch_size", "number of columns in a batch", 32),
+      repeat("-repeat", "number of repetitions", 20);
+
+    if (Mz < 2 or n_columns < 1 or batch_size < 1 or repeat < 1) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "-Mz has to be at least 2; -columns, -batch_size and -repeat"
+                         " have to be positive");
+    }
+
+    Columns C(n_columns, Mz);
+
+    std::vector<double>
+      x_scalar(C.R.size(), 0.0),
+      x_batched(C.R.size(), 0.0);
+
+    double
+      T_scalar  = solve_scalar(C, repeat, x_scalar),
+      T_batched = solve_batched(C, repeat, batch_size, x_batched);
+
+    // Both solvers perform the same floating point operations, so solutions should be
+    // identical.
+    unsigned int n_different = 0;
+    for (unsigned int c = 0; c < C.size.size(); ++c) {
+      for (unsigned int k = 0; k < C.size[c]; ++k) {
+        if (x_scalar[c * C.Mz + k] != x_batched[c * C.Mz + k]) {
+          n_different += 1;
+        }
+      }
+    }
+
+    const double
+      N       = (double)n_columns * repeat,
+      scalar  = T_scalar / N * 1e6,
+      batched = T_batched / N * 1e6;
+
+    log->message(1, "%5s  %8s  %6s  %16s  %16s  %7s\n",
+                 "Mz", "columns", "batch", "scalar (us/col)", "batched (us/col)", "speedup");
+    log->message(1, "%5d  %8d  %6d  %16.3f  %16.3f  %7.2f\n",
+                 (int)Mz, (int)n_columns, (int)batch_size, scalar, batched,
+                 scalar / std::max(batched, 1e-16));
+
+    if (n_different > 0) {
+      log->message(1, "Batched and scalar solutions differ at %d locations.\n", n_different);
+      return 1;
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
@@ -218,6 +218,14 @@ void compute_cts(const array::Array3D &ice_enthalpy, const array::Scalar &ice_th
 double total_ice_enthalpy(double thickness_threshold,
                           const array::Array3D &ice_enthalpy,
                           const array::Scalar &ice_thickness) {
+  return GlobalSum(ice_enthalpy.grid()->com,
+                   total_ice_enthalpy_local(thickness_threshold, ice_enthalpy, ice_thickness));
+}
+
+//! Computes the enthalpy of the ice in the sub-domain owned by this process, in J.
+double total_ice_enthalpy_local(double thickness_threshold,
+                                const array::Array3D &ice_enthalpy,
+                                const array::Scalar &ice_thickness) {
   double enthalpy_sum = 0.0;
 
   auto grid = ice_enthalpy.grid();
@@ -254,7 +262,7 @@ double total_ice_enthalpy(double thickness_threshold,
 
   enthalpy_sum *= config->get_number("constants.ice.density");
 
-  return GlobalSum(grid->com, enthalpy_sum);
+  return enthalpy_sum;
 }
 
 //! Create a temperature field within the ice from provided ice thickness, surface temperature, surface mass balance, and geothermal flux.
@@ -54,6 +54,10 @@ double total_ice_enthalpy(double thickness_threshold,
                           const array::Array3D &ice_enthalpy,
                           const array::Scalar &ice_thickness);
 
+double total_ice_enthalpy_local(double thickness_threshold,
+                                const array::Array3D &ice_enthalpy,
+                                const array::Scalar &ice_thickness);
+
 void bootstrap_ice_temperature(const array::Scalar &ice_thickness,
                                const array::Scalar &ice_surface_temp,
                                const array::Scalar &surface_mass_balance,
@@ -123,6 +123,7 @@ void CalvingAtThickness::update(double t,
     }
   }
 
+  cell_type.inc_state_counter();
   cell_type.update_ghosts();
   ice_thickness.update_ghosts();
 }
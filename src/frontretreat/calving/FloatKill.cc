@@ -83,6 +83,7 @@ void FloatKill::update(array::Scalar &cell_type, array::Scalar &ice_thickness) {
     }
   }
 
+  cell_type.inc_state_counter();
   cell_type.update_ghosts();
   ice_thickness.update_ghosts();
 }
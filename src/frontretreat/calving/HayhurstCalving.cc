@@ -20,6 +20,7 @@
 #include "pism/frontretreat/calving/HayhurstCalving.hh"
 
 #include "pism/util/Grid.hh"
+#include "pism/pism_parameters.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/array/CellType.hh"
 
@@ -68,10 +69,12 @@ void HayhurstCalving::update(const array::CellType1 &cell_type,
 
   using std::min;
 
+  const auto &constants = m_config->parameters().constants;
+
   const double
-    ice_density   = m_config->get_number("constants.ice.density"),
-    water_density = m_config->get_number("constants.sea_water.density"),
-    gravity       = m_config->get_number("constants.standard_gravity"),
+    ice_density   = constants.ice.density,
+    water_density = constants.sea_water.density,
+    gravity       = constants.standard_gravity,
     // convert "Pa" to "MPa" and "m yr-1" to "m s-1"
     unit_scaling  = pow(1e-6, m_exponent_r) * convert(m_sys, 1.0, "m year-1", "m second-1");
 
@@ -78,7 +78,7 @@ void IcebergRemover::update_impl(const array::Scalar &bc_mask,
     }
   }
 
-  connected_components::label_isolated(m_iceberg_mask, mask_grounded_ice);
+  connected_components::label_isolated_union_find(m_iceberg_mask, mask_grounded_ice);
 
   // correct ice thickness and the cell type mask using the resulting
   // "iceberg" mask:
@@ -97,6 +97,7 @@ void IcebergRemover::update_impl(const array::Scalar &bc_mask,
 
   // update ghosts of the cell_type and the ice thickness (then surface
   // elevation can be updated redundantly)
+  cell_type.inc_state_counter();
   cell_type.update_ghosts();
   ice_thickness.update_ghosts();
 }
@@ -117,7 +117,7 @@ void IcebergRemoverFEM::update_impl(const array::Scalar &bc_mask,
 
   // Identify icebergs:
   {
-    connected_components::label_isolated(m_iceberg_mask, mask_grounded_ice);
+    connected_components::label_isolated_union_find(m_iceberg_mask, mask_grounded_ice);
     m_iceberg_mask.update_ghosts();
   }
 
@@ -188,6 +188,7 @@ void IcebergRemoverFEM::update_impl(const array::Scalar &bc_mask,
 
   // update ghosts of the mask and the ice thickness (then surface
   // elevation can be updated redundantly)
+  cell_type.inc_state_counter();
   cell_type.update_ghosts();
   ice_thickness.update_ghosts();
 }
@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""Generate the strongly-typed snapshot of PISM's configuration parameters
+(pism::ConfigParameters, see Config::parameters()) from pism_config.cdl.
+
+Usage: generate_parameters.py pism_config.cdl pism_parameters.hh pism_parameters.cc
+
+This script uses the Python standard library only: it parses the CDL file directly.
+"""
+
+import re
+import sys
+
+# Parameters using these units are converted to "internal" (SI) units used by PISM's
+# code, e.g. "meter / year" -> "m second^-1". Units not listed here are kept as is, but
+# see non_si_tokens below.
+internal_units = {
+    "365day": "seconds",
+    "365days": "seconds",
+    "year": "seconds",
+    "years": "seconds",
+    "hours": "seconds",
+    "meter / year": "m second^-1",
+    "meters year^-1": "m second^-1",
+    "m year^-1": "m second^-1",
+    "m / year": "m second^-1",
+    "mm / year": "m second^-1",
+    "m / day": "m second^-1",
+    "mm/hr": "m second^-1",
+    "meter / (kelvin day)": "m kelvin^-1 second^-1",
+    "year^-1": "second^-1",
+    "kg m^-2 year^-1": "kg m^-2 second^-1",
+    "(m / year) / km": "second^-1",
+    "(kg m^-2 / year) / km": "kg m^-3 second^-1",
+    "km": "meters",
+    "km^2": "m^2",
+    "km s^-1": "m second^-1",
+    "mm": "meters",
+    "K / km": "kelvin / meter",
+    "kelvin / km": "kelvin / meter",
+    "kPa": "Pascal",
+    "MPa": "Pascal",
+    "Pa^-3 year^-1 m^-2": "Pa^-3 second^-1 m^-2",
+}
+
+# Units of these parameters contain symbolic exponents, so they cannot be converted. Code
+# using them converts units itself.
+unconverted_units = set([
+    "(MPa)^r / year",
+    "m-alpha day^(alpha-1) Celsius-beta",
+    "m day^(alpha-1) Celsius-beta",
+])
+
+# Units of number parameters containing one of these tokens have to be listed in
+# internal_units or unconverted_units (see internal()).
+non_si_tokens = set("""
+365day 365days year years yr week weeks day days hour hours hr minute minutes km mm kPa MPa
+""".split())
+
+special_suffixes = ["_doc", "_units", "_type", "_option", "_choices", "_valid_min", "_valid_max"]
+
+cxx_keywords = set("""
+alignas alignof and and_eq asm auto bitand bitor bool break case catch char char16_t
+char32_t class compl const constexpr const_cast continue decltype default delete do double
+dynamic_cast else enum explicit export extern false float for friend goto if inline int
+long mutable namespace new noexcept not not_eq nullptr operator or or_eq private protected
+public register reinterpret_cast return short signed sizeof static static_assert
+static_cast struct switch template this thread_local throw true try typedef typeid
+typename union unsigned using virtual void volatile wchar_t while xor xor_eq
+""".split())
+
+# name of the member used for a parameter that is also a prefix of other parameters
+# (e.g. "time.file" and "time.file.continue")
+value_member = "value"
+
+
+def read_cdl(filename):
+    "Read attributes of the 'pism_config' variable from a CDL file."
+    attributes = {}
+    with open(filename) as f:
+        for line in f:
+            m = re.match(r'\s*pism_config:([A-Za-z0-9_.]+)\s*=\s*(.*);\s*$', line)
+            if m:
+                name, value = m.groups()
+                if value.startswith('"'):
+                    value = value[1:-1]
+                attributes[name] = value
+    return attributes
+
+
+def parameters(attributes):
+    "Return a sorted list of (name, type, units) tuples."
+    result = []
+    for name in sorted(attributes.keys()):
+        if name == "long_name" or any(name.endswith(s) for s in special_suffixes):
+            continue
+        result.append((name, attributes[name + "_type"], attributes.get(name + "_units", "")))
+    return result
+
+
+def internal(name, units):
+    """Return units used by the code for a number parameter 'name' using 'units'.
+
+    Stops with an error if 'units' are not SI and cannot be converted: add them to
+    internal_units (or unconverted_units) in this case.
+    """
+    if units in internal_units:
+        return internal_units[units]
+
+    tokens = set(re.findall(r"[A-Za-z0-9]+", units))
+    if units not in unconverted_units and tokens & non_si_tokens:
+        sys.exit("generate_parameters.py: cannot convert '{}' (units of {}) to SI".format(units,
+                                                                                        name))
+
+    return units
+
+
+def member(token):
+    "Convert a token in a parameter name to a C++ identifier."
+    return token + "_" if token in cxx_keywords else token
+
+
+def tree(params):
+    """Build a nested dictionary. Leaves are (name, type, units) tuples."""
+    result = {}
+    # proper prefixes of all parameter names
+    prefixes = set()
+    for p in params:
+        tokens = p[0].split(".")
+        for k in range(1, len(tokens)):
+            prefixes.add(".".join(tokens[:k]))
+
+    for p in params:
+        node = result
+        tokens = p[0].split(".")
+        for t in tokens[:-1]:
+            node = node.setdefault(member(t), {})
+
+        if p[0] in prefixes:
+            # this parameter is also a prefix of other parameters
+            node = node.setdefault(member(tokens[-1]), {})
+            assert value_member not in node
+            node[value_member] = p
+        else:
+            node[member(tokens[-1])] = p
+    return result
+
+
+def cxx_type(parameter_type):
+    return {"flag": "bool",
+            "integer": "int",
+            "number": "double",
+            "keyword": "std::string",
+            "string": "std::string"}[parameter_type]
+
+
+def declarations(node, indent):
+    "Generate declarations of members of 'node'."
+    lines = []
+    pad = " " * indent
+    for key in sorted(node.keys()):
+        value = node[key]
+        if isinstance(value, dict):
+            lines.append(pad + "struct {")
+            lines += declarations(value, indent + 2)
+            lines.append(pad + "}} {};".format(key))
+        else:
+            name, T, units = value
+            if T == "number" and units:
+                units = internal(name, units)
+                lines.append(pad + "{} {}; //!< {} [{}]".format(cxx_type(T), key, name, units))
+            else:
+                lines.append(pad + "{} {}; //!< {}".format(cxx_type(T), key, name))
+    return lines
+
+
+def assignments(node, prefix):
+    "Generate code setting members of 'node'."
+    lines = []
+    for key in sorted(node.keys()):
+        value = node[key]
+        path = prefix + [key]
+        if isinstance(value, dict):
+            lines += assignments(value, path)
+            continue
+
+        name, T, units = value
+        target = ".".join(path)
+        if T == "flag":
+            code = 'config.get_flag("{}", F)'.format(name)
+        elif T in ["string", "keyword"]:
+            code = 'config.get_string("{}", F)'.format(name)
+        elif T == "integer":
+            code = 'static_cast<int>(config.get_number("{}", F))'.format(name)
+        elif internal(name, units) != units:
+            code = 'config.get_number("{}", "{}", F)'.format(name, internal(name, units))
+        else:
+            code = 'config.get_number("{}", F)'.format(name)
+        lines.append("  {} = {};".format(target, code))
+    return lines
+
+
+header_template = """// This file was generated by generate_parameters.py using pism_config.cdl. Do not edit.
+
+#ifndef PISM_PARAMETERS_H
+#define PISM_PARAMETERS_H
+
+#include <string>
+
+namespace pism {{
+
+class Config;
+
+//! A strongly-typed snapshot of all configuration parameters.
+/*!
+ * Members mirror parameter names: `constants.ice.density` is
+ * `ConfigParameters::constants.ice.density`. A parameter that is also a prefix of other
+ * parameter names (e.g. `time.file`) is stored in the member `{value}`. Members with
+ * names that are C++ keywords get a trailing underscore (`time.file.continue_`).
+ *
+ * Dimensional parameters are converted to units used by PISM's code (SI, with time in
+ * seconds); comments below list the units of each member. The only exceptions are
+ * parameters with units containing symbolic exponents (e.g. `(MPa)^r / year`): they are
+ * kept in units listed in `pism_config.cdl`.
+ *
+ * Use Config::parameters() to get an instance.
+ */
+struct ConfigParameters {{
+  ConfigParameters(const Config &config);
+
+{members}
+}};
+
+}} // end of namespace pism
+
+#endif /* PISM_PARAMETERS_H */
+"""
+
+source_template = """// This file was generated by generate_parameters.py using pism_config.cdl. Do not edit.
+
+#include "pism/pism_parameters.hh"
+#include "pism/util/ConfigInterface.hh"
+
+namespace pism {{
+
+ConfigParameters::ConfigParameters(const Config &config) {{
+  // getting a snapshot of all parameters does not mean that all of them are used
+  const auto F = Config::FORGET_THIS_USE;
+
+{assignments}
+}}
+
+}} // end of namespace pism
+"""
+
+
+def write_if_changed(filename, text):
+    "Write 'text' to 'filename' unless it already contains 'text' (avoids re-compiling)."
+    try:
+        with open(filename) as f:
+            if f.read() == text:
+                return
+    except IOError:
+        pass
+
+    with open(filename, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 4:
+        sys.exit(__doc__)
+
+    cdl, header, source = sys.argv[1:]
+
+    t = tree(parameters(read_cdl(cdl)))
+
+    write_if_changed(header, header_template.format(value=value_member,
+                                                    members="\n".join(declarations(t, 2))))
+    write_if_changed(source, source_template.format(assignments="\n".join(assignments(t, []))))
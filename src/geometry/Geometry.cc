@@ -162,6 +162,8 @@ void Geometry::ensure_consistency(double ice_free_thickness_threshold) {
       loop.failed();
     }
     loop.check();
+
+    cell_type.inc_state_counter();
   }
 
   ice_thickness.update_ghosts();
@@ -252,6 +254,12 @@ void ice_bottom_surface(const Geometry &geometry, array::Scalar &result) {
 
 //! Computes the ice volume, in m^3.
 double ice_volume(const Geometry &geometry, double thickness_threshold) {
+  return GlobalSum(geometry.ice_thickness.grid()->com,
+                   ice_volume_local(geometry, thickness_threshold));
+}
+
+//! Computes the volume of the ice in the sub-domain owned by this process, in m^3.
+double ice_volume_local(const Geometry &geometry, double thickness_threshold) {
   auto grid = geometry.ice_thickness.grid();
   auto config = grid->ctx()->config();
 
@@ -281,11 +289,17 @@ double ice_volume(const Geometry &geometry, double thickness_threshold) {
     }
   }
 
-  return GlobalSum(grid->com, volume);
+  return volume;
 }
 
 double ice_volume_not_displacing_seawater(const Geometry &geometry,
                                           double thickness_threshold) {
+  return GlobalSum(geometry.ice_thickness.grid()->com,
+                   ice_volume_not_displacing_seawater_local(geometry, thickness_threshold));
+}
+
+double ice_volume_not_displacing_seawater_local(const Geometry &geometry,
+                                                double thickness_threshold) {
   auto grid = geometry.ice_thickness.grid();
   auto config = grid->ctx()->config();
 
@@ -314,9 +328,11 @@ double ice_volume_not_displacing_seawater(const Geometry &geometry,
     }
   } // end of the loop over grid points
 
-  return GlobalSum(grid->com, volume);
+  return volume;
 }
 
+//! Computes the area of cells in the sub-domain owned by this process satisfying
+//! `condition`.
 static double compute_area(const Grid &grid, std::function<bool(int, int)> condition) {
   double cell_area = grid.cell_area();
   double area = 0.0;
@@ -329,11 +345,16 @@ static double compute_area(const Grid &grid, std::function<bool(int, int)> condi
     }
   }
 
-  return GlobalSum(grid.com, area);
+  return area;
 }
 
 //! Computes ice area, in m^2.
 double ice_area(const Geometry &geometry, double thickness_threshold) {
+  return GlobalSum(geometry.ice_thickness.grid()->com,
+                   ice_area_local(geometry, thickness_threshold));
+}
+
+double ice_area_local(const Geometry &geometry, double thickness_threshold) {
   array::AccessScope list{ &geometry.ice_thickness };
   return compute_area(*geometry.ice_thickness.grid(), [&](int i, int j) {
     return geometry.ice_thickness(i, j) >= thickness_threshold;
@@ -342,6 +363,11 @@ double ice_area(const Geometry &geometry, double thickness_threshold) {
 
 //! Computes grounded ice area, in m^2.
 double ice_area_grounded(const Geometry &geometry, double thickness_threshold) {
+  return GlobalSum(geometry.ice_thickness.grid()->com,
+                   ice_area_grounded_local(geometry, thickness_threshold));
+}
+
+double ice_area_grounded_local(const Geometry &geometry, double thickness_threshold) {
   array::AccessScope list{ &geometry.cell_type, &geometry.ice_thickness };
   return compute_area(*geometry.ice_thickness.grid(), [&](int i, int j) {
     return (geometry.cell_type.grounded(i, j) and
@@ -351,6 +377,11 @@ double ice_area_grounded(const Geometry &geometry, double thickness_threshold) {
 
 //! Computes floating ice area, in m^2.
 double ice_area_floating(const Geometry &geometry, double thickness_threshold) {
+  return GlobalSum(geometry.ice_thickness.grid()->com,
+                   ice_area_floating_local(geometry, thickness_threshold));
+}
+
+double ice_area_floating_local(const Geometry &geometry, double thickness_threshold) {
   array::AccessScope list{ &geometry.cell_type, &geometry.ice_thickness };
   return compute_area(*geometry.ice_thickness.grid(), [&](int i, int j) {
     return (geometry.cell_type.ocean(i, j) and geometry.ice_thickness(i, j) >= thickness_threshold);
@@ -360,6 +391,11 @@ double ice_area_floating(const Geometry &geometry, double thickness_threshold) {
 
 //! Computes the sea level rise that would result if all the ice were melted.
 double sea_level_rise_potential(const Geometry &geometry, double thickness_threshold) {
+  return GlobalSum(geometry.ice_thickness.grid()->com,
+                   sea_level_rise_potential_local(geometry, thickness_threshold));
+}
+
+double sea_level_rise_potential_local(const Geometry &geometry, double thickness_threshold) {
   auto config = geometry.ice_thickness.grid()->ctx()->config();
 
   const double
@@ -368,8 +404,8 @@ double sea_level_rise_potential(const Geometry &geometry, double thickness_thres
     ocean_area    = config->get_number("constants.global_ocean_area");
 
   const double
-    volume                  = ice_volume_not_displacing_seawater(geometry,
-                                                                 thickness_threshold),
+    volume                  = ice_volume_not_displacing_seawater_local(geometry,
+                                                                       thickness_threshold),
     additional_water_volume = (ice_density / water_density) * volume,
     sea_level_change        = additional_water_volume / ocean_area;
 
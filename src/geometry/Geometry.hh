@@ -69,6 +69,16 @@ double ice_volume_not_displacing_seawater(const Geometry &geometry,
                                           double thickness_threshold);
 double sea_level_rise_potential(const Geometry &geometry, double thickness_threshold);
 
+// Contributions of the sub-domain owned by this process to quantities above (use these to
+// combine several reductions into one)
+double ice_volume_local(const Geometry &geometry, double thickness_threshold);
+double ice_area_floating_local(const Geometry &geometry, double thickness_threshold);
+double ice_area_grounded_local(const Geometry &geometry, double thickness_threshold);
+double ice_area_local(const Geometry &geometry, double thickness_threshold);
+double ice_volume_not_displacing_seawater_local(const Geometry &geometry,
+                                                double thickness_threshold);
+double sea_level_rise_potential_local(const Geometry &geometry, double thickness_threshold);
+
 void set_no_model_strip(const Grid &grid, double width, array::Scalar &result);
 
 } // end of namespace pism
@@ -22,6 +22,7 @@
 #include "pism/util/Grid.hh"
 #include "pism/util/Mask.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/GhostUpdate.hh"
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/array/Staggered.hh"
 #include "pism/util/array/Vector.hh"
@@ -254,12 +255,16 @@ void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
 
   profiling().begin("ge.update_ghosted_copies");
   {
-    // make ghosted copies of input fields
-    m_impl->ice_thickness.copy_from(geometry.ice_thickness);
-    m_impl->area_specific_volume.copy_from(geometry.ice_area_specific_volume);
-    m_impl->sea_level.copy_from(geometry.sea_level_elevation);
-    m_impl->bed_elevation.copy_from(geometry.bed_elevation);
-    m_impl->input_velocity.copy_from(advective_velocity);
+    // make ghosted copies of input fields, updating all their ghosts at once
+    m_impl->ice_thickness.copy_from(geometry.ice_thickness, false);
+    m_impl->area_specific_volume.copy_from(geometry.ice_area_specific_volume, false);
+    m_impl->sea_level.copy_from(geometry.sea_level_elevation, false);
+    m_impl->bed_elevation.copy_from(geometry.bed_elevation, false);
+    m_impl->input_velocity.copy_from(advective_velocity, false);
+
+    array::update_ghosts({ &m_impl->ice_thickness, &m_impl->area_specific_volume,
+                           &m_impl->sea_level, &m_impl->bed_elevation,
+                           &m_impl->input_velocity });
 
     // Compute cell_type and surface_elevation. Ghosts of results are updated.
     m_impl->gc.compute(m_impl->sea_level,          // in (uses ghosts)
@@ -1299,6 +1304,12 @@ void ice_flow_rate_across_grounding_line(const array::CellType1 &cell_type,
 double total_grounding_line_flux(const array::CellType1 &cell_type,
                                  const array::Staggered1 &flux,
                                  double dt) {
+  return GlobalSum(cell_type.grid()->com, total_grounding_line_flux_local(cell_type, flux, dt));
+}
+
+double total_grounding_line_flux_local(const array::CellType1 &cell_type,
+                                       const array::Staggered1 &flux,
+                                       double dt) {
   auto grid = cell_type.grid();
 
   const double
@@ -1334,7 +1345,7 @@ double total_grounding_line_flux(const array::CellType1 &cell_type,
   }
   loop.check();
 
-  return GlobalSum(grid->com, total_flux);
+  return total_flux;
 }
 
 } // end of namespace pism
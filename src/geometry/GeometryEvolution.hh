@@ -174,6 +174,14 @@ void ice_flow_rate_across_grounding_line(const array::CellType1 &cell_type,
 double total_grounding_line_flux(const array::CellType1 &cell_type,
                                  const array::Staggered1 &flux,
                                  double dt);
+
+/*!
+ * Compute the grounding line flux in the sub-domain owned by this process over a time
+ * step, in kg.
+ */
+double total_grounding_line_flux_local(const array::CellType1 &cell_type,
+                                       const array::Staggered1 &flux,
+                                       double dt);
 } // end of namespace pism
 
 #endif /* GEOMETRYEVOLUTION_H */
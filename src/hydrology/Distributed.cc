@@ -17,10 +17,13 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <algorithm> // std::min, std::max
+#include <cmath>     // std::ceil
 
 #include "pism/geometry/Geometry.hh"
 #include "pism/hydrology/Distributed.hh"
+#include "pism/pism_parameters.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/GhostUpdate.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
 #include "pism/util/pism_utilities.hh"
@@ -28,6 +31,63 @@
 namespace pism {
 namespace hydrology {
 
+namespace {
+
+/*!
+ * Solve
+ *
+ * f(P) = P - C (P_o - P)^n - b = 0
+ *
+ * for P in [0, P_o]. Since f is increasing on this interval, the solution of the problem
+ * with the constraint 0 <= P <= P_o is 0 if f(0) >= 0 and P_o if f(P_o) <= 0.
+ *
+ * Uses Newton's method safeguarded by bisection.
+ */
+double implicit_pressure(double b, double C, double n, double P_o) {
+  if (b + C * pow(P_o, n) <= 0.0) {
+    return 0.0;
+  }
+
+  if (b >= P_o) {
+    return P_o;
+  }
+
+  // the solution is in (a, z)
+  double
+    a = 0.0,
+    z = P_o,
+    P = b > 0.0 ? b : 0.5 * P_o;
+
+  const int max_iterations = 50;
+  const double tolerance = 1e-10 * P_o;
+
+  for (int k = 0; k < max_iterations; ++k) {
+    double
+      f  = P - C * pow(P_o - P, n) - b,
+      df = 1.0 + C * n * pow(P_o - P, n - 1.0);
+
+    if (f > 0.0) {
+      z = P;
+    } else {
+      a = P;
+    }
+
+    double P_next = P - f / df;
+    if (not (P_next > a and P_next < z)) {
+      P_next = 0.5 * (a + z);
+    }
+
+    if (std::abs(P_next - P) <= tolerance) {
+      return P_next;
+    }
+    P = P_next;
+  }
+
+  return P;
+}
+
+} // namespace
+
 Distributed::Distributed(std::shared_ptr<const Grid> g)
     : Routing(g), m_P(m_grid, "bwp"), m_Pnew(m_grid, "Pnew_internal") {
 
@@ -41,11 +101,26 @@ Distributed::Distributed(std::shared_ptr<const Grid> g)
       .long_name("new transportable subglacial water pressure during update")
       .units("Pa");
   m_Pnew.metadata()["valid_min"] = { 0.0 };
+
+  // Check valid ranges of parameters used during time steps. (Time-stepping code uses
+  // Config::parameters() and does not do this.)
+  for (const auto *name : { "stress_balance.sia.Glen_exponent",
+                            "flow_law.isothermal_Glen.ice_softness",
+                            "hydrology.cavitation_opening_coefficient",
+                            "hydrology.creep_closure_coefficient",
+                            "hydrology.roughness_scale",
+                            "hydrology.regularizing_porosity" }) {
+    m_config->get_number(name);
+  }
 }
 
 void Distributed::initialization_message() const {
   m_log->message(2,
                  "* Initializing the distributed, linked-cavities subglacial hydrology model...\n");
+
+  if (m_implicit) {
+    m_log->message(2, "  ... using implicit time stepping.\n");
+  }
 }
 
 void Distributed::restart_impl(const File &input_file, int record) {
@@ -225,13 +300,15 @@ void Distributed::update_P(double dt,
                            const array::Staggered1 &Q,
                            array::Scalar &P_new) const {
 
+  const auto &params = m_config->parameters();
+
   const double
-    n    = m_config->get_number("stress_balance.sia.Glen_exponent"),
-    A    = m_config->get_number("flow_law.isothermal_Glen.ice_softness"),
-    c1   = m_config->get_number("hydrology.cavitation_opening_coefficient"),
-    c2   = m_config->get_number("hydrology.creep_closure_coefficient"),
-    Wr   = m_config->get_number("hydrology.roughness_scale"),
-    phi0 = m_config->get_number("hydrology.regularizing_porosity");
+    n    = params.stress_balance.sia.Glen_exponent,
+    A    = params.flow_law.isothermal_Glen.ice_softness,
+    c1   = params.hydrology.cavitation_opening_coefficient,
+    c2   = params.hydrology.creep_closure_coefficient,
+    Wr   = params.hydrology.roughness_scale,
+    phi0 = params.hydrology.regularizing_porosity;
 
   // update Pnew from time step
   const double
@@ -291,6 +368,74 @@ void Distributed::update_P(double dt,
 }
 
 
+//! Point-wise implicit update of the water pressure.
+/*!
+  Uses the same equation as update_P(), but with the creep closure term evaluated at the
+  new pressure and the divergence of the water flux corresponding to the new water
+  thickness `W_new` (computed by update_W_implicit(); `flow_change` is its contribution
+  to the change in W during this step).
+
+  Because all other terms are known, this requires solving one scalar equation at each
+  grid point (see implicit_pressure()) and is not limited by the stability condition
+  used by max_timestep_P_diff().
+*/
+void Distributed::update_P_implicit(double dt,
+                                    const array::CellType &cell_type,
+                                    const array::Scalar &sliding_speed,
+                                    const array::Scalar &surface_input_rate,
+                                    const array::Scalar &basal_melt_rate,
+                                    const array::Scalar &P_overburden,
+                                    const array::Scalar &Wtill,
+                                    const array::Scalar &Wtill_new,
+                                    const array::Scalar &P,
+                                    const array::Scalar &W_new,
+                                    const array::Scalar &flow_change,
+                                    array::Scalar &P_new) const {
+
+  const auto &params = m_config->parameters();
+
+  const double
+    n    = params.stress_balance.sia.Glen_exponent,
+    A    = params.flow_law.isothermal_Glen.ice_softness,
+    c1   = params.hydrology.cavitation_opening_coefficient,
+    c2   = params.hydrology.creep_closure_coefficient,
+    Wr   = params.hydrology.roughness_scale,
+    phi0 = params.hydrology.regularizing_porosity;
+
+  const double CC = (m_rg * dt) / phi0;
+
+  array::AccessScope list{&P, &W_new, &Wtill, &Wtill_new, &sliding_speed, &flow_change,
+                          &surface_input_rate, &basal_melt_rate, &cell_type,
+                          &P_overburden, &P_new};
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    double
+      W   = W_new(i, j),
+      P_o = P_overburden(i, j);
+
+    if (cell_type.ice_free_land(i, j)) {
+      P_new(i, j) = 0.0;
+    } else if (cell_type.ocean(i, j)) {
+      P_new(i, j) = P_o;
+    } else if (W <= 0.0) {
+      P_new(i, j) = P_o;
+    } else {
+      double Open = c1 * sliding_speed(i, j) * std::max(0.0, Wr - W);
+
+      double Wtill_change = Wtill_new(i, j) - Wtill(i, j);
+      double total_input = surface_input_rate(i, j) + basal_melt_rate(i, j);
+
+      // all terms except for creep closure
+      double b = P(i, j) + CC * (flow_change(i, j) / dt - Open + total_input - Wtill_change / dt);
+
+      P_new(i, j) = implicit_pressure(b, CC * c2 * A * W, n, P_o);
+    }
+  } // end of the loop over grid points
+}
+
+
 //! Update the model state variables W,P by running the subglacial hydrology model.
 /*!
   Runs the hydrology model from time t to time t + dt.  Here [t,dt]
@@ -305,17 +450,22 @@ void Distributed::update_impl(double t, double dt, const Inputs& inputs) {
     ht  = t,
     hdt = 0.0;
 
+  const auto &hydrology = m_config->parameters().hydrology;
+
   const double
     t_final     = t + dt,
-    dt_max      = m_config->get_number("hydrology.maximum_time_step", "seconds"),
-    phi0        = m_config->get_number("hydrology.regularizing_porosity"),
-    tillwat_max = m_config->get_number("hydrology.tillwat_max");
+    dt_max      = hydrology.maximum_time_step, // seconds
+    phi0        = hydrology.regularizing_porosity,
+    tillwat_max = hydrology.tillwat_max;
 
   m_Qstag_average.set(0.0);
+  m_implicit_stats = { 0, 0, 0, 0, 0.0 };
 
   // make sure W,P have valid ghosts before starting hydrology steps
-  m_W.update_ghosts();
-  m_P.update_ghosts();
+  array::update_ghosts({ &m_W, &m_P });
+
+  // used to update ghosts of staggered grid fields in one go
+  array::GhostUpdate ghosts{ &m_Wstag, &m_Kstag, &m_Qstag };
 
   unsigned int step_counter = 0;
   for (; ht < t_final; ht += hdt) {
@@ -353,7 +503,14 @@ void Distributed::update_impl(double t, double dt, const Inputs& inputs) {
     // to get Q, W needs valid ghosts
     advective_fluxes(m_Vstag, m_W, m_Qstag);
 
-    m_Qstag_average.add(hdt, m_Qstag);
+    // update_P() and update_W() need ghosts of m_Wstag, m_Kstag and m_Qstag: communicate
+    // while computing the time step and updating till water
+    ghosts.begin();
+
+    // ghosts of m_Qstag_average are updated after the loop
+    if (not m_implicit) {
+      m_Qstag_average.add(hdt, m_Qstag);
+    }
 
     {
       const double
@@ -362,9 +519,14 @@ void Distributed::update_impl(double t, double dt, const Inputs& inputs) {
         dt_diff_p = max_timestep_P_diff(phi0, dt_diff_w);
 
       hdt = std::min(t_final - ht, dt_max);
-      hdt = std::min(hdt, dt_cfl);
-      hdt = std::min(hdt, dt_diff_w);
-      hdt = std::min(hdt, dt_diff_p);
+      if (m_implicit) {
+        double dt_explicit = std::min(dt_cfl, std::min(dt_diff_w, dt_diff_p));
+        m_implicit_stats.explicit_steps += std::ceil(hdt / dt_explicit);
+      } else {
+        hdt = std::min(hdt, dt_cfl);
+        hdt = std::min(hdt, dt_diff_w);
+        hdt = std::min(hdt, dt_diff_p);
+      }
     }
 
     m_log->message(3, "  hydrology step %05d, dt = %f s\n", step_counter, hdt);
@@ -386,26 +548,54 @@ void Distributed::update_impl(double t, double dt, const Inputs& inputs) {
                    m_conservation_error_change,
                    m_no_model_mask_change);
 
-    update_P(hdt,
-             inputs.geometry->cell_type,
-             *inputs.ice_sliding_speed,
-             m_surface_input_rate,
-             m_basal_melt_rate,
-             m_Pover,
-             m_Wtill, m_Wtillnew,
-             subglacial_water_pressure(),
-             m_W, m_Wstag,
-             m_Kstag, m_Qstag,
-             m_Pnew);
-
-    // update Wnew from W, Wtill, Wtillnew, Wstag, Q, input_rate
-    update_W(hdt,
-             m_surface_input_rate,
-             m_basal_melt_rate,
-             m_W, m_Wstag,
-             m_Wtill, m_Wtillnew,
-             m_Kstag, m_Qstag,
-             m_Wnew);
+    ghosts.end();
+
+    if (m_implicit) {
+      // update Wnew using P from the beginning of the step, then update Pnew using Wnew
+      update_W_implicit(hdt,
+                        inputs.geometry->cell_type,
+                        inputs.no_model_mask,
+                        subglacial_water_pressure(),
+                        m_surface_input_rate,
+                        m_basal_melt_rate,
+                        m_W,
+                        m_Wtill, m_Wtillnew,
+                        m_Wnew);
+      m_Qstag_average.add(hdt, m_Qstag);
+
+      update_P_implicit(hdt,
+                        inputs.geometry->cell_type,
+                        *inputs.ice_sliding_speed,
+                        m_surface_input_rate,
+                        m_basal_melt_rate,
+                        m_Pover,
+                        m_Wtill, m_Wtillnew,
+                        subglacial_water_pressure(),
+                        m_Wnew,
+                        m_flow_change_incremental,
+                        m_Pnew);
+    } else {
+      update_P(hdt,
+               inputs.geometry->cell_type,
+               *inputs.ice_sliding_speed,
+               m_surface_input_rate,
+               m_basal_melt_rate,
+               m_Pover,
+               m_Wtill, m_Wtillnew,
+               subglacial_water_pressure(),
+               m_W, m_Wstag,
+               m_Kstag, m_Qstag,
+               m_Pnew);
+
+      // update Wnew from W, Wtill, Wtillnew, Wstag, Q, input_rate
+      update_W(hdt,
+               m_surface_input_rate,
+               m_basal_melt_rate,
+               m_W, m_Wstag,
+               m_Wtill, m_Wtillnew,
+               m_Kstag, m_Qstag,
+               m_Wnew);
+    }
     // remove water in ice-free areas and account for changes
     enforce_bounds(inputs.geometry->cell_type,
                    inputs.no_model_mask,
@@ -423,8 +613,10 @@ void Distributed::update_impl(double t, double dt, const Inputs& inputs) {
     m_P.copy_from(m_Pnew);
   } // end of the time-stepping loop
 
+  m_Qstag_average.update_ghosts();
+
   staggered_to_regular(inputs.geometry->cell_type, m_Qstag_average,
-                       m_config->get_flag("hydrology.routing.include_floating_ice"),
+                       hydrology.routing.include_floating_ice,
                        m_Q);
   m_Q.scale(1.0 / dt);
 
@@ -433,6 +625,10 @@ void Distributed::update_impl(double t, double dt, const Inputs& inputs) {
                  step_counter,
                  units::convert(m_sys, dt/step_counter, "seconds", "years"),
                  dt/step_counter);
+
+  if (m_implicit) {
+    report_implicit_stats();
+  }
 }
 
 } // end of namespace hydrology
@@ -39,6 +39,10 @@ namespace hydrology {
   In addition to the actions within the null strip taken by hydrology::Routing,
   this model also sets the staggered grid values of the gradient of the hydraulic
   potential to zero if either regular grid neighbor is in the null strip.
+
+  With implicit time stepping (see `hydrology.time_stepping`) W is updated using backward
+  Euler with P lagged, followed by a point-wise implicit update of P (see
+  update_P_implicit()).
 */
 class Distributed : public Routing {
 public:
@@ -89,6 +93,19 @@ protected:
                 const array::Staggered1 &K,
                 const array::Staggered1 &Q,
                 array::Scalar &P_new) const;
+
+  void update_P_implicit(double dt,
+                         const array::CellType &cell_type,
+                         const array::Scalar &sliding_speed,
+                         const array::Scalar &surface_input_rate,
+                         const array::Scalar &basal_melt_rate,
+                         const array::Scalar &P_overburden,
+                         const array::Scalar &Wtill,
+                         const array::Scalar &Wtill_new,
+                         const array::Scalar &P,
+                         const array::Scalar &W_new,
+                         const array::Scalar &flow_change,
+                         array::Scalar &P_new) const;
 protected:
   array::Scalar1 m_P;
   array::Scalar m_Pnew;
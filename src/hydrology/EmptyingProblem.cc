@@ -234,11 +234,14 @@ void EmptyingProblem::update(const Geometry &geometry,
     }
     volume_0 = cell_area * GlobalSum(m_grid->com, volume_0);
   }
-  m_W.update_ghosts();
+  // compute_velocity() does not use m_W: update its ghosts in the meantime
+  m_W.begin_update_ghosts();
 
   // uses ghosts of m_potential and m_domain_mask, updates ghosts of m_Vstag
   compute_velocity(m_potential, m_domain_mask, m_Vstag);
 
+  m_W.end_update_ghosts();
+
   m_Qsum.set(0.0);
 
   // no input means no flux
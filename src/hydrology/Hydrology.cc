@@ -17,6 +17,7 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "pism/hydrology/Hydrology.hh"
+#include "pism/pism_parameters.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
 #include "pism/util/array/CellType.hh"
@@ -676,14 +677,16 @@ void Hydrology::enforce_bounds(const array::CellType &cell_type,
                                array::Scalar &conservation_error_change,
                                array::Scalar &no_model_mask_change) {
 
-  bool include_floating = m_config->get_flag("hydrology.routing.include_floating_ice");
+  const auto &params = m_config->parameters();
+
+  bool include_floating = params.hydrology.routing.include_floating_ice;
 
   array::AccessScope list{&water_thickness, &cell_type,
       &grounded_margin_change, &grounding_line_change, &conservation_error_change,
       &no_model_mask_change};
 
   double
-    fresh_water_density = m_config->get_number("constants.fresh_water.density"),
+    fresh_water_density = params.constants.fresh_water.density,
     kg_per_m            = m_grid->cell_area() * fresh_water_density; // kg m-1
 
   for (auto p = m_grid->points(); p; p.next()) {
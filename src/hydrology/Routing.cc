@@ -17,9 +17,14 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <cassert>
+#include <cmath>                // std::ceil
 
 #include "pism/hydrology/Routing.hh"
+#include "pism/pism_parameters.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/GhostUpdate.hh"
+#include "pism/util/array/Pool.hh"
+#include "pism/util/petscwrappers/DM.hh"
 
 #include "pism/util/error_handling.hh"
 
@@ -255,7 +260,8 @@ Routing::Routing(std::shared_ptr<const Grid> grid)
     m_R(grid, "potential_workspace"), /* box stencil used */
     m_dx(grid->dx()),
     m_dy(grid->dy()),
-    m_bottom_surface(grid, "ice_bottom_surface_elevation") {
+    m_bottom_surface(grid, "ice_bottom_surface_elevation"),
+    m_implicit_stats({ 0, 0, 0, 0, 0.0 }) {
 
   m_rg = (m_config->get_number("constants.fresh_water.density") *
           m_config->get_number("constants.standard_gravity"));
@@ -310,6 +316,42 @@ Routing::Routing(std::shared_ptr<const Grid> grid)
                          "hydrology::Routing: hydrology.tillwat_max is negative.\n"
                          "This is not allowed.");
     }
+
+    // Check valid ranges of parameters used during time steps. (Time-stepping code uses
+    // Config::parameters() and does not do this.)
+    m_config->get_number("hydrology.hydraulic_conductivity");
+    m_config->get_number("hydrology.gradient_power_in_flux");
+    m_config->get_number("hydrology.tillwat_decay_rate");
+    m_config->get_number("hydrology.maximum_time_step");
+    m_config->get_flag("hydrology.add_water_input_to_till_storage");
+  }
+
+  m_implicit = m_config->get_string("hydrology.time_stepping") == "implicit";
+
+  if (m_implicit) {
+    m_config->get_number("hydrology.implicit.max_iterations");
+    m_config->get_number("hydrology.implicit.relative_tolerance");
+
+    PetscErrorCode ierr;
+    ierr = DMSetMatType(*m_Wnew.dm(), MATAIJ);
+    PISM_CHK(ierr, "DMSetMatType");
+
+    ierr = DMCreateMatrix(*m_Wnew.dm(), m_A.rawptr());
+    PISM_CHK(ierr, "DMCreateMatrix");
+
+    ierr = KSPCreate(m_grid->com, m_KSP.rawptr());
+    PISM_CHK(ierr, "KSPCreate");
+
+    ierr = KSPSetOptionsPrefix(m_KSP, "hydrology_");
+    PISM_CHK(ierr, "KSPSetOptionsPrefix");
+
+    // use the latest Picard iterate as the initial guess
+    ierr = KSPSetInitialGuessNonzero(m_KSP, PETSC_TRUE);
+    PISM_CHK(ierr, "KSPSetInitialGuessNonzero");
+
+    // Process options:
+    ierr = KSPSetFromOptions(m_KSP);
+    PISM_CHK(ierr, "KSPSetFromOptions");
   }
 }
 
@@ -322,6 +364,10 @@ void Routing::initialization_message() const {
   } else {
     m_log->message(2, "  ... routing subglacial water under grounded ice only.\n");
   }
+
+  if (m_implicit) {
+    m_log->message(2, "  ... using implicit time stepping.\n");
+  }
 }
 
 void Routing::restart_impl(const File &input_file, int record) {
@@ -373,12 +419,14 @@ const array::Staggered& Routing::velocity_staggered() const {
 
 //! Average the regular grid water thickness to values at the center of cell edges.
 /*! Uses mask values to avoid averaging using water thickness values from
-  either ice-free or floating areas. */
+  either ice-free or floating areas.
+
+  Ghosts of `result` are not updated. */
 void Routing::water_thickness_staggered(const array::Scalar &W,
                                         const array::CellType1 &mask,
                                         array::Staggered &result) {
 
-  bool include_floating = m_config->get_flag("hydrology.routing.include_floating_ice");
+  bool include_floating = m_config->parameters().hydrology.routing.include_floating_ice;
 
   array::AccessScope list{ &mask, &W, &result };
 
@@ -413,8 +461,6 @@ void Routing::water_thickness_staggered(const array::Scalar &W,
       }
     }
   }
-
-  result.update_ghosts();
 }
 
 
@@ -432,16 +478,20 @@ void Routing::water_thickness_staggered(const array::Scalar &W,
   scheme. This requires \f$R\f$ to be defined on a box stencil of width 1.
 
   Also returns the maximum over all staggered points of \f$ K W \f$.
+
+  Uses values of `W` at owned points only. Ghosts of `result` are not updated.
 */
 void Routing::compute_conductivity(const array::Staggered &W,
                                    const array::Scalar &P,
                                    const array::Scalar &bed_elevation,
                                    array::Staggered &result,
                                    double &KW_max) const {
+  const auto &hydrology = m_config->parameters().hydrology;
+
   const double
-    k     = m_config->get_number("hydrology.hydraulic_conductivity"),
-    alpha = m_config->get_number("hydrology.thickness_power_in_flux"),
-    beta  = m_config->get_number("hydrology.gradient_power_in_flux"),
+    k     = hydrology.hydraulic_conductivity,
+    alpha = hydrology.thickness_power_in_flux,
+    beta  = hydrology.gradient_power_in_flux,
     betapow = (beta - 2.0) / 2.0;
 
   array::AccessScope list({&result, &W});
@@ -506,8 +556,6 @@ void Routing::compute_conductivity(const array::Staggered &W,
   }
 
   KW_max = GlobalMax(m_grid->com, KW_max);
-
-  result.update_ghosts();
 }
 
 
@@ -663,7 +711,8 @@ void Routing::compute_velocity(const array::Staggered &W,
 
 //! Compute Q = V W at edge-centers (staggered grid) by first-order upwinding.
 /*!
-  The field W must have valid ghost values, but V does not need them.
+  The field W must have valid ghost values, but V does not need them. Ghosts of `result`
+  are not updated.
 
   FIXME:  This could be re-implemented using the Koren (1993) flux-limiter.
 */
@@ -680,8 +729,6 @@ void Routing::advective_fluxes(const array::Staggered &V,
     result(i, j, 0) = V(i, j, 0) * (V(i, j, 0) >= 0.0 ? W(i, j) :  W(i + 1, j));
     result(i, j, 1) = V(i, j, 1) * (V(i, j, 1) >= 0.0 ? W(i, j) :  W(i, j + 1));
   }
-
-  result.update_ghosts();
 }
 
 /*!
@@ -732,13 +779,15 @@ void Routing::update_Wtill(double dt,
                            const array::Scalar &surface_input_rate,
                            const array::Scalar &basal_melt_rate,
                            array::Scalar &Wtill_new) {
+  const auto &hydrology = m_config->parameters().hydrology;
+
   const double
-    tillwat_max = m_config->get_number("hydrology.tillwat_max"),
-    C           = m_config->get_number("hydrology.tillwat_decay_rate", "m / second");
+    tillwat_max = hydrology.tillwat_max,
+    C           = hydrology.tillwat_decay_rate; // m / second
 
   array::AccessScope list{&Wtill, &Wtill_new, &basal_melt_rate};
 
-  bool add_surface_input = m_config->get_flag("hydrology.add_water_input_to_till_storage");
+  bool add_surface_input = hydrology.add_water_input_to_till_storage;
   if (add_surface_input) {
     list.add(surface_input_rate);
   }
@@ -823,6 +872,256 @@ void Routing::update_W(double dt,
   m_input_change.add(dt, basal_melt_rate);
 }
 
+//! Assemble the matrix of a backward Euler step for the water thickness equation.
+/*!
+  Uses the spatial discretization of W_change_due_to_flow() (first-order upwinding of
+  the advective flux and centered differences for the diffusive flux) with *lagged*
+  coefficients: `Wstag`, `K` and `V` are computed using the latest Picard iterate. The
+  resulting matrix is strictly diagonally dominant by columns and its off-diagonal
+  entries are non-positive (i.e. it is an M-matrix), so the solution is non-negative if
+  the right hand side is.
+
+  Uses ghosts of `Wstag`, `K` and `V`.
+*/
+void Routing::assemble_W_matrix(double dt,
+                                const array::Staggered1 &Wstag,
+                                const array::Staggered1 &K,
+                                const array::Staggered1 &V,
+                                Mat A) const {
+  PetscErrorCode ierr = 0;
+
+  const double
+    wux = 1.0 / (m_dx * m_dx),
+    wuy = 1.0 / (m_dy * m_dy);
+
+  const int
+    nrow = 1,
+    ncol = 5;
+
+  ierr = MatZeroEntries(A); PISM_CHK(ierr, "MatZeroEntries");
+
+  array::AccessScope list{&Wstag, &K, &V};
+
+  ParallelSection loop(m_grid->com);
+  try {
+    MatStencil row, col[ncol];
+    row.c = 0;
+
+    for (int m = 0; m < ncol; m++) {
+      col[m].c = 0;
+    }
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      /* Order of grid points in the stencil:
+       *
+       *   0
+       * 1 2 3
+       *   4
+       */
+      const int I[] = {i, i - 1,  i,  i + 1, i};
+      const int J[] = {j + 1, j,  j,  j, j - 1};
+
+      row.i = i;
+      row.j = j;
+
+      for (int m = 0; m < ncol; m++) {
+        col[m].i = I[m];
+        col[m].j = J[m];
+      }
+
+      auto v  = V.star(i, j);
+      auto k  = K.star(i, j);
+      auto ws = Wstag.star(i, j);
+
+      const double
+        De = m_rg * k.e * ws.e,
+        Dw = m_rg * k.w * ws.w,
+        Dn = m_rg * k.n * ws.n,
+        Ds = m_rg * k.s * ws.s;
+
+      // upwinding: the flux through the eastern face is V_e W_c if V_e >= 0 and V_e W_e
+      // otherwise, etc.
+      double L[ncol] = {
+        dt * (std::min(v.n, 0.0) / m_dy - wuy * Dn),
+        dt * (-std::max(v.w, 0.0) / m_dx - wux * Dw),
+        1.0 + dt * ((std::max(v.e, 0.0) - std::min(v.w, 0.0)) / m_dx +
+                    (std::max(v.n, 0.0) - std::min(v.s, 0.0)) / m_dy +
+                    wux * (De + Dw) + wuy * (Dn + Ds)),
+        dt * (std::min(v.e, 0.0) / m_dx - wux * De),
+        dt * (-std::max(v.s, 0.0) / m_dy - wuy * Ds)
+      };
+
+      ierr = MatSetValuesStencil(A, nrow, &row, ncol, col, L, INSERT_VALUES);
+      PISM_CHK(ierr, "MatSetValuesStencil");
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY); PISM_CHK(ierr, "MatAssemblyBegin");
+  ierr = MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY); PISM_CHK(ierr, "MatAssemblyEnd");
+}
+
+//! The implicit computation of Wnew, called by update().
+/*!
+  Takes a backward Euler step
+
+  \f[ W^{n+1} - \Delta t\, \left( - \nabla\cdot(\mathbf{V} W^{n+1}) + \nabla\cdot(D \nabla W^{n+1}) \right) = W^{n} + \Delta t\, \frac{m}{\rho_w} - \Delta W_{till}, \f]
+
+  where the nonlinear coefficients \f$\mathbf{V}\f$ and \f$D = \rho_w g K W\f$ are
+  updated using Picard iterations. Each iteration solves a linear system using PETSc's
+  KSP (use options with the prefix `-hydrology_` to choose the solver). Iterations stop
+  when the maximum norm of the change in W is below `hydrology.implicit.relative_tolerance`
+  times the maximum norm of W or after `hydrology.implicit.max_iterations` iterations. In
+  the latter case the last iterate is used.
+
+  Expects `m_Wstag`, `m_Kstag` and `m_Vstag` computed using `W` and `P` (with valid
+  ghosts for `m_Wstag` and `m_Kstag`). Updates `m_Qstag` to contain advective fluxes
+  corresponding to `W_new`. Ghosts of `m_Qstag` are not updated.
+*/
+void Routing::update_W_implicit(double dt,
+                                const array::CellType1  &cell_type,
+                                const array::Scalar1    *no_model_mask,
+                                const array::Scalar     &P,
+                                const array::Scalar     &surface_input_rate,
+                                const array::Scalar     &basal_melt_rate,
+                                const array::Scalar     &W,
+                                const array::Scalar     &Wtill,
+                                const array::Scalar     &Wtill_new,
+                                array::Scalar           &W_new) {
+  const auto &hydrology = m_config->parameters().hydrology;
+
+  const int max_iterations = hydrology.implicit.max_iterations;
+  const double tolerance = hydrology.implicit.relative_tolerance;
+
+  auto rhs = array::pooled<array::Scalar>(m_grid, "W_rhs");
+  auto W_k = array::pooled<array::Scalar1>(m_grid, "W_iterate");
+
+  {
+    array::AccessScope list{&W, &Wtill, &Wtill_new, &surface_input_rate,
+                            &basal_melt_rate, rhs.get()};
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      double input_rate = surface_input_rate(i, j) + basal_melt_rate(i, j);
+
+      double Wtill_change = Wtill_new(i, j) - Wtill(i, j);
+      (*rhs)(i, j) = W(i, j) + (dt * input_rate - Wtill_change);
+    }
+  }
+
+  W_k->copy_from(W);
+
+  m_Vstag.update_ghosts();
+
+  PetscErrorCode ierr = 0;
+
+  bool converged = false;
+  for (int k = 0; k < max_iterations and not converged; ++k) {
+    if (k > 0) {
+      // update coefficients using the latest iterate
+      water_thickness_staggered(*W_k, cell_type, m_Wstag);
+
+      double KW_max = 0.0;
+      compute_conductivity(m_Wstag, P, m_bottom_surface, m_Kstag, KW_max);
+
+      compute_velocity(m_Wstag, P, m_bottom_surface, m_Kstag, no_model_mask, m_Vstag);
+
+      array::update_ghosts({ &m_Wstag, &m_Kstag, &m_Vstag });
+    }
+
+    assemble_W_matrix(dt, m_Wstag, m_Kstag, m_Vstag, m_A);
+
+    // initial guess
+    W_new.copy_from(*W_k);
+
+    ierr = KSPSetOperators(m_KSP, m_A, m_A);
+    PISM_CHK(ierr, "KSPSetOperators");
+
+    ierr = KSPSolve(m_KSP, rhs->vec(), W_new.vec());
+    PISM_CHK(ierr, "KSPSolve");
+
+    KSPConvergedReason reason;
+    ierr = KSPGetConvergedReason(m_KSP, &reason);
+    PISM_CHK(ierr, "KSPGetConvergedReason");
+
+    if (reason < 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "KSP iteration failed while updating water thickness: %s",
+                                    KSPConvergedReasons[reason]);
+    }
+
+    PetscInt ksp_iterations = 0;
+    ierr = KSPGetIterationNumber(m_KSP, &ksp_iterations);
+    PISM_CHK(ierr, "KSPGetIterationNumber");
+
+    m_implicit_stats.ksp_iterations += ksp_iterations;
+    m_implicit_stats.picard_iterations += 1;
+
+    // compute the change and use W_new as the next iterate
+    {
+      double local[2] = { 0.0, 0.0 }, global[2];
+
+      array::AccessScope list{W_k.get(), &W_new};
+
+      for (auto p = m_grid->points(); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        local[0] = std::max(local[0], std::abs(W_new(i, j) - (*W_k)(i, j)));
+        local[1] = std::max(local[1], std::abs(W_new(i, j)));
+
+        // the conductivity is not defined for negative thicknesses
+        (*W_k)(i, j) = std::max(W_new(i, j), 0.0);
+      }
+      W_k->update_ghosts();
+
+      GlobalMax(m_grid->com, local, global, 2);
+
+      converged = global[0] <= tolerance * global[1];
+    }
+  }
+
+  if (not converged) {
+    m_implicit_stats.not_converged += 1;
+    m_log->message(3, "  Picard iterations did not converge in %d iterations\n",
+                   max_iterations);
+  }
+
+  // advective fluxes corresponding to W_new
+  advective_fluxes(m_Vstag, *W_k, m_Qstag);
+
+  {
+    array::AccessScope list{rhs.get(), &W_new, &m_flow_change_incremental};
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      m_flow_change_incremental(i, j) = W_new(i, j) - (*rhs)(i, j);
+    }
+  }
+
+  m_flow_change.add(1.0, m_flow_change_incremental);
+  m_input_change.add(dt, surface_input_rate);
+  m_input_change.add(dt, basal_melt_rate);
+
+  m_implicit_stats.steps += 1;
+}
+
+//! Report the number of implicit steps, solver iterations and explicit sub-steps avoided.
+void Routing::report_implicit_stats() const {
+  const auto &s = m_implicit_stats;
+
+  m_log->message(2,
+                 "  took %d implicit hydrology steps (explicit: ~%.0f sub-steps) using\n"
+                 "  %d Picard iterations (%d steps did not converge) and %d KSP iterations\n",
+                 s.steps, s.explicit_steps, s.picard_iterations, s.not_converged,
+                 s.ksp_iterations);
+}
+
 //! Update the model state variables W and Wtill by applying the subglacial hydrology model equations.
 /*!
   Runs the hydrology model from time t to time t + dt.  Here [t, dt]
@@ -831,6 +1130,9 @@ void Routing::update_W(double dt,
 
   To update W = `bwat` we call update_W(), and to update Wtill = `tillwat` we
   call update_Wtill().
+
+  If `hydrology.time_stepping` is "implicit" we call update_W_implicit() instead and take
+  steps limited by `hydrology.maximum_time_step` only.
 */
 void Routing::update_impl(double t, double dt, const Inputs& inputs) {
 
@@ -840,16 +1142,22 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
     ht  = t,
     hdt = 0.0;
 
+  const auto &hydrology = m_config->parameters().hydrology;
+
   const double
     t_final     = t + dt,
-    dt_max      = m_config->get_number("hydrology.maximum_time_step", "seconds"),
-    tillwat_max = m_config->get_number("hydrology.tillwat_max");
+    dt_max      = hydrology.maximum_time_step, // seconds
+    tillwat_max = hydrology.tillwat_max;
 
   m_Qstag_average.set(0.0);
+  m_implicit_stats = { 0, 0, 0, 0, 0.0 };
 
   // make sure W has valid ghosts before starting hydrology steps
   m_W.update_ghosts();
 
+  // used to update ghosts of staggered grid fields in one go
+  array::GhostUpdate ghosts{ &m_Wstag, &m_Kstag, &m_Qstag };
+
   unsigned int step_counter = 0;
   for (; ht < t_final; ht += hdt) {
     step_counter++;
@@ -860,13 +1168,11 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
     check_bounds(m_Wtill, tillwat_max);
 #endif
 
-    // updates ghosts of m_Wstag
     water_thickness_staggered(m_W,
                               inputs.geometry->cell_type,
                               m_Wstag);
 
     double maxKW = 0.0;
-    // updates ghosts of m_Kstag
     profiling().begin("routing_conductivity");
     compute_conductivity(m_Wstag,
                          subglacial_water_pressure(),
@@ -885,12 +1191,18 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
     profiling().end("routing_velocity");
 
     // to get Q, W needs valid ghosts (ghosts of m_Vstag are not used)
-    // updates ghosts of m_Qstag
     profiling().begin("routing_flux");
     advective_fluxes(m_Vstag, m_W, m_Qstag);
     profiling().end("routing_flux");
 
-    m_Qstag_average.add(hdt, m_Qstag);
+    // update_W() needs ghosts of m_Wstag, m_Kstag and m_Qstag: communicate while
+    // computing the time step and updating till water
+    ghosts.begin();
+
+    // ghosts of m_Qstag_average are updated after the loop
+    if (not m_implicit) {
+      m_Qstag_average.add(hdt, m_Qstag);
+    }
 
     {
       const double
@@ -898,8 +1210,12 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
         dt_diff_w = max_timestep_W_diff(maxKW);
 
       hdt = std::min(t_final - ht, dt_max);
-      hdt = std::min(hdt, dt_cfl);
-      hdt = std::min(hdt, dt_diff_w);
+      if (m_implicit) {
+        m_implicit_stats.explicit_steps += std::ceil(hdt / std::min(dt_cfl, dt_diff_w));
+      } else {
+        hdt = std::min(hdt, dt_cfl);
+        hdt = std::min(hdt, dt_diff_w);
+      }
     }
 
     m_log->message(3, "  hydrology step %05d, dt = %f s\n", step_counter, hdt);
@@ -925,17 +1241,32 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
       profiling().end("routing_Wtill");
     }
 
+    ghosts.end();
+
     // update Wnew from W, Wtill, Wtillnew, Wstag, Q, input_rate
     // uses ghosts of m_W, m_Wstag, m_Qstag, m_Kstag
     {
       profiling().begin("routing_W");
-      update_W(hdt,
-               m_surface_input_rate,
-               m_basal_melt_rate,
-               m_W, m_Wstag,
-               m_Wtill, m_Wtillnew,
-               m_Kstag, m_Qstag,
-               m_Wnew);
+      if (m_implicit) {
+        update_W_implicit(hdt,
+                          inputs.geometry->cell_type,
+                          inputs.no_model_mask,
+                          subglacial_water_pressure(),
+                          m_surface_input_rate,
+                          m_basal_melt_rate,
+                          m_W,
+                          m_Wtill, m_Wtillnew,
+                          m_Wnew);
+        m_Qstag_average.add(hdt, m_Qstag);
+      } else {
+        update_W(hdt,
+                 m_surface_input_rate,
+                 m_basal_melt_rate,
+                 m_W, m_Wstag,
+                 m_Wtill, m_Wtillnew,
+                 m_Kstag, m_Qstag,
+                 m_Wnew);
+      }
       // remove water in ice-free areas and account for changes
       enforce_bounds(inputs.geometry->cell_type,
                      inputs.no_model_mask,
@@ -956,8 +1287,10 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
     m_Wtill.copy_from(m_Wtillnew);
   } // end of the time-stepping loop
 
+  m_Qstag_average.update_ghosts();
+
   staggered_to_regular(inputs.geometry->cell_type, m_Qstag_average,
-                       m_config->get_flag("hydrology.routing.include_floating_ice"),
+                       hydrology.routing.include_floating_ice,
                        m_Q);
   m_Q.scale(1.0 / dt);
 
@@ -967,6 +1300,10 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
                  units::convert(m_sys, dt / step_counter, "seconds", "years"),
                  dt / step_counter,
                  (dt / step_counter) / 3600.0);
+
+  if (m_implicit) {
+    report_implicit_stats();
+  }
 }
 
 std::map<std::string, Diagnostic::Ptr> Routing::diagnostics_impl() const {
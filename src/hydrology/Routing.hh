@@ -21,6 +21,8 @@
 
 #include "pism/hydrology/Hydrology.hh"
 #include "pism/util/array/Staggered.hh"
+#include "pism/util/petscwrappers/KSP.hh"
+#include "pism/util/petscwrappers/Mat.hh"
 
 namespace pism {
 
@@ -77,6 +79,10 @@ namespace hydrology {
   conserving energy in the flowing ice.) See wall_melt(). At this time the wall melt is
   diagnostic only and does not add to the water amount W; such an addition is generally
   unstable.
+
+  Set `hydrology.time_stepping` to "implicit" to update W using backward Euler steps
+  limited by `hydrology.maximum_time_step` only (see update_W_implicit()) instead of
+  explicit sub-steps limited by CFL and diffusion stability conditions.
 */
 class Routing : public Hydrology {
 public:
@@ -114,8 +120,8 @@ protected:
 
   array::Staggered1 m_Qstag_average;
 
-  // edge-centered (staggered) water velocity
-  array::Staggered m_Vstag;
+  // edge-centered (staggered) water velocity; ghosts are used by the implicit scheme only
+  array::Staggered1 m_Vstag;
 
   // edge-centered (staggered) W values (averaged from regular)
   array::Staggered1 m_Wstag;
@@ -134,6 +140,27 @@ protected:
 
   array::Scalar1 m_bottom_surface;
 
+  // true if hydrology.time_stepping is "implicit"
+  bool m_implicit;
+
+  // matrix and solver used by the implicit water thickness update
+  petsc::Mat m_A;
+  petsc::KSP m_KSP;
+
+  //! Implicit time stepping statistics (reset at the beginning of update_impl())
+  struct ImplicitStats {
+    int steps;
+    int picard_iterations;
+    int ksp_iterations;
+    // number of steps with Picard iterations that did not converge
+    int not_converged;
+    // estimated number of explicit sub-steps needed to cover the same time interval
+    double explicit_steps;
+  };
+  ImplicitStats m_implicit_stats;
+
+  void report_implicit_stats() const;
+
   void water_thickness_staggered(const array::Scalar &W,
                                  const array::CellType1 &mask,
                                  array::Staggered &result);
@@ -172,6 +199,23 @@ protected:
                 const array::Staggered1 &Q,
                 array::Scalar           &W_new);
 
+  void assemble_W_matrix(double dt,
+                         const array::Staggered1 &Wstag,
+                         const array::Staggered1 &K,
+                         const array::Staggered1 &V,
+                         Mat A) const;
+
+  void update_W_implicit(double dt,
+                         const array::CellType1  &cell_type,
+                         const array::Scalar1    *no_model_mask,
+                         const array::Scalar     &P,
+                         const array::Scalar     &surface_input_rate,
+                         const array::Scalar     &basal_melt_rate,
+                         const array::Scalar     &W,
+                         const array::Scalar     &Wtill,
+                         const array::Scalar     &Wtill_new,
+                         array::Scalar           &W_new);
+
   void update_Wtill(double dt,
                     const array::Scalar &Wtill,
                     const array::Scalar &surface_input_rate,
@@ -46,7 +46,11 @@
 #include "pism/age/Isochrones.hh"
 #include "pism/energy/EnergyModel.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/io/AsyncWriter.hh"
+#include "pism/util/array/ActiveColumns.hh"
+#include "pism/util/array/Array3D.hh"
 #include "pism/util/array/Forcing.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/fracturedensity/FractureDensity.hh"
 #include "pism/coupler/util/options.hh" // ForcingOptions
 #include "pism/coupler/ocean/PyOceanModel.hh"
@@ -315,6 +319,8 @@ void IceModel::enforce_consistency_of_geometry(ConsistencyFlag flag) {
 
 stressbalance::Inputs IceModel::stress_balance_inputs() {
   stressbalance::Inputs result;
+  result.time = m_time->current();
+
   if (m_config->get_flag("geometry.update.use_basal_melt_rate")) {
     result.basal_melt_rate = &m_basal_melt_rate;
   }
@@ -481,6 +487,7 @@ void IceModel::step(bool do_mass_continuity,
     inputs.u3            = &m_stress_balance->velocity_u();
     inputs.v3            = &m_stress_balance->velocity_v();
     inputs.w3            = &m_stress_balance->velocity_w();
+    inputs.cell_type     = &m_geometry.cell_type;
 
     profiling.begin("age");
     m_age_model->update(current_time, dt_TempAge, inputs);
@@ -622,6 +629,10 @@ void IceModel::step(bool do_mass_continuity,
                          m_geometry_evolution->bottom_surface_mass_balance());
   }
 
+  // the 3D velocity and the strain heating are not needed until the next stress balance
+  // update
+  m_stress_balance->compact();
+
   //! \li update the state variables in the subglacial hydrology model (typically
   //!  water thickness and sometimes pressure)
   profiling.begin("basal_hydrology");
@@ -769,9 +780,7 @@ IceModelTerminationReason IceModel::run() {
   // This is needed to compute rates of change of the ice mass, volume, etc.
   {
     const double time = m_time->current();
-    for (const auto &d : m_ts_diagnostics) {
-      d.second->update(time, time);
-    }
+    update_timeseries(m_grid->com, m_ts_diagnostics, time, time);
   }
 
   m_log->message(2, "running forward ...\n");
@@ -826,6 +835,29 @@ IceModelTerminationReason IceModel::run() {
   } // end of the time-stepping loop
   profiling.stage_end("time-stepping loop");
 
+  if (m_async_writer) {
+    // wait for the last writes to finish and report errors (if any)
+    m_async_writer->wait();
+
+    m_log->message(2, "Time spent waiting for the asynchronous output: %.3f seconds.\n",
+                   m_async_writer->stall_time());
+  }
+
+  // report the distribution of active (icy and next to ice) columns among ranks
+  m_geometry.cell_type.active_columns().report(*m_log);
+
+  // report memory used by temporary arrays (diagnostics, etc)
+  m_grid->array_pool().report(*m_log);
+
+  // report memory used by 3D fields stored in single precision
+  array::report_storage(*m_log, { &m_energy_model->enthalpy(),
+                                  m_age_model ? &m_age_model->age() : nullptr,
+                                  &m_stress_balance->velocity_u(),
+                                  &m_stress_balance->velocity_v(),
+                                  &m_stress_balance->velocity_w(),
+                                  &m_stress_balance->volumetric_strain_heating(),
+                                  m_isochrones ? &m_isochrones->layer_thicknesses() : nullptr });
+
   return termination_reason;
 }
 
@@ -1033,9 +1065,7 @@ void IceModel::update_diagnostics(double dt) {
   }
 
   const double time = m_time->current();
-  for (const auto &d : m_ts_diagnostics) {
-    d.second->update(time - dt, time);
-  }
+  update_timeseries(m_grid->com, m_ts_diagnostics, time - dt, time);
 }
 
 /*!
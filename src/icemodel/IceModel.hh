@@ -103,6 +103,10 @@ class Forcing;
 class CellType;
 }
 
+namespace io {
+class AsyncWriter;
+}
+
 class Grid;
 class AgeModel;
 class Isochrones;
@@ -421,6 +425,11 @@ protected:
   // Set of variables to put in the output file:
   std::set<std::string> m_output_vars;
 
+  //! Background I/O thread used to write snapshots, spatial time-series and checkpoints
+  //! (null unless output.async.enabled is set).
+  std::shared_ptr<io::AsyncWriter> m_async_writer;
+  void init_async_output();
+
   // This is related to the snapshot saving feature
   std::string m_snapshots_filename;
   std::shared_ptr<File> m_snapshot_file;
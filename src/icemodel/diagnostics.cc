@@ -34,6 +34,7 @@
 #include "pism/util/EnthalpyConverter.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/util/projection.hh"
 
 #if (Pism_USE_PROJ == 1)
@@ -81,8 +82,7 @@ public:
 protected:
   std::shared_ptr<array::Array> compute_impl() const {
 
-    auto result        = std::make_shared<array::Scalar>(m_grid, "");
-    result->metadata() = m_vars[0];
+    auto result = allocate<array::Scalar>("");
 
     if (m_interval_length > 0.0) {
       double ice_density = m_config->get_number("constants.ice.density");
@@ -622,10 +622,12 @@ namespace pism {
 namespace details {
 enum IceKind {ICE_COLD, ICE_TEMPERATE};
 
-static double ice_volume(const array::Scalar &ice_thickness,
-                         const array::Array3D &ice_enthalpy,
-                         IceKind kind,
-                         double thickness_threshold) {
+//! Volume of cold or temperate (depending on `kind`) ice in the sub-domain owned by this
+//! process.
+static double ice_volume_local(const array::Scalar &ice_thickness,
+                               const array::Array3D &ice_enthalpy,
+                               IceKind kind,
+                               double thickness_threshold) {
 
   auto grid = ice_thickness.grid();
   auto ctx = grid->ctx();
@@ -683,13 +685,15 @@ static double ice_volume(const array::Scalar &ice_thickness,
   }
   loop.check();
 
-  return GlobalSum(grid->com, volume);
+  return volume;
 }
 
-static double base_area(const array::Scalar &ice_thickness,
-                        const array::Array3D &ice_enthalpy,
-                        IceKind kind,
-                        double thickness_threshold) {
+//! Area of the ice base in the sub-domain owned by this process that is cold or temperate
+//! (depending on `kind`).
+static double base_area_local(const array::Scalar &ice_thickness,
+                              const array::Array3D &ice_enthalpy,
+                              IceKind kind,
+                              double thickness_threshold) {
 
   auto grid = ice_thickness.grid();
   auto ctx = grid->ctx();
@@ -728,7 +732,7 @@ static double base_area(const array::Scalar &ice_thickness,
   }
   loop.check();
 
-  return GlobalSum(grid->com, area);
+  return area;
 }
 
 } // end of namespace details
@@ -770,6 +774,7 @@ std::shared_ptr<array::Array> IceMarginPressureDifference::compute_impl() const
   auto result = allocate<array::Scalar>("ice_margin_pressure_difference");
 
   array::CellType1 mask(m_grid, "mask");
+  mask.use_pool();
 
   const auto &H         = model->geometry().ice_thickness;
   const auto &bed       = model->geometry().bed_elevation;
@@ -919,8 +924,7 @@ std::shared_ptr<array::Array> HardnessAverage::compute_impl() const {
     }
   }
 
-  auto result        = std::make_shared<array::Scalar>(m_grid, "hardav");
-  result->metadata() = m_vars[0];
+  auto result = allocate<array::Scalar>("hardav");
 
   const auto &cell_type = model->geometry().cell_type;
 
@@ -970,8 +974,7 @@ Rank::Rank(const IceModel *m) : Diag<IceModel>(m) {
 
 std::shared_ptr<array::Array> Rank::compute_impl() const {
 
-  auto result        = std::make_shared<array::Scalar>(m_grid, "rank");
-  result->metadata() = m_vars[0];
+  auto result = allocate<array::Scalar>("rank");
 
   array::AccessScope list{ result.get() };
 
@@ -1087,7 +1090,7 @@ std::shared_ptr<array::Array> TemperaturePA::compute_impl() const {
   bool cold_mode = member(m_config->get_string("energy.model"), {"cold", "none"});
   double melting_point_temp = m_config->get_number("constants.fresh_water.melting_point_temperature");
 
-  auto result = std::make_shared<array::Array3D>(m_grid, "temp_pa", array::WITHOUT_GHOSTS, m_grid->z());
+  auto result = array::pooled<array::Array3D>(m_grid, "temp_pa", array::WITHOUT_GHOSTS, m_grid->z());
   result->metadata() = m_vars[0];
 
   const auto &thickness = model->geometry().ice_thickness;
@@ -1151,8 +1154,7 @@ std::shared_ptr<array::Array> TemperaturePABasal::compute_impl() const {
   bool cold_mode = member(m_config->get_string("energy.model"), {"cold", "none"});
   double melting_point_temp = m_config->get_number("constants.fresh_water.melting_point_temperature");
 
-  auto result = std::make_shared<array::Scalar>(m_grid, "temp_pa_base");
-  result->metadata() = m_vars[0];
+  auto result = allocate<array::Scalar>("temp_pa_base");
 
   const auto &thickness = model->geometry().ice_thickness;
   const auto &enthalpy = model->energy_balance_model()->enthalpy();
@@ -1207,8 +1209,7 @@ IceEnthalpySurface::IceEnthalpySurface(const IceModel *m)
 
 std::shared_ptr<array::Array> IceEnthalpySurface::compute_impl() const {
 
-  auto result = std::make_shared<array::Scalar>(m_grid, "enthalpysurf");
-  result->metadata() = m_vars[0];
+  auto result = allocate<array::Scalar>("enthalpysurf");
 
   // compute levels corresponding to 1 m below the ice surface:
 
@@ -1254,8 +1255,7 @@ IceEnthalpyBasal::IceEnthalpyBasal(const IceModel *m)
 
 std::shared_ptr<array::Array> IceEnthalpyBasal::compute_impl() const {
 
-  auto result = std::make_shared<array::Scalar>(m_grid, "enthalpybase");
-  result->metadata() = m_vars[0];
+  auto result = allocate<array::Scalar>("enthalpybase");
 
   extract_surface(model->energy_balance_model()->enthalpy(), 0.0, *result);  // z=0 slice
 
@@ -1603,13 +1603,15 @@ public:
   IceVolumeGlacierized(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of the ice in glacierized areas";
     m_variable["valid_min"] = { 0.0 };
   }
-  double compute() {
-    return ice_volume(model->geometry(),
-                      m_config->get_number("output.ice_free_thickness_standard"));
+  double compute_local() {
+    return ice_volume_local(model->geometry(),
+                            m_config->get_number("output.ice_free_thickness_standard"));
   }
 };
 
@@ -1618,13 +1620,15 @@ class IceVolume : public TSDiag<TSSnapshotDiagnostic, IceModel> {
 public:
   IceVolume(IceModel *m) : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of the ice, including seasonal cover";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
-    return ice_volume(model->geometry(), 0.0);
+  double compute_local() {
+    return ice_volume_local(model->geometry(), 0.0);
   }
 };
 
@@ -1634,14 +1638,16 @@ public:
   SeaLevelRisePotential(const IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "sea_level_rise_potential") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m", "m");
     m_variable["long_name"] = "the sea level rise that would result if all the ice were melted";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
-    return sea_level_rise_potential(model->geometry(),
-                                    m_config->get_number("output.ice_free_thickness_standard"));
+  double compute_local() {
+    return sea_level_rise_potential_local(model->geometry(),
+                                          m_config->get_number("output.ice_free_thickness_standard"));
   }
 };
 
@@ -1651,13 +1657,15 @@ public:
   IceVolumeRateOfChangeGlacierized(IceModel *m)
       : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_volume_glacierized") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3 s^-1", "m^3 year^-1");
     m_variable["long_name"] = "rate of change of the ice volume in glacierized areas";
   }
 
-  double compute() {
-    return ice_volume(model->geometry(),
-                      m_config->get_number("output.ice_free_thickness_standard"));
+  double compute_local() {
+    return ice_volume_local(model->geometry(),
+                            m_config->get_number("output.ice_free_thickness_standard"));
   }
 };
 
@@ -1667,12 +1675,14 @@ public:
   IceVolumeRateOfChange(IceModel *m)
       : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_volume") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3 s^-1", "m^3 year^-1");
     m_variable["long_name"] = "rate of change of the ice volume, including seasonal cover";
   }
 
-  double compute() {
-    return ice_volume(model->geometry(), 0.0);
+  double compute_local() {
+    return ice_volume_local(model->geometry(), 0.0);
   }
 };
 
@@ -1682,13 +1692,16 @@ public:
   IceAreaGlacierized(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^2", "m^2");
     m_variable["long_name"] = "glacierized area";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
-    return ice_area(model->geometry(), m_config->get_number("output.ice_free_thickness_standard"));
+  double compute_local() {
+    return ice_area_local(model->geometry(),
+                          m_config->get_number("output.ice_free_thickness_standard"));
   }
 };
 
@@ -1698,18 +1711,20 @@ public:
   IceMassNotDisplacingSeaWater(const IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "limnsw") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("kg", "kg");
     m_variable["long_name"]     = "mass of the ice not displacing sea water";
     m_variable["standard_name"] = "land_ice_mass_not_displacing_sea_water";
     m_variable["valid_min"]     = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
 
     const double thickness_standard = m_config->get_number("output.ice_free_thickness_standard"),
                  ice_density        = m_config->get_number("constants.ice.density"),
-                 ice_volume =
-                     ice_volume_not_displacing_seawater(model->geometry(), thickness_standard),
+                 ice_volume = ice_volume_not_displacing_seawater_local(model->geometry(),
+                                                                       thickness_standard),
                  ice_mass = ice_volume * ice_density;
 
     return ice_mass;
@@ -1722,15 +1737,17 @@ public:
   IceMassGlacierized(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_mass_glacierized") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("kg", "kg");
     m_variable["long_name"] = "mass of the ice in glacierized areas";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
     double ice_density        = m_config->get_number("constants.ice.density"),
            thickness_standard = m_config->get_number("output.ice_free_thickness_standard");
-    return ice_volume(model->geometry(), thickness_standard) * ice_density;
+    return ice_volume_local(model->geometry(), thickness_standard) * ice_density;
   }
 };
 
@@ -1739,6 +1756,8 @@ class IceMass : public TSDiag<TSSnapshotDiagnostic, IceModel> {
 public:
   IceMass(IceModel *m) : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_mass") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("lim");
     }
@@ -1749,8 +1768,8 @@ public:
     m_variable["valid_min"]     = { 0.0 };
   }
 
-  double compute() {
-    return (ice_volume(model->geometry(), 0.0) * m_config->get_number("constants.ice.density"));
+  double compute_local() {
+    return (ice_volume_local(model->geometry(), 0.0) * m_config->get_number("constants.ice.density"));
   }
 };
 
@@ -1760,14 +1779,16 @@ public:
   IceMassRateOfChangeGlacierized(IceModel *m)
       : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_mass_glacierized") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("kg s^-1", "Gt year^-1");
     m_variable["long_name"] = "rate of change of the ice mass in glacierized areas";
   }
 
-  double compute() {
+  double compute_local() {
     double ice_density         = m_config->get_number("constants.ice.density"),
            thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
-    return ice_volume(model->geometry(), thickness_threshold) * ice_density;
+    return ice_volume_local(model->geometry(), thickness_threshold) * ice_density;
   }
 };
 
@@ -1781,12 +1802,14 @@ public:
   IceMassRateOfChangeDueToFlow(IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_flow") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("kg s^-1", "Gt year^-1");
     m_variable["long_name"] = "rate of change of the mass of ice due to flow"
                               " (i.e. prescribed ice thickness)";
   }
 
-  double compute() {
+  double compute_local() {
 
     const double ice_density = m_config->get_number("constants.ice.density");
 
@@ -1805,7 +1828,7 @@ public:
     }
 
     // (kg/m^3) * m^3 = kg
-    return ice_density * GlobalSum(m_grid->com, volume_change);
+    return ice_density * volume_change;
   }
 };
 
@@ -1814,13 +1837,15 @@ class IceMassRateOfChange : public TSDiag<TSRateDiagnostic, IceModel> {
 public:
   IceMassRateOfChange(IceModel *m) : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_mass") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("kg s^-1", "Gt year^-1");
     m_variable["long_name"] = "rate of change of the mass of ice, including seasonal cover";
   }
 
-  double compute() {
+  double compute_local() {
     const double ice_density = m_config->get_number("constants.ice.density");
-    return ice_volume(model->geometry(), 0.0) * ice_density;
+    return ice_volume_local(model->geometry(), 0.0) * ice_density;
   }
 };
 
@@ -1831,16 +1856,18 @@ public:
   IceVolumeGlacierizedTemperate(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_temperate") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of temperate ice in glacierized areas";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
     auto thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
-    return details::ice_volume(model->geometry().ice_thickness,
-                               model->energy_balance_model()->enthalpy(), details::ICE_TEMPERATE,
-                               thickness_threshold);
+    return details::ice_volume_local(model->geometry().ice_thickness,
+                                     model->energy_balance_model()->enthalpy(),
+                                     details::ICE_TEMPERATE, thickness_threshold);
   }
 };
 
@@ -1850,15 +1877,17 @@ public:
   IceVolumeTemperate(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_temperate") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of temperate ice, including seasonal cover";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
-    return details::ice_volume(model->geometry().ice_thickness,
-                               model->energy_balance_model()->enthalpy(), details::ICE_TEMPERATE,
-                               0.0);
+  double compute_local() {
+    return details::ice_volume_local(model->geometry().ice_thickness,
+                                     model->energy_balance_model()->enthalpy(),
+                                     details::ICE_TEMPERATE, 0.0);
   }
 };
 
@@ -1868,16 +1897,18 @@ public:
   IceVolumeGlacierizedCold(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_cold") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of cold ice in glacierized areas";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
     auto thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
-    return details::ice_volume(model->geometry().ice_thickness,
-                               model->energy_balance_model()->enthalpy(), details::ICE_COLD,
-                               thickness_threshold);
+    return details::ice_volume_local(model->geometry().ice_thickness,
+                                     model->energy_balance_model()->enthalpy(),
+                                     details::ICE_COLD, thickness_threshold);
   }
 };
 
@@ -1886,15 +1917,17 @@ class IceVolumeCold : public TSDiag<TSSnapshotDiagnostic, IceModel> {
 public:
   IceVolumeCold(IceModel *m) : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_cold") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of cold ice, including seasonal cover";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
-    return details::ice_volume(model->geometry().ice_thickness,
-                               model->energy_balance_model()->enthalpy(), details::ICE_COLD,
-                               0.0);
+  double compute_local() {
+    return details::ice_volume_local(model->geometry().ice_thickness,
+                                     model->energy_balance_model()->enthalpy(),
+                                     details::ICE_COLD, 0.0);
   }
 };
 
@@ -1904,16 +1937,18 @@ public:
   IceAreaGlacierizedTemperateBase(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_temperate_base") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^2", "m^2");
     m_variable["long_name"] = "glacierized area where basal ice is temperate";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
     auto thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
-    return details::base_area(model->geometry().ice_thickness,
-                              model->energy_balance_model()->enthalpy(), details::ICE_TEMPERATE,
-                              thickness_threshold);
+    return details::base_area_local(model->geometry().ice_thickness,
+                                    model->energy_balance_model()->enthalpy(),
+                                    details::ICE_TEMPERATE, thickness_threshold);
   }
 };
 
@@ -1923,16 +1958,18 @@ public:
   IceAreaGlacierizedColdBase(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_cold_base") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^2", "m^2");
     m_variable["long_name"] = "glacierized area where basal ice is cold";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
     auto thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
-    return details::base_area(model->geometry().ice_thickness,
-                              model->energy_balance_model()->enthalpy(), details::ICE_COLD,
-                              thickness_threshold);
+    return details::base_area_local(model->geometry().ice_thickness,
+                                    model->energy_balance_model()->enthalpy(),
+                                    details::ICE_COLD, thickness_threshold);
   }
 };
 
@@ -1942,15 +1979,17 @@ public:
   IceEnthalpyGlacierized(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_enthalpy_glacierized") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("J", "J");
     m_variable["long_name"] = "enthalpy of the ice in glacierized areas";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
-    return energy::total_ice_enthalpy(m_config->get_number("output.ice_free_thickness_standard"),
-                                      model->energy_balance_model()->enthalpy(),
-                                      model->geometry().ice_thickness);
+  double compute_local() {
+    return energy::total_ice_enthalpy_local(
+        m_config->get_number("output.ice_free_thickness_standard"),
+        model->energy_balance_model()->enthalpy(), model->geometry().ice_thickness);
   }
 };
 
@@ -1959,14 +1998,16 @@ class IceEnthalpy : public TSDiag<TSSnapshotDiagnostic, IceModel> {
 public:
   IceEnthalpy(IceModel *m) : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_enthalpy") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("J", "J");
     m_variable["long_name"] = "enthalpy of the ice, including seasonal cover";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
-    return energy::total_ice_enthalpy(0.0, model->energy_balance_model()->enthalpy(),
-                                      model->geometry().ice_thickness);
+  double compute_local() {
+    return energy::total_ice_enthalpy_local(0.0, model->energy_balance_model()->enthalpy(),
+                                            model->geometry().ice_thickness);
   }
 };
 
@@ -1976,6 +2017,8 @@ public:
   IceAreaGlacierizedGrounded(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_grounded") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("iareagr");
     }
@@ -1986,9 +2029,9 @@ public:
     m_variable["valid_min"]     = { 0.0 };
   }
 
-  double compute() {
-    return ice_area_grounded(model->geometry(),
-                             m_config->get_number("output.ice_free_thickness_standard"));
+  double compute_local() {
+    return ice_area_grounded_local(model->geometry(),
+                                   m_config->get_number("output.ice_free_thickness_standard"));
   }
 };
 
@@ -1998,6 +2041,8 @@ public:
   IceAreaGlacierizedShelf(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_floating") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("iareafl");
     }
@@ -2008,9 +2053,9 @@ public:
     m_variable["valid_min"]     = { 0.0 };
   }
 
-  double compute() {
-    return ice_area_floating(model->geometry(),
-                             m_config->get_number("output.ice_free_thickness_standard"));
+  double compute_local() {
+    return ice_area_floating_local(model->geometry(),
+                                   m_config->get_number("output.ice_free_thickness_standard"));
   }
 };
 
@@ -2020,12 +2065,14 @@ public:
   IceVolumeGlacierizedGrounded(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_grounded") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of grounded ice in glacierized areas";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
     const auto &cell_type = model->geometry().cell_type;
 
     const array::Scalar &ice_thickness = model->geometry().ice_thickness;
@@ -2046,7 +2093,7 @@ public:
       }
     }
 
-    return GlobalSum(m_grid->com, volume);
+    return volume;
   }
 };
 
@@ -2056,12 +2103,14 @@ public:
   IceVolumeGlacierizedShelf(IceModel *m)
       : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_floating") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("m^3", "m^3");
     m_variable["long_name"] = "volume of ice shelves in glacierized areas";
     m_variable["valid_min"] = { 0.0 };
   }
 
-  double compute() {
+  double compute_local() {
     const auto &cell_type = model->geometry().cell_type;
 
     const array::Scalar &ice_thickness = model->geometry().ice_thickness;
@@ -2082,7 +2131,7 @@ public:
       }
     }
 
-    return GlobalSum(m_grid->com, volume);
+    return volume;
   }
 };
 
@@ -2180,7 +2229,8 @@ public:
 };
 
 /*!
- * Return total mass change due to one of the terms in the mass continuity equation.
+ * Return the mass change in the sub-domain owned by this process due to one of the terms
+ * in the mass continuity equation.
  *
  * Possible terms are
  *
@@ -2256,7 +2306,7 @@ double mass_change(const IceModel *model, TermType term, AreaType area) {
   }
 
   // (kg / m^3) * m^3 = kg
-  return ice_density * GlobalSum(grid.com, volume_change);
+  return ice_density * volume_change;
 }
 
 //! \brief Reports the total bottom surface ice flux.
@@ -2265,6 +2315,8 @@ public:
   IceMassFluxBasal(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_basal_mass_flux") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("tendlibmassbf");
     }
@@ -2275,7 +2327,7 @@ public:
     m_variable["comment"]       = "positive means ice gain";
   }
 
-  double compute() {
+  double compute_local() {
     return mass_change(model, BMB, BOTH);
   }
 };
@@ -2286,6 +2338,8 @@ public:
   IceMassFluxSurface(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_surface_mass_flux") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("tendacabf");
     }
@@ -2296,7 +2350,7 @@ public:
     m_variable["comment"]       = "positive means ice gain";
   }
 
-  double compute() {
+  double compute_local() {
     return mass_change(model, SMB, BOTH);
   }
 };
@@ -2307,13 +2361,15 @@ public:
   IceMassFluxBasalGrounded(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "basal_mass_flux_grounded") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("kg s^-1", "Gt year^-1");
     m_variable["long_name"]     = "total over grounded ice domain of basal mass flux";
     m_variable["standard_name"] = "tendency_of_land_ice_mass_due_to_basal_mass_balance";
     m_variable["comment"]       = "positive means ice gain";
   }
 
-  double compute() {
+  double compute_local() {
     return mass_change(model, BMB, GROUNDED);
   }
 };
@@ -2324,6 +2380,8 @@ public:
   IceMassFluxBasalFloating(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "basal_mass_flux_floating") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("tendlibmassbffl");
     }
@@ -2334,7 +2392,7 @@ public:
     m_variable["comment"]       = "positive means ice gain";
   }
 
-  double compute() {
+  double compute_local() {
     return mass_change(model, BMB, SHELF);
   }
 };
@@ -2346,13 +2404,15 @@ public:
   IceMassFluxConservationError(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_conservation_error") {
 
+    m_reduction = REDUCE_SUM;
+
     set_units("kg s^-1", "Gt year^-1");
     m_variable["long_name"] = "total numerical flux needed to preserve non-negativity"
                               " of ice thickness";
     m_variable["comment"]   = "positive means ice gain";
   }
 
-  double compute() {
+  double compute_local() {
     return mass_change(model, ERROR, BOTH);
   }
 };
@@ -2363,6 +2423,8 @@ public:
   IceMassFluxDischarge(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_discharge") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("tendlifmassbf");
     }
@@ -2373,7 +2435,7 @@ public:
     m_variable["comment"]       = "positive means ice gain";
   }
 
-  double compute() {
+  double compute_local() {
     const double ice_density = m_config->get_number("constants.ice.density");
 
     const array::Scalar &calving        = model->calving();
@@ -2393,7 +2455,7 @@ public:
     }
 
     // (kg/m^3) * m^3 = kg
-    return ice_density * GlobalSum(m_grid->com, volume_change);
+    return ice_density * volume_change;
   }
 };
 
@@ -2403,6 +2465,8 @@ public:
   IceMassFluxCalving(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_calving") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("tendlicalvf");
     }
@@ -2413,7 +2477,7 @@ public:
     m_variable["comment"]       = "positive means ice gain";
   }
 
-  double compute() {
+  double compute_local() {
     const double ice_density = m_config->get_number("constants.ice.density");
 
     const array::Scalar &calving = model->calving();
@@ -2431,7 +2495,7 @@ public:
     }
 
     // (kg/m^3) * m^3 = kg
-    return ice_density * GlobalSum(m_grid->com, volume_change);
+    return ice_density * volume_change;
   }
 };
 
@@ -2441,6 +2505,8 @@ public:
   IceMassFluxAtGroundingLine(const IceModel *m)
       : TSDiag<TSFluxDiagnostic, IceModel>(m, "grounding_line_flux") {
 
+    m_reduction = REDUCE_SUM;
+
     if (m_config->get_flag("output.ISMIP6")) {
       m_variable.set_name("tendligroundf");
       m_variable["standard_name"] = "tendency_of_grounded_ice_mass";
@@ -2451,9 +2517,10 @@ public:
     m_variable["comment"]   = "negative flux corresponds to ice loss into the ocean";
   }
 
-  double compute() {
-    return total_grounding_line_flux(model->geometry().cell_type,
-                                     model->geometry_evolution().flux_staggered(), model->dt());
+  double compute_local() {
+    return total_grounding_line_flux_local(model->geometry().cell_type,
+                                           model->geometry_evolution().flux_staggered(),
+                                           model->dt());
   }
 };
 
@@ -2492,8 +2559,7 @@ public:
 protected:
   std::shared_ptr<array::Array> compute_impl() const {
 
-    auto result        = std::make_shared<array::Scalar>(m_grid, "dHdt");
-    result->metadata() = m_vars[0];
+    auto result = allocate<array::Scalar>("dHdt");
 
     if (m_interval_length > 0.0) {
       model->geometry().ice_thickness.add(-1.0, m_last_thickness, *result);
@@ -2667,8 +2733,7 @@ IceAreaFractionGrounded::IceAreaFractionGrounded(const IceModel *m) : Diag<IceMo
 }
 
 std::shared_ptr<array::Array> IceAreaFractionGrounded::compute_impl() const {
-  auto result = std::make_shared<array::Scalar>(m_grid, grounded_ice_sheet_area_fraction_name);
-  result->metadata() = m_vars[0];
+  auto result = allocate<array::Scalar>(grounded_ice_sheet_area_fraction_name);
 
   const double ice_density   = m_config->get_number("constants.ice.density"),
                ocean_density = m_config->get_number("constants.sea_water.density");
@@ -2977,6 +3042,7 @@ std::shared_ptr<array::Array> IceViscosity::compute_impl() const {
   result->metadata(0) = m_vars[0];
 
   array::Array3D W(m_grid, "wvel", array::WITH_GHOSTS, m_grid->z());
+  W.use_pool();
 
   using mask::ice_free;
 
@@ -64,7 +64,8 @@ void IceModel::identify_open_ocean(const array::CellType &cell_type, array::Scal
     }
   }
 
-  connected_components::label_isolated(result, water_reachable_from_domain_edge);
+  connected_components::label_isolated_union_find(result,
+                                                  water_reachable_from_domain_edge);
 
   // now `result` contains ones in "ice free ocean" cells that are not connected to the edge
   // of the domain and zeros elsewhere
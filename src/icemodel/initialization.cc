@@ -797,6 +797,7 @@ void IceModel::misc_setup() {
   init_frontal_melt();
   init_front_retreat();
   init_diagnostics();
+  init_async_output();
   init_snapshots();
   init_checkpoints();
   init_timeseries();
@@ -30,6 +30,7 @@
 #include "pism/util/io/File.hh"
 
 #include "pism/util/io/io_helpers.hh"
+#include "pism/util/io/AsyncWriter.hh"
 #include "pism/util/Profiling.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/projection.hh"
@@ -128,7 +129,9 @@ void IceModel::save_results() {
     File file(m_grid->com,
               filename,
               string_to_backend(m_config->get_string("output.format")),
-              io::PISM_READWRITE_MOVE);
+              io::PISM_READWRITE_MOVE,
+              nullptr,
+              static_cast<int>(m_config->get_number("output.aggregators")));
 
     write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
 
@@ -138,6 +141,35 @@ void IceModel::save_results() {
                    m_time->current());
   }
   profiling.end("io.model_state");
+
+  if (m_async_writer) {
+    // report errors in asynchronous writes (if any)
+    m_async_writer->wait();
+  }
+}
+
+//! Start the background I/O thread used to write snapshots, spatial time-series and
+//! checkpoints (if requested).
+void IceModel::init_async_output() {
+  if (not m_config->get_flag("output.async.enabled")) {
+    return;
+  }
+
+  m_async_writer = m_ctx->io_thread();
+
+  if (m_async_writer == nullptr) {
+    m_log->message(2,
+                   "PISM WARNING: asynchronous output requires MPI_THREAD_MULTIPLE support.\n"
+                   "              Writing snapshots, spatial time-series and checkpoints"
+                   " synchronously...\n");
+    return;
+  }
+
+  const size_t MiB = 1024 * 1024;
+  int memory_budget = static_cast<int>(m_async_writer->memory_budget() / MiB);
+
+  m_log->message(2, "* Writing snapshots, spatial time-series and checkpoints asynchronously"
+                 " (memory budget: %d MiB)...\n", memory_budget);
 }
 
 void write_run_stats(const File &file, const pism::VariableMetadata &stats) {
@@ -74,7 +74,9 @@ bool IceModel::write_checkpoint() {
     File file(m_grid->com,
               m_checkpoint_filename,
               string_to_backend(m_config->get_string("output.format")),
-              io::PISM_READWRITE_MOVE);
+              io::PISM_READWRITE_MOVE,
+              m_async_writer,
+              static_cast<int>(m_config->get_number("output.aggregators")));
 
     write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
     write_run_stats(file, run_stats());
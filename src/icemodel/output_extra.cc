@@ -309,7 +309,9 @@ void IceModel::write_extras() {
       }
 
       m_extra_file.reset(new File(m_grid->com, filename,
-                                  string_to_backend(m_config->get_string("output.format")), mode));
+                                  string_to_backend(m_config->get_string("output.format")), mode,
+                                  m_async_writer,
+                                  static_cast<int>(m_config->get_number("output.aggregators"))));
 
       // Prepare the file:
       io::define_time(*m_extra_file, *m_ctx);
@@ -141,7 +141,8 @@ void IceModel::write_snapshot() {
 
     m_snapshot_file = std::make_shared<File>(
         m_grid->com, filename, string_to_backend(m_config->get_string("output.format")),
-        io::PISM_READWRITE_MOVE);
+        io::PISM_READWRITE_MOVE, m_async_writer,
+        static_cast<int>(m_config->get_number("output.aggregators")));
 
     write_metadata(*m_snapshot_file, WRITE_MAPPING, PREPEND_HISTORY);
   }
@@ -306,6 +306,10 @@ int main(int argc, char *argv[]) {
 
     model->init();
 
+    // Freeze configuration parameters: from now on code running every time step uses the
+    // snapshot of parameters (see Config::parameters()).
+    config->freeze();
+
     auto list_type = options::Keyword("-list_diagnostics",
                                       "List available diagnostic quantities and stop.",
                                       "all,spatial,scalar,json",
@@ -344,6 +348,7 @@ int main(int argc, char *argv[]) {
       }
     }
     print_unused_parameters(*log, 3, *config);
+    print_lookups_after_freeze(*log, 2, *config);
 
     if (profiling_log.is_set()) {
       ctx->profiling().report(profiling_log);
@@ -225,6 +225,8 @@ pism_class(pism::Logger, "pism/util/Logger.hh");
 %shared_ptr(pism::Config);
 %shared_ptr(pism::NetCDFConfig);
 %shared_ptr(pism::DefaultConfig);
+// ConfigParameters is generated at build time and is meant for C++ code only
+%ignore pism::Config::parameters;
 %include "util/ConfigInterface.hh"
 %include "util/Config.hh"
 
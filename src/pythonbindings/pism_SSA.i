@@ -20,6 +20,8 @@
 %template(ArrayPrincipalStrainRates) pism::array::Array2D<pism::stressbalance::PrincipalStrainRates>;
 %include "stressbalance/StressBalance.hh"
 
+// takes a std::unique_ptr (not supported by SWIG)
+%ignore pism::stressbalance::ShallowStressBalance::set_velocity_predictor;
 %shared_ptr(pism::stressbalance::ZeroSliding)
 %shared_ptr(pism::stressbalance::PrescribedSliding)
 %include "stressbalance/ShallowStressBalance.hh"
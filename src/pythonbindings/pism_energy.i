@@ -13,6 +13,9 @@ using pism::MaskValue;
 
 /* wrap the enthalpy solver to make testing easier */
 %ignore pism::TridiagonalSystem::solve(unsigned int, double *);
+%ignore pism::TridiagonalSystemBatch::System;
+%ignore pism::TridiagonalSystemBatch::system;
+%ignore pism::TridiagonalSystemBatch::solution;
 %include "util/ColumnSystem.hh"
 
 %rename(get_lambda) pism::energy::enthSystemCtx::lambda;
@@ -39,6 +42,7 @@ using pism::MaskValue;
 %include "regional/EnthalpyModel_Regional.hh"
 
 %ignore pism::energy::BedrockColumn::solve(double, double, double, const double *, double *);
+%ignore pism::energy::BedrockColumn::assemble;
 %include "energy/BedrockColumn.hh"
 
 %include "energy/utilities.hh"
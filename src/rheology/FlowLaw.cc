@@ -18,6 +18,7 @@
 
 #include "pism/rheology/FlowLaw.hh"
 
+#include <cmath>
 #include <petsc.h>
 
 #include "pism/util/EnthalpyConverter.hh"
@@ -32,6 +33,41 @@
 namespace pism {
 namespace rheology {
 
+namespace {
+
+// Kernels used by batched methods. The Glen exponent n = 3 is by far the most common
+// case, so the template parameter `glen_n3` is used to avoid calling pow() in this case.
+
+//! Multiply `result[k]` by `stress[k]^(n-1)`.
+template <bool glen_n3>
+void multiply_by_stress_power(const double *stress, double n,
+                              unsigned int N, double *result) {
+  for (unsigned int k = 0; k < N; ++k) {
+    result[k] *= glen_n3 ? stress[k] * stress[k] : pow(stress[k], n - 1);
+  }
+}
+
+//! Compute `softness[k]^(-1/n)`.
+template <bool glen_n3>
+void hardness_from_softness(const double *softness, double hardness_power,
+                            unsigned int N, double *result) {
+  for (unsigned int k = 0; k < N; ++k) {
+    result[k] = glen_n3 ? 1.0 / cbrt(softness[k]) : pow(softness[k], hardness_power);
+  }
+}
+
+//! Compute the effective viscosity (see FlowLaw::effective_viscosity()).
+template <bool glen_n3>
+void effective_viscosity(const double *hardness, const double *gamma, double eps,
+                         double viscosity_power, unsigned int N, double *nu) {
+  for (unsigned int k = 0; k < N; ++k) {
+    const double x = eps + gamma[k];
+    nu[k] = 0.5 * hardness[k] * (glen_n3 ? 1.0 / cbrt(x) : pow(x, viscosity_power));
+  }
+}
+
+} // end of anonymous namespace
+
 FlowLaw::FlowLaw(const std::string &prefix, const Config &config,
                  EnthalpyConverter::Ptr ec)
   : m_EC(ec) {
@@ -84,6 +120,53 @@ double FlowLaw::softness_paterson_budd(double T_pa) const {
   return A * exp(-Q / (m_ideal_gas_constant * T_pa));
 }
 
+//! Batched version of softness_paterson_budd().
+void FlowLaw::softness_paterson_budd_n(const double *T_pa, unsigned int n,
+                                       double *result) const {
+  const double
+    A_cold = m_A_cold,
+    A_warm = m_A_warm,
+    Q_cold = m_Q_cold,
+    Q_warm = m_Q_warm,
+    T_crit = m_crit_temp,
+    R      = m_ideal_gas_constant;
+
+  for (unsigned int k = 0; k < n; ++k) {
+    const bool cold = T_pa[k] < T_crit;
+
+    const double
+      A = cold ? A_cold : A_warm,
+      Q = cold ? Q_cold : Q_warm;
+
+    result[k] = A * exp(-Q / (R * T_pa[k]));
+  }
+}
+
+//! Multiply `result[k]` by `stress[k]^(n-1)`, where `n` is the Glen exponent.
+void FlowLaw::multiply_by_stress_power_n(const double *stress, unsigned int n,
+                                         double *result) const {
+  if (m_n == 3.0) {
+    multiply_by_stress_power<true>(stress, m_n, n, result);
+  } else {
+    multiply_by_stress_power<false>(stress, m_n, n, result);
+  }
+}
+
+//! Compute ice hardness `softness[k]^(-1/n)`, where `n` is the Glen exponent.
+/*!
+ * For `n = 3` this uses `cbrt()` and results differ from ones computed by hardness()
+ * by a few units in the last place: `pow(A, -1.0 / 3.0)` uses a rounded exponent, so its
+ * relative error is approximately `|log(A)|` times the machine epsilon.
+ */
+void FlowLaw::hardness_from_softness_n(const double *softness, unsigned int n,
+                                       double *result) const {
+  if (m_n == 3.0) {
+    hardness_from_softness<true>(softness, m_hardness_power, n, result);
+  } else {
+    hardness_from_softness<false>(softness, m_hardness_power, n, result);
+  }
+}
+
 //! The flow law itself.
 double FlowLaw::flow(double stress, double enthalpy,
                      double pressure, double grain_size) const {
@@ -178,6 +261,30 @@ void FlowLaw::effective_viscosity(double hardness, double gamma, double eps,
   }
 }
 
+//! Batched version of effective_viscosity().
+/*!
+ * Computes `nu[k]` (and `dnu[k]` unless `dnu` is NULL) for `k = 0, ..., n - 1`. Unlike
+ * effective_viscosity(), `nu` cannot be NULL.
+ *
+ * For the Glen exponent `n = 3` results may differ from ones computed by
+ * effective_viscosity() by a few units in the last place (see
+ * hardness_from_softness_n()).
+ */
+void FlowLaw::effective_viscosity_n(const double *hardness, const double *gamma, double eps,
+                                    unsigned int n, double *nu, double *dnu) const {
+  if (m_n == 3.0) {
+    rheology::effective_viscosity<true>(hardness, gamma, eps, m_viscosity_power, n, nu);
+  } else {
+    rheology::effective_viscosity<false>(hardness, gamma, eps, m_viscosity_power, n, nu);
+  }
+
+  if (dnu != NULL) {
+    for (unsigned int k = 0; k < n; ++k) {
+      dnu[k] = m_viscosity_power * nu[k] / (eps + gamma[k]);
+    }
+  }
+}
+
 void averaged_hardness_vec(const FlowLaw &ice,
                            const array::Scalar &thickness,
                            const array::Array3D  &enthalpy,
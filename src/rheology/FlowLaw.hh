@@ -86,6 +86,9 @@ public:
   void effective_viscosity(double hardness, double gamma, double eps,
                            double *nu, double *dnu) const;
 
+  void effective_viscosity_n(const double *hardness, const double *gamma, double eps,
+                             unsigned int n, double *nu, double *dnu) const;
+
   std::string name() const;
   double exponent() const;
 
@@ -113,6 +116,12 @@ protected:
                                unsigned int n, double *result) const;
   virtual double softness_impl(double E, double p) const = 0;
 
+  // Helpers used to implement batched methods. In these `result[k]` depends on inputs at
+  // index `k` only, so `result` may be the same array as an input.
+  void softness_paterson_budd_n(const double *T_pa, unsigned int n, double *result) const;
+  void multiply_by_stress_power_n(const double *stress, unsigned int n, double *result) const;
+  void hardness_from_softness_n(const double *softness, unsigned int n, double *result) const;
+
 protected:
   std::string m_name;
 
@@ -17,6 +17,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>            // std::min
+
 #include "pism/rheology/GPBLD.hh"
 #include "pism/util/ConfigInterface.hh"
 
@@ -60,22 +62,59 @@ double GPBLD::softness_impl(double enthalpy, double pressure) const {
   }
 }
 
-void GPBLD::flow_n_impl(const double *stress, const double *enthalpy,
-                        const double *pressure, const double *grainsize,
-                        unsigned int n, double *result) const {
-  // optimize the common case of Glen n=3
-  if (m_n == 3.0) {
-    for (unsigned int k = 0; k < n; ++k) {
-      result[k] = this->softness(enthalpy[k], pressure[k]) * (stress[k] * stress[k]);
+//! Batched version of softness_impl().
+/*!
+ * Computes temperatures and water fraction factors first (this part depends on the
+ * enthalpy converter), then uses a batched version of softness_paterson_budd().
+ */
+void GPBLD::softness_n(const double *enthalpy, const double *pressure,
+                       unsigned int n, double *result) const {
+  const unsigned int block_size = 64;
+
+  // water fraction factor in eqn (23) in \ref AschwandenBlatter2009
+  double W[block_size];
+
+  for (unsigned int k0 = 0; k0 < n; k0 += block_size) {
+    const unsigned int N = std::min(n - k0, block_size);
+
+    const double
+      *E = enthalpy + k0,
+      *P = pressure + k0;
+    double *T = result + k0;
+
+    for (unsigned int k = 0; k < N; ++k) {
+      const double E_s = m_EC->enthalpy_cts(P[k]);
+      if (E[k] < E_s) {       // cold ice
+        T[k] = m_EC->pressure_adjusted_temperature(E[k], P[k]);
+        W[k] = 1.0;
+      } else { // temperate ice
+        double omega = m_EC->water_fraction(E[k], P[k]);
+        omega = std::min(omega, m_water_frac_observed_limit);
+        T[k] = m_T_0;
+        W[k] = 1.0 + m_water_frac_coeff * omega;
+      }
     }
 
-    return;
-  }
+    softness_paterson_budd_n(T, N, T);
 
-  for (unsigned int k = 0; k < n; ++k) {
-    result[k] = this->flow(stress[k], enthalpy[k], pressure[k], grainsize[k]);
+    for (unsigned int k = 0; k < N; ++k) {
+      result[k0 + k] *= W[k];
+    }
   }
 }
 
+void GPBLD::flow_n_impl(const double *stress, const double *enthalpy,
+                        const double *pressure, const double * /* grainsize */,
+                        unsigned int n, double *result) const {
+  softness_n(enthalpy, pressure, n, result);
+  multiply_by_stress_power_n(stress, n, result);
+}
+
+void GPBLD::hardness_n_impl(const double *enthalpy, const double *pressure,
+                            unsigned int n, double *result) const {
+  softness_n(enthalpy, pressure, n, result);
+  hardness_from_softness_n(result, n, result);
+}
+
 } // end of namespace rheology
 } // end of namespace pism
@@ -38,6 +38,11 @@ protected:
   void flow_n_impl(const double *stress, const double *enthalpy,
                    const double *pressure, const double *grainsize,
                    unsigned int n, double *result) const;
+  void hardness_n_impl(const double *enthalpy, const double *pressure,
+                       unsigned int n, double *result) const;
+
+  void softness_n(const double *enthalpy, const double *pressure,
+                  unsigned int n, double *result) const;
   double m_T_0, m_water_frac_coeff, m_water_frac_observed_limit;
 };
 
@@ -74,6 +74,20 @@ double GoldsbyKohlstedt::flow_impl(double stress, double E,
   return flow_from_temp(stress, temp, pressure, grainsize);
 }
 
+/*!
+ * Computes temperatures for the whole batch, then calls flow_from_temp_n(), so that
+ * there is one virtual call per batch instead of one per element.
+ */
+void GoldsbyKohlstedt::flow_n_impl(const double *stress, const double *E,
+                                   const double *pressure, const double *grainsize,
+                                   unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = m_EC->temperature(E[k], pressure[k]);
+  }
+
+  flow_from_temp_n(stress, result, pressure, grainsize, n, result);
+}
+
 double GoldsbyKohlstedt::hardness_impl(double enthalpy, double pressure) const {
 
   // We use the Paterson-Budd relation for the hardness parameter. It would be nice if we didn't
@@ -86,6 +100,17 @@ double GoldsbyKohlstedt::hardness_impl(double enthalpy, double pressure) const {
   return pow(A, m_hardness_power);
 }
 
+void GoldsbyKohlstedt::hardness_n_impl(const double *enthalpy, const double *pressure,
+                                       unsigned int n, double *result) const {
+  // See hardness_impl().
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = m_EC->pressure_adjusted_temperature(enthalpy[k], pressure[k]);
+  }
+
+  softness_paterson_budd_n(result, n, result);
+  hardness_from_softness_n(result, n, result);
+}
+
 double GoldsbyKohlstedt::softness_impl(double , double) const {
   throw std::runtime_error("double GoldsbyKohlstedt::softness is not implemented");
 
@@ -137,6 +162,16 @@ double GoldsbyKohlstedt::flow_from_temp(double stress, double temp,
   return eps_diff + eps_disl + (eps_basal * eps_gbs) / (eps_basal + eps_gbs);
 }
 
+//! Batched version of flow_from_temp(). `result` may be the same array as `temp`.
+void GoldsbyKohlstedt::flow_from_temp_n(const double *stress, const double *temp,
+                                        const double *pressure, const double *gs,
+                                        unsigned int n, double *result) const {
+  // the qualified call is not virtual and can be inlined
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = GoldsbyKohlstedt::flow_from_temp(stress[k], temp[k], pressure[k], gs[k]);
+  }
+}
+
 
 /*****************
 THE NEXT PROCEDURE REPEATS CODE; INTENDED ONLY FOR DEBUGGING
@@ -232,6 +267,14 @@ double GoldsbyKohlstedtStripped::flow_from_temp(double stress, double temp, doub
   return eps_disl + (eps_basal * eps_gbs) / (eps_basal + eps_gbs);
 }
 
+void GoldsbyKohlstedtStripped::flow_from_temp_n(const double *stress, const double *temp,
+                                                const double *pressure, const double *gs,
+                                                unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = GoldsbyKohlstedtStripped::flow_from_temp(stress[k], temp[k], pressure[k], gs[k]);
+  }
+}
+
 
 } // end of namespace rheology
 } // end of namespace pism
@@ -50,12 +50,20 @@ public:
 protected:
   virtual double flow_impl(double stress, double E,
                            double pressure, double grainsize) const;
+  virtual void flow_n_impl(const double *stress, const double *E,
+                           const double *pressure, const double *grainsize,
+                           unsigned int n, double *result) const;
+  virtual void hardness_n_impl(const double *enthalpy, const double *pressure,
+                               unsigned int n, double *result) const;
 
   // NB! not virtual
   double softness_impl(double E, double p) const __attribute__((noreturn));
   double hardness_impl(double E, double p) const;
   virtual double flow_from_temp(double stress, double temp,
                                 double pressure, double gs) const;
+  virtual void flow_from_temp_n(const double *stress, const double *temp,
+                                const double *pressure, const double *gs,
+                                unsigned int n, double *result) const;
   GKparts flowParts(double stress, double temp, double pressure) const;
 
   double  m_V_act_vol,  m_d_grain_size,
@@ -83,6 +91,9 @@ public:
 protected:
   virtual double flow_from_temp(double stress, double temp,
                                 double pressure, double gs) const;
+  virtual void flow_from_temp_n(const double *stress, const double *temp,
+                                const double *pressure, const double *gs,
+                                unsigned int n, double *result) const;
 
   double m_d_grain_size_stripped;
 };
@@ -44,5 +44,11 @@ double Hooke::softness_from_temp(double T_pa) const {
                          + 3.0 * m_C_Hooke * pow(m_Tr_Hooke - T_pa, -m_K_Hooke));
 }
 
+void Hooke::softness_from_temp_n(const double *T_pa, unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = Hooke::softness_from_temp(T_pa[k]);
+  }
+}
+
 } // end of namespace rheology
 } // end of namespace pism
@@ -31,6 +31,9 @@ public:
   IsothermalGlen(const std::string &prefix, const Config &config, EnthalpyConverter::Ptr EC);
 protected:
   double flow_impl(double stress, double, double, double) const;
+  void flow_n_impl(const double *stress, const double *, const double *, const double *,
+                   unsigned int n, double *result) const;
+  void hardness_n_impl(const double *, const double *, unsigned int n, double *result) const;
   double softness_impl(double, double) const;
   double hardness_impl(double, double) const;
   double flow_from_temp(double stress, double, double, double) const;
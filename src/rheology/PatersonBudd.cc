@@ -58,6 +58,51 @@ double PatersonBudd::softness_from_temp(double T_pa) const {
   return softness_paterson_budd(T_pa);
 }
 
+//! Batched version of softness_from_temp(). `result` may be the same array as `T_pa`.
+void PatersonBudd::softness_from_temp_n(const double *T_pa, unsigned int n,
+                                        double *result) const {
+  softness_paterson_budd_n(T_pa, n, result);
+}
+
+//! Batched version of flow_from_temp(). `result` may be the same array as `temp`.
+void PatersonBudd::flow_from_temp_n(const double *stress, const double *temp,
+                                    const double *pressure, unsigned int n,
+                                    double *result) const {
+  const double C = m_beta_CC_grad / (m_rho * m_standard_gravity);
+
+  // pressure-adjusted temperature
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = temp[k] + C * pressure[k];
+  }
+
+  softness_from_temp_n(result, n, result);
+  multiply_by_stress_power_n(stress, n, result);
+}
+
+/*!
+ * Computes temperatures for the whole batch, then calls flow_from_temp_n(), so that
+ * there is one virtual call per batch instead of one per element.
+ */
+void PatersonBudd::flow_n_impl(const double *stress, const double *E,
+                               const double *pressure, const double * /* grainsize */,
+                               unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = m_EC->temperature(E[k], pressure[k]);
+  }
+
+  flow_from_temp_n(stress, result, pressure, n, result);
+}
+
+void PatersonBudd::hardness_n_impl(const double *E, const double *pressure,
+                                   unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = m_EC->pressure_adjusted_temperature(E[k], pressure[k]);
+  }
+
+  softness_from_temp_n(result, n, result);
+  hardness_from_softness_n(result, n, result);
+}
+
 double PatersonBudd::hardness_from_temp(double T_pa) const {
   return pow(softness_from_temp(T_pa), m_hardness_power);
 }
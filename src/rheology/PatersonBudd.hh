@@ -39,15 +39,24 @@ public:
 protected:
   virtual double flow_impl(double stress, double E,
                            double pressure, double gs) const;
+  virtual void flow_n_impl(const double *stress, const double *E,
+                           const double *pressure, const double *grainsize,
+                           unsigned int n, double *result) const;
+  virtual void hardness_n_impl(const double *enthalpy, const double *pressure,
+                               unsigned int n, double *result) const;
   // This also takes care of hardness
   virtual double softness_impl(double enthalpy, double pressure) const;
 
   virtual double softness_from_temp(double T_pa) const;
+  virtual void softness_from_temp_n(const double *T_pa, unsigned int n, double *result) const;
   virtual double hardness_from_temp(double T_pa) const;
 
   // special temperature-dependent method
   virtual double flow_from_temp(double stress, double temp,
                                 double pressure, double gs) const;
+  virtual void flow_from_temp_n(const double *stress, const double *temp,
+                                const double *pressure, unsigned int n,
+                                double *result) const;
 };
 
 } // end of namespace rheology
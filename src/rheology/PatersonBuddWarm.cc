@@ -39,12 +39,31 @@ double PatersonBuddWarm::softness_from_temp(double T_pa) const {
   return m_A_warm * exp(-m_Q_warm / (m_ideal_gas_constant * T_pa));
 }
 
+void PatersonBuddWarm::softness_from_temp_n(const double *T_pa, unsigned int n,
+                                            double *result) const {
+  const double
+    A = m_A_warm,
+    Q = m_Q_warm,
+    R = m_ideal_gas_constant;
+
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = A * exp(-Q / (R * T_pa[k]));
+  }
+}
+
 // ignores pressure and uses non-pressure-adjusted temperature
 double PatersonBuddWarm::flow_from_temp(double stress, double temp,
                                         double , double) const {
   return softness_from_temp(temp) * pow(stress,m_n-1);
 }
 
+void PatersonBuddWarm::flow_from_temp_n(const double *stress, const double *temp,
+                                        const double *, unsigned int n,
+                                        double *result) const {
+  softness_from_temp_n(temp, n, result);
+  multiply_by_stress_power_n(stress, n, result);
+}
+
 
 } // end of namespace rheology
 } // end of namespace pism
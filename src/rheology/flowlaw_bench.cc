@@ -0,0 +1,247 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "\nPISM_FLOWLAW_BENCH\n"
+  "  Compares batched (flow_n(), hardness_n(), effective_viscosity_n()) and scalar\n"
+  "  implementations of ice flow laws: checks that results agree to within a given\n"
+  "  number of units in the last place and reports timing.\n"
+  "  Batched flow rates are expected to match scalar ones exactly. Hardness and\n"
+  "  viscosity may differ by a few ULPs when n = 3 because scalar code uses\n"
+  "  pow(x, -1.0/3.0), i.e. a rounded exponent.\n\n";
+
+#include <petsc.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>              // memcpy
+#include <limits>
+#include <vector>
+
+#include "pism/rheology/FlowLaw.hh"
+#include "pism/rheology/FlowLawFactory.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/EnthalpyConverter.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+
+namespace pism {
+namespace rheology {
+
+//! Distance between `a` and `b` in units in the last place.
+static uint64_t ulp_distance(double a, double b) {
+  if (a == b) {
+    return 0;
+  }
+
+  if (std::isnan(a) or std::isnan(b)) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  int64_t A = 0, B = 0;
+  memcpy(&A, &a, sizeof(double));
+  memcpy(&B, &b, sizeof(double));
+
+  // map the sign-magnitude representation to a monotonic sequence of integers
+  if (A < 0) {
+    A = std::numeric_limits<int64_t>::min() - A;
+  }
+  if (B < 0) {
+    B = std::numeric_limits<int64_t>::min() - B;
+  }
+
+  return A > B ? (uint64_t)A - (uint64_t)B : (uint64_t)B - (uint64_t)A;
+}
+
+static uint64_t max_ulp_distance(const std::vector<double> &a, const std::vector<double> &b) {
+  uint64_t result = 0;
+  for (size_t k = 0; k < a.size(); ++k) {
+    result = std::max(result, ulp_distance(a[k], b[k]));
+  }
+  return result;
+}
+
+//! Inputs corresponding to an ice column: cold near the surface, temperate near the base.
+struct Column {
+  Column(const EnthalpyConverter &EC, unsigned int n) {
+    const double
+      H          = 3000.0,      // ice thickness, meters
+      T_surface  = 240.0,       // kelvin
+      slope      = 0.01,        // surface slope
+      grain_size = 1e-3;        // meters
+
+    for (unsigned int k = 0; k < n; ++k) {
+      const double
+        depth = H * k / std::max(n - 1.0, 1.0),
+        p     = EC.pressure(depth),
+        T_m   = EC.melting_temperature(p),
+        s     = depth / H;
+
+      // the bottom 10% of the column is temperate
+      const double
+        T     = s < 0.9 ? T_surface + (T_m - T_surface) * (s / 0.9) : T_m,
+        omega = s < 0.9 ? 0.0 : 0.2 * (s - 0.9);
+
+      pressure.push_back(p);
+      enthalpy.push_back(EC.enthalpy_permissive(T, omega, p));
+      stress.push_back(slope * p);
+      grainsize.push_back(grain_size);
+      // second invariant of the strain rate, s^-2
+      gamma.push_back(1e-20 * pow(1e6, s));
+    }
+  }
+
+  std::vector<double> pressure, enthalpy, stress, grainsize, gamma;
+};
+
+/*!
+ * Compares batched and scalar implementations of `flow_law`.
+ *
+ * Returns `true` if results agree to within `max_ulps` units in the last place.
+ */
+static bool compare(const FlowLaw &flow_law, const Column &C, int repeat, uint64_t max_ulps,
+                    const Logger &log) {
+  const unsigned int n = C.pressure.size();
+
+  const double *E = C.enthalpy.data(), *p = C.pressure.data(), *s = C.stress.data(),
+    *gs = C.grainsize.data(), *gamma = C.gamma.data();
+
+  std::vector<double>
+    flow_scalar(n), flow_batched(n),
+    B_scalar(n), B_batched(n),
+    nu_scalar(n), nu_batched(n),
+    dnu_scalar(n), dnu_batched(n);
+
+  const double eps = 1e-18;
+
+  double T_scalar = 0.0, T_batched = 0.0;
+  for (int r = 0; r < repeat; ++r) {
+    double T0 = MPI_Wtime();
+    for (unsigned int k = 0; k < n; ++k) {
+      flow_scalar[k] = flow_law.flow(s[k], E[k], p[k], gs[k]);
+    }
+    for (unsigned int k = 0; k < n; ++k) {
+      B_scalar[k] = flow_law.hardness(E[k], p[k]);
+    }
+    for (unsigned int k = 0; k < n; ++k) {
+      flow_law.effective_viscosity(B_scalar[k], gamma[k], eps, &nu_scalar[k], &dnu_scalar[k]);
+    }
+    double T1 = MPI_Wtime();
+    flow_law.flow_n(s, E, p, gs, n, flow_batched.data());
+    flow_law.hardness_n(E, p, n, B_batched.data());
+    // use the same hardness to compare viscosities
+    flow_law.effective_viscosity_n(B_scalar.data(), gamma, eps, n, nu_batched.data(),
+                                   dnu_batched.data());
+    double T2 = MPI_Wtime();
+
+    T_scalar  += T1 - T0;
+    T_batched += T2 - T1;
+  }
+
+  uint64_t
+    flow_ulps = max_ulp_distance(flow_scalar, flow_batched),
+    B_ulps    = max_ulp_distance(B_scalar, B_batched),
+    nu_ulps   = std::max(max_ulp_distance(nu_scalar, nu_batched),
+                         max_ulp_distance(dnu_scalar, dnu_batched));
+
+  bool success = flow_ulps <= max_ulps and B_ulps <= max_ulps and nu_ulps <= max_ulps;
+
+  log.message(1, "%-45s  %8.3f  %8.3f  %6.2f  %4llu %4llu %4llu  %s\n",
+              flow_law.name().c_str(),
+              T_scalar * 1e3, T_batched * 1e3, T_scalar / std::max(T_batched, 1e-16),
+              (unsigned long long)flow_ulps,
+              (unsigned long long)B_ulps,
+              (unsigned long long)nu_ulps,
+              success ? "OK" : "FAIL");
+
+  return success;
+}
+
+} // end of namespace rheology
+} // end of namespace pism
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+  using namespace pism::rheology;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  try {
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_flowlaw_bench");
+    auto config = ctx->config();
+    auto log = ctx->log();
+
+    std::string usage =
+      "  pism_flowlaw_bench [-n N] [-repeat R] [-max_ulps U]\n"
+      "where\n"
+      "  -n             number of values in a batch (default: 101)\n"
+      "  -repeat        number of repetitions used for timing (default: 1000)\n"
+      "  -max_ulps      largest acceptable difference, in units in the last place (default: 32)\n";
+
+    bool stop = show_usage_check_req_opts(*log, "pism_flowlaw_bench", {}, usage);
+    if (stop) {
+      return 0;
+    }
+
+    options::Integer
+      n("-n", "number of values in a batch", 101),
+      repeat("-repeat", "number of repetitions", 1000),
+      max_ulps("-max_ulps", "largest acceptable difference, in ULPs", 32);
+
+    if (n < 1 or repeat < 1 or max_ulps < 0) {
+      throw RuntimeError(PISM_ERROR_LOCATION, "-n and -repeat have to be positive;"
+                         " -max_ulps has to be non-negative");
+    }
+
+    EnthalpyConverter::Ptr EC(new EnthalpyConverter(*config));
+
+    Column column(*EC, n);
+
+    log->message(1, "%-45s  %8s  %8s  %6s  %14s\n",
+                 "flow law", "scalar", "batched", "ratio", "max ULP diff");
+    log->message(1, "%-45s  %8s  %8s  %6s  %4s %4s %4s\n",
+                 "", "(ms)", "(ms)", "", "flow", "B", "nu");
+
+    bool success = true;
+    for (const auto *name : {ICE_ISOTHERMAL_GLEN, ICE_PB, ICE_GPBLD, ICE_HOOKE,
+                             ICE_ARR, ICE_ARRWARM, ICE_GOLDSBY_KOHLSTEDT}) {
+      FlowLawFactory factory("stress_balance.sia.", config, EC);
+      factory.set_default(name);
+      auto flow_law = factory.create();
+
+      success = compare(*flow_law, column, repeat, max_ulps, *log) and success;
+    }
+
+    if (not success) {
+      log->message(1, "Batched and scalar flow law implementations do not agree.\n");
+      return 1;
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
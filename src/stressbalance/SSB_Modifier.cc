@@ -22,6 +22,7 @@
 #include "pism/util/Grid.hh"
 #include "pism/util/ConfigInterface.hh"
 #include "pism/stressbalance/StressBalance.hh"
+#include "pism/util/array/GhostUpdate.hh"
 #include "pism/util/array/Vector.hh"
 #include "pism/util/Context.hh"
 
@@ -51,6 +52,10 @@ SSB_Modifier::SSB_Modifier(std::shared_ptr<const Grid> g)
   m_diffusive_flux.metadata(0)
       .long_name("diffusive (SIA) flux components on the staggered grid")
       .units("m^2 s^-1");
+
+  bool single_precision = array::single_precision_requested(*m_config, "velocity");
+  m_u.use_single_precision(single_precision);
+  m_v.use_single_precision(single_precision);
 }
 
 void SSB_Modifier::init() {
@@ -73,6 +78,12 @@ const array::Array3D& SSB_Modifier::velocity_v() const {
   return m_v;
 }
 
+//! Store the 3D horizontal velocity in single precision until it is used again.
+void SSB_Modifier::compact() {
+  m_u.compact();
+  m_v.compact();
+}
+
 std::string SSB_Modifier::stdout_report() const {
   return "";
 }
@@ -123,8 +134,7 @@ void ConstantInColumn::update(const array::Vector &sliding_velocity,
   }
 
   // Communicate to get ghosts (needed to compute w):
-  m_u.update_ghosts();
-  m_v.update_ghosts();
+  array::update_ghosts({ &m_u, &m_v });
 
   // diffusive flux and maximum diffusivity
   m_diffusive_flux.set(0.0);
@@ -57,6 +57,8 @@ public:
 
   const array::Array3D& velocity_v() const;
 
+  void compact();
+
   virtual std::string stdout_report() const;
 
   std::shared_ptr<const rheology::FlowLaw> flow_law() const;
@@ -16,14 +16,23 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>            // std::max, std::min
+#include <cmath>                // NAN, std::isfinite
+
 #include "pism/stressbalance/ShallowStressBalance.hh"
 #include "pism/basalstrength/basal_resistance.hh"
 #include "pism/rheology/FlowLawFactory.hh"
 #include "pism/stressbalance/SSB_diagnostics.hh"
+#include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/VelocityPredictor.hh"
+#include "pism/geometry/Geometry.hh"
 #include "pism/util/Context.hh"
 #include "pism/util/Vars.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/util/error_handling.hh"
+#include "pism/util/Units.hh"
+#include "pism/util/pism_utilities.hh"
 
 namespace pism {
 namespace stressbalance {
@@ -35,8 +44,15 @@ ShallowStressBalance::ShallowStressBalance(std::shared_ptr<const Grid> g)
     m_EC(g->ctx()->enthalpy_converter()),
     m_velocity(m_grid, "bar"),
     m_basal_frictional_heating(m_grid, "bfrict"),
-    m_e_factor(1.0)
+    m_e_factor(1.0),
+    m_n_skipped(0),
+    m_total_solves(0),
+    m_total_skipped(0),
+    m_last_solve_time(NAN)
 {
+  m_adaptive_update      = m_config->get_flag("stress_balance.adaptive_update.enabled");
+  m_adaptive_tolerance   = m_config->get_number("stress_balance.adaptive_update.relative_residual");
+  m_adaptive_max_skipped = m_config->get_number("stress_balance.adaptive_update.max_skipped");
 
   if (m_config->get_flag("basal_resistance.pseudo_plastic.enabled")) {
     m_basal_sliding_law = new IceBasalResistancePseudoPlasticLaw(*m_config);
@@ -46,6 +62,15 @@ ShallowStressBalance::ShallowStressBalance(std::shared_ptr<const Grid> g)
     m_basal_sliding_law = new IceBasalResistancePlasticLaw(*m_config);
   }
 
+  {
+    auto extrapolation = m_config->get_string("stress_balance.initial_guess.extrapolation");
+    if (extrapolation == "linear") {
+      m_predictor.reset(new VelocityPredictor(1));
+    } else if (extrapolation == "quadratic") {
+      m_predictor.reset(new VelocityPredictor(2));
+    }
+  }
+
   m_velocity.metadata(0)
       .long_name("thickness-advective ice velocity (x-component)")
       .units("m s^-1");
@@ -83,6 +108,17 @@ double ShallowStressBalance::flow_enhancement_factor() const {
   return m_e_factor;
 }
 
+/*!
+ * Set the predictor used to compute initial guesses for nonlinear solvers, replacing the
+ * one selected using `stress_balance.initial_guess.extrapolation`. Use NULL to disable.
+ *
+ * This makes it possible to use a custom predictor (a class derived from
+ * VelocityPredictor). Stress balance models that do not use a nonlinear solver ignore it.
+ */
+void ShallowStressBalance::set_velocity_predictor(std::unique_ptr<VelocityPredictor> predictor) {
+  m_predictor = std::move(predictor);
+}
+
 EnthalpyConverter::Ptr ShallowStressBalance::enthalpy_converter() const {
   return m_EC;
 }
@@ -91,6 +127,95 @@ const IceBasalResistancePlasticLaw* ShallowStressBalance::sliding_law() const {
   return m_basal_sliding_law;
 }
 
+/*!
+ * Returns `true` if the solve at the current time step can be skipped, re-using the
+ * velocity computed earlier.
+ *
+ * This is the case if the adaptive update frequency is enabled, the number of
+ * consecutive skipped solves is below `stress_balance.adaptive_update.max_skipped` and
+ * the norm of the residual of the stress balance evaluated at the current velocity,
+ * relative to the norm of the residual at zero velocity, is below
+ * `stress_balance.adaptive_update.relative_residual`.
+ *
+ * `relative_residual` computes this relative residual using current inputs (it is called
+ * only if necessary); it should return a negative number if it is not available.
+ *
+ * Solvers using this have to call solve_done() after each solve.
+ */
+bool ShallowStressBalance::skip_solve(const std::function<double()> &relative_residual) {
+  if (not m_adaptive_update or m_total_solves == 0) {
+    return false;
+  }
+
+  if (m_n_skipped < m_adaptive_max_skipped) {
+    double residual = relative_residual();
+
+    if (residual >= 0.0 and residual <= m_adaptive_tolerance) {
+      m_n_skipped += 1;
+      m_total_skipped += 1;
+
+      m_log->message(3, "  Stress balance: skipped the solve (relative residual %.2e)\n",
+                     residual);
+      return true;
+    }
+  }
+
+  if (m_n_skipped > 0) {
+    // keep the velocity used during skipped steps to estimate the thickness drift
+    m_stale_velocity = array::pooled<array::Vector>(m_grid, "stale_velocity");
+    m_stale_velocity->copy_from(m_velocity);
+  }
+
+  return false;
+}
+
+/*!
+ * Update counters used by the adaptive update frequency mechanism after a solve.
+ *
+ * If preceding solves were skipped, reports their number and an estimate of the change in
+ * ice thickness due to using a "stale" velocity (compared to solving at every time step),
+ * computed using the change in ice flux since the last solve.
+ */
+void ShallowStressBalance::solve_done(const Inputs &inputs) {
+  if (m_stale_velocity) {
+    const auto &H = inputs.geometry->ice_thickness;
+
+    double flux_change = 0.0, velocity_change = 0.0;
+    {
+      array::AccessScope list{ &H, &m_velocity, m_stale_velocity.get() };
+
+      for (auto p = m_grid->points(); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        double du = (m_velocity(i, j) - (*m_stale_velocity)(i, j)).magnitude();
+
+        velocity_change = std::max(velocity_change, du);
+        flux_change     = std::max(flux_change, H(i, j) * du);
+      }
+    }
+    velocity_change = GlobalMax(m_grid->com, velocity_change);
+    flux_change     = GlobalMax(m_grid->com, flux_change);
+
+    // |div(Q_new - Q_stale)| ~ |Q_new - Q_stale| / dx
+    double
+      elapsed = inputs.time - m_last_solve_time,
+      dx      = std::min(m_grid->dx(), m_grid->dy()),
+      drift   = std::isfinite(elapsed) ? elapsed * flux_change / dx : 0.0;
+
+    m_log->message(2,
+                   "  Stress balance: skipped %d solve(s) (%d of %d in total), "
+                   "max. velocity change %.2f m/year, estimated thickness drift %.3f m\n",
+                   m_n_skipped, m_total_skipped, m_total_skipped + m_total_solves + 1,
+                   units::convert(m_sys, velocity_change, "m second-1", "m year-1"), drift);
+
+    m_stale_velocity.reset();
+  }
+
+  m_n_skipped = 0;
+  m_total_solves += 1;
+  m_last_solve_time = inputs.time;
+}
+
 //! \brief Get the thickness-advective 2D velocity.
 const array::Vector1& ShallowStressBalance::velocity() const {
   return m_velocity;
@@ -19,6 +19,9 @@
 #ifndef _SHALLOWSTRESSBALANCE_H_
 #define _SHALLOWSTRESSBALANCE_H_
 
+#include <functional>
+#include <memory>
+
 #include "pism/util/Component.hh"
 #include "pism/util/array/Vector.hh"
 #include "pism/util/EnthalpyConverter.hh"
@@ -34,6 +37,7 @@ class IceBasalResistancePlasticLaw;
 namespace stressbalance {
 
 class Inputs;
+class VelocityPredictor;
 
 //! Shallow stress balance (such as the SSA).
 class ShallowStressBalance : public Component {
@@ -69,11 +73,16 @@ public:
   const IceBasalResistancePlasticLaw* sliding_law() const;
 
   double flow_enhancement_factor() const;
+
+  void set_velocity_predictor(std::unique_ptr<VelocityPredictor> predictor);
 protected:
   virtual void init_impl();
 
   virtual DiagnosticList diagnostics_impl() const;
 
+  bool skip_solve(const std::function<double()> &relative_residual);
+  void solve_done(const Inputs &inputs);
+
   IceBasalResistancePlasticLaw *m_basal_sliding_law;
   std::shared_ptr<rheology::FlowLaw> m_flow_law;
   EnthalpyConverter::Ptr m_EC;
@@ -83,6 +92,22 @@ protected:
 
   //! flow enhancement factor
   double m_e_factor;
+
+  //! predictor of the initial guess for nonlinear solvers (may be NULL)
+  std::unique_ptr<VelocityPredictor> m_predictor;
+
+  // adaptive update frequency (see skip_solve())
+  bool m_adaptive_update;
+  double m_adaptive_tolerance;
+  int m_adaptive_max_skipped;
+  //! number of solves skipped since the last solve
+  int m_n_skipped;
+  //! total numbers of solves and skipped solves
+  int m_total_solves, m_total_skipped;
+  //! model time of the last solve
+  double m_last_solve_time;
+  //! velocity before the solve following skipped ones (used to estimate thickness drift)
+  std::shared_ptr<array::Vector> m_stale_velocity;
 };
 
 //! Returns zero velocity field, zero friction heating, and zero for D^2.
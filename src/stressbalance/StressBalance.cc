@@ -16,6 +16,8 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <cmath>                // NAN
+
 #include "pism/stressbalance/StressBalance.hh"
 #include "pism/stressbalance/ShallowStressBalance.hh"
 #include "pism/stressbalance/SSB_Modifier.hh"
@@ -26,6 +28,7 @@
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/array/ActiveColumns.hh"
 #include "pism/util/array/CellType.hh"
 #include "pism/util/Time.hh"
 #include "pism/geometry/Geometry.hh"
@@ -35,6 +38,9 @@ namespace pism {
 namespace stressbalance {
 
 Inputs::Inputs() {
+  // NAN means "unknown"
+  time = NAN;
+
   geometry = NULL;
   new_bed_elevation = true;
 
@@ -152,6 +158,10 @@ StressBalance::StressBalance(std::shared_ptr<const Grid> g,
   m_strain_heating.metadata(0)
       .long_name("rate of strain heating in ice (dissipation heating)")
       .units("W m^-3");
+
+  m_w.use_single_precision(array::single_precision_requested(*m_config, "velocity"));
+  m_strain_heating.use_single_precision(
+      array::single_precision_requested(*m_config, "strain_heating"));
 }
 
 StressBalance::~StressBalance() {
@@ -244,6 +254,19 @@ const array::Array3D& StressBalance::volumetric_strain_heating() const {
   return m_strain_heating;
 }
 
+/*!
+ * Store the 3D velocity and the strain heating in single precision until they are used
+ * again (if requested using `grid.single_precision_fields`).
+ *
+ * Call this once all the models using these fields are done with them for the current
+ * time step.
+ */
+void StressBalance::compact() {
+  m_w.compact();
+  m_strain_heating.compact();
+  m_modifier->compact();
+}
+
 //! Compute vertical velocity using incompressibility of the ice.
 /*!
 The vertical velocity \f$w(x,y,z,t)\f$ is the velocity *relative to the
@@ -483,7 +506,8 @@ static inline double D2(double u_x, double u_y, double u_z, double v_x, double v
   that `u` and `v` above the ice are filled using constant
   extrapolation.
 
-  Resulting field does not have ghosts.
+  Resulting field does not have ghosts. It is set to zero in inactive columns (ice-free
+  columns that are not next to ice; see array::CellType::active_columns()).
 
   Below is the *Maxima* code that produces the expression evaluated by D2().
 
@@ -525,9 +549,16 @@ void StressBalance::compute_volumetric_strain_heating(const Inputs &inputs) {
   const unsigned int Mz = m_grid->Mz();
   std::vector<double> depth(Mz), pressure(Mz), hardness(Mz);
 
+  const auto &columns = mask.active_columns();
+
+  // there is no ice in inactive columns
+  for (auto p = columns.inactive_points(); p; p.next()) {
+    m_strain_heating.set_column(p.i(), p.j(), 0.0);
+  }
+
   ParallelSection loop(m_grid->com);
   try {
-    for (auto p = m_grid->points(); p; p.next()) {
+    for (auto p = columns.points(); p; p.next()) {
       const int i = p.i(), j = p.j();
 
       double H = thickness(i, j);
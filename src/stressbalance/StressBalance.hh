@@ -41,6 +41,9 @@ class Inputs {
 public:
   Inputs();
 
+  //! model time corresponding to these inputs (used to extrapolate solutions in time)
+  double time;
+
   const Geometry *geometry;
   bool new_bed_elevation;
 
@@ -113,6 +116,8 @@ public:
 
   const array::Array3D& volumetric_strain_heating() const;
 
+  void compact();
+
   //! \brief Produce a report string for the standard output.
   std::string stdout_report() const;
 
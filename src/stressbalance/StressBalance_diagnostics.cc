@@ -29,6 +29,7 @@
 #include "pism/util/error_handling.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/rheology/FlowLaw.hh"
 #include "pism/rheology/FlowLawFactory.hh"
 #include "pism/util/Context.hh"
@@ -375,6 +376,8 @@ std::shared_ptr<array::Array> PSB_velsurf::compute_impl() const {
 
   array::Scalar u_surf(m_grid, "u_surf");
   array::Scalar v_surf(m_grid, "v_surf");
+  u_surf.use_pool();
+  v_surf.use_pool();
 
   const array::Array3D
     &u3 = model->velocity_u(),
@@ -603,6 +606,8 @@ std::shared_ptr<array::Array> PSB_velbase::compute_impl() const {
 
   array::Scalar u_base(m_grid, "u_base");
   array::Scalar v_base(m_grid, "v_base");
+  u_base.use_pool();
+  v_base.use_pool();
 
   const array::Array3D &u3 = model->velocity_u(), &v3 = model->velocity_v();
 
@@ -752,7 +757,7 @@ PSB_strainheat::PSB_strainheat(const StressBalance *m) : Diag<StressBalance>(m)
 
 std::shared_ptr<array::Array> PSB_strainheat::compute_impl() const {
   auto result =
-      std::make_shared<array::Array3D>(m_grid, "strainheat", array::WITHOUT_GHOSTS, m_grid->z());
+      array::pooled<array::Array3D>(m_grid, "strainheat", array::WITHOUT_GHOSTS, m_grid->z());
 
   result->metadata() = m_vars[0];
 
@@ -775,17 +780,19 @@ PSB_strain_rates::PSB_strain_rates(const StressBalance *m) : Diag<StressBalance>
 std::shared_ptr<array::Array> PSB_strain_rates::compute_impl() const {
   auto velbar = array::cast<array::Vector>(PSB_velbar(model).compute());
 
-  auto result = std::make_shared<array::Array2D<PrincipalStrainRates> >(m_grid, "strain_rates",
-                                                                        array::WITHOUT_GHOSTS);
+  auto result = array::pooled<array::Array2D<PrincipalStrainRates> >(m_grid, "strain_rates",
+                                                                     array::WITHOUT_GHOSTS);
   result->metadata(0) = m_vars[0];
   result->metadata(1) = m_vars[1];
 
   array::Vector1 velbar_with_ghosts(m_grid, "velbar");
+  velbar_with_ghosts.use_pool();
 
   // copy_from communicates ghosts
   velbar_with_ghosts.copy_from(*velbar);
 
   array::CellType1 cell_type(m_grid, "cell_type");
+  cell_type.use_pool();
   {
     const auto &mask = *m_grid->variables().get_2d_cell_type("mask");
     cell_type.copy_from(mask);
@@ -806,7 +813,7 @@ PSB_deviatoric_stresses::PSB_deviatoric_stresses(const StressBalance *m) : Diag<
 
 std::shared_ptr<array::Array> PSB_deviatoric_stresses::compute_impl() const {
 
-  auto result = std::make_shared<array::Array2D<stressbalance::DeviatoricStresses> >(
+  auto result = array::pooled<array::Array2D<stressbalance::DeviatoricStresses> >(
       m_grid, "deviatoric_stresses", array::WITHOUT_GHOSTS);
   result->metadata(0) = m_vars[0];
   result->metadata(1) = m_vars[1];
@@ -817,6 +824,8 @@ std::shared_ptr<array::Array> PSB_deviatoric_stresses::compute_impl() const {
 
   array::Scalar hardness(m_grid, "hardness");
   array::Vector1 velocity(m_grid, "velocity");
+  hardness.use_pool();
+  velocity.use_pool();
 
   averaged_hardness_vec(*model->shallow()->flow_law(), *thickness, *enthalpy, hardness);
 
@@ -824,6 +833,7 @@ std::shared_ptr<array::Array> PSB_deviatoric_stresses::compute_impl() const {
   velocity.copy_from(*array::cast<array::Vector>(PSB_velbar(model).compute()));
 
   array::CellType1 cell_type(m_grid, "cell_type");
+  cell_type.use_pool();
   {
     const auto &mask = *m_grid->variables().get_2d_cell_type("mask");
     cell_type.copy_from(mask);
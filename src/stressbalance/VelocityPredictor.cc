@@ -0,0 +1,244 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::min
+#include <cmath>                // std::isfinite
+
+#include "pism/stressbalance/VelocityPredictor.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+namespace stressbalance {
+
+namespace {
+
+//! Destroy `v` (if it is not NULL).
+void destroy(petsc::Vec &v) {
+  if (v.get() != NULL) {
+    PetscErrorCode ierr = VecDestroy(v.rawptr());
+    PISM_CHK(ierr, "VecDestroy");
+  }
+}
+
+//! Returns true if `a` and `b` have the same layout on all ranks.
+//!
+//! Collective: callers use the result to decide whether to evaluate the residual.
+bool compatible(Vec a, Vec b) {
+  PetscInt a_size = 0, b_size = 0;
+  PetscErrorCode ierr = VecGetLocalSize(a, &a_size);
+  PISM_CHK(ierr, "VecGetLocalSize");
+  ierr = VecGetLocalSize(b, &b_size);
+  PISM_CHK(ierr, "VecGetLocalSize");
+
+  MPI_Comm com = MPI_COMM_NULL;
+  ierr = PetscObjectGetComm((PetscObject)a, &com);
+  PISM_CHK(ierr, "PetscObjectGetComm");
+
+  return GlobalMin(com, a_size == b_size ? 1.0 : 0.0) > 0.0;
+}
+
+} // namespace
+
+VelocityPredictor::VelocityPredictor(int order)
+  : m_order(order), m_n_predictions(0), m_n_accepted(0) {
+  if (order < 1) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid velocity predictor order: %d (has to be positive)",
+                                  order);
+  }
+}
+
+VelocityPredictor::~VelocityPredictor() {
+  // empty
+}
+
+//! Discard the history of solutions.
+void VelocityPredictor::reset() {
+  m_history.clear();
+  m_times.clear();
+}
+
+/*!
+ * Add the `solution` corresponding to the model time `time` to the history.
+ *
+ * Replaces the last stored solution if `time` is the same (e.g. if the stress balance was
+ * re-computed during a time step). Discards the history if `time` is earlier than the
+ * time of the last stored solution. Calls with non-finite `time` are ignored.
+ */
+void VelocityPredictor::add(double time, Vec solution) {
+  if (not std::isfinite(time)) {
+    return;
+  }
+
+  PetscErrorCode ierr = 0;
+
+  if (not m_history.empty() and
+      (time < m_times.back() or not compatible(solution, *m_history.back()))) {
+    reset();
+  }
+
+  if (not m_history.empty() and time == m_times.back()) {
+    ierr = VecCopy(solution, *m_history.back());
+    PISM_CHK(ierr, "VecCopy");
+    return;
+  }
+
+  std::shared_ptr<petsc::Vec> v;
+  if ((int)m_history.size() > m_order) {
+    // re-use the storage of the oldest solution
+    v = m_history.front();
+    m_history.pop_front();
+    m_times.pop_front();
+  } else {
+    v = std::make_shared<petsc::Vec>();
+    ierr = VecDuplicate(solution, v->rawptr());
+    PISM_CHK(ierr, "VecDuplicate");
+  }
+
+  ierr = VecCopy(solution, *v);
+  PISM_CHK(ierr, "VecCopy");
+
+  m_history.push_back(v);
+  m_times.push_back(time);
+}
+
+/*!
+ * Compute the extrapolated solution at `time`, storing it in `result`.
+ *
+ * Uses a polynomial of degree `min(order, N - 1)`, where `N` is the number of stored
+ * solutions, interpolating most recent solutions.
+ *
+ * Returns `false` if there is not enough history to extrapolate.
+ */
+bool VelocityPredictor::predict(double time, Vec result) {
+  int N = m_history.size();
+  int degree = std::min(m_order, N - 1);
+
+  if (degree < 1 or not (time > m_times.back())) {
+    return false;
+  }
+
+  PetscErrorCode ierr = VecSet(result, 0.0);
+  PISM_CHK(ierr, "VecSet");
+
+  for (int m = N - degree - 1; m < N; ++m) {
+    // Lagrange basis polynomial corresponding to the m-th stored solution
+    double w = 1.0;
+    for (int l = N - degree - 1; l < N; ++l) {
+      if (l != m) {
+        w *= (time - m_times[l]) / (m_times[m] - m_times[l]);
+      }
+    }
+
+    ierr = VecAXPY(result, w, *m_history[m]);
+    PISM_CHK(ierr, "VecAXPY");
+  }
+
+  return true;
+}
+
+/*!
+ * Replace the initial `guess` with the predicted solution at `time` if this reduces the
+ * norm of the residual computed using `residual_norm`.
+ *
+ * Returns `true` if `guess` was modified.
+ */
+bool VelocityPredictor::apply(double time, Vec guess,
+                              const std::function<double(Vec)> &residual_norm) {
+  if (not std::isfinite(time) or m_history.empty()) {
+    return false;
+  }
+
+  if (not compatible(guess, *m_history.back())) {
+    reset();
+    destroy(m_prediction);
+    destroy(m_residual);
+    return false;
+  }
+
+  PetscErrorCode ierr = 0;
+  if (m_prediction.get() == NULL) {
+    ierr = VecDuplicate(guess, m_prediction.rawptr());
+    PISM_CHK(ierr, "VecDuplicate");
+  }
+
+  if (not predict(time, m_prediction)) {
+    return false;
+  }
+  m_n_predictions += 1;
+
+  double
+    plain     = residual_norm(guess),
+    predicted = residual_norm(m_prediction);
+
+  if (std::isfinite(predicted) and predicted < plain) {
+    ierr = VecCopy(m_prediction, guess);
+    PISM_CHK(ierr, "VecCopy");
+
+    m_n_accepted += 1;
+    return true;
+  }
+
+  return false;
+}
+
+/*!
+ * Same as above, using the residual of the nonlinear system solved by `snes`.
+ *
+ * The caller has to make sure that the residual evaluation callback of `snes` is ready
+ * to be used (i.e. all its inputs are set).
+ */
+bool VelocityPredictor::apply(double time, SNES snes, Vec guess) {
+  auto residual_norm = [this, snes](Vec x) {
+    PetscErrorCode ierr = 0;
+    if (m_residual.get() == NULL) {
+      ierr = VecDuplicate(x, m_residual.rawptr());
+      PISM_CHK(ierr, "VecDuplicate");
+    }
+
+    ierr = SNESComputeFunction(snes, x, m_residual);
+    PISM_CHK(ierr, "SNESComputeFunction");
+
+    double result = 0.0;
+    ierr = VecNorm(m_residual, NORM_2, &result);
+    PISM_CHK(ierr, "VecNorm");
+
+    return result;
+  };
+
+  return apply(time, guess, residual_norm);
+}
+
+int VelocityPredictor::order() const {
+  return m_order;
+}
+
+//! Number of computed predictions.
+int VelocityPredictor::n_predictions() const {
+  return m_n_predictions;
+}
+
+//! Number of predictions used as initial guesses.
+int VelocityPredictor::n_accepted() const {
+  return m_n_accepted;
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
@@ -0,0 +1,86 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_VELOCITYPREDICTOR_H
+#define PISM_VELOCITYPREDICTOR_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include <petscsnes.h>
+
+#include "pism/util/petscwrappers/Vec.hh"
+
+namespace pism {
+namespace stressbalance {
+
+//! Initial guess for a nonlinear stress balance solver computed using solutions from
+//! previous time steps.
+/*!
+ * Keeps a short history of solutions (PETSc `Vec`s in the layout used by a solver) and
+ * uses Lagrange polynomial extrapolation in time to predict the solution at the next
+ * time. `order` of 1 corresponds to linear and 2 to quadratic extrapolation.
+ *
+ * A prediction is used only if the norm of the residual it corresponds to is smaller than
+ * the one corresponding to the "plain" initial guess (usually the previous solution), so
+ * using a predictor should not make convergence worse.
+ *
+ * Derived classes may override predict() to implement a different predictor (e.g. one
+ * using changes in ice thickness) and can be installed using
+ * ShallowStressBalance::set_velocity_predictor().
+ */
+class VelocityPredictor {
+public:
+  VelocityPredictor(int order);
+  virtual ~VelocityPredictor();
+
+  void reset();
+
+  void add(double time, Vec solution);
+
+  bool apply(double time, Vec guess, const std::function<double(Vec)> &residual_norm);
+
+  bool apply(double time, SNES snes, Vec guess);
+
+  int order() const;
+  int n_predictions() const;
+  int n_accepted() const;
+protected:
+  virtual bool predict(double time, Vec result);
+
+  //! maximum degree of the extrapolating polynomial
+  int m_order;
+
+  //! times corresponding to stored solutions (increasing)
+  std::deque<double> m_times;
+  //! stored solutions (oldest first)
+  std::deque<std::shared_ptr<petsc::Vec> > m_history;
+private:
+  petsc::Vec m_prediction;
+  petsc::Vec m_residual;
+
+  int m_n_predictions;
+  int m_n_accepted;
+};
+
+} // end of namespace stressbalance
+} // end of namespace pism
+
+#endif /* PISM_VELOCITYPREDICTOR_H */
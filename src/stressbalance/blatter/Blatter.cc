@@ -34,6 +34,7 @@
 
 #include "pism/geometry/Geometry.hh"
 #include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/VelocityPredictor.hh"
 #include "pism/util/array/Array3D.hh"
 #include "pism/util/pism_options.hh"
 #include "pism/util/pism_utilities.hh" // pism::printf()
@@ -274,6 +275,9 @@ Blatter::Blatter(std::shared_ptr<const Grid> grid, int Mz, int coarsening_factor
                        "Failed to allocate a Blatter solver instance");
   }
 
+  m_element_geometry_valid = false;
+  setup_jacobian();
+
   {
     std::vector<double> sigma(Mz);
     double dz = 1.0 / (Mz - 1.0);
@@ -995,12 +999,31 @@ void Blatter::update(const Inputs &inputs, bool full_update) {
 
   init_2d_parameters(inputs);
   init_ice_hardness(inputs, m_da);
+  reset_element_geometry();
 
   report_mesh_info();
 
+  if (skip_solve([this]() { return relative_residual(); })) {
+    // re-use the velocity from the last solve
+    get_basal_velocity(m_velocity);
+
+    compute_basal_frictional_heating(m_velocity, *inputs.basal_yield_stress,
+                                     inputs.geometry->cell_type,
+                                     m_basal_frictional_heating);
+
+    compute_averaged_velocity(m_velocity);
+    return;
+  }
+
   // Store the "old" initial guess: it may be needed to re-try.
   ierr = VecCopy(m_x, m_x_old); PISM_CHK(ierr, "VecCopy");
 
+  // Use the extrapolated initial guess if it is better. Re-tries below start from the
+  // "old" one.
+  if (m_predictor) {
+    m_predictor->apply(inputs.time, m_snes, m_x);
+  }
+
   SolutionInfo info;
   int snes_total_it = 0;
   int ksp_total_it = 0;
@@ -1076,6 +1099,10 @@ void Blatter::update(const Inputs &inputs, bool full_update) {
   throw RuntimeError(PISM_ERROR_LOCATION, "Blatter solver failed");
 
  bp_done:
+  if (m_predictor) {
+    m_predictor->add(inputs.time, m_x);
+  }
+
   // report the total number of iterations
   m_log->message(2,
                  "Blatter solver: %s. Done.\n"
@@ -1087,6 +1114,11 @@ void Blatter::update(const Inputs &inputs, bool full_update) {
                    "  Level 0 KSP (last iteration): %d\n",
                    (int)info.mg_coarse_ksp_it);
   }
+  if (m_predictor) {
+    m_log->message(2,
+                   "  Predicted initial guesses: %d of %d accepted\n",
+                   m_predictor->n_accepted(), m_predictor->n_predictions());
+  }
 
   // put basal velocity in m_velocity to use it in the next call
   get_basal_velocity(m_velocity);
@@ -1099,6 +1131,35 @@ void Blatter::update(const Inputs &inputs, bool full_update) {
 
   // copy the solution from m_x to m_u_sigma, m_v_sigma for re-starting
   copy_solution();
+
+  solve_done(inputs);
+}
+
+/*!
+ * Compute the norm of the residual at the current velocity relative to the norm of the
+ * residual at zero velocity.
+ *
+ * Has to be called after init_2d_parameters() and init_ice_hardness().
+ */
+double Blatter::relative_residual() {
+  PetscErrorCode ierr = 0;
+
+  petsc::Vec zero, residual;
+  ierr = VecDuplicate(m_x, zero.rawptr()); PISM_CHK(ierr, "VecDuplicate");
+  ierr = VecDuplicate(m_x, residual.rawptr()); PISM_CHK(ierr, "VecDuplicate");
+
+  ierr = VecSet(zero, 0.0); PISM_CHK(ierr, "VecSet");
+
+  double norm[2] = {0.0, 0.0};
+  ::Vec velocity[2] = {m_x, zero};
+  for (int k = 0; k < 2; ++k) {
+    ierr = SNESComputeFunction(m_snes, velocity[k], residual);
+    PISM_CHK(ierr, "SNESComputeFunction");
+
+    ierr = VecNorm(residual, NORM_2, &norm[k]); PISM_CHK(ierr, "VecNorm");
+  }
+
+  return norm[1] > 0.0 ? norm[0] / norm[1] : -1.0;
 }
 
 void Blatter::copy_solution() {
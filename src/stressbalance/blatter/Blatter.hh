@@ -23,9 +23,13 @@
 #include "pism/util/petscwrappers/SNES.hh"
 #include "pism/util/petscwrappers/DM.hh"
 #include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/petscwrappers/Mat.hh"
 #include "pism/util/fem/FEM.hh"
 #include "pism/util/fem/Element.hh"
 
+#include <functional>
+#include <vector>
+
 namespace pism {
 
 namespace fem {
@@ -45,6 +49,8 @@ public:
   std::shared_ptr<array::Array3D> velocity_u_sigma() const;
   std::shared_ptr<array::Array3D> velocity_v_sigma() const;
 
+  std::vector<double> jacobian_difference();
+
   /*!
    * 2D input parameters
    */
@@ -77,6 +83,17 @@ protected:
   // solver
   petsc::SNES m_snes;
 
+  // matrix-free Jacobian (NULL if the Jacobian is assembled)
+  petsc::Mat m_J_mf;
+  // assembled Jacobian used to build the preconditioner with the matrix-free Jacobian
+  petsc::Mat m_J_pc;
+  // point at which the matrix-free Jacobian is evaluated (local, i.e. with ghosts)
+  petsc::Vec m_x_lin;
+
+  // geometric factors of elements used by the matrix-free Jacobian
+  std::vector<fem::Q1Element3::Geometry> m_element_geometry;
+  bool m_element_geometry_valid;
+
   array::Array2D<Parameters> m_parameters;
 
   // Scaling of quadrature weights (note: this does not seem to matter).
@@ -161,6 +178,40 @@ protected:
                               const Vector2d *u_nodal,
                               double K[2 * fem::q13d::n_chi][2 * fem::q13d::n_chi]);
 
+  typedef std::function<void(const fem::Q1Element3 &element, const double *z,
+                             const Vector2d *velocity, const double *B_nodal)>
+  ElementCallback;
+
+  void setup_jacobian();
+
+  void set_linearization_point(const DMDALocalInfo &petsc_info, const Vector2d ***X);
+
+  void reset_element_geometry();
+
+  void jacobian_element_loop(const DMDALocalInfo &info, Parameters **P,
+                             const ElementCallback &callback);
+
+  void jacobian_action(Vec w, Vec y);
+
+  void jacobian_diagonal(Vec d);
+
+  virtual void jacobian_f_action(const fem::Q1Element3 &element,
+                                 const Vector2d *u_nodal,
+                                 const double *B_nodal,
+                                 const Vector2d *w_nodal,
+                                 Vector2d *result);
+
+  void jacobian_basal_action(const double *z,
+                             Parameters **P,
+                             const fem::Q1Element3 &element,
+                             const Vector2d *u_nodal,
+                             const Vector2d *w_nodal,
+                             Vector2d *result);
+
+  static PetscErrorCode jacobian_mult_callback(Mat A, Vec x, Vec y);
+
+  static PetscErrorCode jacobian_diagonal_callback(Mat A, Vec d);
+
   void compute_residual(DMDALocalInfo *info, const Vector2d ***X, Vector2d ***R);
 
   void residual_dirichlet(const DMDALocalInfo &info,
@@ -230,6 +281,8 @@ protected:
   };
 
   SolutionInfo solve();
+
+  double relative_residual();
   SolutionInfo parameter_continuation();
 };
 
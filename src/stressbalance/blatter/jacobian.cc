@@ -45,11 +45,32 @@ void Blatter::jacobian_f(const fem::Q1Element3 &element,
     *u_y = m_work2[2],
     *u_z = m_work2[3];
 
-  double *B = m_work[0];
+  double
+    *B     = m_work[0],
+    *gamma = m_work[1],
+    *nu    = m_work[2],
+    *dnu   = m_work[3];
 
   element.evaluate(u_nodal, u, u_x, u_y, u_z);
   element.evaluate(B_nodal, B);
 
+  // compute the second invariant of the strain rate at quadrature points
+  for (unsigned int q = 0; q < element.n_pts(); ++q) {
+    double
+      ux = u_x[q].u,
+      uy = u_y[q].u,
+      uz = u_z[q].u,
+      vx = u_x[q].v,
+      vy = u_y[q].v,
+      vz = u_z[q].v;
+
+    gamma[q] = (ux * ux + vy * vy + ux * vy +
+                0.25 * ((uy + vx) * (uy + vx) + uz * uz + vz * vz));
+  }
+
+  // evaluate effective viscosity and its derivative at quadrature points
+  m_flow_law->effective_viscosity_n(B, gamma, m_viscosity_eps, element.n_pts(), nu, dnu);
+
   // loop over all quadrature points
   for (unsigned int q = 0; q < element.n_pts(); ++q) {
     auto W = element.weight(q) / m_scaling;
@@ -62,15 +83,10 @@ void Blatter::jacobian_f(const fem::Q1Element3 &element,
       vy = u_y[q].v,
       vz = u_z[q].v;
 
-    double gamma = (ux * ux + vy * vy + ux * vy +
-                    0.25 * ((uy + vx) * (uy + vx) + uz * uz + vz * vz));
-
-    double eta, deta;
-    m_flow_law->effective_viscosity(B[q], gamma, m_viscosity_eps, &eta, &deta);
-
     // add the enhancement factor
-    eta *= m_E_viscosity;
-    deta *= m_E_viscosity;
+    double
+      eta  = nu[q] * m_E_viscosity,
+      deta = dnu[q] * m_E_viscosity;
 
     // loop over test and trial functions, computing the upper-triangular part of
     // the element Jacobian
@@ -199,13 +215,26 @@ void Blatter::jacobian_dirichlet(const DMDALocalInfo &info, Parameters **P, Mat
  */
 void Blatter::compute_jacobian(DMDALocalInfo *petsc_info,
                                const Vector2d ***X, Mat A, Mat J) {
+  PetscErrorCode ierr;
+
+  if (A == m_J_mf) {
+    // the matrix-free Jacobian needs the current iterate only
+    set_linearization_point(*petsc_info, X);
+
+    if (J == A) {
+      ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY); PISM_CHK(ierr, "MatAssemblyBegin");
+      ierr = MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY); PISM_CHK(ierr, "MatAssemblyEnd");
+      return;
+    }
+  }
+
   auto info = grid_transpose(*petsc_info);
 
   // Zero out the Jacobian in preparation for updating it.
-  PetscErrorCode ierr = MatZeroEntries(J);
+  ierr = MatZeroEntries(J);
   PISM_CHK(ierr, "MatZeroEntries");
 
-  ierr = MatSetOption(A, MAT_SUBSET_OFF_PROC_ENTRIES, PETSC_TRUE);
+  ierr = MatSetOption(J, MAT_SUBSET_OFF_PROC_ENTRIES, PETSC_TRUE);
   PISM_CHK(ierr, "MatSetOption");
 
   ierr = MatSetOption(J, MAT_NEW_NONZERO_LOCATION_ERR, PETSC_TRUE);
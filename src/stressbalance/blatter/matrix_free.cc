@@ -0,0 +1,601 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::copy
+#include <cmath>                // std::sin
+#include <cstring>              // memset
+
+#include "pism/stressbalance/blatter/Blatter.hh"
+
+#include "pism/rheology/FlowLaw.hh"
+#include "pism/util/node_types.hh"
+#include "pism/util/error_handling.hh"
+
+#include "pism/stressbalance/blatter/util/DataAccess.hh"
+#include "pism/stressbalance/blatter/util/grid_hierarchy.hh"    // grid_transpose(), grid_z()
+#include "pism/util/fem/Quadrature.hh"
+
+namespace pism {
+namespace stressbalance {
+
+/*!
+ * Create the matrix-free Jacobian (if requested).
+ *
+ * With the "matrix_free_operator" Jacobian the Krylov solver uses the matrix-free action
+ * of the Jacobian while the preconditioner is built using the assembled Jacobian (which
+ * can be lagged using -bp_snes_lag_preconditioner).
+ *
+ * With the "matrix_free" Jacobian nothing is assembled on the finest grid: the
+ * preconditioner has to rely on the action of the Jacobian and its diagonal only (e.g.
+ * multigrid with Chebyshev/Jacobi smoothers on the finest level).
+ */
+void Blatter::setup_jacobian() {
+  auto type = m_config->get_string("stress_balance.blatter.jacobian");
+
+  if (type == "assembled") {
+    return;
+  }
+
+  PetscErrorCode ierr;
+
+  PetscInt n = 0, N = 0;
+  ierr = VecGetLocalSize(m_x, &n); PISM_CHK(ierr, "VecGetLocalSize");
+  ierr = VecGetSize(m_x, &N); PISM_CHK(ierr, "VecGetSize");
+
+  ierr = MatCreateShell(m_grid->com, n, n, N, N, this, m_J_mf.rawptr());
+  PISM_CHK(ierr, "MatCreateShell");
+
+  ierr = MatShellSetOperation(m_J_mf, MATOP_MULT,
+                              (void(*)(void))jacobian_mult_callback);
+  PISM_CHK(ierr, "MatShellSetOperation");
+
+  ierr = MatShellSetOperation(m_J_mf, MATOP_GET_DIAGONAL,
+                              (void(*)(void))jacobian_diagonal_callback);
+  PISM_CHK(ierr, "MatShellSetOperation");
+
+  ierr = MatSetOption(m_J_mf, MAT_SYMMETRIC, PETSC_TRUE);
+  PISM_CHK(ierr, "MatSetOption");
+
+  // storage for the linearization point (including ghosts)
+  ierr = DMCreateLocalVector(m_da, m_x_lin.rawptr());
+  PISM_CHK(ierr, "DMCreateLocalVector");
+
+  if (type == "matrix_free") {
+    ierr = SNESSetJacobian(m_snes, m_J_mf, m_J_mf, NULL, NULL);
+    PISM_CHK(ierr, "SNESSetJacobian");
+  } else {
+    ierr = DMCreateMatrix(m_da, m_J_pc.rawptr());
+    PISM_CHK(ierr, "DMCreateMatrix");
+
+    ierr = SNESSetJacobian(m_snes, m_J_mf, m_J_pc, NULL, NULL);
+    PISM_CHK(ierr, "SNESSetJacobian");
+  }
+
+  m_element_geometry_valid = false;
+}
+
+/*!
+ * Store the current iterate `X` (including ghosts): the matrix-free Jacobian is evaluated
+ * at this point.
+ */
+void Blatter::set_linearization_point(const DMDALocalInfo &petsc_info, const Vector2d ***X) {
+  Vector2d ***x_lin = nullptr;
+  PetscErrorCode ierr = DMDAVecGetArray(m_da, m_x_lin, &x_lin);
+  PISM_CHK(ierr, "DMDAVecGetArray");
+
+  // note: petsc_info uses PETSc's (not PISM's) ordering of indexes
+  for (int k = petsc_info.gzs; k < petsc_info.gzs + petsc_info.gzm; k++) {
+    for (int j = petsc_info.gys; j < petsc_info.gys + petsc_info.gym; j++) {
+      for (int i = petsc_info.gxs; i < petsc_info.gxs + petsc_info.gxm; i++) {
+        x_lin[k][j][i] = X[k][j][i];
+      }
+    }
+  }
+
+  ierr = DMDAVecRestoreArray(m_da, m_x_lin, &x_lin);
+  PISM_CHK(ierr, "DMDAVecRestoreArray");
+}
+
+/*!
+ * Discard geometric factors of elements stored by jacobian_element_loop().
+ *
+ * Has to be called every time the ice geometry changes.
+ */
+void Blatter::reset_element_geometry() {
+  m_element_geometry_valid = false;
+}
+
+/*!
+ * Loop over all the elements that have at least one owned node and call `callback` for
+ * each element that is not exterior.
+ *
+ * Arguments of `callback` are the element, nodal z coordinates, nodal values of the ice
+ * velocity at the linearization point (with Dirichlet values substituted) and ice
+ * hardness. Rows and columns corresponding to Dirichlet nodes are marked as invalid.
+ *
+ * Geometric factors of all the elements are computed during the first call and re-used
+ * until reset_element_geometry() is called. This uses `4*Nq` numbers per element instead
+ * of `2*Nk*2*Nk` numbers stored in the assembled Jacobian.
+ */
+void Blatter::jacobian_element_loop(const DMDALocalInfo &info, Parameters **P,
+                                    const ElementCallback &callback) {
+  double
+    x_min = m_grid->x0() - m_grid->Lx(),
+    y_min = m_grid->y0() - m_grid->Ly(),
+    dx    = m_grid->dx(),
+    dy    = m_grid->dy();
+
+  fem::Q1Element3 element(info,
+                          fem::Q13DQuadrature8(),
+                          dx, dy, x_min, y_min);
+
+  const int Nk = fem::q13d::n_chi;
+  const int Nq = element.n_pts();
+  assert(element.n_chi() <= Nk);
+  assert(Nq <= m_Nq);
+
+  double z[Nk], bottom_elevation[Nk], ice_thickness[Nk], B_nodal[Nk];
+  int node_type[Nk];
+  Vector2d velocity[Nk];
+
+  // number of elements (including ones that have no owned nodes) in each direction
+  int
+    Mx = info.gxm - 1,
+    My = info.gym - 1,
+    Mz = info.gzm - 1;
+
+  bool use_cache = m_element_geometry_valid;
+  if (not use_cache) {
+    m_element_geometry.resize(Mx * My * Mz * Nq);
+  }
+
+  DataAccess<double***> hardness(m_da, 3, GHOSTED);
+
+  Vector2d ***X = nullptr;
+  PetscErrorCode ierr = DMDAVecGetArray(m_da, m_x_lin, &X);
+  PISM_CHK(ierr, "DMDAVecGetArray");
+
+  for (int j = info.gys; j < info.gys + info.gym - 1; j++) {
+    for (int i = info.gxs; i < info.gxs + info.gxm - 1; i++) {
+
+      nodal_parameter_values(element, P, i, j,
+                             node_type,
+                             bottom_elevation,
+                             ice_thickness,
+                             NULL,
+                             NULL);
+
+      // skip ice-free (exterior) columns
+      if (exterior_element(node_type)) {
+        continue;
+      }
+
+      for (int k = info.gzs; k < info.gzs + info.gzm - 1; k++) {
+
+        for (int n = 0; n < Nk; ++n) {
+          auto I = element.local_to_global(i, j, k, n);
+
+          z[n] = grid_z(bottom_elevation[n], ice_thickness[n], info.mz, I.k);
+        }
+
+        auto *G = &m_element_geometry[(((j - info.gys) * Mx + (i - info.gxs)) * Mz +
+                                       (k - info.gzs)) * Nq];
+        if (use_cache) {
+          element.reset(i, j, k, z, G);
+        } else {
+          element.reset(i, j, k, z);
+          const auto &geometry = element.geometry();
+          std::copy(geometry.begin(), geometry.begin() + Nq, G);
+        }
+
+        element.nodal_values((const Vector2d***)X, velocity);
+
+        // Don't contribute to Dirichlet nodes
+        for (int n = 0; n < Nk; ++n) {
+          auto I = element.local_to_global(n);
+          if (dirichlet_node(info, I)) {
+            element.mark_row_invalid(n);
+            element.mark_col_invalid(n);
+            velocity[n] = u_bc(element.x(n), element.y(n), element.z(n));
+          }
+        }
+
+        element.nodal_values((double***)hardness, B_nodal);
+
+        callback(element, z, velocity, B_nodal);
+      }
+    }
+  }
+
+  ierr = DMDAVecRestoreArray(m_da, m_x_lin, &X);
+  PISM_CHK(ierr, "DMDAVecRestoreArray");
+
+  m_element_geometry_valid = true;
+}
+
+/*!
+ * Computes the action of the Jacobian contribution of the "main" part of the Blatter
+ * system on `w_nodal`, adding to `result`.
+ *
+ * Uses the directional derivative of the second invariant of the strain rate instead of
+ * element Jacobian entries. This is equivalent to multiplying by the matrix computed by
+ * jacobian_f() but requires O(Nq*Nk) instead of O(Nq*Nk^2) operations.
+ */
+void Blatter::jacobian_f_action(const fem::Q1Element3 &element,
+                                const Vector2d *u_nodal,
+                                const double *B_nodal,
+                                const Vector2d *w_nodal,
+                                Vector2d *result) {
+  int Nk = fem::q13d::n_chi;
+
+  Vector2d
+    *u   = m_work2[0],
+    *u_x = m_work2[1],
+    *u_y = m_work2[2],
+    *u_z = m_work2[3],
+    *w   = m_work2[4],
+    *w_x = m_work2[5],
+    *w_y = m_work2[6],
+    *w_z = m_work2[7];
+
+  double
+    *B     = m_work[0],
+    *gamma = m_work[1],
+    *nu    = m_work[2],
+    *dnu   = m_work[3];
+
+  element.evaluate(u_nodal, u, u_x, u_y, u_z);
+  element.evaluate(w_nodal, w, w_x, w_y, w_z);
+  element.evaluate(B_nodal, B);
+
+  // compute the second invariant of the strain rate at quadrature points
+  for (unsigned int q = 0; q < element.n_pts(); ++q) {
+    double
+      ux = u_x[q].u,
+      uy = u_y[q].u,
+      uz = u_z[q].u,
+      vx = u_x[q].v,
+      vy = u_y[q].v,
+      vz = u_z[q].v;
+
+    gamma[q] = (ux * ux + vy * vy + ux * vy +
+                0.25 * ((uy + vx) * (uy + vx) + uz * uz + vz * vz));
+  }
+
+  // evaluate effective viscosity and its derivative at quadrature points
+  m_flow_law->effective_viscosity_n(B, gamma, m_viscosity_eps, element.n_pts(), nu, dnu);
+
+  for (unsigned int q = 0; q < element.n_pts(); ++q) {
+    auto W = element.weight(q) / m_scaling;
+
+    double
+      ux = u_x[q].u,
+      uy = u_y[q].u,
+      uz = u_z[q].u,
+      vx = u_x[q].v,
+      vy = u_y[q].v,
+      vz = u_z[q].v;
+
+    double
+      wux = w_x[q].u,
+      wuy = w_y[q].u,
+      wuz = w_z[q].u,
+      wvx = w_x[q].v,
+      wvy = w_y[q].v,
+      wvz = w_z[q].v;
+
+    // add the enhancement factor
+    double
+      eta  = nu[q] * m_E_viscosity,
+      deta = dnu[q] * m_E_viscosity;
+
+    // derivative of gamma in the direction w
+    double dgamma = ((2.0 * ux + vy) * wux + (2.0 * vy + ux) * wvy +
+                     0.5 * ((uy + vx) * (wuy + wvx) + uz * wuz + vz * wvz));
+
+    for (int t = 0; t < Nk; ++t) {
+      auto psi = element.chi(q, t);
+
+      // F_u = grad(psi) . (4ux + 2vy, uy + vx, uz) and
+      // F_v = grad(psi) . (uy + vx, 4vy + 2ux, vz)
+      double
+        F_u = (psi.dx * (4.0 * ux + 2.0 * vy) + psi.dy * (uy + vx) + psi.dz * uz),
+        F_v = (psi.dx * (uy + vx) + psi.dy * (4.0 * vy + 2.0 * ux) + psi.dz * vz);
+
+      // F_u and F_v are linear in u, so their derivatives in the direction w are F_u(w)
+      // and F_v(w)
+      double
+        dF_u = (psi.dx * (4.0 * wux + 2.0 * wvy) + psi.dy * (wuy + wvx) + psi.dz * wuz),
+        dF_v = (psi.dx * (wuy + wvx) + psi.dy * (4.0 * wvy + 2.0 * wux) + psi.dz * wvz);
+
+      result[t].u += W * (eta * dF_u + deta * dgamma * F_u);
+      result[t].v += W * (eta * dF_v + deta * dgamma * F_v);
+    }
+  } // end of the loop over q
+}
+
+/*!
+ * Computes the basal boundary condition contribution to the action of the Jacobian on
+ * `w_nodal`, adding to `result`.
+ */
+void Blatter::jacobian_basal_action(const double *z,
+                                    Parameters **P,
+                                    const fem::Q1Element3 &element,
+                                    const Vector2d *u_nodal,
+                                    const Vector2d *w_nodal,
+                                    Vector2d *result) {
+  const int Nk = fem::q13d::n_chi;
+
+  double floatation[Nk], basal_yield_stress[Nk];
+  for (int n = 0; n < Nk; ++n) {
+    auto I = element.local_to_global(n);
+
+    basal_yield_stress[n] = P[I.j][I.i].tauc;
+    floatation[n]         = P[I.j][I.i].floatation;
+  }
+
+  fem::Q1Element3Face *face = grounding_line(floatation) ? &m_face100 : &m_face4;
+
+  face->reset(fem::q13d::FACE_BOTTOM, z);
+
+  double K[2 * Nk][2 * Nk];
+  memset(K, 0, sizeof(K));
+
+  jacobian_basal(*face, basal_yield_stress, floatation, u_nodal, K);
+
+  for (int t = 0; t < Nk; ++t) {
+    for (int s = 0; s < Nk; ++s) {
+      result[t].u += K[t * 2 + 0][s * 2 + 0] * w_nodal[s].u + K[t * 2 + 0][s * 2 + 1] * w_nodal[s].v;
+      result[t].v += K[t * 2 + 1][s * 2 + 0] * w_nodal[s].u + K[t * 2 + 1][s * 2 + 1] * w_nodal[s].v;
+    }
+  }
+}
+
+/*!
+ * Compute `y = J w`, where `J` is the Jacobian at the point set using
+ * set_linearization_point().
+ *
+ * The result is the same as the product of `w` and the matrix assembled by
+ * compute_jacobian().
+ */
+void Blatter::jacobian_action(Vec w, Vec y) {
+  PetscErrorCode ierr;
+
+  DMDALocalInfo petsc_info;
+  ierr = DMDAGetLocalInfo(m_da, &petsc_info); PISM_CHK(ierr, "DMDAGetLocalInfo");
+  auto info = grid_transpose(petsc_info);
+
+  Vec w_local = nullptr;
+  ierr = DMGetLocalVector(m_da, &w_local); PISM_CHK(ierr, "DMGetLocalVector");
+
+  ierr = DMGlobalToLocalBegin(m_da, w, INSERT_VALUES, w_local);
+  PISM_CHK(ierr, "DMGlobalToLocalBegin");
+  ierr = DMGlobalToLocalEnd(m_da, w, INSERT_VALUES, w_local);
+  PISM_CHK(ierr, "DMGlobalToLocalEnd");
+
+  ierr = VecSet(y, 0.0); PISM_CHK(ierr, "VecSet");
+
+  Vector2d ***W = nullptr, ***Y = nullptr;
+  ierr = DMDAVecGetArray(m_da, w_local, &W); PISM_CHK(ierr, "DMDAVecGetArray");
+  ierr = DMDAVecGetArray(m_da, y, &Y); PISM_CHK(ierr, "DMDAVecGetArray");
+
+  array::AccessScope list(m_parameters);
+  auto *P = m_parameters.array();
+
+  const int Nk = fem::q13d::n_chi;
+
+  auto element_action = [&](const fem::Q1Element3 &element, const double *z,
+                            const Vector2d *velocity, const double *B_nodal) {
+    Vector2d w_nodal[Nk], y_nodal[Nk];
+
+    element.nodal_values((const Vector2d***)W, w_nodal);
+    for (int n = 0; n < Nk; ++n) {
+      // Dirichlet nodes do not contribute
+      if (dirichlet_node(info, element.local_to_global(n))) {
+        w_nodal[n] = 0.0;
+      }
+    }
+
+    jacobian_f_action(element, velocity, B_nodal, w_nodal, y_nodal);
+
+    // basal boundary
+    if (element.local_to_global(0).k == 0) {
+      jacobian_basal_action(z, P, element, velocity, w_nodal, y_nodal);
+    }
+
+    element.add_contribution(y_nodal, Y);
+  };
+
+  jacobian_element_loop(info, P, element_action);
+
+  // identity at Dirichlet nodes (both explicit and grid points outside the domain)
+  for (int j = info.ys; j < info.ys + info.ym; j++) {
+    for (int i = info.xs; i < info.xs + info.xm; i++) {
+      for (int k = info.zs; k < info.zs + info.zm; k++) {
+        if ((int)P[j][i].node_type == NODE_EXTERIOR or dirichlet_node(info, {i, j, k})) {
+          Y[j][i][k] += W[j][i][k]; // STORAGE_ORDER
+        }
+      }
+    }
+  }
+
+  ierr = DMDAVecRestoreArray(m_da, y, &Y); PISM_CHK(ierr, "DMDAVecRestoreArray");
+  ierr = DMDAVecRestoreArray(m_da, w_local, &W); PISM_CHK(ierr, "DMDAVecRestoreArray");
+
+  ierr = DMRestoreLocalVector(m_da, &w_local); PISM_CHK(ierr, "DMRestoreLocalVector");
+}
+
+/*!
+ * Compute the diagonal of the Jacobian at the point set using set_linearization_point().
+ *
+ * Used by point-block Jacobi and Chebyshev smoothers when the Jacobian is not assembled.
+ */
+void Blatter::jacobian_diagonal(Vec d) {
+  PetscErrorCode ierr;
+
+  DMDALocalInfo petsc_info;
+  ierr = DMDAGetLocalInfo(m_da, &petsc_info); PISM_CHK(ierr, "DMDAGetLocalInfo");
+  auto info = grid_transpose(petsc_info);
+
+  ierr = VecSet(d, 0.0); PISM_CHK(ierr, "VecSet");
+
+  Vector2d ***D = nullptr;
+  ierr = DMDAVecGetArray(m_da, d, &D); PISM_CHK(ierr, "DMDAVecGetArray");
+
+  array::AccessScope list(m_parameters);
+  auto *P = m_parameters.array();
+
+  const int Nk = fem::q13d::n_chi;
+
+  auto element_diagonal = [&](const fem::Q1Element3 &element, const double *z,
+                              const Vector2d *velocity, const double *B_nodal) {
+    double K[2 * Nk][2 * Nk];
+    memset(K, 0, sizeof(K));
+
+    // note: jacobian_f() computes the upper-triangular part, including the diagonal
+    jacobian_f(element, velocity, B_nodal, K);
+
+    // basal boundary
+    if (element.local_to_global(0).k == 0) {
+      double floatation[Nk], basal_yield_stress[Nk];
+      for (int n = 0; n < Nk; ++n) {
+        auto I = element.local_to_global(n);
+
+        basal_yield_stress[n] = P[I.j][I.i].tauc;
+        floatation[n]         = P[I.j][I.i].floatation;
+      }
+
+      fem::Q1Element3Face *face = grounding_line(floatation) ? &m_face100 : &m_face4;
+
+      face->reset(fem::q13d::FACE_BOTTOM, z);
+
+      jacobian_basal(*face, basal_yield_stress, floatation, velocity, K);
+    }
+
+    Vector2d d_nodal[Nk];
+    for (int n = 0; n < Nk; ++n) {
+      d_nodal[n] = {K[n * 2 + 0][n * 2 + 0], K[n * 2 + 1][n * 2 + 1]};
+    }
+
+    element.add_contribution(d_nodal, D);
+  };
+
+  jacobian_element_loop(info, P, element_diagonal);
+
+  // identity at Dirichlet nodes (both explicit and grid points outside the domain)
+  for (int j = info.ys; j < info.ys + info.ym; j++) {
+    for (int i = info.xs; i < info.xs + info.xm; i++) {
+      for (int k = info.zs; k < info.zs + info.zm; k++) {
+        if ((int)P[j][i].node_type == NODE_EXTERIOR or dirichlet_node(info, {i, j, k})) {
+          D[j][i][k] += Vector2d(1.0, 1.0); // STORAGE_ORDER
+        }
+      }
+    }
+  }
+
+  ierr = DMDAVecRestoreArray(m_da, d, &D); PISM_CHK(ierr, "DMDAVecRestoreArray");
+}
+
+/*!
+ * Compare the matrix-free Jacobian to the assembled one at the current solution.
+ *
+ * Returns relative differences (in the max norm) between products of the two Jacobians
+ * and a test vector and between their diagonals.
+ *
+ * Requires the "matrix_free_operator" Jacobian. Used by regression tests.
+ */
+std::vector<double> Blatter::jacobian_difference() {
+  if (m_J_pc.get() == nullptr) {
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "comparing Jacobians requires"
+                       " stress_balance.blatter.jacobian = matrix_free_operator");
+  }
+
+  PetscErrorCode ierr;
+
+  // evaluate both Jacobians at the current solution
+  ierr = SNESComputeJacobian(m_snes, m_x, m_J_mf, m_J_pc);
+  PISM_CHK(ierr, "SNESComputeJacobian");
+
+  petsc::Vec w, y_mf, y;
+  ierr = VecDuplicate(m_x, w.rawptr()); PISM_CHK(ierr, "VecDuplicate");
+  ierr = VecDuplicate(m_x, y_mf.rawptr()); PISM_CHK(ierr, "VecDuplicate");
+  ierr = VecDuplicate(m_x, y.rawptr()); PISM_CHK(ierr, "VecDuplicate");
+
+  // the test vector: all the entries are different and non-zero
+  {
+    PetscInt start = 0, end = 0;
+    ierr = VecGetOwnershipRange(w, &start, &end); PISM_CHK(ierr, "VecGetOwnershipRange");
+
+    petsc::VecArray W(w);
+    for (PetscInt n = start; n < end; ++n) {
+      W.get()[n - start] = std::sin(n + 1.0);
+    }
+  }
+
+  // computes |a - b| / |a|, overwriting b
+  auto relative_difference = [](Vec a, Vec b) {
+    double a_norm = 0.0, difference = 0.0;
+    PetscErrorCode code = VecNorm(a, NORM_INFINITY, &a_norm); PISM_CHK(code, "VecNorm");
+    code = VecAXPY(b, -1.0, a); PISM_CHK(code, "VecAXPY");
+    code = VecNorm(b, NORM_INFINITY, &difference); PISM_CHK(code, "VecNorm");
+    return difference / a_norm;
+  };
+
+  std::vector<double> result;
+
+  ierr = MatMult(m_J_pc, w, y); PISM_CHK(ierr, "MatMult");
+  ierr = MatMult(m_J_mf, w, y_mf); PISM_CHK(ierr, "MatMult");
+  result.push_back(relative_difference(y, y_mf));
+
+  ierr = MatGetDiagonal(m_J_pc, y); PISM_CHK(ierr, "MatGetDiagonal");
+  ierr = MatGetDiagonal(m_J_mf, y_mf); PISM_CHK(ierr, "MatGetDiagonal");
+  result.push_back(relative_difference(y, y_mf));
+
+  return result;
+}
+
+PetscErrorCode Blatter::jacobian_mult_callback(Mat A, Vec x, Vec y) {
+  Blatter *solver = nullptr;
+  PetscErrorCode ierr = MatShellGetContext(A, &solver); CHKERRQ(ierr);
+  try {
+    solver->jacobian_action(x, y);
+  } catch (...) {
+    MPI_Comm com = solver->grid()->com;
+    handle_fatal_errors(com);
+    SETERRQ(com, 1, "A PISM callback failed");
+  }
+  return 0;
+}
+
+PetscErrorCode Blatter::jacobian_diagonal_callback(Mat A, Vec d) {
+  Blatter *solver = nullptr;
+  PetscErrorCode ierr = MatShellGetContext(A, &solver); CHKERRQ(ierr);
+  try {
+    solver->jacobian_diagonal(d);
+  } catch (...) {
+    MPI_Comm com = solver->grid()->com;
+    handle_fatal_errors(com);
+    SETERRQ(com, 1, "A PISM callback failed");
+  }
+  return 0;
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
@@ -45,7 +45,10 @@ void Blatter::residual_f(const fem::Q1Element3 &element,
     *u_y = m_work2[2],
     *u_z = m_work2[3];
 
-  double *B = m_work[0];
+  double
+    *B     = m_work[0],
+    *gamma = m_work[1],
+    *nu    = m_work[2];
 
   // evaluate u and its partial derivatives at quadrature points
   element.evaluate(u_nodal, u, u_x, u_y, u_z);
@@ -53,6 +56,23 @@ void Blatter::residual_f(const fem::Q1Element3 &element,
   // evaluate B (ice hardness) at quadrature points
   element.evaluate(B_nodal, B);
 
+  // compute the second invariant of the strain rate at quadrature points
+  for (unsigned int q = 0; q < element.n_pts(); ++q) {
+    double
+      ux = u_x[q].u,
+      uy = u_y[q].u,
+      uz = u_z[q].u,
+      vx = u_x[q].v,
+      vy = u_y[q].v,
+      vz = u_z[q].v;
+
+    gamma[q] = (ux * ux + vy * vy + ux * vy +
+                0.25 * ((uy + vx) * (uy + vx) + uz * uz + vz * vz));
+  }
+
+  // evaluate effective viscosity at quadrature points
+  m_flow_law->effective_viscosity_n(B, gamma, m_viscosity_eps, element.n_pts(), nu, nullptr);
+
   // loop over all quadrature points
   for (unsigned int q = 0; q < element.n_pts(); ++q) {
     auto W = element.weight(q) / m_scaling;
@@ -65,14 +85,8 @@ void Blatter::residual_f(const fem::Q1Element3 &element,
       vy = u_y[q].v,
       vz = u_z[q].v;
 
-    double gamma = (ux * ux + vy * vy + ux * vy +
-                    0.25 * ((uy + vx) * (uy + vx) + uz * uz + vz * vz));
-
-    double eta;
-    m_flow_law->effective_viscosity(B[q], gamma, m_viscosity_eps, &eta, nullptr);
-
     // add the enhancement factor
-    eta *= m_E_viscosity;
+    double eta = nu[q] * m_E_viscosity;
 
     // loop over all test functions
     for (int t = 0; t < element.n_chi(); ++t) {
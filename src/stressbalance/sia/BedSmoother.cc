@@ -23,7 +23,9 @@
 #include "pism/util/Grid.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/GhostUpdate.hh"
 #include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/IS.hh"
 #include "pism/util/petscwrappers/Vec.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/VariableMetadata.hh"
@@ -61,14 +63,6 @@ BedSmoother::BedSmoother(std::shared_ptr<const Grid> g)
     m_C4.metadata(0)
         .long_name("polynomial coeff of H^-4, in bed roughness parameterization")
         .units("m^4");
-
-    // allocate Vecs that live on processor 0:
-    m_topgp0 = m_topgsmooth.allocate_proc0_copy();
-    m_topgsmoothp0 = m_topgsmooth.allocate_proc0_copy();
-    m_maxtlp0 = m_maxtl.allocate_proc0_copy();
-    m_C2p0 = m_C2.allocate_proc0_copy();
-    m_C3p0 = m_C3.allocate_proc0_copy();
-    m_C4p0 = m_C4.allocate_proc0_copy();
   }
 
   m_Glen_exponent = m_config->get_number("stress_balance.sia.Glen_exponent"); // choice is SIA; see #285
@@ -86,6 +80,15 @@ BedSmoother::BedSmoother(std::shared_ptr<const Grid> g)
   // initialized right after construction and users don't have to call preprocess_bed() manually.
   m_Nx = -1;
   m_Ny = -1;
+
+  // the scatter used to get the patch of the bed needed by this rank is created by
+  // preprocess_bed()
+  m_window_Nx = -1;
+  m_window_Ny = -1;
+  m_window_xs = 0;
+  m_window_xm = 0;
+  m_window_ys = 0;
+  m_window_ym = 0;
 }
 
 
@@ -137,131 +140,211 @@ void BedSmoother::preprocess_bed(const array::Scalar &topg,
   m_Nx = Nx;
   m_Ny = Ny;
 
-  topg.put_on_proc0(*m_topgp0);
-  smooth_the_bed_on_proc0();
-  // next call *does indeed* fill ghosts in topgsmooth
-  m_topgsmooth.get_from_proc0(*m_topgsmoothp0);
-
-  compute_coefficients_on_proc0();
-  // following calls *do* fill the ghosts
-  m_maxtl.get_from_proc0(*m_maxtlp0);
-  m_C2.get_from_proc0(*m_C2p0);
-  m_C3.get_from_proc0(*m_C3p0);
-  m_C4.get_from_proc0(*m_C4p0);
+  get_window(topg);
+
+  smooth_the_bed();
+  compute_coefficients();
+
+  // fill ghosts
+  array::update_ghosts({ &m_topgsmooth, &m_maxtl, &m_C2, &m_C3, &m_C4 });
 }
 
+/*!
+ * Sets up the scatter used to get the patch of the original bed elevation needed to
+ * compute the smoothed bed and coefficients in the sub-domain owned by this rank.
+ *
+ * The patch extends `m_Nx` and `m_Ny` grid points beyond the owned sub-domain, so it
+ * may include points owned by ranks that are not immediate neighbors of this one. (This
+ * is why we can't use ghosts of an array::Scalar with a wide stencil: PETSc requires
+ * the stencil width to be less than the width of the sub-domain owned by a rank.)
+ */
+void BedSmoother::set_up_window() {
+  PetscErrorCode ierr = 0;
+
+  const int
+    Mx = (int)m_grid->Mx(),
+    My = (int)m_grid->My(),
+    xs = m_grid->xs(),
+    ys = m_grid->ys();
+
+  // the smoothing domain is not periodic: clip the patch to the grid
+  m_window_xs = std::max(xs - m_Nx, 0);
+  m_window_ys = std::max(ys - m_Ny, 0);
+  m_window_xm = std::min(xs + (int)m_grid->xm() + m_Nx, Mx) - m_window_xs;
+  m_window_ym = std::min(ys + (int)m_grid->ym() + m_Ny, My) - m_window_ys;
+
+  const int
+    n_owned  = m_grid->xm() * m_grid->ym(),
+    n_window = m_window_xm * m_window_ym;
+
+  if (m_topg_owned.get() == nullptr) {
+    ierr = VecCreateMPI(m_grid->com, n_owned, PETSC_DETERMINE, m_topg_owned.rawptr());
+    PISM_CHK(ierr, "VecCreateMPI");
+  }
 
-//! Computes the smoothed bed by a simple average over a rectangle of grid points.
-void BedSmoother::smooth_the_bed_on_proc0() {
+  // destroy the patch and the scatter created for different half-widths, if any
+  ierr = VecDestroy(m_topg_window.rawptr());
+  PISM_CHK(ierr, "VecDestroy");
 
-  ParallelSection rank0(m_grid->com);
-  try {
-    if (m_grid->rank() == 0) {
-      const int Mx = (int)m_grid->Mx();
-      const int My = (int)m_grid->My();
-
-      petsc::VecArray2D
-        b0(*m_topgp0,       Mx, My),
-        bs(*m_topgsmoothp0, Mx, My);
-
-      for (int j=0; j < My; j++) {
-        for (int i=0; i < Mx; i++) {
-          // average only over those points which are in the grid; do
-          // not wrap periodically
-          double sum = 0.0, count = 0.0;
-          for (int r = -m_Nx; r <= m_Nx; r++) {
-            for (int s = -m_Ny; s <= m_Ny; s++) {
-              if ((i+r >= 0) and (i+r < Mx) and (j+s >= 0) and (j+s < My)) {
-                sum   += b0(i+r, j+s);
-                count += 1.0;
-              }
-            }
-          }
-          // unprotected division by count but r=0,s=0 case guarantees count>=1
-          bs(i, j) = sum / count;
-        }
-      }
+  ierr = VecScatterDestroy(m_window_scatter.rawptr());
+  PISM_CHK(ierr, "VecScatterDestroy");
+
+  ierr = VecCreateSeq(PETSC_COMM_SELF, n_window, m_topg_window.rawptr());
+  PISM_CHK(ierr, "VecCreateSeq");
+
+  // Indexes of points in the patch using the "natural" ordering...
+  std::vector<PetscInt> from(n_window), to(n_window);
+  for (int j = 0; j < m_window_ym; ++j) {
+    for (int i = 0; i < m_window_xm; ++i) {
+      const int k = j * m_window_xm + i;
+      from[k] = (m_window_ys + j) * Mx + (m_window_xs + i);
+      to[k]   = k;
+    }
+  }
+
+  // ... converted to the PETSc ordering of a DMDA. Values in m_topg_owned use the same
+  // ordering: each rank stores owned values in the order used by Grid::points().
+  AO ao = NULL;
+  ierr = DMDAGetAO(*m_topgsmooth.dm(), &ao);
+  PISM_CHK(ierr, "DMDAGetAO");
+
+  ierr = AOApplicationToPetsc(ao, n_window, from.data());
+  PISM_CHK(ierr, "AOApplicationToPetsc");
+
+  petsc::IS is_from, is_to;
+  ierr = ISCreateGeneral(PETSC_COMM_SELF, n_window, from.data(), PETSC_COPY_VALUES,
+                         is_from.rawptr());
+  PISM_CHK(ierr, "ISCreateGeneral");
+
+  ierr = ISCreateGeneral(PETSC_COMM_SELF, n_window, to.data(), PETSC_COPY_VALUES,
+                         is_to.rawptr());
+  PISM_CHK(ierr, "ISCreateGeneral");
+
+  ierr = VecScatterCreate(m_topg_owned, is_from, m_topg_window, is_to,
+                          m_window_scatter.rawptr());
+  PISM_CHK(ierr, "VecScatterCreate");
+
+  m_window_Nx = m_Nx;
+  m_window_Ny = m_Ny;
+}
+
+//! Gets the patch of the original bed `topg` needed by this rank.
+void BedSmoother::get_window(const array::Scalar &topg) {
+  if (m_window_Nx != m_Nx or m_window_Ny != m_Ny) {
+    set_up_window();
+  }
+
+  {
+    array::AccessScope list{&topg};
+    petsc::VecArray owned(m_topg_owned);
+    double *b = owned.get();
+
+    int k = 0;
+    for (auto p = m_grid->points(); p; p.next()) {
+      b[k] = topg(p.i(), p.j());
+      ++k;
     }
-  } catch (...) {
-    rank0.failed();
   }
-  rank0.check();
+
+  PetscErrorCode ierr = 0;
+  ierr = VecScatterBegin(m_window_scatter, m_topg_owned, m_topg_window,
+                         INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterBegin");
+
+  ierr = VecScatterEnd(m_window_scatter, m_topg_owned, m_topg_window,
+                       INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterEnd");
 }
 
+//! Computes the smoothed bed by a simple average over a rectangle of grid points.
+/*!
+ * Uses the patch of the original bed stored in `m_topg_window`. Does not update ghosts.
+ */
+void BedSmoother::smooth_the_bed() {
+  const int Mx = (int)m_grid->Mx();
+  const int My = (int)m_grid->My();
 
-void BedSmoother::compute_coefficients_on_proc0() {
+  petsc::VecArray2D b0(m_topg_window, m_window_xm, m_window_ym, -m_window_xs, -m_window_ys);
 
-  const unsigned int Mx = m_grid->Mx(), My = m_grid->My();
+  array::AccessScope list{&m_topgsmooth};
 
-  ParallelSection rank0(m_grid->com);
-  try {
-    if (m_grid->rank() == 0) {
-      petsc::VecArray2D
-        b0(*m_topgp0,       Mx, My),
-        bs(*m_topgsmoothp0, Mx, My),
-        mt(*m_maxtlp0,      Mx, My),
-        c2(*m_C2p0,         Mx, My),
-        c3(*m_C3p0,         Mx, My),
-        c4(*m_C4p0,         Mx, My);
-
-      for (int j=0; j < (int)My; j++) {
-        for (int i=0; i < (int)Mx; i++) {
-          // average only over those points which are in the grid
-          // do not wrap periodically
-          double
-            topgs     = bs(i, j),
-            maxtltemp = 0.0,
-            sum2      = 0.0,
-            sum3      = 0.0,
-            sum4      = 0.0,
-            count     = 0.0;
-
-          for (int r = -m_Nx; r <= m_Nx; r++) {
-            for (int s = -m_Ny; s <= m_Ny; s++) {
-              if ((i+r >= 0) && (i+r < (int)Mx) && (j+s >= 0) && (j+s < (int)My)) {
-                // tl is elevation of local topography at a pt in patch
-                const double tl  = b0(i+r, j+s) - topgs;
-                maxtltemp = std::max(maxtltemp, tl);
-                // accumulate 2nd, 3rd, and 4th powers with only 3 multiplications
-                const double tl2 = tl * tl;
-                sum2 += tl2;
-                sum3 += tl2 * tl;
-                sum4 += tl2 * tl2;
-                count += 1.0;
-              }
-            }
-          }
-          mt(i, j) = maxtltemp;
-
-          // unprotected division by count but r=0,s=0 case guarantees count>=1
-          c2(i, j) = sum2 / count;
-          c3(i, j) = sum3 / count;
-          c4(i, j) = sum4 / count;
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    // average only over those points which are in the grid; do
+    // not wrap periodically
+    double sum = 0.0, count = 0.0;
+    for (int r = -m_Nx; r <= m_Nx; r++) {
+      for (int s = -m_Ny; s <= m_Ny; s++) {
+        if ((i+r >= 0) and (i+r < Mx) and (j+s >= 0) and (j+s < My)) {
+          sum   += b0(i+r, j+s);
+          count += 1.0;
         }
       }
+    }
+    // unprotected division by count but r=0,s=0 case guarantees count>=1
+    m_topgsmooth(i, j) = sum / count;
+  }
+}
 
-      // scale the coeffs in Taylor series
-      const double
-        n = m_Glen_exponent,
-        k  = (n + 2) / n,
-        s2 = k * (2 * n + 2) / (2 * n),
-        s3 = s2 * (3 * n + 2) / (3 * n),
-        s4 = s3 * (4 * n + 2) / (4 * n);
 
-      PetscErrorCode ierr;
-      ierr = VecScale(*m_C2p0,s2);
-      PISM_CHK(ierr, "VecScale");
+/*!
+ * Computes the maximum elevation of the local topography and coefficients of the
+ * approximation of \f$\theta\f$ in the sub-domain owned by this rank.
+ *
+ * Call smooth_the_bed() first. Does not update ghosts.
+ */
+void BedSmoother::compute_coefficients() {
 
-      ierr = VecScale(*m_C3p0,s3);
-      PISM_CHK(ierr, "VecScale");
+  const int Mx = (int)m_grid->Mx(), My = (int)m_grid->My();
 
-      ierr = VecScale(*m_C4p0,s4);
-      PISM_CHK(ierr, "VecScale");
+  // scale the coeffs in Taylor series
+  const double
+    n = m_Glen_exponent,
+    k  = (n + 2) / n,
+    s2 = k * (2 * n + 2) / (2 * n),
+    s3 = s2 * (3 * n + 2) / (3 * n),
+    s4 = s3 * (4 * n + 2) / (4 * n);
+
+  petsc::VecArray2D b0(m_topg_window, m_window_xm, m_window_ym, -m_window_xs, -m_window_ys);
+
+  array::AccessScope list{&m_topgsmooth, &m_maxtl, &m_C2, &m_C3, &m_C4};
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    // average only over those points which are in the grid
+    // do not wrap periodically
+    double
+      topgs     = m_topgsmooth(i, j),
+      maxtltemp = 0.0,
+      sum2      = 0.0,
+      sum3      = 0.0,
+      sum4      = 0.0,
+      count     = 0.0;
+
+    for (int r = -m_Nx; r <= m_Nx; r++) {
+      for (int s = -m_Ny; s <= m_Ny; s++) {
+        if ((i+r >= 0) && (i+r < Mx) && (j+s >= 0) && (j+s < My)) {
+          // tl is elevation of local topography at a pt in patch
+          const double tl  = b0(i+r, j+s) - topgs;
+          maxtltemp = std::max(maxtltemp, tl);
+          // accumulate 2nd, 3rd, and 4th powers with only 3 multiplications
+          const double tl2 = tl * tl;
+          sum2 += tl2;
+          sum3 += tl2 * tl;
+          sum4 += tl2 * tl2;
+          count += 1.0;
+        }
+      }
     }
-  } catch (...) {
-    rank0.failed();
+    m_maxtl(i, j) = maxtltemp;
+
+    // unprotected division by count but r=0,s=0 case guarantees count>=1
+    m_C2(i, j) = (sum2 / count) * s2;
+    m_C3(i, j) = (sum3 / count) * s3;
+    m_C4(i, j) = (sum4 / count) * s4;
   }
-  rank0.check();
 }
 
 
@@ -23,6 +23,8 @@
 
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/ConfigInterface.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/petscwrappers/VecScatter.hh"
 
 namespace pism {
 
@@ -58,6 +60,11 @@ namespace stressbalance {
   topography changes, for instance at the start of an IceModel run, or at a bed
   deformation step in an IceModel run.
 
+  Smoothing is done in parallel: each rank gets the patch of the original
+  topography it needs (the owned sub-domain extended by the smoothing range) and
+  computes the smoothed bed and coefficients at grid points it owns. Results do
+  not depend on the number of ranks.
+
   BedSmoother then provides three major functionalities, all of which \e must
   \e follow the call to `preprocess_bed()`:
   -# User accesses public array::Scalar `topgsmooth`, the smoothed bed itself.
@@ -113,18 +120,27 @@ protected:
 
   double m_Glen_exponent, m_smoothing_range;
 
-  //! original bed elevation on processor 0
-  std::shared_ptr<petsc::Vec> m_topgp0;
-  //! smoothed bed elevation on processor 0
-  std::shared_ptr<petsc::Vec> m_topgsmoothp0;
-  //! maximum elevation at (i,j) of local topography (nearby patch)
-  std::shared_ptr<petsc::Vec> m_maxtlp0, m_C2p0, m_C3p0, m_C4p0;
+  //! half-widths used to set up the scatter below (-1 if not set up yet)
+  int m_window_Nx, m_window_Ny;
+  //! the patch of the original bed needed to smooth the bed in the sub-domain owned by
+  //! this rank: owned grid points plus `m_Nx` and `m_Ny` points on each side, clipped to
+  //! the grid
+  int m_window_xs, m_window_xm, m_window_ys, m_window_ym;
+
+  //! original bed elevation at grid points owned by this rank
+  petsc::Vec m_topg_owned;
+  //! original bed elevation in the patch used by this rank
+  petsc::Vec m_topg_window;
+  //! scatter from m_topg_owned to m_topg_window
+  petsc::VecScatter m_window_scatter;
 
   void preprocess_bed(const array::Scalar &topg,
                       unsigned int Nx_in, unsigned int Ny_in);
 
-  void smooth_the_bed_on_proc0();
-  void compute_coefficients_on_proc0();
+  void set_up_window();
+  void get_window(const array::Scalar &topg);
+  void smooth_the_bed();
+  void compute_coefficients();
 };
 
 } // end of namespace stressbalance
@@ -18,6 +18,7 @@
 
 #include <cstdlib>
 #include <cassert>
+#include <memory>              // std::unique_ptr
 
 #include "pism/stressbalance/sia/BedSmoother.hh"
 #include "pism/stressbalance/sia/SIAFD.hh"
@@ -29,10 +30,13 @@
 #include "pism/util/Grid.hh"
 #include "pism/util/Profiling.hh"
 #include "pism/util/Time.hh"
+#include "pism/util/array/ActiveColumns.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/GhostUpdate.hh"
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/threading.hh"
 #include "pism/util/array/Vector.hh"
 
 namespace pism {
@@ -481,8 +485,7 @@ void SIAFD::surface_gradient_haseloff(const array::Scalar2 &ice_surface_elevatio
     } // end of "y-derivative, i-offset"
   }
 
-  h_x.update_ghosts();
-  h_y.update_ghosts();
+  array::update_ghosts({ &h_x, &h_y });
 }
 
 
@@ -521,6 +524,9 @@ void SIAFD::surface_gradient_haseloff(const array::Scalar2 &ice_surface_elevatio
  *
  * The trapezoidal rule is used to approximate the integral.
  *
+ * \f$D\f$ and \f$\delta\f$ are set to zero at staggered grid points between two ice-free
+ * cells; only active columns (see array::CellType::active_columns()) are visited.
+ *
  * \param[in]  full_update the flag specitying if we're doing a "full" update.
  * \param[in]  h_x x-component of the surface gradient, on the staggered grid
  * \param[in]  h_y y-component of the surface gradient, on the staggered grid
@@ -534,7 +540,13 @@ void SIAFD::compute_diffusivity(bool full_update, const Geometry &geometry,
 
   array::Array3D *delta[] = { &m_delta_0, &m_delta_1 };
 
+  const auto &mask = geometry.cell_type;
+
   result.set(0.0);
+  if (full_update) {
+    delta[0]->set(0.0);
+    delta[1]->set(0.0);
+  }
 
   const double current_time = time().current(),
                D_limit      = m_config->get_number("stress_balance.sia.max_diffusivity");
@@ -545,8 +557,6 @@ void SIAFD::compute_diffusivity(bool full_update, const Geometry &geometry,
              limit_diffusivity = m_config->get_flag("stress_balance.sia.limit_diffusivity"),
              use_age           = compute_grain_size_using_age or e_age_coupling;
 
-  rheology::grain_size_vostok gs_vostok;
-
   // get "theta" from Schoof (2003) bed smoothness calculation and the
   // thickness relative to the smoothed bed; each array::Scalar involved must
   // have stencil width WIDE_GHOSTS for this too work
@@ -555,7 +565,7 @@ void SIAFD::compute_diffusivity(bool full_update, const Geometry &geometry,
   m_bed_smoother->smoothed_thk(geometry.ice_surface_elevation, geometry.ice_thickness,
                                geometry.cell_type, thk_smooth);
 
-  array::AccessScope list{ &result, &theta, &thk_smooth, &h_x, &h_y, enthalpy };
+  array::AccessScope list{ &result, &theta, &thk_smooth, &h_x, &h_y, enthalpy, &mask };
 
   if (use_age) {
     assert(age->stencil_width() >= 2);
@@ -578,146 +588,171 @@ void SIAFD::compute_diffusivity(bool full_update, const Geometry &geometry,
   const std::vector<double> &z = m_grid->z();
   const unsigned int Mx = m_grid->Mx(), My = m_grid->My(), Mz = m_grid->Mz();
 
-  std::vector<double> depth(Mz), stress(Mz), pressure(Mz), E(Mz), flow(Mz);
-  std::vector<double> delta_ij(Mz);
-  std::vector<double> A(Mz),
-      ice_grain_size(Mz, m_config->get_number("constants.ice.grain_size", "m"));
-  std::vector<double> e_factor(Mz, m_e_factor);
+  // work space used by each thread
+  struct Work {
+    Work(unsigned int N, double grain_size, double e)
+        : depth(N), stress(N), pressure(N), E(N), flow(N), delta_ij(N), A(N),
+          ice_grain_size(N, grain_size), e_factor(N, e) {
+      // empty
+    }
+    std::vector<double> depth, stress, pressure, E, flow, delta_ij, A, ice_grain_size, e_factor;
+    rheology::grain_size_vostok gs_vostok;
+    double D_max                 = 0.0;
+    int high_diffusivity_counter = 0;
+  };
+
+  const int n_threads = max_threads(*m_config);
+  std::vector<std::unique_ptr<Work> > work(n_threads);
+  for (int k = 0; k < n_threads; ++k) {
+    work[k].reset(new Work(Mz, m_config->get_number("constants.ice.grain_size", "m"), m_e_factor));
+  }
+
+  // staggered grid points next to ice are in active columns (including one ghost)
+  const auto &columns = mask.active_columns().runs(1);
 
-  double D_max                 = 0.0;
-  int high_diffusivity_counter = 0;
   for (int o = 0; o < 2; o++) {
     ParallelSection loop(m_grid->com);
-    try {
-      for (auto p = m_grid->points(1); p; p.next()) {
-        const int i = p.i(), j = p.j();
-
-        // staggered point: o=0 is i+1/2, o=1 is j+1/2, (i, j) and (i+oi, j+oj)
-        //   are regular grid neighbors of a staggered point:
-        const int oi = 1 - o, oj = o;
+    for_each_point(columns, n_threads, loop, [&](int i, int j, int thread) {
+      Work &w = *work[thread];
+      auto &depth = w.depth, &stress = w.stress, &pressure = w.pressure, &E = w.E,
+           &flow = w.flow, &delta_ij = w.delta_ij, &A = w.A, &ice_grain_size = w.ice_grain_size,
+           &e_factor = w.e_factor;
+
+      // staggered point: o=0 is i+1/2, o=1 is j+1/2, (i, j) and (i+oi, j+oj)
+      //   are regular grid neighbors of a staggered point:
+      const int oi = 1 - o, oj = o;
+
+      // no SIA flow between ice-free cells (result and delta are set to zero above)
+      if (mask.ice_free(i, j) and mask.ice_free(i + oi, j + oj)) {
+        return;
+      }
 
-        const double thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i + oi, j + oj));
+      const double thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i + oi, j + oj));
 
-        // zero thickness case:
-        if (thk == 0.0) {
-          result(i, j, o) = 0.0;
-          if (full_update) {
-            delta[o]->set_column(i, j, 0.0);
-          }
-          continue;
+      // zero thickness case:
+      if (thk == 0.0) {
+        result(i, j, o) = 0.0;
+        if (full_update) {
+          delta[o]->set_column(i, j, 0.0);
         }
+        return;
+      }
 
-        const int ks = m_grid->kBelowHeight(thk);
+      const int ks = m_grid->kBelowHeight(thk);
 
-        for (int k = 0; k <= ks; ++k) {
-          depth[k] = thk - z[k];
-        }
+      for (int k = 0; k <= ks; ++k) {
+        depth[k] = thk - z[k];
+      }
 
-        // pressure added by the ice (i.e. pressure difference between the
-        // current level and the top of the column)
-        m_EC->pressure(depth, ks, pressure); // FIXME issue #15
+      // pressure added by the ice (i.e. pressure difference between the
+      // current level and the top of the column)
+      m_EC->pressure(depth, ks, pressure); // FIXME issue #15
 
-        if (use_age) {
-          const double *age_ij     = age->get_column(i, j),
-                       *age_offset = age->get_column(i + oi, j + oj);
+      if (use_age) {
+        const double *age_ij     = age->get_column(i, j),
+                     *age_offset = age->get_column(i + oi, j + oj);
 
-          for (int k = 0; k <= ks; ++k) {
-            A[k] = 0.5 * (age_ij[k] + age_offset[k]);
-          }
-
-          if (compute_grain_size_using_age) {
-            for (int k = 0; k <= ks; ++k) {
-              // convert age from seconds to years:
-              ice_grain_size[k] = gs_vostok(A[k] * m_seconds_per_year);
-            }
-          }
+        for (int k = 0; k <= ks; ++k) {
+          A[k] = 0.5 * (age_ij[k] + age_offset[k]);
+        }
 
-          if (e_age_coupling) {
-            for (int k = 0; k <= ks; ++k) {
-              const double accumulation_time = current_time - A[k];
-              if (interglacial(accumulation_time)) {
-                e_factor[k] = m_e_factor_interglacial;
-              } else {
-                e_factor[k] = m_e_factor;
-              }
-            }
+        if (compute_grain_size_using_age) {
+          for (int k = 0; k <= ks; ++k) {
+            // convert age from seconds to years:
+            ice_grain_size[k] = w.gs_vostok(A[k] * m_seconds_per_year);
           }
         }
 
-        {
-          const double *E_ij     = enthalpy->get_column(i, j),
-                       *E_offset = enthalpy->get_column(i + oi, j + oj);
+        if (e_age_coupling) {
           for (int k = 0; k <= ks; ++k) {
-            E[k] = 0.5 * (E_ij[k] + E_offset[k]);
+            const double accumulation_time = current_time - A[k];
+            if (interglacial(accumulation_time)) {
+              e_factor[k] = m_e_factor_interglacial;
+            } else {
+              e_factor[k] = m_e_factor;
+            }
           }
         }
+      }
 
-        const double alpha = sqrt(PetscSqr(h_x(i, j, o)) + PetscSqr(h_y(i, j, o)));
+      {
+        const double *E_ij     = enthalpy->get_column(i, j),
+                     *E_offset = enthalpy->get_column(i + oi, j + oj);
         for (int k = 0; k <= ks; ++k) {
-          stress[k] = alpha * pressure[k];
+          E[k] = 0.5 * (E_ij[k] + E_offset[k]);
         }
+      }
 
-        m_flow_law->flow_n(stress.data(), E.data(), pressure.data(), ice_grain_size.data(), ks + 1,
-                           flow.data());
+      const double alpha = sqrt(PetscSqr(h_x(i, j, o)) + PetscSqr(h_y(i, j, o)));
+      for (int k = 0; k <= ks; ++k) {
+        stress[k] = alpha * pressure[k];
+      }
 
-        const double theta_local = 0.5 * (theta(i, j) + theta(i + oi, j + oj));
-        for (int k = 0; k <= ks; ++k) {
-          delta_ij[k] = e_factor[k] * theta_local * 2.0 * pressure[k] * flow[k];
-        }
+      m_flow_law->flow_n(stress.data(), E.data(), pressure.data(), ice_grain_size.data(), ks + 1,
+                         flow.data());
 
-        double D = 0.0; // diffusivity for deformational SIA flow
-        {
-          for (int k = 1; k <= ks; ++k) {
-            // trapezoidal rule
-            const double dz = z[k] - z[k - 1];
-            D += 0.5 * dz * ((depth[k] + dz) * delta_ij[k - 1] + depth[k] * delta_ij[k]);
-          }
-          // finish off D with (1/2) dz (0 + (H-z[ks])*delta_ij[ks]), but dz=H-z[ks]:
-          const double dz = thk - z[ks];
-          D += 0.5 * dz * dz * delta_ij[ks];
-        }
+      const double theta_local = 0.5 * (theta(i, j) + theta(i + oi, j + oj));
+      for (int k = 0; k <= ks; ++k) {
+        delta_ij[k] = e_factor[k] * theta_local * 2.0 * pressure[k] * flow[k];
+      }
 
-        // Override diffusivity at the edges of the domain. (At these
-        // locations PISM uses ghost cells *beyond* the boundary of
-        // the computational domain. This does not matter if the ice
-        // does not extend all the way to the domain boundary, as in
-        // whole-ice-sheet simulations. In a regional setup, though,
-        // this adjustment lets us avoid taking very small time-steps
-        // because of the possible thickness and bed elevation
-        // "discontinuities" at the boundary.)
-        {
-          if ((i < 0 or i >= (int)Mx - 1) and not(m_grid->periodicity() & grid::X_PERIODIC)) {
-            D = 0.0;
-          }
-          if ((j < 0 or j >= (int)My - 1) and not(m_grid->periodicity() & grid::Y_PERIODIC)) {
-            D = 0.0;
-          }
+      double D = 0.0; // diffusivity for deformational SIA flow
+      {
+        for (int k = 1; k <= ks; ++k) {
+          // trapezoidal rule
+          const double dz = z[k] - z[k - 1];
+          D += 0.5 * dz * ((depth[k] + dz) * delta_ij[k - 1] + depth[k] * delta_ij[k]);
         }
+        // finish off D with (1/2) dz (0 + (H-z[ks])*delta_ij[ks]), but dz=H-z[ks]:
+        const double dz = thk - z[ks];
+        D += 0.5 * dz * dz * delta_ij[ks];
+      }
 
-        if (limit_diffusivity and D >= D_limit) {
-          D = D_limit;
-          high_diffusivity_counter += 1;
+      // Override diffusivity at the edges of the domain. (At these
+      // locations PISM uses ghost cells *beyond* the boundary of
+      // the computational domain. This does not matter if the ice
+      // does not extend all the way to the domain boundary, as in
+      // whole-ice-sheet simulations. In a regional setup, though,
+      // this adjustment lets us avoid taking very small time-steps
+      // because of the possible thickness and bed elevation
+      // "discontinuities" at the boundary.)
+      {
+        if ((i < 0 or i >= (int)Mx - 1) and not(m_grid->periodicity() & grid::X_PERIODIC)) {
+          D = 0.0;
         }
+        if ((j < 0 or j >= (int)My - 1) and not(m_grid->periodicity() & grid::Y_PERIODIC)) {
+          D = 0.0;
+        }
+      }
 
-        D_max = std::max(D_max, D);
+      if (limit_diffusivity and D >= D_limit) {
+        D = D_limit;
+        w.high_diffusivity_counter += 1;
+      }
 
-        result(i, j, o) = D;
+      w.D_max = std::max(w.D_max, D);
 
-        // if doing the full update, fill the delta column above the ice and
-        // store it:
-        if (full_update) {
-          for (unsigned int k = ks + 1; k < Mz; ++k) {
-            delta_ij[k] = 0.0;
-          }
-          delta[o]->set_column(i, j, delta_ij.data());
+      result(i, j, o) = D;
+
+      // if doing the full update, fill the delta column above the ice and
+      // store it:
+      if (full_update) {
+        for (unsigned int k = ks + 1; k < Mz; ++k) {
+          delta_ij[k] = 0.0;
         }
-      } // i, j-loop
-    } catch (...) {
-      loop.failed();
-    }
+        delta[o]->set_column(i, j, delta_ij.data());
+      }
+    });
     loop.check();
   } // o-loop
 
+  double D_max                 = 0.0;
+  int high_diffusivity_counter = 0;
+  for (const auto &w : work) {
+    D_max = std::max(D_max, w->D_max);
+    high_diffusivity_counter += w->high_diffusivity_counter;
+  }
+
   m_D_max = GlobalMax(m_grid->com, D_max);
 
   high_diffusivity_counter = GlobalSum(m_grid->com, high_diffusivity_counter);
@@ -791,7 +826,11 @@ void SIAFD::compute_I(const Geometry &geometry) {
 
   m_bed_smoother->smoothed_thk(h, H, mask, thk_smooth);
 
-  array::AccessScope list{ delta[0], delta[1], I[0], I[1], &thk_smooth };
+  // I is zero between ice-free cells (see compute_diffusivity())
+  I[0]->set(0.0);
+  I[1]->set(0.0);
+
+  array::AccessScope list{ delta[0], delta[1], I[0], I[1], &thk_smooth, &mask };
 
   assert(I[0]->stencil_width() >= 1);
   assert(I[1]->stencil_width() >= 1);
@@ -806,37 +845,40 @@ void SIAFD::compute_I(const Geometry &geometry) {
     dz[k] = m_grid->z(k) - m_grid->z(k - 1);
   }
 
+  const int n_threads = max_threads(*m_config);
+
+  const auto &columns = mask.active_columns().runs(1);
+
   for (int o = 0; o < 2; ++o) {
     ParallelSection loop(m_grid->com);
-    try {
-      for (auto p = m_grid->points(1); p; p.next()) {
-        const int i = p.i(), j = p.j();
+    for_each_point(columns, n_threads, loop, [&](int i, int j, int /* thread */) {
+      const int oi = 1 - o, oj = o;
 
-        const int oi = 1 - o, oj = o;
-        const double thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i + oi, j + oj));
+      if (mask.ice_free(i, j) and mask.ice_free(i + oi, j + oj)) {
+        return;
+      }
 
-        const double *delta_ij = delta[o]->get_column(i, j);
-        double *I_ij           = I[o]->get_column(i, j);
+      const double thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i + oi, j + oj));
 
-        const unsigned int ks = m_grid->kBelowHeight(thk);
+      const double *delta_ij = delta[o]->get_column(i, j);
+      double *I_ij           = I[o]->get_column(i, j);
 
-        // within the ice:
-        I_ij[0]          = 0.0;
-        double I_current = 0.0;
-        for (unsigned int k = 1; k <= ks; ++k) {
-          // trapezoidal rule
-          I_current += 0.5 * dz[k] * (delta_ij[k - 1] + delta_ij[k]);
-          I_ij[k] = I_current;
-        }
+      const unsigned int ks = m_grid->kBelowHeight(thk);
 
-        // above the ice:
-        for (unsigned int k = ks + 1; k < Mz; ++k) {
-          I_ij[k] = I_current;
-        }
+      // within the ice:
+      I_ij[0]          = 0.0;
+      double I_current = 0.0;
+      for (unsigned int k = 1; k <= ks; ++k) {
+        // trapezoidal rule
+        I_current += 0.5 * dz[k] * (delta_ij[k - 1] + delta_ij[k]);
+        I_ij[k] = I_current;
       }
-    } catch (...) {
-      loop.failed();
-    }
+
+      // above the ice:
+      for (unsigned int k = ks + 1; k < Mz; ++k) {
+        I_ij[k] = I_current;
+      }
+    });
     loop.check();
   } // o-loop
 }
@@ -872,7 +914,18 @@ void SIAFD::compute_3d_horizontal_velocity(const Geometry &geometry, const array
 
   const unsigned int Mz = m_grid->Mz();
 
-  for (auto p = m_grid->points(); p; p.next()) {
+  const auto &columns = geometry.cell_type.active_columns();
+
+  // I is zero on all sides of an inactive column, so the velocity is equal to the sliding
+  // velocity
+  for (auto p = columns.inactive_points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    u_out.set_column(i, j, sliding_velocity(i, j).u);
+    v_out.set_column(i, j, sliding_velocity(i, j).v);
+  }
+
+  for (auto p = columns.points(); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     const double
@@ -914,8 +967,7 @@ void SIAFD::compute_3d_horizontal_velocity(const Geometry &geometry, const array
   }
 
   // Communicate to get ghosts:
-  u_out.update_ghosts();
-  v_out.update_ghosts();
+  array::update_ghosts({ &u_out, &v_out });
 }
 
 //! Determine if `accumulation_time` corresponds to an interglacial period.
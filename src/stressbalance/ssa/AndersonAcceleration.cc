@@ -0,0 +1,243 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/stressbalance/ssa/AndersonAcceleration.hh"
+
+#include <algorithm>            // std::max
+#include <cmath>                // fabs
+
+#include "pism/util/Grid.hh"
+#include "pism/util/pism_utilities.hh" // GlobalSum()
+
+namespace pism {
+namespace stressbalance {
+
+namespace {
+
+/*!
+ * Solve the `n*n` linear system `A x = b` (`A` is stored row-major) using Gaussian
+ * elimination with partial pivoting. Overwrites `A` and `b`; puts the solution in `b`.
+ *
+ * Returns `false` if `A` is (numerically) singular.
+ */
+bool solve_dense(int n, std::vector<double> &A, std::vector<double> &b) {
+  double scale = 0.0;
+  for (int k = 0; k < n; ++k) {
+    scale = std::max(scale, fabs(A[k * n + k]));
+  }
+
+  for (int k = 0; k < n; ++k) {
+    int pivot = k;
+    for (int r = k + 1; r < n; ++r) {
+      if (fabs(A[r * n + k]) > fabs(A[pivot * n + k])) {
+        pivot = r;
+      }
+    }
+
+    if (fabs(A[pivot * n + k]) <= 1e-14 * scale) {
+      return false;
+    }
+
+    if (pivot != k) {
+      for (int c = 0; c < n; ++c) {
+        std::swap(A[k * n + c], A[pivot * n + c]);
+      }
+      std::swap(b[k], b[pivot]);
+    }
+
+    for (int r = k + 1; r < n; ++r) {
+      double factor = A[r * n + k] / A[k * n + k];
+      for (int c = k; c < n; ++c) {
+        A[r * n + c] -= factor * A[k * n + c];
+      }
+      b[r] -= factor * b[k];
+    }
+  }
+
+  for (int k = n - 1; k >= 0; --k) {
+    for (int c = k + 1; c < n; ++c) {
+      b[k] -= A[k * n + c] * b[c];
+    }
+    b[k] /= A[k * n + k];
+  }
+
+  return true;
+}
+
+} // namespace
+
+AndersonAcceleration::AndersonAcceleration(std::shared_ptr<const Grid> grid, int depth)
+  : m_grid(grid),
+    m_depth(depth),
+    m_f_last(grid, "anderson_f_last"),
+    m_g_last(grid, "anderson_g_last") {
+
+  for (int k = 0; k < m_depth; ++k) {
+    m_dF.emplace_back(std::make_shared<array::Staggered>(grid, "anderson_delta_f"));
+    m_dG.emplace_back(std::make_shared<array::Staggered>(grid, "anderson_delta_g"));
+  }
+
+  reset();
+}
+
+//! Forget all the history (call this before starting a new fixed-point iteration).
+void AndersonAcceleration::reset() {
+  m_size      = 0;
+  m_oldest    = 0;
+  m_have_last = false;
+}
+
+/*!
+ * Replace `g` = G(x) with the accelerated iterate.
+ *
+ * @param[in] f residual of the current iterate, `G(x) - x`
+ * @param[in,out] g value of `G(x)` on input, accelerated iterate on output
+ *
+ * Returns `true` if `g` was modified. `g` is left unchanged (and the history is reset)
+ * if the accelerated iterate would be non-positive at a point where `g` is positive.
+ *
+ * Does not update ghosts of `g`.
+ */
+bool AndersonAcceleration::update(const array::Staggered &f, array::Staggered &g) {
+  if (m_depth <= 0) {
+    return false;
+  }
+
+  // update the history
+  if (m_have_last) {
+    int k = 0;
+    if (m_size < m_depth) {
+      k = (m_oldest + m_size) % m_depth;
+      m_size += 1;
+    } else {
+      // replace the oldest difference
+      k = m_oldest;
+      m_oldest = (m_oldest + 1) % m_depth;
+    }
+
+    m_dF[k]->copy_from(f);
+    m_dF[k]->add(-1.0, m_f_last);
+
+    m_dG[k]->copy_from(g);
+    m_dG[k]->add(-1.0, m_g_last);
+  }
+
+  m_f_last.copy_from(f);
+  m_g_last.copy_from(g);
+  m_have_last = true;
+
+  if (m_size == 0) {
+    return false;
+  }
+
+  const int n = m_size;
+
+  array::AccessScope list{ &f, &g };
+  for (int a = 0; a < n; ++a) {
+    list.add(*m_dF[a]);
+    list.add(*m_dG[a]);
+  }
+
+  // Assemble normal equations (dF^T dF) gamma = dF^T f of the least squares problem.
+  // Entries of dF^T dF are stored first, followed by entries of dF^T f.
+  std::vector<double> A(n * n), b(n);
+  {
+    std::vector<double> local(n * n + n, 0.0), global(n * n + n, 0.0);
+
+    for (auto p = m_grid->points(); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      for (int d = 0; d < 2; ++d) {
+        for (int a = 0; a < n; ++a) {
+          double dF_a = (*m_dF[a])(i, j, d);
+
+          for (int c = a; c < n; ++c) {
+            local[a * n + c] += dF_a * (*m_dF[c])(i, j, d);
+          }
+          local[n * n + a] += dF_a * f(i, j, d);
+        }
+      }
+    }
+
+    GlobalSum(m_grid->com, local.data(), global.data(), n * n + n);
+
+    for (int a = 0; a < n; ++a) {
+      for (int c = a; c < n; ++c) {
+        A[a * n + c] = global[a * n + c];
+        A[c * n + a] = global[a * n + c];
+      }
+      b[a] = global[n * n + a];
+    }
+  }
+
+  // Tikhonov regularization: differences stored in the history are often nearly
+  // collinear
+  {
+    double trace = 0.0;
+    for (int a = 0; a < n; ++a) {
+      trace += A[a * n + a];
+    }
+    for (int a = 0; a < n; ++a) {
+      A[a * n + a] += 1e-12 * trace / n;
+    }
+  }
+
+  if (not solve_dense(n, A, b)) {
+    reset();
+    return false;
+  }
+  const auto &gamma = b;
+
+  // check if the accelerated iterate is acceptable
+  int failures = 0;
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    for (int d = 0; d < 2; ++d) {
+      double x = g(i, j, d);
+      for (int a = 0; a < n; ++a) {
+        x -= gamma[a] * (*m_dG[a])(i, j, d);
+      }
+
+      if (g(i, j, d) > 0.0 and x <= 0.0) {
+        failures += 1;
+      }
+    }
+  }
+
+  if (GlobalSum(m_grid->com, failures) > 0) {
+    reset();
+    return false;
+  }
+
+  for (auto p = m_grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    for (int d = 0; d < 2; ++d) {
+      for (int a = 0; a < n; ++a) {
+        g(i, j, d) -= gamma[a] * (*m_dG[a])(i, j, d);
+      }
+    }
+  }
+
+  return true;
+}
+
+} // end of namespace stressbalance
+} // end of namespace pism
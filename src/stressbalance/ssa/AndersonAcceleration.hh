@@ -0,0 +1,71 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ANDERSONACCELERATION_H
+#define PISM_ANDERSONACCELERATION_H
+
+#include <memory>
+#include <vector>
+
+#include "pism/util/array/Staggered.hh"
+
+namespace pism {
+namespace stressbalance {
+
+//! Anderson acceleration of a fixed-point iteration `x <- G(x)` for fields on the
+//! staggered grid.
+/*!
+ * Given the current iterate `x_k` and `g_k = G(x_k)`, the accelerated iterate is
+ *
+ * @f[ x_{k+1} = g_k - \sum_{a} \gamma_a \Delta g_a, @f]
+ *
+ * where `\Delta g_a` (`\Delta f_a`) are differences of consecutive values of `g`
+ * (residuals `f = g - x`) and `\gamma` minimizes `|f_k - \sum_a \gamma_a \Delta f_a|_2`.
+ * At most `depth` differences are kept.
+ *
+ * See H. F. Walker and P. Ni, Anderson acceleration for fixed-point iterations, SIAM J.
+ * Numer. Anal. 49(4), 2011.
+ */
+class AndersonAcceleration {
+public:
+  AndersonAcceleration(std::shared_ptr<const Grid> grid, int depth);
+
+  void reset();
+
+  bool update(const array::Staggered &f, array::Staggered &g);
+private:
+  std::shared_ptr<const Grid> m_grid;
+
+  //! maximum number of differences to keep
+  int m_depth;
+  //! number of differences stored
+  int m_size;
+  //! index of the oldest difference in m_dF and m_dG
+  int m_oldest;
+  //! true if m_f_last and m_g_last contain values from the previous iteration
+  bool m_have_last;
+
+  std::vector<std::shared_ptr<array::Staggered> > m_dF, m_dG;
+  array::Staggered m_f_last, m_g_last;
+};
+
+} // end of namespace stressbalance
+} // end of namespace pism
+
+#endif /* PISM_ANDERSONACCELERATION_H */
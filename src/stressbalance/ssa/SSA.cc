@@ -68,7 +68,8 @@ double SSAStrengthExtension::get_min_thickness() const {
 
 SSA::SSA(std::shared_ptr<const Grid> g)
   : ShallowStressBalance(g),
-    m_velocity_global(m_grid, "bar")
+    m_velocity_global(m_grid, "bar"),
+    m_inputs_processed(false)
 {
 
   m_e_factor = m_config->get_number("stress_balance.ssa.enhancement_factor");
@@ -132,7 +133,17 @@ void SSA::init_impl() {
 void SSA::update(const Inputs &inputs, bool full_update) {
 
   if (full_update) {
-    solve(inputs);
+    if (skip_solve([this, &inputs]() { return relative_residual(inputs); })) {
+      m_inputs_processed = false;
+
+      if (m_log->get_threshold() >= 2) {
+        m_stdout_ssa = "  SSA: skipped\n";
+      }
+    } else {
+      solve(inputs);
+      solve_done(inputs);
+    }
+
     compute_basal_frictional_heating(m_velocity,
                                      *inputs.basal_yield_stress,
                                      inputs.geometry->cell_type,
@@ -140,6 +151,20 @@ void SSA::update(const Inputs &inputs, bool full_update) {
   }
 }
 
+/*!
+ * Norm of the residual of the SSA system evaluated at the current velocity relative to the
+ * norm of the residual at zero velocity. Used to decide if a solve can be skipped (see
+ * ShallowStressBalance::skip_solve()).
+ *
+ * Returns a negative number if the residual is not available (the default).
+ *
+ * Implementations that have to process inputs to compute the residual should set
+ * `m_inputs_processed` so that the following solve() can skip this step.
+ */
+double SSA::relative_residual(const Inputs &inputs) {
+  (void) inputs;
+  return -1.0;
+}
 
 /*!
  * Estimate velocity at ice-free cells near the ice margin using interpolation from
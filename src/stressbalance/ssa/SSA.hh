@@ -125,12 +125,17 @@ protected:
 
   virtual void solve(const Inputs &inputs) = 0;
 
+  virtual double relative_residual(const Inputs &inputs);
+
   void extrapolate_velocity(const array::CellType1 &cell_type,
                             array::Vector1 &velocity) const;
 
   std::string m_stdout_ssa;
 
   array::Vector m_velocity_global; // global vector for solution
+
+  //! true if relative_residual() processed inputs used by the following solve()
+  bool m_inputs_processed;
 };
 
 } // end of namespace stressbalance
@@ -16,15 +16,22 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>            // std::max
 #include <cassert>
+#include <cmath>                // std::sqrt
 #include <memory>
 #include <stdexcept>
 
+#include <petsctime.h>          // PetscTime()
+
 #include "pism/geometry/Geometry.hh"
 #include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/VelocityPredictor.hh"
+#include "pism/stressbalance/ssa/AndersonAcceleration.hh"
 #include "pism/stressbalance/ssa/SSAFD.hh"
 #include "pism/util/Grid.hh"
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/util/petscwrappers/DM.hh"
 #include "pism/util/petscwrappers/Vec.hh"
 #include "pism/util/pism_options.hh"
@@ -93,6 +100,21 @@ SSAFD::SSAFD(std::shared_ptr<const Grid> grid, bool regional_mode)
     ierr = KSPConvergedDefaultSetUIRNorm(m_KSP);
     PISM_CHK(ierr, "KSPConvergedDefaultSetUIRNorm");
   }
+
+  int anderson_depth = static_cast<int>(m_config->get_number("stress_balance.ssa.fd.anderson_depth"));
+  if (anderson_depth > 0) {
+    m_anderson.reset(new AndersonAcceleration(grid, anderson_depth));
+  }
+
+  m_reuse_pc                = m_config->get_flag("stress_balance.ssa.fd.reuse_preconditioner");
+  m_reuse_pc_max_growth     = m_config->get_number("stress_balance.ssa.fd.reuse_preconditioner_max_growth");
+  m_pc_stale                = true;
+  m_pc_reference_iterations = 0;
+}
+
+SSAFD::~SSAFD() {
+  // empty, but implemented here to be able to use a forward declaration of
+  // AndersonAcceleration in the header
 }
 
 //! @note Uses `PetscErrorCode` *intentionally*.
@@ -260,13 +282,20 @@ FIXME: update this doxygen comment
 void SSAFD::solve(const Inputs &inputs) {
 
   // These computations do not depend on the solution, so they need to
-  // be done only once.
-  initialize_iterations(inputs);
+  // be done only once. (relative_residual() may have done this already.)
+  if (not m_inputs_processed) {
+    initialize_iterations(inputs);
+  }
+  m_inputs_processed = false;
 
   // Store away old SSA velocity (it might be needed in case a solver
   // fails).
   m_velocity_old.copy_from(m_velocity);
 
+  if (m_predictor) {
+    predict_initial_guess(inputs);
+  }
+
   for (unsigned int k = 0; k < 3; ++k) {
     try {
       if (k == 0) {
@@ -301,6 +330,11 @@ void SSAFD::solve(const Inputs &inputs) {
     }
   }
 
+  if (m_predictor) {
+    m_velocity_global.copy_from(m_velocity);
+    m_predictor->add(inputs.time, m_velocity_global.vec());
+  }
+
   if (m_config->get_flag("stress_balance.ssa.fd.extrapolate_at_margins")) {
     extrapolate_velocity(inputs.geometry->cell_type, m_velocity);
   }
@@ -315,6 +349,40 @@ void SSAFD::solve(const Inputs &inputs) {
   }
 }
 
+/*!
+ * Replace the initial guess in `m_velocity` with the one computed by the velocity
+ * predictor (using solutions from previous time steps) if it reduces the residual.
+ *
+ * Has to be called after initialize_iterations().
+ */
+void SSAFD::predict_initial_guess(const Inputs &inputs) {
+  auto residual = array::pooled<array::Vector>(m_grid, "residual");
+  auto da = m_velocity.dm();
+
+  // Note: the residual is evaluated using m_velocity and m_nuH; picard_manager()
+  // re-computes m_nuH, so we only need to restore m_velocity.
+  auto residual_norm = [this, &inputs, &residual, &da](Vec x) {
+    PetscErrorCode ierr = DMGlobalToLocalBegin(*da, x, INSERT_VALUES, m_velocity.vec());
+    PISM_CHK(ierr, "DMGlobalToLocalBegin");
+    ierr = DMGlobalToLocalEnd(*da, x, INSERT_VALUES, m_velocity.vec());
+    PISM_CHK(ierr, "DMGlobalToLocalEnd");
+
+    {
+      array::AccessScope list{ &m_velocity, residual.get() };
+      compute_residual(inputs, m_velocity.array(), residual->array());
+    }
+
+    auto norm = residual->norm(NORM_2);
+    return std::sqrt(norm[0] * norm[0] + norm[1] * norm[1]);
+  };
+
+  m_velocity_global.copy_from(m_velocity);
+
+  m_predictor->apply(inputs.time, m_velocity_global.vec(), residual_norm);
+
+  m_velocity.copy_from(m_velocity_global);
+}
+
 void SSAFD::picard_iteration(const Inputs &inputs, double nuH_regularization,
                              double nuH_iter_failure_underrelax) {
 
@@ -332,6 +400,7 @@ void SSAFD::picard_iteration(const Inputs &inputs, double nuH_regularization,
       m_log->message(1, "  re-trying using the Additive Schwarz preconditioner...\n");
 
       pc_setup_asm();
+      m_pc_stale = true;
 
       m_velocity.copy_from(m_velocity_old);
 
@@ -354,6 +423,10 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
   // KSPGetIterationNumber() call below
   PetscInt ksp_iterations, ksp_iterations_total = 0, outer_iterations;
   KSPConvergedReason reason;
+  // number of accelerated Picard iterations and preconditioner set-ups
+  int accelerated_iterations = 0, pc_setups = 0;
+  // time spent in KSPSolve()
+  PetscLogDouble solve_time = 0.0;
 
   int max_iterations =
       static_cast<int>(m_config->get_number("stress_balance.ssa.fd.max_iterations"));
@@ -376,6 +449,13 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
     update_nuH_viewers(m_nuH);
   }
 
+  // Anderson acceleration is not used by recovery strategies relying on
+  // under-relaxation
+  bool accelerate = m_anderson and nuH_iter_failure_underrelax == 1.0;
+  if (accelerate) {
+    m_anderson->reset();
+  }
+
   // outer loop
   for (int k = 0; k < max_iterations; ++k) {
 
@@ -391,17 +471,43 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
     }
 
     // Call PETSc to solve linear system by iterative method; "inner iteration":
-    ierr = KSPSetOperators(m_KSP, m_A, m_A);
-    PISM_CHK(ierr, "KSPSetOperator");
-
-    ierr = KSPSolve(m_KSP, m_rhs.vec(), m_velocity_global.vec());
-    PISM_CHK(ierr, "KSPSolve");
-
-    // Check if diverged; report to standard out about iteration
-    ierr = KSPGetConvergedReason(m_KSP, &reason);
-    PISM_CHK(ierr, "KSPGetConvergedReason");
+    bool reuse_pc = m_reuse_pc and not m_pc_stale;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      ierr = KSPSetReusePreconditioner(m_KSP, reuse_pc ? PETSC_TRUE : PETSC_FALSE);
+      PISM_CHK(ierr, "KSPSetReusePreconditioner");
+
+      ierr = KSPSetOperators(m_KSP, m_A, m_A);
+      PISM_CHK(ierr, "KSPSetOperator");
+
+      PetscLogDouble start = 0.0, end = 0.0;
+      ierr = PetscTime(&start);
+      PISM_CHK(ierr, "PetscTime");
+
+      ierr = KSPSolve(m_KSP, m_rhs.vec(), m_velocity_global.vec());
+      PISM_CHK(ierr, "KSPSolve");
+
+      ierr = PetscTime(&end);
+      PISM_CHK(ierr, "PetscTime");
+      solve_time += end - start;
+
+      // Check if diverged; report to standard out about iteration
+      ierr = KSPGetConvergedReason(m_KSP, &reason);
+      PISM_CHK(ierr, "KSPGetConvergedReason");
+
+      if (reason < 0 and reuse_pc) {
+        // the lagged preconditioner may be too far out of date: re-try with an
+        // up-to-date one, starting from the same initial guess
+        m_log->message(3, "  KSPSolve() with a re-used preconditioner failed; re-building...\n");
+        m_velocity_global.copy_from(m_velocity);
+        reuse_pc = false;
+        continue;
+      }
+      break;
+    }
 
     if (reason < 0) {
+      m_pc_stale = true;
+
       // KSP diverged
       m_log->message(1, "PISM WARNING:  KSPSolve() reports 'diverged'; reason = %d = '%s'\n",
                      reason, KSPConvergedReasons[reason]);
@@ -419,6 +525,16 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
 
     ksp_iterations_total += ksp_iterations;
 
+    if (not reuse_pc) {
+      // the preconditioner was re-built
+      pc_setups += 1;
+      m_pc_stale = false;
+      m_pc_reference_iterations = ksp_iterations;
+    } else if (ksp_iterations > m_reuse_pc_max_growth * std::max(m_pc_reference_iterations, 1)) {
+      // the preconditioner is out of date: re-build it before the next solve
+      m_pc_stale = true;
+    }
+
     if (very_verbose) {
       m_stdout_ssa += pism::printf("S:%d,%d: ", (int)ksp_iterations, reason);
     }
@@ -455,6 +571,7 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
 
     // update viscosity
     double nuH_norm = 0.0, nuH_norm_change = 0.0;
+    bool converged = false;
     {
       // in preparation of measuring change of effective viscosity:
       m_nuH_old.copy_from(m_nuH);
@@ -472,6 +589,18 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
       auto norm       = compute_nuH_norm(m_nuH, m_nuH_old);
       nuH_norm        = norm[0];
       nuH_norm_change = norm[1];
+      converged       = nuH_norm == 0 || nuH_norm_change / nuH_norm < ssa_relative_tolerance;
+
+      if (accelerate and not converged) {
+        // compute_nuH_norm() set m_nuH_old to (old nuH) - (new nuH), i.e. the negative
+        // of the residual of the fixed-point iteration
+        m_nuH_old.scale(-1.0);
+
+        if (m_anderson->update(m_nuH_old, m_nuH)) {
+          m_nuH.update_ghosts();
+          accelerated_iterations += 1;
+        }
+      }
     }
 
     if (m_nuh_viewer != nullptr) {
@@ -492,7 +621,7 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
     outer_iterations = k + 1;
 
     // check for viscosity convergence
-    if (nuH_norm == 0 || nuH_norm_change / nuH_norm < ssa_relative_tolerance) {
+    if (converged) {
       goto done;
     }
   } // outer loop (k)
@@ -506,16 +635,32 @@ void SSAFD::picard_manager(const Inputs &inputs, double nuH_regularization,
 
 done:
 
+  std::string details;
+  if (accelerate) {
+    details += pism::printf(", %d accelerated", accelerated_iterations);
+  }
+  if (m_reuse_pc) {
+    details += pism::printf(", %d PC set-ups", pc_setups);
+  }
+  if (m_predictor) {
+    details += pism::printf(", %d of %d predicted guesses accepted",
+                            m_predictor->n_accepted(), m_predictor->n_predictions());
+  }
+  if (accelerate or m_reuse_pc or very_verbose) {
+    details += pism::printf(", %.3f s in KSPSolve()", (double)solve_time);
+  }
+
   if (very_verbose) {
     auto tempstr =
-        pism::printf("... =%5d outer iterations, ~%3.1f KSP iterations each\n",
-                     (int)outer_iterations, ((double)ksp_iterations_total) / outer_iterations);
+        pism::printf("... =%5d outer iterations, ~%3.1f KSP iterations each%s\n",
+                     (int)outer_iterations, ((double)ksp_iterations_total) / outer_iterations,
+                     details.c_str());
     m_stdout_ssa += tempstr;
   } else if (verbose) {
     // at default verbosity, just record last nuH_norm_change and iterations
     auto tempstr =
-        pism::printf("%5d outer iterations, ~%3.1f KSP iterations each\n", (int)outer_iterations,
-                     ((double)ksp_iterations_total) / outer_iterations);
+        pism::printf("%5d outer iterations, ~%3.1f KSP iterations each%s\n", (int)outer_iterations,
+                     ((double)ksp_iterations_total) / outer_iterations, details.c_str());
 
     m_stdout_ssa += tempstr;
   }
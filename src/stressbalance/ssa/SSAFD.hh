@@ -20,6 +20,7 @@
 #define _SSAFD_H_
 
 #include <array>
+#include <memory>
 
 #include "pism/stressbalance/ssa/SSAFDBase.hh"
 
@@ -31,12 +32,13 @@
 namespace pism {
 namespace stressbalance {
 
+class AndersonAcceleration;
 
 //! PISM's SSA solver: the finite difference implementation.
 class SSAFD : public SSAFDBase {
 public:
   SSAFD(std::shared_ptr<const Grid> g, bool regional_mode);
-  virtual ~SSAFD() = default;
+  virtual ~SSAFD();
 
 protected:
 
@@ -48,6 +50,8 @@ protected:
 
   void solve(const Inputs &inputs);
 
+  void predict_initial_guess(const Inputs &inputs);
+
   void picard_iteration(const Inputs &inputs, double nuH_regularization,
                         double nuH_iter_failure_underrelax);
 
@@ -75,7 +79,19 @@ protected:
 
   unsigned int m_default_pc_failure_count;
   unsigned int m_default_pc_failure_max_count;
-  
+
+  //! Anderson acceleration of Picard iterations (null if disabled)
+  std::unique_ptr<AndersonAcceleration> m_anderson;
+
+  //! true if the preconditioner should be re-used across Picard iterations and time steps
+  bool m_reuse_pc;
+  //! re-build the preconditioner if the number of KSP iterations grows by this factor
+  double m_reuse_pc_max_growth;
+  //! true if the preconditioner has to be re-built before the next linear solve
+  bool m_pc_stale;
+  //! number of KSP iterations of the first solve using the current preconditioner
+  int m_pc_reference_iterations;
+
   std::shared_ptr<petsc::Viewer> m_nuh_viewer;
 
   bool m_regional_mode;
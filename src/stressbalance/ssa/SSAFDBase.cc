@@ -25,9 +25,11 @@
 #include "pism/stressbalance/StressBalance.hh"    // stressbalance::Inputs
 
 #include "pism/util/Mask.hh"
+#include "pism/util/array/Pool.hh"
 
 #include "pism/util/pism_utilities.hh" // average_water_column_pressure()
 #include <cassert>
+#include <cmath>                // std::sqrt
 
 namespace pism {
 namespace stressbalance {
@@ -1536,6 +1538,32 @@ void SSAFDBase::compute_residual(const Inputs &inputs, const array::Vector2 &vel
   compute_residual(inputs, m_velocity.array(), result.array());
 }
 
+/*!
+ * Compute the norm of the residual at the current velocity relative to the norm of the
+ * right hand side (i.e. the residual at zero velocity).
+ */
+double SSAFDBase::relative_residual(const Inputs &inputs) {
+  initialize_iterations(inputs);
+  m_inputs_processed = true;
+
+  auto residual = array::pooled<array::Vector>(m_grid, "residual");
+
+  m_velocity.update_ghosts();
+  {
+    array::AccessScope list{ &m_velocity, residual.get() };
+    compute_residual(inputs, m_velocity.array(), residual->array());
+  }
+
+  auto R = residual->norm(NORM_2);
+  auto F = m_rhs.norm(NORM_2);
+
+  double rhs_norm = std::sqrt(F[0] * F[0] + F[1] * F[1]);
+  if (rhs_norm > 0.0) {
+    return std::sqrt(R[0] * R[0] + R[1] * R[1]) / rhs_norm;
+  }
+  return -1.0;
+}
+
 const array::Staggered &SSAFDBase::integrated_viscosity() const {
   return m_nuH;
 }
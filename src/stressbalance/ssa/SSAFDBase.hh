@@ -48,6 +48,8 @@ protected:
 
   void initialize_iterations(const Inputs &inputs);
 
+  double relative_residual(const Inputs &inputs) override;
+
   void compute_nuH(const array::Scalar1 &ice_thickness, const array::CellType2 &cell_type,
                    const pism::Vector2d *const *velocity, const array::Staggered &hardness,
                    double nuH_regularization, array::Staggered1 &result);
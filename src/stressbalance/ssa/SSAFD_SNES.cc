@@ -19,6 +19,7 @@
 
 #include "pism/stressbalance/ssa/SSAFD_SNES.hh"
 #include "pism/stressbalance/StressBalance.hh" // Inputs
+#include "pism/stressbalance/VelocityPredictor.hh"
 #include "pism/util/petscwrappers/Vec.hh"
 #include <algorithm>            // std::max()
 
@@ -116,7 +117,15 @@ SSAFD_SNES::SSAFD_SNES(std::shared_ptr<const Grid> grid, bool regional_mode)
 
 void SSAFD_SNES::solve(const Inputs &inputs) {
   m_callback_data.inputs = &inputs;
-  initialize_iterations(inputs);
+  if (not m_inputs_processed) {
+    initialize_iterations(inputs);
+  }
+  m_inputs_processed = false;
+
+  if (m_predictor) {
+    m_predictor->apply(inputs.time, m_snes, m_velocity_global.vec());
+  }
+
   {
     PetscErrorCode ierr;
 
@@ -149,6 +158,10 @@ void SSAFD_SNES::solve(const Inputs &inputs) {
   }
   m_callback_data.inputs = nullptr;
 
+  if (m_predictor) {
+    m_predictor->add(inputs.time, m_velocity_global.vec());
+  }
+
   // copy from m_velocity_global to provide m_velocity with ghosts:
   m_velocity.copy_from(m_velocity_global);
 
@@ -27,11 +27,13 @@
 #include "pism/util/error_handling.hh"
 #include "pism/util/Vars.hh"
 #include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/VelocityPredictor.hh"
 #include "pism/geometry/Geometry.hh"
 
 #include "pism/util/node_types.hh"
 #include "pism/util/pism_utilities.hh" // average_water_column_pressure()
 #include "pism/util/Interpolation1D.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/util/petscwrappers/DM.hh"
 #include "pism/util/petscwrappers/Vec.hh"
 #include "pism/util/petscwrappers/Viewer.hh"
@@ -176,6 +178,11 @@ void SSAFEM::solve(const Inputs &inputs) {
                                   reason->description().c_str());
   }
 
+  if (m_predictor and m_log->get_threshold() >= 2) {
+    m_stdout_ssa += pism::printf("%d of %d predicted guesses accepted ",
+                                 m_predictor->n_accepted(), m_predictor->n_predictions());
+  }
+
   if (m_log->get_threshold() > 2) {
     m_stdout_ssa += "SSAFEM converged (SNES reason " + reason->description() + ")";
   }
@@ -183,10 +190,47 @@ void SSAFEM::solve(const Inputs &inputs) {
 
 std::shared_ptr<TerminationReason> SSAFEM::solve_with_reason(const Inputs &inputs) {
 
-  // Set up the system to solve.
+  // Set up the system to solve. (relative_residual() may have done this already.)
+  if (not m_inputs_processed) {
+    cache_inputs(inputs);
+  }
+  m_inputs_processed = false;
+
+  if (m_predictor) {
+    m_predictor->apply(inputs.time, m_snes, m_velocity_global.vec());
+  }
+
+  auto reason = solve_nocache();
+
+  if (m_predictor and not reason->failed()) {
+    m_predictor->add(inputs.time, m_velocity_global.vec());
+  }
+
+  return reason;
+}
+
+/*!
+ * Compute the norm of the residual at the current velocity relative to the norm of the
+ * residual at zero velocity.
+ */
+double SSAFEM::relative_residual(const Inputs &inputs) {
   cache_inputs(inputs);
+  m_inputs_processed = true;
+
+  auto zero     = array::pooled<array::Vector>(m_grid, "zero_velocity");
+  auto residual = array::pooled<array::Vector>(m_grid, "residual");
+
+  double norm[2] = {0.0, 0.0};
+  Vec velocity[2] = {m_velocity_global.vec(), zero->vec()};
+  for (int k = 0; k < 2; ++k) {
+    PetscErrorCode ierr = SNESComputeFunction(m_snes, velocity[k], residual->vec());
+    PISM_CHK(ierr, "SNESComputeFunction");
+
+    ierr = VecNorm(residual->vec(), NORM_2, &norm[k]);
+    PISM_CHK(ierr, "VecNorm");
+  }
 
-  return solve_nocache();
+  return norm[1] > 0.0 ? norm[0] / norm[1] : -1.0;
 }
 
 //! Solve the SSA without first recomputing the values of coefficients at quad
@@ -107,6 +107,8 @@ protected:
 
   std::shared_ptr<TerminationReason> solve_nocache();
 
+  virtual double relative_residual(const Inputs &inputs);
+
   //! Adaptor for gluing SNESDAFormFunction callbacks to an SSAFEM.
   /* The callbacks from SNES are mediated via SNESDAFormFunction, which has the
      convention that its context argument is a pointer to a struct
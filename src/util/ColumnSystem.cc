@@ -244,6 +244,164 @@ std::string TridiagonalSystem::prefix() const {
   return m_prefix;
 }
 
+//! Allocate storage for `batch_size` systems of size up to `max_system_size`.
+TridiagonalSystemBatch::TridiagonalSystemBatch(unsigned int max_system_size,
+                                               unsigned int batch_size)
+  : m_max_system_size(max_system_size), m_batch_size(batch_size) {
+  const unsigned int huge = 1e6;
+  assert(max_system_size >= 1 && max_system_size < huge);
+  assert(batch_size >= 1 && batch_size < huge);
+
+  size_t N = static_cast<size_t>(m_max_system_size) * m_batch_size;
+
+  m_L.resize(N);
+  m_D.resize(N);
+  m_U.resize(N);
+  m_rhs.resize(N);
+
+  m_size.resize(m_batch_size, 0);
+  m_pivot.resize(m_batch_size);
+  m_zero_pivot.resize(m_batch_size);
+}
+
+unsigned int TridiagonalSystemBatch::batch_size() const {
+  return m_batch_size;
+}
+
+unsigned int TridiagonalSystemBatch::max_system_size() const {
+  return m_max_system_size;
+}
+
+//! Set the size of the system in the slot `b`. Use zero to mark a slot as unused.
+void TridiagonalSystemBatch::set_size(unsigned int b, unsigned int system_size) {
+  assert(b < m_batch_size);
+  assert(system_size <= m_max_system_size);
+
+  m_size[b] = system_size;
+}
+
+unsigned int TridiagonalSystemBatch::size(unsigned int b) const {
+  return m_size[b];
+}
+
+//! Solve systems in slots `0, ..., n_systems - 1`.
+/*!
+  Performs the same floating point operations as TridiagonalSystem::solve() for each
+  system.
+
+  Overwrites coefficients of all systems in the batch.
+
+  Throws RuntimeError if a zero pivot is found in any of the systems. Callers should use
+  RuntimeError::add_context() to identify the column.
+ */
+void TridiagonalSystemBatch::solve(unsigned int n_systems) {
+  assert(n_systems <= m_batch_size);
+
+  const size_t B = m_batch_size;
+
+  unsigned int N = 0;
+  for (unsigned int b = 0; b < n_systems; ++b) {
+    N = std::max(N, m_size[b]);
+  }
+
+  if (N == 0) {
+    return;
+  }
+
+  // Replace rows beyond the size of each system with x_k = 0. This way all systems can be
+  // processed together without changing results.
+  for (unsigned int b = 0; b < n_systems; ++b) {
+    unsigned int n = m_size[b];
+    if (n > 0) {
+      U(n - 1, b) = 0.0;
+    }
+    for (unsigned int k = n; k < N; ++k) {
+      L(k, b)   = 0.0;
+      D(k, b)   = 1.0;
+      U(k, b)   = 0.0;
+      RHS(k, b) = 0.0;
+    }
+  }
+
+  const double
+    *L = m_L.data(),
+    *D = m_D.data();
+  double
+    *U     = m_U.data(),
+    *x     = m_rhs.data(),
+    *pivot = m_pivot.data();
+  int *zero_pivot = m_zero_pivot.data();
+
+  // Note: to reduce the amount of memory used, the right hand side is overwritten by the
+  // solution and U_{k-1} is overwritten by work_k (see TridiagonalSystem::solve()).
+
+  for (unsigned int b = 0; b < n_systems; ++b) {
+    pivot[b]      = D[b];
+    zero_pivot[b] = pivot[b] == 0.0 ? 1 : 0;
+    x[b]          = x[b] / pivot[b];
+  }
+
+  for (unsigned int k = 1; k < N; ++k) {
+    const double
+      *L_k = L + k * B,
+      *D_k = D + k * B,
+      *x_p = x + (k - 1) * B;
+    double
+      *work_k = U + (k - 1) * B,
+      *x_k    = x + k * B;
+
+    // Note: zero pivots are recorded instead of stopping right away to keep this loop
+    // free of branches. Iterations of this loop are independent, but the compiler cannot
+    // prove it (pointers may alias).
+#pragma omp simd
+    for (unsigned int b = 0; b < n_systems; ++b) {
+      work_k[b] = work_k[b] / pivot[b];
+
+      pivot[b] = D_k[b] - L_k[b] * work_k[b];
+
+      zero_pivot[b] = (zero_pivot[b] == 0 and pivot[b] == 0.0) ? (int)k + 1 : zero_pivot[b];
+
+      x_k[b] = (x_k[b] - L_k[b] * x_p[b]) / pivot[b];
+    }
+  }
+
+  for (unsigned int b = 0; b < n_systems; ++b) {
+    if (zero_pivot[b] != 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "zero pivot at row %d (system %d in a batch)",
+                                    zero_pivot[b], b);
+    }
+  }
+
+  for (int k = static_cast<int>(N) - 2; k >= 0; --k) {
+    const double
+      *work_n = U + k * B,
+      *x_n    = x + (k + 1) * B;
+    double *x_k = x + k * B;
+
+#pragma omp simd
+    for (unsigned int b = 0; b < n_systems; ++b) {
+      x_k[b] -= work_n[b] * x_n[b];
+    }
+  }
+}
+
+//! Row (1-based) of the first zero pivot in the slot `b` after solve() or zero if there was none.
+int TridiagonalSystemBatch::zero_pivot(unsigned int b) const {
+  assert(b < m_batch_size);
+
+  return m_zero_pivot[b];
+}
+
+//! Copy the solution of the system in the slot `b` to `result` (`size(b)` values).
+void TridiagonalSystemBatch::solution(unsigned int b, double *result) const {
+  assert(b < m_batch_size);
+
+  for (unsigned int k = 0; k < m_size[b]; ++k) {
+    result[k] = x(k, b);
+  }
+}
+
 //! A column system is a kind of a tridiagonal system.
 columnSystemCtx::columnSystemCtx(const std::vector<double>& storage_grid,
                                  const std::string &prefix,
@@ -135,6 +135,102 @@ private:
   std::string m_prefix;
 };
 
+//! Solves a batch of independent tridiagonal systems (one per column) at once.
+/*!
+  Uses the same algorithm as TridiagonalSystem, but stores coefficients of all systems in
+  a batch interleaved: row `k` of the system in the slot `b` is stored at `k * B + b`,
+  where `B` is the batch size. This way each step of the forward elimination and back
+  substitution processes the same row in all columns of a batch, which allows compilers
+  to vectorize these loops *across* columns.
+
+  Systems in a batch may have different sizes. Rows beyond the size of a system are
+  replaced with `x_k = 0`, so the solution of each system is the same as the one computed
+  by TridiagonalSystem::solve().
+
+  The default batch size is small so that coefficients of all systems in a batch fit in
+  the L1 or L2 cache (see `pism_tridiagonal_bench`).
+
+  Usage:
+
+  1. set coefficients of the system in slot `b` using `system(b)` (it has the same
+     interface as TridiagonalSystem) and its size using set_size(),
+  2. call solve(),
+  3. get solutions using solution() or x().
+*/
+class TridiagonalSystemBatch {
+public:
+  TridiagonalSystemBatch(unsigned int max_system_size, unsigned int batch_size = 8);
+
+  unsigned int batch_size() const;
+  unsigned int max_system_size() const;
+
+  void set_size(unsigned int b, unsigned int system_size);
+  unsigned int size(unsigned int b) const;
+
+  void solve(unsigned int n_systems);
+  int zero_pivot(unsigned int b) const;
+
+  void solution(unsigned int b, double *result) const;
+
+  double& L(size_t k, size_t b) {
+    return m_L[k * m_batch_size + b];
+  }
+  double& D(size_t k, size_t b) {
+    return m_D[k * m_batch_size + b];
+  }
+  double& U(size_t k, size_t b) {
+    return m_U[k * m_batch_size + b];
+  }
+  double& RHS(size_t k, size_t b) {
+    return m_rhs[k * m_batch_size + b];
+  }
+  //! Component `k` of the solution of the system in the slot `b` (valid after solve()).
+  double x(size_t k, size_t b) const {
+    return m_rhs[k * m_batch_size + b];
+  }
+
+  //! View of the system in one slot of a batch, with the interface of TridiagonalSystem.
+  class System {
+  public:
+    System(TridiagonalSystemBatch &batch, unsigned int b)
+      : m_batch(batch), m_b(b) {
+      // empty
+    }
+    double& L(size_t k) {
+      return m_batch.L(k, m_b);
+    }
+    double& D(size_t k) {
+      return m_batch.D(k, m_b);
+    }
+    double& U(size_t k) {
+      return m_batch.U(k, m_b);
+    }
+    double& RHS(size_t k) {
+      return m_batch.RHS(k, m_b);
+    }
+  private:
+    TridiagonalSystemBatch &m_batch;
+    unsigned int m_b;
+  };
+
+  System system(unsigned int b) {
+    return System(*this, b);
+  }
+private:
+  unsigned int m_max_system_size;
+  unsigned int m_batch_size;
+
+  //! sizes of systems in the batch
+  std::vector<unsigned int> m_size;
+
+  // interleaved coefficients; solve() overwrites the right hand side with solutions
+  std::vector<double> m_L, m_D, m_U, m_rhs;
+
+  // current pivot and the "zero pivot" flag for each system
+  std::vector<double> m_pivot;
+  std::vector<int> m_zero_pivot;
+};
+
 class ColumnInterpolation;
 
 //! Base class for tridiagonal systems in the ice.
@@ -20,6 +20,7 @@
 #include <mpi.h>
 #include <cmath>                // std::round()
 #include <cstdlib>              // realpath()
+#include <mutex>
 
 
 #include "pism/util/io/File.hh"
@@ -29,6 +30,7 @@
 #include "pism/util/pism_options.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/IO_Flags.hh"
+#include "pism/pism_parameters.hh"
 
 // include an implementation header so that we can allocate a DefaultConfig instance in
 // config_from_options()
@@ -39,10 +41,38 @@ namespace pism {
 
 struct Config::Impl {
   Impl(units::System::Ptr sys)
-    : unit_system(sys) {
+    : unit_system(sys), n_changes(0), parameters_version(-1), frozen(false),
+      record_lookups(false) {
     // empty
   }
 
+  //! Stop if the configuration is frozen. Called before changing a parameter `name`.
+  void check_frozen(const std::string &name) {
+    if (frozen) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot set '%s': configuration parameters cannot be "
+                                    "changed after initialization",
+                                    name.c_str());
+    }
+    n_changes += 1;
+  }
+
+  //! Record a look-up of the parameter `name` by name.
+  //!
+  //! Thread-safe: parameters may be looked up in OpenMP parallel regions.
+  void record_lookup(const std::string &name) {
+    if (record_lookups) {
+      std::lock_guard<std::mutex> lock(mutex);
+      lookups_after_freeze[name] += 1;
+    }
+  }
+
+  //! Remember that the parameter `name` was used. Thread-safe.
+  void record_use(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    parameters_used.insert(name);
+  }
+
   units::System::Ptr unit_system;
 
   std::string filename;
@@ -53,6 +83,22 @@ struct Config::Impl {
   //! @brief Set of parameters used in a run. Used to warn about parameters that were set but were
   //! not used.
   std::set<std::string> parameters_used;
+
+  //! Number of changes. Used to decide when to re-build the snapshot of parameters.
+  int n_changes;
+  //! Value of `n_changes` when `parameters` was built.
+  int parameters_version;
+  std::unique_ptr<ConfigParameters> parameters;
+
+  //! True if parameters cannot be changed.
+  bool frozen;
+
+  //! True if look-ups after freeze() should be recorded.
+  bool record_lookups;
+  //! Numbers of look-ups of each parameter after freeze().
+  Lookups lookups_after_freeze;
+  //! Protects `lookups_after_freeze` and `parameters_used`.
+  std::mutex mutex;
 };
 
 Config::Config(units::System::Ptr system)
@@ -192,6 +238,8 @@ bool Config::is_valid_number(const std::string &name) const {
 }
 
 double Config::get_number(const std::string &name, UseFlag flag) const {
+  m_impl->record_lookup(name);
+
   auto value = get_number_impl(name);
 
   if (flag == REMEMBER_THIS_USE) {
@@ -200,7 +248,7 @@ double Config::get_number(const std::string &name, UseFlag flag) const {
     // note that we don't check the valid range when flag == FORGET_THIS_USE. This way we
     // can get the default value of a parameter. Parameters without a default value should
     // be set to values outside of their respective valid ranges (if possible).
-    m_impl->parameters_used.insert(name);
+    m_impl->record_use(name);
 
     if (type(name) == "integer" and std::round(value) != value) {
       throw RuntimeError::formatted(
@@ -261,8 +309,10 @@ double Config::get_number(const std::string &name,
 }
 
 std::vector<double> Config::get_numbers(const std::string &name, UseFlag flag) const {
+  m_impl->record_lookup(name);
+
   if (flag == REMEMBER_THIS_USE) {
-    m_impl->parameters_used.insert(name);
+    m_impl->record_use(name);
   }
   return this->get_numbers_impl(name);
 }
@@ -288,6 +338,8 @@ std::vector<double> Config::get_numbers(const std::string &name,
 
 void Config::set_number(const std::string &name, double value,
                         ConfigSettingFlag flag) {
+  m_impl->check_frozen(name);
+
   std::set<std::string> &set_by_user = m_impl->parameters_set_by_user;
 
   if (flag == CONFIG_USER) {
@@ -306,6 +358,8 @@ void Config::set_number(const std::string &name, double value,
 void Config::set_numbers(const std::string &name,
                          const std::vector<double> &values,
                          ConfigSettingFlag flag) {
+  m_impl->check_frozen(name);
+
   std::set<std::string> &set_by_user = m_impl->parameters_set_by_user;
 
   if (flag == CONFIG_USER) {
@@ -326,8 +380,10 @@ Config::Strings Config::all_strings() const {
 }
 
 std::string Config::get_string(const std::string &name, UseFlag flag) const {
+  m_impl->record_lookup(name);
+
   if (flag == REMEMBER_THIS_USE) {
-    m_impl->parameters_used.insert(name);
+    m_impl->record_use(name);
   }
   return this->get_string_impl(name);
 }
@@ -335,6 +391,8 @@ std::string Config::get_string(const std::string &name, UseFlag flag) const {
 void Config::set_string(const std::string &name,
                         const std::string &value,
                         ConfigSettingFlag flag) {
+  m_impl->check_frozen(name);
+
   std::set<std::string> &set_by_user = m_impl->parameters_set_by_user;
 
   if (flag == CONFIG_USER) {
@@ -355,14 +413,18 @@ Config::Flags Config::all_flags() const {
 }
 
 bool Config::get_flag(const std::string& name, UseFlag flag) const {
+  m_impl->record_lookup(name);
+
   if (flag == REMEMBER_THIS_USE) {
-    m_impl->parameters_used.insert(name);
+    m_impl->record_use(name);
   }
   return this->get_flag_impl(name);
 }
 
 void Config::set_flag(const std::string& name, bool value,
                          ConfigSettingFlag flag) {
+  m_impl->check_frozen(name);
+
   std::set<std::string> &set_by_user = m_impl->parameters_set_by_user;
 
   if (flag == CONFIG_USER) {
@@ -378,6 +440,68 @@ void Config::set_flag(const std::string& name, bool value,
   this->set_flag_impl(name, value);
 }
 
+/*!
+ * Return a snapshot of all parameters with values converted to units used in PISM's code.
+ * Use this instead of get_number(), get_flag() and get_string() in code that runs often
+ * (e.g. once per time step or sub-step): accessing a member of ConfigParameters is much
+ * cheaper than looking up a parameter by name (and possibly converting its units).
+ *
+ * Note that using the snapshot does not mark parameters as "used" (see
+ * print_unused_parameters()). Code using it should get the values of parameters it uses
+ * by name at least once during initialization.
+ *
+ * The snapshot is re-built when needed until the configuration is frozen (see
+ * freeze()). Do not call this method in a multi-threaded region before then.
+ */
+const ConfigParameters &Config::parameters() const {
+  if (m_impl->parameters == nullptr or m_impl->parameters_version != m_impl->n_changes) {
+    m_impl->parameters.reset(new ConfigParameters(*this));
+    m_impl->parameters_version = m_impl->n_changes;
+  }
+  return *m_impl->parameters;
+}
+
+/*!
+ * Freeze configuration parameters. Any attempt to change a parameter after this call is
+ * an error until thaw() is called.
+ *
+ * If `debug.config_lookups` is set, record all look-ups of parameters by name after this
+ * call. Use print_lookups_after_freeze() to find code that should use parameters() instead.
+ *
+ * Freezing is optional: the `pism` executable freezes parameters after initializing the
+ * model.
+ */
+void Config::freeze() {
+  bool record_lookups = get_flag("debug.config_lookups");
+
+  // build the snapshot before freezing
+  parameters();
+
+  m_impl->frozen         = true;
+  m_impl->record_lookups = record_lookups;
+}
+
+/*!
+ * Allow changing parameters after freeze() and stop recording look-ups by name.
+ *
+ * The snapshot of parameters (see parameters()) is re-built after the next change, so
+ * call freeze() again (or call parameters() outside of multi-threaded regions) before
+ * using it in threaded code.
+ */
+void Config::thaw() {
+  m_impl->frozen         = false;
+  m_impl->record_lookups = false;
+}
+
+bool Config::frozen() const {
+  return m_impl->frozen;
+}
+
+//! Parameters looked up by name after freeze() and the number of look-ups of each.
+const Config::Lookups &Config::lookups_after_freeze() const {
+  return m_impl->lookups_after_freeze;
+}
+
 static bool special_parameter(const std::string &name) {
   for (const auto &suffix : {"_doc", "_units", "_type", "_option", "_choices", "_valid_min", "_valid_max"}) {
     if (ends_with(name, suffix)) {
@@ -507,6 +631,21 @@ void print_unused_parameters(const Logger &log, int verbosity_threshhold,
   }
 }
 
+void print_lookups_after_freeze(const Logger &log, int verbosity_threshhold,
+                                const Config &config) {
+  const auto &lookups = config.lookups_after_freeze();
+
+  if (lookups.empty()) {
+    return;
+  }
+
+  log.message(verbosity_threshhold,
+              "Parameters looked up by name after initialization (number of look-ups):\n");
+  for (const auto &p : lookups) {
+    log.message(verbosity_threshhold, "  %s (%d)\n", p.first.c_str(), p.second);
+  }
+}
+
 // command-line options
 
 //! Get a flag from a command-line option.
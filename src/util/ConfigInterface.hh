@@ -35,6 +35,7 @@ namespace pism {
 
 class File;
 class Logger;
+struct ConfigParameters;
 
 
 //! Flag used by `set_...()` methods.
@@ -123,6 +124,15 @@ public:
   bool get_flag(const std::string& name, UseFlag flag = REMEMBER_THIS_USE) const;
   void set_flag(const std::string& name, bool value, ConfigSettingFlag flag = CONFIG_FORCE);
 
+  const ConfigParameters &parameters() const;
+
+  void freeze();
+  void thaw();
+  bool frozen() const;
+
+  typedef std::map<std::string, int> Lookups;
+  const Lookups &lookups_after_freeze() const;
+
   std::string doc(const std::string &parameter) const;
   std::string units(const std::string &parameter) const;
   std::string type(const std::string &parameter) const;
@@ -209,6 +219,10 @@ void print_config(const Logger &log, int verbosity_threshhold, const Config &con
 void print_unused_parameters(const Logger &log, int verbosity_threshhold,
                              const Config &config);
 
+//! Report parameters looked up by name after the configuration was frozen.
+void print_lookups_after_freeze(const Logger &log, int verbosity_threshhold,
+                                const Config &config);
+
 } // end of namespace pism
 
 #endif /* _PISMCONFIGINTERFACE_H_ */
@@ -23,6 +23,8 @@
 #include "pism/util/Time.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/EnthalpyConverter.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/io/AsyncWriter.hh"
 #include <memory>
 
 namespace pism {
@@ -48,6 +50,7 @@ public:
   std::string prefix;
   Profiling profiling;
   std::shared_ptr<Logger> logger;
+  std::shared_ptr<io::AsyncWriter> io_thread;
 };
 
 Context::Context(MPI_Comm c, std::shared_ptr<units::System> sys,
@@ -118,6 +121,34 @@ std::shared_ptr<Logger> Context::log() {
   return m_impl->logger;
 }
 
+/*!
+ * Returns the I/O thread used to write output and read forcing in the background, creating
+ * it if necessary. All these tasks have to share one thread because NetCDF is not
+ * thread-safe.
+ *
+ * Returns null if MPI does not support `MPI_THREAD_MULTIPLE` on some of the ranks.
+ *
+ * This is a collective call (until the thread is created).
+ */
+std::shared_ptr<io::AsyncWriter> Context::io_thread() const {
+  if (m_impl->io_thread == nullptr) {
+    int supported = io::AsyncWriter::thread_support() ? 1 : 0;
+    int supported_everywhere = 0;
+    MPI_Allreduce(&supported, &supported_everywhere, 1, MPI_INT, MPI_MIN, m_impl->com);
+
+    if (supported_everywhere == 0) {
+      return nullptr;
+    }
+
+    const size_t MiB = 1024 * 1024;
+    auto memory_budget = m_impl->config->get_number("output.async.memory_budget");
+
+    m_impl->io_thread = std::make_shared<io::AsyncWriter>(static_cast<size_t>(memory_budget) * MiB);
+  }
+
+  return m_impl->io_thread;
+}
+
 std::shared_ptr<Context> context_from_options(MPI_Comm com,
                                               const std::string &prefix,
                                               bool print) {
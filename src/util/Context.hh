@@ -37,6 +37,10 @@ class Time;
 class Profiling;
 class Logger;
 
+namespace io {
+class AsyncWriter;
+}
+
 class Context {
 public:
   Context(MPI_Comm c, std::shared_ptr<units::System> sys, std::shared_ptr<Config> conf,
@@ -60,6 +64,8 @@ public:
   std::shared_ptr<Config> config();
   std::shared_ptr<Time> time();
 
+  std::shared_ptr<io::AsyncWriter> io_thread() const;
+
 private:
   class Impl;
   Impl *m_impl;
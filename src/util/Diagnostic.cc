@@ -153,6 +153,9 @@ TSDiagnostic::TSDiagnostic(std::shared_ptr<const Grid> grid, const std::string &
 
   m_current_time = 0;
   m_start        = 0;
+  m_reduction    = REDUCE_NONE;
+  m_value_set    = false;
+  m_value        = 0.0;
 
   m_buffer_size = static_cast<size_t>(m_config->get_number("output.timeseries.buffer_size"));
 
@@ -292,6 +295,105 @@ void TSDiagnostic::update(double t0, double t1) {
   this->update_impl(t0, t1);
 }
 
+/*!
+ * Update using the `value` computed elsewhere instead of calling compute().
+ */
+void TSDiagnostic::update(double t0, double t1, double value) {
+  m_value_set = true;
+  m_value     = value;
+  try {
+    this->update_impl(t0, t1);
+  } catch (...) {
+    m_value_set = false;
+    throw;
+  }
+  m_value_set = false;
+}
+
+TSDiagnostic::Reduction TSDiagnostic::reduction() const {
+  return m_reduction;
+}
+
+//! Contribution of the sub-domain owned by this process.
+double TSDiagnostic::local_value() {
+  return this->compute_local();
+}
+
+//! Value passed to update() or the result of compute().
+double TSDiagnostic::value() {
+  if (m_value_set) {
+    return m_value;
+  }
+  return this->compute();
+}
+
+double TSDiagnostic::compute() {
+  switch (m_reduction) {
+  case REDUCE_SUM:
+    return GlobalSum(m_grid->com, this->compute_local());
+  case REDUCE_MAX:
+    return GlobalMax(m_grid->com, this->compute_local());
+  default:
+  case REDUCE_NONE:
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "%s: compute() is not implemented",
+                                  m_variable.get_name().c_str());
+  }
+}
+
+double TSDiagnostic::compute_local() {
+  throw RuntimeError::formatted(PISM_ERROR_LOCATION, "%s: compute_local() is not implemented",
+                                m_variable.get_name().c_str());
+}
+
+/*!
+ * Update scalar diagnostics in `diagnostics`.
+ *
+ * Contributions of the local sub-domain to all diagnostics that implement compute_local()
+ * are collected in one buffer per reduction type and combined using one `MPI_Allreduce`
+ * call per type. Remaining diagnostics use compute().
+ */
+void update_timeseries(MPI_Comm com, const TSDiagnosticList &diagnostics, double t0, double t1) {
+  std::vector<double> sum_local, max_local;
+
+  for (const auto &d : diagnostics) {
+    switch (d.second->reduction()) {
+    case TSDiagnostic::REDUCE_SUM:
+      sum_local.push_back(d.second->local_value());
+      break;
+    case TSDiagnostic::REDUCE_MAX:
+      max_local.push_back(d.second->local_value());
+      break;
+    default:
+    case TSDiagnostic::REDUCE_NONE:
+      break;
+    }
+  }
+
+  std::vector<double> sum(sum_local.size()), max(max_local.size());
+  if (not sum.empty()) {
+    GlobalSum(com, sum_local.data(), sum.data(), static_cast<int>(sum.size()));
+  }
+  if (not max.empty()) {
+    GlobalMax(com, max_local.data(), max.data(), static_cast<int>(max.size()));
+  }
+
+  size_t s = 0, m = 0;
+  for (const auto &d : diagnostics) {
+    switch (d.second->reduction()) {
+    case TSDiagnostic::REDUCE_SUM:
+      d.second->update(t0, t1, sum[s++]);
+      break;
+    case TSDiagnostic::REDUCE_MAX:
+      d.second->update(t0, t1, max[m++]);
+      break;
+    default:
+    case TSDiagnostic::REDUCE_NONE:
+      d.second->update(t0, t1);
+      break;
+    }
+  }
+}
+
 void TSSnapshotDiagnostic::update_impl(double t0, double t1) {
   static const double epsilon = 1e-4; // seconds
 
@@ -301,11 +403,11 @@ void TSSnapshotDiagnostic::update_impl(double t0, double t1) {
 
   assert(t1 > t0);
 
-  evaluate(t0, t1, this->compute());
+  evaluate(t0, t1, this->value());
 }
 
 void TSRateDiagnostic::update_impl(double t0, double t1) {
-  const double v = this->compute();
+  const double v = this->value();
 
   if (m_v_previous_set) {
     assert(t1 > t0);
@@ -325,7 +427,7 @@ void TSFluxDiagnostic::update_impl(double t0, double t1) {
 
   assert(t1 > t0);
 
-  evaluate(t0, t1, this->compute());
+  evaluate(t0, t1, this->value());
 }
 
 void TSDiagnostic::flush() {
@@ -26,6 +26,7 @@
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/VariableMetadata.hh"
 #include "pism/util/io/IO_Flags.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
@@ -100,10 +101,13 @@ protected:
 
   /*!
    * Allocate storage for an array of type `T` and copy metadata from `m_vars`.
+   *
+   * Uses storage from the pool of the grid (see array::Pool): diagnostic quantities are
+   * computed, written and freed.
    */
   template<typename T>
   std::shared_ptr<T> allocate(const std::string &name) const {
-    auto result = std::make_shared<T>(m_grid, name);
+    auto result = array::pooled<T>(m_grid, name);
     for (unsigned int k = 0; k < result->ndof(); ++k) {
       result->metadata(k) = m_vars.at(k);
     }
@@ -142,6 +146,7 @@ public:
 protected:
   std::shared_ptr<array::Array> compute_impl() const {
     auto result = m_input.duplicate();
+    result->use_pool();
 
     result->set_name(m_input.get_name());
     for (unsigned int k = 0; k < m_vars.size(); ++k) {
@@ -279,10 +284,17 @@ class TSDiagnostic {
 public:
   typedef std::shared_ptr<TSDiagnostic> Ptr;
 
+  //! Reduction combining contributions of all sub-domains (see compute_local()).
+  enum Reduction { REDUCE_NONE, REDUCE_SUM, REDUCE_MAX };
+
   TSDiagnostic(std::shared_ptr<const Grid> g, const std::string &name);
   virtual ~TSDiagnostic();
 
   void update(double t0, double t1);
+  void update(double t0, double t1, double value);
+
+  Reduction reduction() const;
+  double local_value();
 
   void flush();
 
@@ -297,8 +309,22 @@ protected:
    * Compute the diagnostic. Regular (snapshot) quantity should be computed here; for rates of
    * change, compute() should return the total change during the time step from t0 to t1. The rate
    * itself is computed in evaluate_rate().
+   *
+   * The default implementation combines values returned by compute_local() using the
+   * reduction `m_reduction`.
+   */
+  virtual double compute();
+
+  /*!
+   * Compute the contribution of the sub-domain owned by this process.
+   *
+   * Diagnostics setting `m_reduction` implement this instead of compute(). This allows
+   * update_timeseries() to combine contributions to all these diagnostics using one
+   * reduction per type.
    */
-  virtual double compute() = 0;
+  virtual double compute_local();
+
+  double value();
 
   /*!
    * Set internal (MKS) and "output" units.
@@ -338,10 +364,19 @@ protected:
   unsigned int m_start;
   //! size of the buffer used to store data
   size_t m_buffer_size;
+
+  //! reduction used by compute() to combine values returned by compute_local()
+  Reduction m_reduction;
+private:
+  //! value passed to update() (used instead of compute() if set)
+  bool m_value_set;
+  double m_value;
 };
 
 typedef std::map<std::string, TSDiagnostic::Ptr> TSDiagnosticList;
 
+void update_timeseries(MPI_Comm com, const TSDiagnosticList &diagnostics, double t0, double t1);
+
 //! Scalar diagnostic reporting a snapshot of a quantity modeled by PISM.
 /*!
  * The method compute() should return the instantaneous "snapshot" value.
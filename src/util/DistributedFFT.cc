@@ -0,0 +1,499 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::max, std::min
+#include <cstdio>               // fopen, fclose
+#include <cstdlib>              // free
+
+#include "pism/util/DistributedFFT.hh"
+
+#include "pism/util/Grid.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/IS.hh"
+
+namespace pism {
+
+/*!
+ * Split `N` items into `size` contiguous chunks that differ in length by at most one.
+ */
+static void partition(int N, int size, std::vector<int> &start, std::vector<int> &count) {
+  start.resize(size);
+  count.resize(size);
+
+  int offset = 0;
+  for (int r = 0; r < size; ++r) {
+    count[r] = N / size + (r < N % size ? 1 : 0);
+    start[r] = offset;
+    offset += count[r];
+  }
+}
+
+static std::complex<double>* allocate(int size) {
+  // allocate at least one element to get a valid pointer on ranks that own no data
+  size = std::max(size, 1);
+  auto *result = (std::complex<double>*) fftw_malloc(sizeof(fftw_complex) * size);
+  for (int k = 0; k < size; ++k) {
+    result[k] = 0.0;
+  }
+  return result;
+}
+
+/*!
+ * Create a plan computing `howmany` contiguous 1D transforms of length `n`.
+ *
+ * Returns NULL if this rank owns no data.
+ */
+static fftw_plan plan_many(int n, int howmany,
+                           std::complex<double> *input, std::complex<double> *output,
+                           int sign, unsigned int flags) {
+  if (howmany == 0) {
+    return NULL;
+  }
+
+  return fftw_plan_many_dft(1, &n, howmany,
+                            (fftw_complex*)input, NULL, 1, n,
+                            (fftw_complex*)output, NULL, 1, n,
+                            sign, flags);
+}
+
+/*!
+ * Read FFTW wisdom from `filename` on rank 0 and import it on all ranks of `com`.
+ *
+ * A missing or invalid file is not an error: FFTW will re-compute plans.
+ */
+static void import_wisdom(MPI_Comm com, const std::string &filename) {
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  std::string wisdom;
+  if (rank == 0) {
+    FILE *f = fopen(filename.c_str(), "r");
+    if (f != NULL) {
+      if (fftw_import_wisdom_from_file(f) != 0) {
+        char *w = fftw_export_wisdom_to_string();
+        wisdom = w;
+        free(w);
+      }
+      fclose(f);
+    }
+  }
+
+  int length = static_cast<int>(wisdom.size());
+  MPI_Bcast(&length, 1, MPI_INT, 0, com);
+
+  if (length > 0) {
+    wisdom.resize(length);
+    MPI_Bcast(&wisdom[0], length, MPI_CHAR, 0, com);
+
+    if (rank != 0) {
+      fftw_import_wisdom_from_string(wisdom.c_str());
+    }
+  }
+}
+
+/*!
+ * Gather FFTW wisdom from all ranks of `com` and save it to `filename` on rank 0.
+ *
+ * Failure to save wisdom is not an error: it only affects the cost of planning in later
+ * runs.
+ */
+static void export_wisdom(MPI_Comm com, const std::string &filename) {
+  int rank = 0, size = 1;
+  MPI_Comm_rank(com, &rank);
+  MPI_Comm_size(com, &size);
+
+  std::string wisdom;
+  {
+    char *w = fftw_export_wisdom_to_string();
+    wisdom = w;
+    free(w);
+  }
+
+  int length = static_cast<int>(wisdom.size());
+  std::vector<int> lengths(size), displacements(size);
+  MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, com);
+
+  int total = 0;
+  for (int r = 0; r < size; ++r) {
+    displacements[r] = total;
+    total += lengths[r];
+  }
+
+  std::vector<char> all_wisdom(std::max(total, 1));
+  MPI_Gatherv(&wisdom[0], length, MPI_CHAR, all_wisdom.data(), lengths.data(),
+              displacements.data(), MPI_CHAR, 0, com);
+
+  if (rank == 0) {
+    // merge wisdom accumulated by all ranks
+    for (int r = 1; r < size; ++r) {
+      std::string w(&all_wisdom[displacements[r]], lengths[r]);
+      fftw_import_wisdom_from_string(w.c_str());
+    }
+
+    FILE *f = fopen(filename.c_str(), "w");
+    if (f != NULL) {
+      fftw_export_wisdom_to_file(f);
+      fclose(f);
+    }
+  }
+}
+
+static void execute(fftw_plan plan) {
+  if (plan != NULL) {
+    fftw_execute(plan);
+  }
+}
+
+DistributedFFT::DistributedFFT(MPI_Comm com, int Nx, int Ny, const std::string &wisdom_file)
+  : m_com(com), m_Nx(Nx), m_Ny(Ny) {
+
+  int rank = 0, size = 1;
+  MPI_Comm_rank(m_com, &rank);
+  MPI_Comm_size(m_com, &size);
+
+  partition(m_Nx, size, m_row_start, m_row_count);
+  partition(m_Ny, size, m_column_start, m_column_count);
+
+  m_xs = m_row_start[rank];
+  m_xm = m_row_count[rank];
+  m_ys = m_column_start[rank];
+  m_ym = m_column_count[rank];
+
+  m_space    = allocate(m_xm * m_Ny);
+  m_spectrum = allocate(m_ym * m_Nx);
+  m_work     = allocate(std::max(m_xm * m_Ny, m_ym * m_Nx));
+
+  m_send.resize(std::max(m_xm * m_Ny, m_ym * m_Nx));
+  m_recv.resize(m_send.size());
+
+  // Note: FFTW calls abort() if fftw_malloc() fails (see LingleClarkSerial.cc)
+
+  unsigned int flags = FFTW_ESTIMATE;
+  if (not wisdom_file.empty()) {
+    import_wisdom(m_com, wisdom_file);
+    flags = FFTW_MEASURE;
+  }
+
+  // transforms along rows (the "j" direction)
+  m_row_forward = plan_many(m_Ny, m_xm, m_space, m_work, FFTW_FORWARD, flags);
+  m_row_inverse = plan_many(m_Ny, m_xm, m_space, m_space, FFTW_BACKWARD, flags);
+
+  // transforms along columns (the "i" direction) in the transposed layout
+  m_column_forward = plan_many(m_Nx, m_ym, m_spectrum, m_spectrum, FFTW_FORWARD, flags);
+  m_column_inverse = plan_many(m_Nx, m_ym, m_spectrum, m_work, FFTW_BACKWARD, flags);
+
+  if (not wisdom_file.empty()) {
+    export_wisdom(m_com, wisdom_file);
+    // planning with FFTW_MEASURE leaves garbage in the input array
+    clear_space();
+  }
+}
+
+DistributedFFT::~DistributedFFT() {
+  fftw_plan plans[] = {m_row_forward, m_row_inverse, m_column_forward, m_column_inverse};
+  for (auto p : plans) {
+    if (p != NULL) {
+      fftw_destroy_plan(p);
+    }
+  }
+  fftw_free(m_space);
+  fftw_free(m_spectrum);
+  fftw_free(m_work);
+}
+
+int DistributedFFT::Nx() const {
+  return m_Nx;
+}
+
+int DistributedFFT::Ny() const {
+  return m_Ny;
+}
+
+int DistributedFFT::xs() const {
+  return m_xs;
+}
+
+int DistributedFFT::xm() const {
+  return m_xm;
+}
+
+int DistributedFFT::ys() const {
+  return m_ys;
+}
+
+int DistributedFFT::ym() const {
+  return m_ym;
+}
+
+std::complex<double> *DistributedFFT::spectrum() {
+  return m_spectrum;
+}
+
+int DistributedFFT::spectrum_size() const {
+  return m_ym * m_Nx;
+}
+
+//! Fill the physical space array with zeros.
+void DistributedFFT::clear_space() {
+  for (int k = 0; k < m_xm * m_Ny; ++k) {
+    m_space[k] = 0.0;
+  }
+}
+
+/*!
+ * Compute the forward transform of space() and put it in spectrum().
+ *
+ * Overwrites space().
+ */
+void DistributedFFT::forward() {
+  execute(m_row_forward);       // space -> work
+  transpose_forward();          // work -> spectrum
+  execute(m_column_forward);    // in place
+}
+
+/*!
+ * Compute the inverse transform of spectrum() and put it in space().
+ *
+ * Does not modify spectrum().
+ */
+void DistributedFFT::inverse() {
+  execute(m_column_inverse);    // spectrum -> work
+  transpose_inverse();          // work -> space
+  execute(m_row_inverse);       // in place
+}
+
+/*!
+ * Re-distribute `m_work` (row slabs) into `m_spectrum` (column slabs).
+ */
+void DistributedFFT::transpose_forward() {
+  int size = static_cast<int>(m_row_start.size());
+
+  std::vector<int> send_counts(size), send_displs(size), recv_counts(size), recv_displs(size);
+
+  int send_offset = 0, recv_offset = 0;
+  for (int r = 0; r < size; ++r) {
+    // pack columns owned by rank r
+    for (int j = m_column_start[r]; j < m_column_start[r] + m_column_count[r]; ++j) {
+      for (int i = 0; i < m_xm; ++i) {
+        m_send[send_offset + (j - m_column_start[r]) * m_xm + i] = m_work[i * m_Ny + j];
+      }
+    }
+    // counts are in doubles: each complex number is sent as two doubles
+    send_counts[r] = 2 * m_xm * m_column_count[r];
+    send_displs[r] = 2 * send_offset;
+    send_offset += m_xm * m_column_count[r];
+
+    recv_counts[r] = 2 * m_row_count[r] * m_ym;
+    recv_displs[r] = 2 * recv_offset;
+    recv_offset += m_row_count[r] * m_ym;
+  }
+
+  MPI_Alltoallv(m_send.data(), send_counts.data(), send_displs.data(), MPI_DOUBLE,
+                m_recv.data(), recv_counts.data(), recv_displs.data(), MPI_DOUBLE,
+                m_com);
+
+  // unpack rows sent by rank r
+  for (int r = 0; r < size; ++r) {
+    const std::complex<double> *block = &m_recv[recv_displs[r] / 2];
+    for (int j = 0; j < m_ym; ++j) {
+      for (int i = 0; i < m_row_count[r]; ++i) {
+        m_spectrum[j * m_Nx + m_row_start[r] + i] = block[j * m_row_count[r] + i];
+      }
+    }
+  }
+}
+
+/*!
+ * Re-distribute `m_work` (column slabs) into `m_space` (row slabs).
+ */
+void DistributedFFT::transpose_inverse() {
+  int size = static_cast<int>(m_row_start.size());
+
+  std::vector<int> send_counts(size), send_displs(size), recv_counts(size), recv_displs(size);
+
+  int send_offset = 0, recv_offset = 0;
+  for (int r = 0; r < size; ++r) {
+    // pack rows owned by rank r
+    for (int j = 0; j < m_ym; ++j) {
+      for (int i = m_row_start[r]; i < m_row_start[r] + m_row_count[r]; ++i) {
+        m_send[send_offset + j * m_row_count[r] + (i - m_row_start[r])] = m_work[j * m_Nx + i];
+      }
+    }
+    send_counts[r] = 2 * m_ym * m_row_count[r];
+    send_displs[r] = 2 * send_offset;
+    send_offset += m_ym * m_row_count[r];
+
+    recv_counts[r] = 2 * m_column_count[r] * m_xm;
+    recv_displs[r] = 2 * recv_offset;
+    recv_offset += m_column_count[r] * m_xm;
+  }
+
+  MPI_Alltoallv(m_send.data(), send_counts.data(), send_displs.data(), MPI_DOUBLE,
+                m_recv.data(), recv_counts.data(), recv_displs.data(), MPI_DOUBLE,
+                m_com);
+
+  // unpack columns sent by rank r
+  for (int r = 0; r < size; ++r) {
+    const std::complex<double> *block = &m_recv[recv_displs[r] / 2];
+    for (int j = 0; j < m_column_count[r]; ++j) {
+      for (int i = 0; i < m_xm; ++i) {
+        m_space[i * m_Ny + m_column_start[r] + j] = block[j * m_xm + i];
+      }
+    }
+  }
+}
+
+FFTEmbedding::FFTEmbedding(const Grid &grid, const DistributedFFT &fft, int i0, int j0)
+  : m_Mx(grid.Mx()), m_My(grid.My()), m_i0(i0), m_j0(j0) {
+
+  if (i0 < 0 or j0 < 0 or i0 + m_Mx > fft.Nx() or j0 + m_My > fft.Ny()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "a %d*%d grid at offsets (%d, %d) does not fit"
+                                  " in the %d*%d FFT domain",
+                                  m_Mx, m_My, i0, j0, fft.Nx(), fft.Ny());
+  }
+
+  PetscErrorCode ierr = 0;
+
+  int n_points = grid.xm() * grid.ym();
+
+  ierr = VecCreateMPI(grid.com, n_points, PETSC_DETERMINE, m_grid_values.rawptr());
+  PISM_CHK(ierr, "VecCreateMPI");
+
+  // This relies on the fact that row slabs of the FFT domain are assigned to ranks in
+  // order.
+  ierr = VecCreateMPI(grid.com, fft.xm() * fft.Ny(), PETSC_DETERMINE, m_slab_values.rawptr());
+  PISM_CHK(ierr, "VecCreateMPI");
+
+  PetscInt start = 0;
+  ierr = VecGetOwnershipRange(m_grid_values, &start, NULL);
+  PISM_CHK(ierr, "VecGetOwnershipRange");
+
+  std::vector<PetscInt> from(n_points), to(n_points);
+  int k = 0;
+  for (auto p = grid.points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    from[k] = start + k;
+    to[k]   = (i + i0) * fft.Ny() + (j + j0);
+    ++k;
+  }
+
+  petsc::IS is_from, is_to;
+  ierr = ISCreateGeneral(grid.com, n_points, from.data(), PETSC_COPY_VALUES, is_from.rawptr());
+  PISM_CHK(ierr, "ISCreateGeneral");
+
+  ierr = ISCreateGeneral(grid.com, n_points, to.data(), PETSC_COPY_VALUES, is_to.rawptr());
+  PISM_CHK(ierr, "ISCreateGeneral");
+
+  ierr = VecScatterCreate(m_grid_values, is_from, m_slab_values, is_to, m_scatter.rawptr());
+  PISM_CHK(ierr, "VecScatterCreate");
+}
+
+/*!
+ * Set the real part of the embedded sub-domain of the physical space of `output` to
+ * `input * normalization`.
+ *
+ * Sets the imaginary part to zero. Values outside of the sub-domain are not modified.
+ */
+void FFTEmbedding::set_real_part(const array::Scalar &input, double normalization,
+                                 DistributedFFT &output) const {
+  PetscErrorCode ierr = 0;
+  auto grid = input.grid();
+
+  {
+    array::AccessScope list{&input};
+    petsc::VecArray values(m_grid_values);
+    double *v = values.get();
+
+    int k = 0;
+    for (auto p = grid->points(); p; p.next()) {
+      v[k] = input(p.i(), p.j());
+      ++k;
+    }
+  }
+
+  ierr = VecScatterBegin(m_scatter, m_grid_values, m_slab_values, INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterBegin");
+  ierr = VecScatterEnd(m_scatter, m_grid_values, m_slab_values, INSERT_VALUES, SCATTER_FORWARD);
+  PISM_CHK(ierr, "VecScatterEnd");
+
+  const int
+    Ny      = output.Ny(),
+    xs      = output.xs(),
+    i_start = std::max(xs, m_i0),
+    i_end   = std::min(xs + output.xm(), m_i0 + m_Mx);
+
+  petsc::VecArray values(m_slab_values);
+  const double *v = values.get();
+  for (int i = i_start; i < i_end; ++i) {
+    for (int j = m_j0; j < m_j0 + m_My; ++j) {
+      output.space(i, j) = v[(i - xs) * Ny + j] * normalization;
+    }
+  }
+}
+
+/*!
+ * Get the real part of the embedded sub-domain of the physical space of `input`, scaled
+ * by `normalization`.
+ */
+void FFTEmbedding::get_real_part(DistributedFFT &input, double normalization,
+                                 array::Scalar &output) const {
+  PetscErrorCode ierr = 0;
+  auto grid = output.grid();
+
+  {
+    const int
+      Ny      = input.Ny(),
+      xs      = input.xs(),
+      i_start = std::max(xs, m_i0),
+      i_end   = std::min(xs + input.xm(), m_i0 + m_Mx);
+
+    petsc::VecArray values(m_slab_values);
+    double *v = values.get();
+    for (int i = i_start; i < i_end; ++i) {
+      for (int j = m_j0; j < m_j0 + m_My; ++j) {
+        v[(i - xs) * Ny + j] = input.space(i, j).real() * normalization;
+      }
+    }
+  }
+
+  ierr = VecScatterBegin(m_scatter, m_slab_values, m_grid_values, INSERT_VALUES, SCATTER_REVERSE);
+  PISM_CHK(ierr, "VecScatterBegin");
+  ierr = VecScatterEnd(m_scatter, m_slab_values, m_grid_values, INSERT_VALUES, SCATTER_REVERSE);
+  PISM_CHK(ierr, "VecScatterEnd");
+
+  {
+    array::AccessScope list{&output};
+    petsc::VecArray values(m_grid_values);
+    const double *v = values.get();
+
+    int k = 0;
+    for (auto p = grid->points(); p; p.next()) {
+      output(p.i(), p.j()) = v[k];
+      ++k;
+    }
+  }
+
+  output.update_ghosts();
+  output.inc_state_counter();   // mark as modified
+}
+
+} // end of namespace pism
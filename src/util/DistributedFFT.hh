@@ -0,0 +1,145 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_DISTRIBUTEDFFT_H
+#define PISM_DISTRIBUTEDFFT_H
+
+#include <complex>
+#include <string>
+#include <vector>
+
+#include <fftw3.h>
+#include <mpi.h>
+
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/petscwrappers/VecScatter.hh"
+
+namespace pism {
+
+class Grid;
+
+namespace array {
+class Scalar;
+} // end of namespace array
+
+/*!
+ * Slab-decomposed 2D complex DFT of size Nx*Ny.
+ *
+ * In "physical" space each rank owns a slab of rows `xs <= i < xs + xm`, each containing
+ * all `Ny` values (the `j` index is the fastest, same as in FFTWArray). The
+ * forward transform leaves its result in the *transposed* layout: each rank owns columns
+ * `ys <= j < ys + ym`, each containing all `Nx` values.
+ *
+ * Point-wise operations in Fourier space don't need the "un-transposed" spectrum, so
+ * leaving it transposed saves two global transposes per forward-inverse pair.
+ *
+ * One-dimensional transforms are computed using FFTW, transposes use MPI_Alltoallv(). The
+ * inverse transform is not normalized (same as FFTW).
+ *
+ * If `wisdom_file` is not empty, FFTW plans are optimized by measuring their run time
+ * (`FFTW_MEASURE`) and the accumulated FFTW "wisdom" is read from and saved to this file,
+ * making planning cheap in later runs using the same grid and number of MPI ranks.
+ */
+class DistributedFFT {
+public:
+  DistributedFFT(MPI_Comm com, int Nx, int Ny, const std::string &wisdom_file = "");
+  ~DistributedFFT();
+
+  int Nx() const;
+  int Ny() const;
+
+  int xs() const;
+  int xm() const;
+
+  int ys() const;
+  int ym() const;
+
+  //! Physical space value at (i, j), `xs <= i < xs + xm`.
+  inline std::complex<double> &space(int i, int j) {
+    return m_space[(i - m_xs) * m_Ny + j];
+  }
+
+  //! Fourier space value at (i, j), `ys <= j < ys + ym`.
+  inline std::complex<double> &spectrum(int i, int j) {
+    return m_spectrum[(j - m_ys) * m_Nx + i];
+  }
+
+  //! Fourier space data owned by this rank (`ym*Nx` values)
+  std::complex<double> *spectrum();
+
+  //! Number of Fourier space values owned by this rank
+  int spectrum_size() const;
+
+  void clear_space();
+
+  void forward();
+  void inverse();
+private:
+  void transpose_forward();
+  void transpose_inverse();
+
+  MPI_Comm m_com;
+  int m_Nx, m_Ny;
+  int m_xs, m_xm, m_ys, m_ym;
+
+  // row (xs, xm) and column (ys, ym) ownership ranges of all ranks
+  std::vector<int> m_row_start, m_row_count, m_column_start, m_column_count;
+
+  std::complex<double> *m_space;
+  std::complex<double> *m_spectrum;
+  std::complex<double> *m_work;
+
+  std::vector<std::complex<double> > m_send, m_recv;
+
+  fftw_plan m_row_forward, m_row_inverse, m_column_forward, m_column_inverse;
+
+  // disable copy constructor and the assignment operator:
+  DistributedFFT(const DistributedFFT &other);
+  DistributedFFT& operator=(const DistributedFFT&);
+};
+
+/*!
+ * Moves data between a field on a PISM grid (distributed using PETSc's DM) and the
+ * physical space of a DistributedFFT, placing the PISM grid at offsets `(i0, j0)` in the
+ * (usually bigger) FFT domain.
+ *
+ * This plays the role of set_real_part() and get_real_part() in fftw_utilities.hh.
+ */
+class FFTEmbedding {
+public:
+  FFTEmbedding(const Grid &grid, const DistributedFFT &fft, int i0, int j0);
+
+  void set_real_part(const array::Scalar &input, double normalization,
+                     DistributedFFT &output) const;
+
+  void get_real_part(DistributedFFT &input, double normalization,
+                     array::Scalar &output) const;
+private:
+  int m_Mx, m_My, m_i0, m_j0;
+
+  //! field values in the "grid" order (owned points only)
+  petsc::Vec m_grid_values;
+  //! field values in the "row slab" order of the FFT domain
+  petsc::Vec m_slab_values;
+  petsc::VecScatter m_scatter;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_DISTRIBUTEDFFT_H */
@@ -39,6 +39,7 @@
 #include "pism/util/Context.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/Vars.hh"
+#include "pism/util/array/Pool.hh"
 #include "pism/util/io/File.hh"
 #include "pism/util/petscwrappers/DM.hh"
 #include "pism/util/projection.hh"
@@ -117,14 +118,14 @@ struct Grid::Impl {
   //! surface and ocean models).
   Vars variables;
 
-  //! GSL binary search accelerator used to speed up kBelowHeight().
-  gsl_interp_accel *bsearch_accel;
-
   std::map<std::string, std::shared_ptr<InputInterpolation>> regridding_2d;
+
+  //! Storage for short-lived arrays
+  array::Pool array_pool;
 };
 
 Grid::Impl::Impl(std::shared_ptr<const Context> context)
-    : ctx(context), mapping_info("mapping", ctx->unit_system()) {
+    : ctx(context), mapping_info("mapping", ctx->unit_system()), array_pool(context->com()) {
   // empty
 }
 
@@ -159,11 +160,6 @@ Grid::Grid(std::shared_ptr<const Context> context, const grid::Parameters &p)
     : com(context->com()), m_impl(new Impl(context)) {
 
   try {
-    m_impl->bsearch_accel = gsl_interp_accel_alloc();
-    if (m_impl->bsearch_accel == NULL) {
-      throw RuntimeError(PISM_ERROR_LOCATION, "Failed to allocate a GSL interpolation accelerator");
-    }
-
     m_impl->rank = context->rank();
     m_impl->size = context->size();
 
@@ -265,8 +261,6 @@ std::shared_ptr<Grid> Grid::FromFile(std::shared_ptr<const Context> ctx,
 }
 
 Grid::~Grid() {
-  gsl_interp_accel_free(m_impl->bsearch_accel);
-
   delete m_impl;
 }
 
@@ -289,7 +283,9 @@ unsigned int Grid::kBelowHeight(double height) const {
                                   height, Lz());
   }
 
-  return gsl_interp_accel_find(m_impl->bsearch_accel, m_impl->z.data(), m_impl->z.size(), height);
+  // Note: this does not use an interpolation accelerator (i.e. has no state) so that it can
+  // be called from several threads (see for_each_point()).
+  return gsl_interp_bsearch(m_impl->z.data(), height, 0, m_impl->z.size() - 1);
 }
 
 
@@ -574,6 +570,11 @@ unsigned int Grid::size() const {
   return m_impl->size;
 }
 
+//! Pool of storage for short-lived arrays using this grid (see array::Pool).
+array::Pool &Grid::array_pool() const {
+  return m_impl->array_pool;
+}
+
 //! Dictionary of variables (2D and 3D fields) associated with this grid.
 Vars &Grid::variables() {
   return m_impl->variables;
@@ -44,6 +44,10 @@ namespace petsc {
 class DM;
 } // end of namespace petsc
 
+namespace array {
+class Pool;
+} // end of namespace array
+
 namespace units {
 class System;
 }
@@ -306,6 +310,8 @@ public:
 
   std::shared_ptr<petsc::DM> get_dm(unsigned int dm_dof, unsigned int stencil_width) const;
 
+  array::Pool &array_pool() const;
+
   std::shared_ptr<InputInterpolation> get_interpolation(const std::vector<double> &levels,
                                                         const File &input_file,
                                                         const std::string &variable_name,
@@ -80,6 +80,9 @@ InputInterpolation3D::InputInterpolation3D(const Grid &target_grid,
   m_interp_context = std::make_shared<LocalInterpCtx>(input_grid, target_grid, levels, type);
 }
 
+const LocalInterpCtx &InputInterpolation3D::context() const {
+  return *m_interp_context;
+}
 
 double InputInterpolation3D::regrid_impl(const SpatialVariableMetadata &metadata,
                                          const pism::File &file,
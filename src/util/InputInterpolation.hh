@@ -74,6 +74,9 @@ public:
                        const File &input_file, const std::string &variable_name,
                        InterpolationType type);
 
+  //! Describes the part of the input grid read by this process.
+  const LocalInterpCtx &context() const;
+
 private:
   double regrid_impl(const SpatialVariableMetadata &metadata, const pism::File &file,
                      int record_index, const Grid &grid, petsc::Vec &output) const;
@@ -33,6 +33,8 @@
 #include "pism/util/petscwrappers/Vec.hh"
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/InputInterpolationYAC.hh"
+#include "pism/util/InterpolationWeightsCache.hh"
+#include "pism/util/ConfigInterface.hh"
 #include "pism/util/pism_utilities.hh" // GlobalMin()
 
 #if (Pism_USE_PROJ == 0)
@@ -125,10 +127,13 @@ struct LonLatGrid {
 /*!
  * Define the PISM grid. Each PE defines its own subdomain.
  *
+ * Cells and their corners use global indices that do not depend on the domain
+ * decomposition, so that cached interpolation weights can be re-used by runs using a
+ * different number of processes.
+ *
  * Returns the point ID that can be used to define a "field".
  */
-int InputInterpolationYAC::define_grid(const std::vector<double> &x_cell,
-                                       const std::vector<double> &y_cell,
+int InputInterpolationYAC::define_grid(const LocalGrid &grid,
                                        const std::string &grid_name,
                                        const std::string &projection) {
 
@@ -137,6 +142,9 @@ int InputInterpolationYAC::define_grid(const std::vector<double> &x_cell,
         PISM_ERROR_LOCATION, "grid '%s' has no projection information", grid_name.c_str());
   }
 
+  const auto &x_cell = grid.x;
+  const auto &y_cell = grid.y;
+
   // Shift x and y by half a grid spacing and add one more row and column to get
   // coordinates of corners of cells in the local sub-domain:
   std::vector<double> x_node(x_cell.size() + 1), y_node(y_cell.size() + 1);
@@ -161,6 +169,29 @@ int InputInterpolationYAC::define_grid(const std::vector<double> &x_cell,
   // Compute lon,lat coordinates of cell corners:
   LonLatGrid nodes(x_node, y_node, projection);
 
+  // Global indices of cells and corners (the global grid of corners has Mx + 1 columns):
+  std::vector<int> cell_index(x_cell.size() * y_cell.size()),
+      node_index(x_node.size() * y_node.size());
+  {
+    auto global_index = [](size_t row, size_t col, int xs, int ys, int ncol) {
+      return (ys + (int)row) * ncol + xs + (int)col;
+    };
+
+    for (size_t row = 0; row < y_cell.size(); ++row) {
+      for (size_t col = 0; col < x_cell.size(); ++col) {
+        cell_index[row * x_cell.size() + col] =
+            global_index(row, col, grid.xs, grid.ys, grid.Mx);
+      }
+    }
+
+    for (size_t row = 0; row < y_node.size(); ++row) {
+      for (size_t col = 0; col < x_node.size(); ++col) {
+        node_index[row * x_node.size() + col] =
+            global_index(row, col, grid.xs, grid.ys, grid.Mx + 1);
+      }
+    }
+  }
+
   int point_id = 0;
   {
     int cyclic[] = { 0, 0 };
@@ -171,6 +202,9 @@ int InputInterpolationYAC::define_grid(const std::vector<double> &x_cell,
     yac_cdef_grid_curve2d(grid_name.c_str(), n_nodes, cyclic, nodes.lon.data(), nodes.lat.data(),
                           &grid_id);
 
+    yac_cset_global_index(cell_index.data(), YAC_LOCATION_CELL, grid_id);
+    yac_cset_global_index(node_index.data(), YAC_LOCATION_CORNER, grid_id);
+
     int n_cells[2] = { (int)x_cell.size(), (int)y_cell.size() };
     yac_cdef_points_curve2d(grid_id, n_cells, YAC_LOCATION_CELL, cells.lon.data(), cells.lat.data(),
                             &point_id);
@@ -183,21 +217,24 @@ int InputInterpolationYAC::define_grid(const std::vector<double> &x_cell,
  * projection info.
  *
  * @param[in] component_id YAC component ID
- * @param[in] pism_grid PISM's grid
- * @param[in] name string describing this grid and field
+ * @param[in] grid local part of the grid
+ * @param[in] proj_string projection (PROJ string)
+ * @param[in] grid_name name of the YAC grid
+ * @param[in] field_name name of the YAC field
  */
-int InputInterpolationYAC::define_field(int component_id, const std::vector<double> &x,
-                                        const std::vector<double> &y,
-                                        const std::string &proj_string, const std::string &name) {
+int InputInterpolationYAC::define_field(int component_id, const LocalGrid &grid,
+                                        const std::string &proj_string,
+                                        const std::string &grid_name,
+                                        const std::string &field_name) {
 
-  int point_id = define_grid(x, y, name, proj_string);
+  int point_id = define_grid(grid, grid_name, proj_string);
 
   const char *time_step_length = "1";
   const int point_set_size     = 1;
   const int collection_size    = 1;
 
   int field_id = 0;
-  yac_cdef_field(name.c_str(), component_id, &point_id, point_set_size, collection_size,
+  yac_cdef_field(field_name.c_str(), component_id, &point_id, point_set_size, collection_size,
                  time_step_length, YAC_TIME_UNIT_SECOND, &field_id);
   return field_id;
 }
@@ -331,6 +368,62 @@ InputInterpolationYAC::InputInterpolationYAC(const pism::Grid &target_grid,
     m_buffer = std::make_shared<pism::array::Scalar>(source_grid, variable_name);
 
     std::string target_grid_name = "internal for " + source_grid_name;
+
+    // local parts of source and target grids
+    auto source_x = grid_subset(source_grid->xs(), source_grid->xm(), source_grid_info.x);
+    auto source_y = grid_subset(source_grid->ys(), source_grid->ym(), source_grid_info.y);
+    auto target_x = grid_subset(target_grid.xs(), target_grid.xm(), target_grid.x());
+    auto target_y = grid_subset(target_grid.ys(), target_grid.ym(), target_grid.y());
+
+    double source_grid_spacing = 0.0;
+    {
+      double dx = 0.0;
+      double dy = 0.0;
+      if (source_grid_info.longitude_latitude) {
+        dx = dx_min(source_grid_mapping.proj_string, source_x, source_y);
+        dy = dy_min(source_grid_mapping.proj_string, source_x, source_y);
+      } else {
+        dx = std::abs(source_x[1] - source_x[0]);
+        dy = std::abs(source_y[1] - source_y[0]);
+      }
+      source_grid_spacing = GlobalMin(ctx->com(), std::min(dx, dy));
+    }
+
+    double target_grid_spacing =
+        GlobalMin(ctx->com(), std::min(target_grid.dx(), target_grid.dy()));
+
+    std::string method;
+    if (type == PIECEWISE_CONSTANT) {
+      method = "nearest neighbor";
+    } else if (source_grid_spacing < target_grid_spacing) {
+      method = "1st order conservative";
+    } else {
+      method = "weighted average of source cell nodes";
+    }
+
+    // YAC grid names. When weights are cached these have to be the same in all runs
+    // using the same grids (they are stored in weight files), so they should not depend
+    // on the input file name.
+    std::string source_yac_grid = source_grid_name;
+    std::string target_yac_grid = target_grid_name;
+
+    std::unique_ptr<InterpolationWeightsCache> cache;
+    bool cache_hit = false;
+    {
+      auto directory = ctx->config()->get_string("input.interpolation_cache_directory");
+      if (not directory.empty()) {
+        cache.reset(new InterpolationWeightsCache(
+            directory, source_grid_info.x, source_grid_info.y,
+            source_grid->get_mapping_info().proj_string, target_grid.x(), target_grid.y(),
+            target_grid.get_mapping_info().proj_string, method));
+
+        source_yac_grid = pism::printf("source_%016llx", (unsigned long long)cache->key());
+        target_yac_grid = pism::printf("target_%016llx", (unsigned long long)cache->key());
+
+        cache_hit = cache->open(ctx->com());
+      }
+    }
+
     {
       // Initialize YAC:
       {
@@ -347,50 +440,45 @@ InputInterpolationYAC::InputInterpolationYAC(const pism::Grid &target_grid,
       int comp_ids[n_comps]           = { 0, 0 };
       yac_cdef_comps_instance(m_instance_id, comp_names, n_comps, comp_ids);
 
-      double source_grid_spacing = 0.0;
       log->message(2, "Defining the source grid (%s)...\n", source_grid_name.c_str());
       {
-        auto x = grid_subset(source_grid->xs(), source_grid->xm(), source_grid_info.x);
-        auto y = grid_subset(source_grid->ys(), source_grid->ym(), source_grid_info.y);
+        LocalGrid local{ source_x,
+                         source_y,
+                         source_grid->xs(),
+                         source_grid->ys(),
+                         (int)source_grid->Mx() };
 
-        m_source_field_id = define_field(
-            comp_ids[0], x, y, source_grid->get_mapping_info().proj_string, source_grid_name);
+        m_source_field_id = define_field(comp_ids[0], local,
+                                         source_grid->get_mapping_info().proj_string,
+                                         source_yac_grid, source_grid_name);
 
-        double dx = 0.0;
-        double dy = 0.0;
-        if (source_grid_info.longitude_latitude) {
-          dx = dx_min(source_grid_mapping.proj_string, x, y);
-          dy = dy_min(source_grid_mapping.proj_string, x, y);
-        } else {
-          dx = std::abs(x[1] - x[0]);
-          dy = std::abs(y[1] - y[0]);
-        }
-        source_grid_spacing = GlobalMin(ctx->com(), std::min(dx, dy));
         log->message(2, " Source grid spacing: ~%3.3f m\n", source_grid_spacing);
       }
 
-      double target_grid_spacing = 0.0;
       log->message(2, "Defining the target grid (%s)...\n", target_grid_name.c_str());
       {
-        auto x = grid_subset(target_grid.xs(), target_grid.xm(), target_grid.x());
-        auto y = grid_subset(target_grid.ys(), target_grid.ym(), target_grid.y());
+        LocalGrid local{ target_x, target_y, target_grid.xs(), target_grid.ys(),
+                         (int)target_grid.Mx() };
 
-        m_target_field_id = define_field(
-            comp_ids[1], x, y, target_grid.get_mapping_info().proj_string, target_grid_name);
+        m_target_field_id =
+            define_field(comp_ids[1], local, target_grid.get_mapping_info().proj_string,
+                         target_yac_grid, target_grid_name);
 
-        target_grid_spacing = GlobalMin(ctx->com(), std::min(target_grid.dx(), target_grid.dy()));
         log->message(2, " Target grid spacing: %3.3f m\n", target_grid_spacing);
       }
 
       // Define the interpolation stack:
       {
-        std::string method;
         int interp_stack_id = 0;
         yac_cget_interp_stack_config(&interp_stack_id);
 
-        if (type == PIECEWISE_CONSTANT) {
-          method = "nearest neighbor";
+        if (cache_hit) {
+          // use cached weights; methods below are used for target points not covered by
+          // the weight file (if any)
+          yac_cadd_interp_stack_config_user_file(interp_stack_id, cache->filename().c_str());
+        }
 
+        if (type == PIECEWISE_CONSTANT) {
           // use nearest neighbor interpolation to interpolate integer fields:
           {
             // nearest neighbor
@@ -403,16 +491,12 @@ InputInterpolationYAC::InputInterpolationYAC(const pism::Grid &target_grid,
         } else {
           int partial_coverage = 0;
           if (source_grid_spacing < target_grid_spacing) {
-            method = "1st order conservative";
-
             int order                = 1;
             int enforce_conservation = 1;
 
             yac_cadd_interp_stack_config_conservative(interp_stack_id, order, enforce_conservation,
                                                       partial_coverage, YAC_CONSERV_DESTAREA);
           } else {
-            method = "weighted average of source cell nodes";
-
             // use average over source grid nodes containing a target point as a backup:
             yac_cadd_interp_stack_config_average(interp_stack_id, YAC_AVG_BARY, partial_coverage);
           }
@@ -429,23 +513,33 @@ InputInterpolationYAC::InputInterpolationYAC(const pism::Grid &target_grid,
 
         log->message(2, "Interpolation method: %s\n", method.c_str());
 
+        // Ask YAC to save computed weights if they are not in the cache:
+        int ext_couple_config_id = 0;
+        yac_cget_ext_couple_config(&ext_couple_config_id);
+        if (cache and not cache_hit) {
+          yac_cset_ext_couple_config_weight_file(ext_couple_config_id,
+                                                 cache->tmp_filename().c_str());
+        }
+
         // Define the coupling between fields:
         const int src_lag = 0;
         const int tgt_lag = 0;
-        yac_cdef_couple_instance(m_instance_id,
-                                 "source_component",       // source component name
-                                 source_grid_name.c_str(), // source grid name
-                                 source_grid_name.c_str(), // source field name
-                                 "target_component",       // target component name
-                                 target_grid_name.c_str(), // target grid name
-                                 target_grid_name.c_str(), // target field name
-                                 "1",                      // time step length in units below
-                                 YAC_TIME_UNIT_SECOND,     // time step length units
-                                 YAC_REDUCTION_TIME_NONE,  // reduction in time (for
-                                                           // asynchronous coupling)
-                                 interp_stack_id, src_lag, tgt_lag);
-
-        // free the interpolation stack config now that we defined the coupling
+        yac_cdef_couple_custom_instance(m_instance_id,
+                                        "source_component",       // source component name
+                                        source_yac_grid.c_str(),  // source grid name
+                                        source_grid_name.c_str(), // source field name
+                                        "target_component",       // target component name
+                                        target_yac_grid.c_str(),  // target grid name
+                                        target_grid_name.c_str(), // target field name
+                                        "1",                      // time step length in units below
+                                        YAC_TIME_UNIT_SECOND,     // time step length units
+                                        YAC_REDUCTION_TIME_NONE,  // reduction in time (for
+                                                                  // asynchronous coupling)
+                                        interp_stack_id, src_lag, tgt_lag,
+                                        ext_couple_config_id);
+
+        // free configs now that we defined the coupling
+        yac_cfree_ext_couple_config(ext_couple_config_id);
         yac_cfree_interp_stack_config(interp_stack_id);
       }
 
@@ -454,6 +548,16 @@ InputInterpolationYAC::InputInterpolationYAC(const pism::Grid &target_grid,
       double end = MPI_Wtime();
       log->message(2, "Initialized interpolation from %s in %f seconds.\n",
                    source_grid_name.c_str(), end - start);
+
+      if (cache) {
+        if (cache_hit) {
+          log->message(2, "interpolation weights cache hit: %s\n", cache->filename().c_str());
+        } else {
+          bool saved = cache->save(ctx->com());
+          log->message(2, "interpolation weights cache miss: %s (%s)\n",
+                       cache->filename().c_str(), saved ? "saved" : "failed to save");
+        }
+      }
     }
   } catch (pism::RuntimeError &e) {
     e.add_context("initializing interpolation from %s to the internal grid",
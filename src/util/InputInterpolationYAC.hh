@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "pism/util/InputInterpolation.hh"
 
@@ -59,11 +60,23 @@ private:
 
   double interpolate(const array::Scalar &source, petsc::Vec &target) const;
 
-  static int define_field(int component_id, const std::vector<double> &x,
-                          const std::vector<double> &y, const std::string &proj_string,
-                          const std::string &name);
-  static int define_grid(const std::vector<double> &x, const std::vector<double> &y,
-                         const std::string &grid_name, const std::string &projection);
+  //! The part of a grid owned by this process.
+  struct LocalGrid {
+    //! coordinates of cell centers in the local sub-domain
+    const std::vector<double> &x;
+    const std::vector<double> &y;
+    //! offsets of the local sub-domain
+    int xs;
+    int ys;
+    //! number of cells in the X direction in the whole grid
+    int Mx;
+  };
+
+  static int define_field(int component_id, const LocalGrid &grid,
+                          const std::string &proj_string, const std::string &grid_name,
+                          const std::string &field_name);
+  static int define_grid(const LocalGrid &grid, const std::string &grid_name,
+                         const std::string &projection);
 
   int m_instance_id;
   int m_source_field_id;
@@ -0,0 +1,302 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstdio>               // fopen, fread, fwrite, std::rename, std::remove
+#include <cstdlib>              // mkstemp
+#include <cstring>              // memcmp, memcpy, memset
+
+#include <fcntl.h>              // open
+#include <sys/mman.h>           // mmap, munmap
+#include <sys/stat.h>           // fstat, fchmod
+#include <unistd.h>             // close
+
+#include "pism/util/InterpolationWeightsCache.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+
+// Increment this if the way interpolation weights are computed changes.
+static const double format_version = 1.0;
+
+// Change this if the format of index files changes.
+static const char magic[8] = "PISMIW2";
+
+namespace {
+
+//! Append the bytes of `data` to `buffer`.
+void append(std::vector<char> &buffer, const void *data, size_t size) {
+  const char *bytes = (const char*)data;
+  buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void append(std::vector<char> &buffer, const std::vector<double> &values) {
+  double size = values.size();
+  append(buffer, &size, sizeof(double));
+  append(buffer, values.data(), values.size() * sizeof(double));
+}
+
+void append(std::vector<char> &buffer, const std::string &text) {
+  double size = text.size();
+  append(buffer, &size, sizeof(double));
+  append(buffer, text.data(), text.size());
+}
+
+//! Checksum of `size` bytes starting at `data`.
+uint64_t checksum_bytes(const char *data, size_t size) {
+  size_t n_words = size / sizeof(uint32_t);
+
+  // `data` is page-aligned (from mmap()) or comes from a std::vector<char>, so it is
+  // safe to treat it as an array of 32-bit words
+  uint64_t result = fletcher64((const uint32_t*)data, n_words);
+
+  // include trailing bytes, if any
+  uint32_t tail = 0;
+  memcpy(&tail, data + n_words * sizeof(uint32_t), size - n_words * sizeof(uint32_t));
+
+  return 31 * result + tail;
+}
+
+} // namespace
+
+InterpolationWeightsCache::InterpolationWeightsCache(const std::string &directory,
+                                                     const std::vector<double> &source_x,
+                                                     const std::vector<double> &source_y,
+                                                     const std::string &source_projection,
+                                                     const std::vector<double> &target_x,
+                                                     const std::vector<double> &target_y,
+                                                     const std::string &target_projection,
+                                                     const std::string &method) {
+  // everything interpolation weights depend on
+  {
+    std::vector<double> parameters = { format_version };
+    append(m_description, parameters);
+    append(m_description, method);
+    append(m_description, source_x);
+    append(m_description, source_y);
+    append(m_description, source_projection);
+    append(m_description, target_x);
+    append(m_description, target_y);
+    append(m_description, target_projection);
+  }
+  m_key = checksum_bytes(m_description.data(), m_description.size());
+
+  m_filename = pism::printf("%s/pism_yac_weights_%016llx.nc",
+                            directory.c_str(), (unsigned long long)m_key);
+  m_index_filename = m_filename + ".index";
+}
+
+uint64_t InterpolationWeightsCache::key() const {
+  return m_key;
+}
+
+//! Name of the cached weight file.
+const std::string &InterpolationWeightsCache::filename() const {
+  return m_filename;
+}
+
+//! Name of the file YAC should write new weights to (set by open() on a cache miss). See
+//! save().
+const std::string &InterpolationWeightsCache::tmp_filename() const {
+  return m_tmp_filename;
+}
+
+/*!
+ * Compute the size and the checksum of the file `filename` by memory-mapping it.
+ *
+ * Returns `false` if the file cannot be read.
+ */
+bool InterpolationWeightsCache::checksum(const std::string &filename, uint64_t &size,
+                                         uint64_t &result) {
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat file_info;
+  if (fstat(fd, &file_info) != 0 or file_info.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  size = file_info.st_size;
+
+  void *data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping remains valid after the file descriptor is closed
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  result = checksum_bytes((const char*)data, size);
+
+  munmap(data, size);
+
+  return true;
+}
+
+/*!
+ * Returns `true` if the index file matches the current grids and interpolation method and
+ * the weight file is complete.
+ */
+bool InterpolationWeightsCache::check_index() const {
+  Header index;
+  memset(&index, 0, sizeof(Header));
+
+  std::vector<char> description;
+
+  bool success = false;
+  FILE *f = fopen(m_index_filename.c_str(), "rb");
+  if (f != NULL) {
+    success = (fread(&index, sizeof(Header), 1, f) == 1);
+
+    success = (success and memcmp(index.magic, magic, sizeof(magic)) == 0 and
+               index.key == m_key and index.key_size == m_description.size());
+
+    if (success) {
+      description.resize(index.key_size);
+      success = (fread(description.data(), 1, description.size(), f) == description.size());
+    }
+    fclose(f);
+  }
+
+  // compare full descriptions: keys are checksums and may collide
+  success = success and description == m_description;
+
+  uint64_t size = 0, sum = 0;
+  success = success and checksum(m_filename, size, sum);
+
+  return success and size == index.size and sum == index.checksum;
+}
+
+/*!
+ * Check if the cache contains weights for the current grids and interpolation method.
+ *
+ * Returns `true` on success ("cache hit") and `false` if the weight file or its index do
+ * not exist, do not match the current grids and method or if the weight file is
+ * corrupted ("cache miss").
+ *
+ * On a cache miss creates a uniquely named temporary file for new weights (see
+ * tmp_filename()).
+ *
+ * Collective: files are checked on rank 0 and results are broadcast.
+ */
+bool InterpolationWeightsCache::open(MPI_Comm com) {
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  int success = 0;
+  if (rank == 0) {
+    success = check_index();
+
+    if (not success) {
+      // create a unique temporary file (in the cache directory, so that rename() in
+      // save() is atomic)
+      std::vector<char> name(m_filename.begin(), m_filename.end());
+      for (char c : std::string(".XXXXXX")) {
+        name.push_back(c);
+      }
+      name.push_back('\0');
+
+      int fd = mkstemp(name.data());
+      if (fd >= 0) {
+        // mkstemp() uses 0600; weights should be readable by others sharing the cache
+        fchmod(fd, 0644);
+        close(fd);
+        m_tmp_filename = name.data();
+      } else {
+        // YAC will fail to write the weight file and save() will report failure
+        m_tmp_filename = m_filename + ".tmp";
+      }
+    }
+  }
+
+  MPI_Bcast(&success, 1, MPI_INT, 0, com);
+
+  if (not success) {
+    int length = static_cast<int>(m_tmp_filename.size());
+    MPI_Bcast(&length, 1, MPI_INT, 0, com);
+
+    std::vector<char> buffer(m_tmp_filename.begin(), m_tmp_filename.end());
+    buffer.resize(length);
+    MPI_Bcast(buffer.data(), length, MPI_CHAR, 0, com);
+
+    m_tmp_filename.assign(buffer.begin(), buffer.end());
+  }
+
+  return success;
+}
+
+/*!
+ * Add weights written by YAC to tmp_filename() to the cache.
+ *
+ * Both the weight file and its index are written to unique temporary names and renamed,
+ * so concurrent runs writing the same weights do not corrupt each other's files.
+ *
+ * Collective: has to be called after YAC wrote the weight file (i.e. after
+ * `yac_cenddef_instance()`).
+ *
+ * Returns `true` on success. Failure to write the cache is not an error: the caller
+ * should report it and continue.
+ */
+bool InterpolationWeightsCache::save(MPI_Comm com) const {
+  int rank = 0;
+  MPI_Comm_rank(com, &rank);
+
+  // make sure that the weight file is complete
+  MPI_Barrier(com);
+
+  int success = 0;
+  if (rank == 0) {
+    std::string weights = m_tmp_filename, index = m_tmp_filename + ".index";
+
+    Header h;
+    memset(&h, 0, sizeof(Header));
+    memcpy(h.magic, magic, sizeof(magic));
+    h.key      = m_key;
+    h.key_size = m_description.size();
+
+    success = (not weights.empty()) and checksum(weights, h.size, h.checksum);
+
+    if (success) {
+      FILE *f = fopen(index.c_str(), "wb");
+      success = (f != NULL);
+      if (success) {
+        success = (fwrite(&h, sizeof(Header), 1, f) == 1);
+        success = success and (fwrite(m_description.data(), 1, m_description.size(), f) ==
+                               m_description.size());
+        success = (fclose(f) == 0) and success;
+      }
+    }
+
+    // move the weight file first: a weight file without a matching index is not used
+    success = success and std::rename(weights.c_str(), m_filename.c_str()) == 0;
+    success = success and std::rename(index.c_str(), m_index_filename.c_str()) == 0;
+
+    if (not success) {
+      std::remove(weights.c_str());
+      std::remove(index.c_str());
+    }
+  }
+
+  MPI_Bcast(&success, 1, MPI_INT, 0, com);
+
+  return success;
+}
+
+} // end of namespace pism
@@ -0,0 +1,93 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_INTERPOLATIONWEIGHTSCACHE_H
+#define PISM_INTERPOLATIONWEIGHTSCACHE_H
+
+#include <cstdint>              // uint64_t
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+namespace pism {
+
+/*!
+ * On-disk cache of interpolation weights computed by YAC.
+ *
+ * The name of a weight file contains a checksum ("key") of everything the weights depend
+ * on: coordinates and projections of the source and target grids and the interpolation
+ * method, so it is safe to use the same cache directory for different runs and different
+ * input files.
+ *
+ * Each weight file is accompanied by a small "index" file containing the full description
+ * of the grids and the method the key is computed from, the size of the weight file and a
+ * checksum of its contents. A cached file is used only if all three match (so a checksum
+ * collision cannot lead to using wrong weights); weight files are memory-mapped to
+ * compute the checksum.
+ *
+ * Weight files are written by YAC (see InputInterpolationYAC) to a uniquely named
+ * temporary file and moved into place by save(), so a partially written file is never
+ * used, even if several runs share the cache directory.
+ */
+class InterpolationWeightsCache {
+public:
+  InterpolationWeightsCache(const std::string &directory,
+                            const std::vector<double> &source_x,
+                            const std::vector<double> &source_y,
+                            const std::string &source_projection,
+                            const std::vector<double> &target_x,
+                            const std::vector<double> &target_y,
+                            const std::string &target_projection,
+                            const std::string &method);
+
+  uint64_t key() const;
+
+  const std::string &filename() const;
+  const std::string &tmp_filename() const;
+
+  bool open(MPI_Comm com);
+
+  bool save(MPI_Comm com) const;
+private:
+  struct Header {
+    char magic[8];
+    uint64_t key;
+    uint64_t key_size;
+    uint64_t size;
+    uint64_t checksum;
+  };
+
+  static bool checksum(const std::string &filename, uint64_t &size, uint64_t &result);
+
+  bool check_index() const;
+
+  //! description of the grids and the interpolation method
+  std::vector<char> m_description;
+  //! checksum of m_description
+  uint64_t m_key;
+  std::string m_filename;
+  std::string m_index_filename;
+  //! temporary file YAC writes new weights to (empty on cache hit)
+  std::string m_tmp_filename;
+};
+
+} // end of namespace pism
+
+#endif /* PISM_INTERPOLATIONWEIGHTSCACHE_H */
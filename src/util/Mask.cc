@@ -51,6 +51,9 @@ void GeometryCalculator::compute_mask(const array::Scalar &sea_level,
 
     result(i,j) = this->mask(sea_level(i, j), bed(i, j), thickness(i, j));
   }
+
+  // mark as modified (see array::CellType::active_columns())
+  result.inc_state_counter();
 }
 
 void GeometryCalculator::compute_surface(const array::Scalar &sea_level,
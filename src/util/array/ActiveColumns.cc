@@ -0,0 +1,178 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/array/ActiveColumns.hh"
+
+#include <algorithm>            // std::min, std::max
+
+#include <mpi.h>
+
+#include "pism/util/array/CellType.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace array {
+
+namespace {
+
+//! Append runs of points in [i_start, i_end) with `flag[i - i_offset] == value` to `result`.
+void append_runs(const std::vector<char> &flag, int i_offset, int i_start, int i_end, int j,
+                 bool value, std::vector<ColumnRun> &result) {
+  int i = i_start;
+  while (i < i_end) {
+    if ((flag[i - i_offset] != 0) != value) {
+      ++i;
+      continue;
+    }
+    int start = i;
+    while (i < i_end and (flag[i - i_offset] != 0) == value) {
+      ++i;
+    }
+    result.push_back({ j, start, i });
+  }
+}
+
+} // namespace
+
+ActiveColumns::ActiveColumns(const CellType &cell_type)
+  : m_n_active(0),
+    m_n_columns(0),
+    m_stencil_width(std::min(cell_type.stencil_width(), 1U)),
+    m_state_counter(cell_type.state_counter()),
+    m_grid(cell_type.grid()) {
+
+  const Grid &grid = *m_grid;
+
+  const int
+    xs = grid.xs(),
+    xm = grid.xm(),
+    ys = grid.ys(),
+    ym = grid.ym(),
+    // width of the ring of ghosts covered by the index
+    W = static_cast<int>(m_stencil_width),
+    // width of the ring of ghosts available in `cell_type`
+    G = static_cast<int>(cell_type.stencil_width());
+
+  array::AccessScope list{ &cell_type };
+
+  auto active = [&](int i, int j) {
+    if (i - 1 < xs - G or i + 1 >= xs + xm + G or j - 1 < ys - G or j + 1 >= ys + ym + G) {
+      // neighbors of (i, j) are not available
+      return true;
+    }
+    return (cell_type.icy(i, j) or cell_type.icy(i + 1, j) or cell_type.icy(i - 1, j) or
+            cell_type.icy(i, j + 1) or cell_type.icy(i, j - 1));
+  };
+
+  std::vector<char> flag(xm + 2 * W);
+  for (int j = ys - W; j < ys + ym + W; ++j) {
+    for (int i = xs - W; i < xs + xm + W; ++i) {
+      flag[i - (xs - W)] = active(i, j) ? 1 : 0;
+    }
+
+    append_runs(flag, xs - W, xs - W, xs + xm + W, j, true, m_active_ghosted);
+
+    if (j >= ys and j < ys + ym) {
+      append_runs(flag, xs - W, xs, xs + xm, j, true, m_active);
+      append_runs(flag, xs - W, xs, xs + xm, j, false, m_inactive);
+    }
+  }
+
+  for (const auto &r : m_active) {
+    m_n_active += r.i_end - r.i_start;
+  }
+  m_n_columns = xm * ym;
+}
+
+/*!
+ * Runs of active columns in the sub-domain owned by this rank, extended by
+ * `stencil_width` (0 or 1) ghost points in each direction.
+ */
+const std::vector<ColumnRun> &ActiveColumns::runs(unsigned int stencil_width) const {
+  if (stencil_width == 0) {
+    return m_active;
+  }
+
+  if (stencil_width > m_stencil_width) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "the index of active columns does not cover ghosts "
+                                  "(requested stencil width: %d)",
+                                  (int)stencil_width);
+  }
+
+  return m_active_ghosted;
+}
+
+//! Runs of inactive (ice-free and not next to ice) columns in the owned sub-domain.
+const std::vector<ColumnRun> &ActiveColumns::inactive_runs() const {
+  return m_inactive;
+}
+
+//! Number of active columns in the sub-domain owned by this rank.
+int ActiveColumns::n_active() const {
+  return m_n_active;
+}
+
+//! State counter of the cell type mask used to build this index.
+int ActiveColumns::state_counter() const {
+  return m_state_counter;
+}
+
+/*!
+ * Report numbers of active columns on all ranks and the resulting load imbalance (the
+ * ratio of the maximum number of active columns per rank to the mean).
+ *
+ * This is a collective operation.
+ */
+void ActiveColumns::report(const Logger &log) const {
+  const Grid &grid = *m_grid;
+
+  const int size = static_cast<int>(grid.size());
+
+  int local[2] = { m_n_active, m_n_columns };
+  std::vector<int> counts(2 * size);
+  MPI_Allgather(local, 2, MPI_INT, counts.data(), 2, MPI_INT, grid.com);
+
+  int min = counts[0], max = counts[0];
+  double total = 0.0, total_columns = 0.0;
+  for (int r = 0; r < size; ++r) {
+    min = std::min(min, counts[2 * r]);
+    max = std::max(max, counts[2 * r]);
+    total += counts[2 * r];
+    total_columns += counts[2 * r + 1];
+  }
+
+  const double mean = total / size;
+
+  log.message(3,
+              "Active columns: %.0f of %.0f (%.1f%%); per rank: min %d, max %d, mean %.1f;\n"
+              "  load imbalance (max / mean): %.2f\n",
+              total, total_columns, 100.0 * total / std::max(total_columns, 1.0), min, max,
+              mean, mean > 0.0 ? max / mean : 1.0);
+
+  for (int r = 0; r < size; ++r) {
+    log.message(4, "  rank %d: %d active of %d columns\n", r, counts[2 * r],
+                counts[2 * r + 1]);
+  }
+}
+
+} // end of namespace array
+} // end of namespace pism
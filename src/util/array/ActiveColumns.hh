@@ -0,0 +1,141 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ACTIVECOLUMNS_H
+#define PISM_ACTIVECOLUMNS_H
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace pism {
+
+class Grid;
+class Logger;
+
+namespace array {
+
+class CellType;
+
+//! Adjacent grid columns `(i_start, j), ..., (i_end - 1, j)`.
+struct ColumnRun {
+  int j;
+  int i_start;
+  int i_end;
+};
+
+/** Iterator class for traversing columns in a list of runs.
+ *
+ * Usage:
+ *
+ * `for (auto p = columns.points(); p; p.next()) { int i = p.i(), j = p.j(); ... }`
+ */
+class ColumnPoints {
+public:
+  ColumnPoints(const std::vector<ColumnRun> &runs)
+    : m_runs(runs), m_run(0), m_i(0) {
+    skip_empty_runs();
+  }
+
+  int i() const {
+    return m_i;
+  }
+  int j() const {
+    return m_runs[m_run].j;
+  }
+
+  void next() {
+    assert(m_run < m_runs.size());
+    m_i += 1;
+    if (m_i >= m_runs[m_run].i_end) {
+      m_run += 1;
+      skip_empty_runs();
+    }
+  }
+
+  operator bool() const {
+    return m_run < m_runs.size();
+  }
+private:
+  void skip_empty_runs() {
+    while (m_run < m_runs.size() and m_runs[m_run].i_start >= m_runs[m_run].i_end) {
+      m_run += 1;
+    }
+    if (m_run < m_runs.size()) {
+      m_i = m_runs[m_run].i_start;
+    }
+  }
+
+  const std::vector<ColumnRun> &m_runs;
+  size_t m_run;
+  int m_i;
+};
+
+//! Compact index of "active" columns: icy columns and ice-free columns next to ice.
+/*!
+ * Most column-wise computations (energy balance, age, SIA, strain heating) are trivial in
+ * ice-free columns. This class lists runs of adjacent active columns (icy cells and their
+ * ice-free 4-neighbors) so that these computations can skip the rest of the domain.
+ *
+ * The index covers the sub-domain owned by this rank and (if the cell type mask is
+ * ghosted) one ghost point in each direction. Ghost points without enough neighbors to
+ * decide are treated as active.
+ *
+ * Do not create instances of this class directly: use array::CellType::active_columns(),
+ * which re-builds the index only if the cell type mask changed.
+ */
+class ActiveColumns {
+public:
+  ActiveColumns(const CellType &cell_type);
+
+  const std::vector<ColumnRun> &runs(unsigned int stencil_width = 0) const;
+  const std::vector<ColumnRun> &inactive_runs() const;
+
+  ColumnPoints points(unsigned int stencil_width = 0) const {
+    return { runs(stencil_width) };
+  }
+
+  ColumnPoints inactive_points() const {
+    return { m_inactive };
+  }
+
+  int n_active() const;
+
+  int state_counter() const;
+
+  void report(const Logger &log) const;
+private:
+  //! active columns in the owned sub-domain
+  std::vector<ColumnRun> m_active;
+  //! active columns in the owned sub-domain and one ghost point in each direction
+  std::vector<ColumnRun> m_active_ghosted;
+  //! inactive columns in the owned sub-domain
+  std::vector<ColumnRun> m_inactive;
+
+  int m_n_active;
+  int m_n_columns;
+  unsigned int m_stencil_width;
+  int m_state_counter;
+  std::shared_ptr<const Grid> m_grid;
+};
+
+} // end of namespace array
+} // end of namespace pism
+
+#endif /* PISM_ACTIVECOLUMNS_H */
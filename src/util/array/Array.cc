@@ -16,6 +16,7 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>            // std::copy, std::max
 #include <cassert>
 
 #include <cmath>
@@ -27,6 +28,7 @@
 
 #include "pism/util/array/Array.hh"
 #include "pism/util/array/Array_impl.hh"
+#include "pism/util/array/Pool.hh"
 
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/Grid.hh"
@@ -60,6 +62,26 @@ void global_to_local(petsc::DM &dm, Vec source, Vec destination) {
   PISM_CHK(ierr, "DMGlobalToLocalEnd");
 }
 
+static StorageUse single_precision_storage_use = { 0.0, 0.0 };
+
+//! Memory used by arrays with single precision storage enabled on this process.
+const StorageUse &single_precision_storage() {
+  return single_precision_storage_use;
+}
+
+/*!
+ * Set the memory used by an array with single precision storage enabled to `bytes`,
+ * updating the total and its high-water mark.
+ */
+void update_storage_use(double &storage_bytes, double bytes) {
+  auto &use = single_precision_storage_use;
+
+  use.current += bytes - storage_bytes;
+  use.peak = std::max(use.peak, use.current);
+
+  storage_bytes = bytes;
+}
+
 Array::Array(std::shared_ptr<const Grid> grid, const std::string &name, Kind ghostedp, size_t dof,
              size_t stencil_width, const std::vector<double> &zlevels) {
   m_impl  = new Impl();
@@ -104,11 +126,23 @@ Array::Array(std::shared_ptr<const Grid> grid, const std::string &name, Kind gho
 Array::~Array() {
   assert(m_impl->access_counter == 0);
 
+  update_storage_use(m_impl->storage_bytes, 0.0);
+
   if (m_impl->bsearch_accel != nullptr) {
     gsl_interp_accel_free(m_impl->bsearch_accel);
     m_impl->bsearch_accel = nullptr;
   }
 
+  if (m_impl->pooled and m_impl->v.get() != nullptr) {
+    try {
+      m_impl->grid->array_pool().put(*dm(), m_impl->ghosted, m_impl->v.get());
+      // the pool owns this Vec now
+      *m_impl->v.rawptr() = nullptr;
+    } catch (...) {
+      // ignore errors: the Vec will be destroyed below
+    }
+  }
+
   delete m_impl;
   m_impl = nullptr;
 }
@@ -307,16 +341,42 @@ unsigned int Array::stencil_width() const {
   return 0;
 }
 
+/*!
+ * Get storage for this array from the pool of the grid (see array::Pool) and return it
+ * to the pool when this array is destroyed.
+ *
+ * Use this for short-lived arrays (diagnostics, temporary storage). Has to be called
+ * before the storage is allocated, i.e. right after the array is created.
+ */
+void Array::use_pool() {
+  if (m_impl->v.get() != nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "storage of '%s' is allocated already",
+                                  m_impl->name.c_str());
+  }
+  m_impl->pooled = true;
+}
+
 petsc::Vec &Array::vec() const {
   if (m_impl->v.get() == nullptr) {
     PetscErrorCode ierr = 0;
-    if (m_impl->ghosted) {
+    if (m_impl->pooled) {
+      *m_impl->v.rawptr() = m_impl->grid->array_pool().get(dm(), m_impl->ghosted);
+    } else if (m_impl->ghosted) {
       ierr = DMCreateLocalVector(*dm(), m_impl->v.rawptr());
       PISM_CHK(ierr, "DMCreateLocalVector");
     } else {
       ierr = DMCreateGlobalVector(*dm(), m_impl->v.rawptr());
       PISM_CHK(ierr, "DMCreateGlobalVector");
     }
+
+    if (not m_impl->packed.empty()) {
+      // restore values stored in single precision (see Array3D::compact())
+      petsc::VecArray data(m_impl->v);
+      std::copy(m_impl->packed.begin(), m_impl->packed.end(), data.get());
+      update_storage_use(m_impl->storage_bytes, m_impl->packed.size() * sizeof(double));
+      std::vector<float>().swap(m_impl->packed);
+    }
   }
   return m_impl->v;
 }
@@ -613,15 +673,33 @@ void  Array::end_access() const {
 
 //! Updates ghost points.
 void  Array::update_ghosts() {
-  PetscErrorCode ierr;
+  begin_update_ghosts();
+  end_update_ghosts();
+}
+
+/*!
+ * Start updating ghost points. Call end_update_ghosts() to finish.
+ *
+ * Computations that do not use ghosts of this array and do not modify it can be
+ * performed in between. To update ghosts of several arrays at once, use
+ * array::GhostUpdate.
+ */
+void Array::begin_update_ghosts() {
   if (not m_impl->ghosted) {
     return;
   }
 
-  ierr = DMLocalToLocalBegin(*dm(), vec(), INSERT_VALUES, vec());
+  PetscErrorCode ierr = DMLocalToLocalBegin(*dm(), vec(), INSERT_VALUES, vec());
   PISM_CHK(ierr, "DMLocalToLocalBegin");
+}
+
+//! Finish updating ghost points (see begin_update_ghosts()).
+void Array::end_update_ghosts() {
+  if (not m_impl->ghosted) {
+    return;
+  }
 
-  ierr = DMLocalToLocalEnd(*dm(), vec(), INSERT_VALUES, vec());
+  PetscErrorCode ierr = DMLocalToLocalEnd(*dm(), vec(), INSERT_VALUES, vec());
   PISM_CHK(ierr, "DMLocalToLocalEnd");
 }
 
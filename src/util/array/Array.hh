@@ -243,6 +243,8 @@ public:
   virtual void begin_access() const;
   virtual void end_access() const;
   void update_ghosts();
+  void begin_update_ghosts();
+  void end_update_ghosts();
 
   std::shared_ptr<petsc::Vec> allocate_proc0_copy() const;
   void put_on_proc0(petsc::Vec &onp0) const;
@@ -259,6 +261,8 @@ public:
 
   void set_interpolation_type(InterpolationType type);
 
+  void use_pool();
+
   void view(std::vector<std::shared_ptr<petsc::Viewer> > viewers) const;
 
 protected:
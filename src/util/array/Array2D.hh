@@ -70,8 +70,9 @@ public:
     details::add(*this, alpha, x, result);
   }
 
-  void copy_from(const Array2D<T> &source) {
-    return details::copy(source, *this);
+  //! Copy values from `source`. Ghosts are updated if `scatter` is true.
+  void copy_from(const Array2D<T> &source, bool scatter = true) {
+    return details::copy(source, *this, scatter);
   }
 
 protected:
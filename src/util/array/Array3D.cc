@@ -16,10 +16,13 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>            // std::max
 #include <cstring>
 #include <cstdlib>
 #include <cassert>
 #include <memory>
+#include <string>
+#include <vector>
 #include <petscvec.h>
 
 #include "pism/util/array/Array3D.hh"
@@ -34,6 +37,10 @@
 #include "pism/util/io/IO_Flags.hh"
 #include "pism/util/io/io_helpers.hh"
 #include "pism/util/InputInterpolation.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/array/Pool.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/pism_utilities.hh"
 
 namespace pism {
 namespace array {
@@ -238,6 +245,77 @@ void Array3D::copy_from(const Array3D &input) {
   inc_state_counter();
 }
 
+/*!
+ * Enable (or disable) storing values of this array in single precision between uses.
+ *
+ * See compact().
+ */
+void Array3D::use_single_precision(bool flag) {
+  m_impl->single_precision = flag;
+
+  // count memory used by this array in the total reported by report_storage()
+  double size = 0.0;
+  if (flag) {
+    double W = stencil_width();
+    size = (m_impl->grid->xm() + 2.0 * W) * (m_impl->grid->ym() + 2.0 * W) *
+           std::max((size_t)ndof(), levels().size());
+    size *= compacted() ? sizeof(float) : sizeof(double);
+  }
+  update_storage_use(m_impl->storage_bytes, size);
+}
+
+/*!
+ * If single precision storage is enabled (see use_single_precision()), store values
+ * in single precision and free double precision storage. Does nothing otherwise.
+ *
+ * This halves the memory used by this array until it is used again: the first call
+ * of vec() (begin_access(), I/O, etc) re-allocates double precision storage and
+ * restores values. Note that this does not reduce the peak memory use if all compacted
+ * arrays are in use at the same time (see report_storage()). Computations use double precision, but values are rounded to single
+ * precision (relative error of about 6e-8) every time this method is called.
+ *
+ * Call this when the owner of the array is done with it for the current time step.
+ */
+void Array3D::compact() {
+  if (not m_impl->single_precision or m_impl->v.get() == nullptr) {
+    return;
+  }
+
+  if (m_impl->access_counter != 0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot compact '%s': it is being accessed",
+                                  m_impl->name.c_str());
+  }
+
+  PetscInt size = 0;
+  PetscErrorCode ierr = VecGetLocalSize(m_impl->v, &size);
+  PISM_CHK(ierr, "VecGetLocalSize");
+
+  {
+    petsc::VecArray data(m_impl->v);
+    m_impl->packed.assign(data.get(), data.get() + size);
+  }
+  update_storage_use(m_impl->storage_bytes, size * sizeof(float));
+
+  if (m_impl->pooled) {
+    m_impl->grid->array_pool().put(*dm(), m_impl->ghosted, m_impl->v.get());
+    *m_impl->v.rawptr() = nullptr;
+  } else {
+    ierr = VecDestroy(m_impl->v.rawptr());
+    PISM_CHK(ierr, "VecDestroy");
+  }
+}
+
+//! Returns true if single precision storage is enabled.
+bool Array3D::single_precision() const {
+  return m_impl->single_precision;
+}
+
+//! Returns true if this array is stored in single precision at the moment.
+bool Array3D::compacted() const {
+  return not m_impl->packed.empty();
+}
+
 std::shared_ptr<Array3D> Array3D::duplicate(Kind ghostedp) const {
 
   auto result =
@@ -275,5 +353,62 @@ void Array3D::regrid_impl(const File &file, io::Default default_value) {
   }
 }
 
+/*!
+ * Returns true if a 3D field identified by `keyword` should be stored in single
+ * precision between uses (see `grid.single_precision_fields`).
+ */
+bool single_precision_requested(const Config &config, const std::string &keyword) {
+  return member(keyword, set_split(config.get_string("grid.single_precision_fields"), ','));
+}
+
+/*!
+ * Report memory used by `fields` that use single precision storage (see
+ * Array3D::use_single_precision()), compared to double precision storage.
+ *
+ * Reports the memory used at the moment and the high-water mark of the memory used by all
+ * arrays with single precision storage enabled. Fields are stored in double precision
+ * while in use, so the high-water mark may be close to the size of double precision
+ * storage.
+ *
+ * Reports maximums over all processes. This is a collective operation.
+ */
+void report_storage(const Logger &log, const std::vector<const Array3D *> &fields) {
+  std::vector<std::string> names;
+  double local[3] = { 0.0, 0.0, single_precision_storage().peak };
+  MPI_Comm com = MPI_COMM_NULL;
+
+  for (const auto *f : fields) {
+    if (f == nullptr or not f->single_precision()) {
+      continue;
+    }
+    names.push_back(f->get_name());
+
+    const auto &grid = *f->grid();
+    com = grid.com;
+    double W = f->stencil_width();
+    double size = (grid.xm() + 2.0 * W) * (grid.ym() + 2.0 * W) *
+                  std::max((size_t)f->ndof(), f->levels().size());
+
+    // current storage
+    local[0] += size * (f->compacted() ? sizeof(float) : sizeof(double));
+    // double precision storage
+    local[1] += size * sizeof(double);
+  }
+
+  if (names.empty()) {
+    return;
+  }
+
+  double result[3];
+  GlobalMax(com, local, result, 3);
+
+  const double MiB = 1024.0 * 1024.0;
+  log.message(3,
+              "3D fields stored in single precision: %s;\n"
+              "  memory (max. per process): %.1f MiB now, %.1f MiB peak"
+              " (%.1f MiB in double precision)\n",
+              join(names, ", ").c_str(), result[0] / MiB, result[2] / MiB, result[1] / MiB);
+}
+
 } // end of namespace array
 } // end of namespace pism
@@ -24,6 +24,9 @@
 
 namespace pism {
 
+class Config;
+class Logger;
+
 namespace array {
 
 class Scalar;
@@ -54,6 +57,11 @@ public:
   double interpolate(int i, int j, double z) const;
 
   void copy_from(const Array3D &input);
+
+  void use_single_precision(bool flag);
+  bool single_precision() const;
+  void compact();
+  bool compacted() const;
 };
 
 void extract_surface(const Array3D &data, double z, Scalar &output);
@@ -61,6 +69,10 @@ void extract_surface(const Array3D &data, const Scalar &z, Scalar &output);
 
 void sum_columns(const Array3D &data, double A, double B, Scalar &output);
 
+bool single_precision_requested(const Config &config, const std::string &keyword);
+
+void report_storage(const Logger &log, const std::vector<const Array3D *> &fields);
+
 } // end of namespace array
 } // end of namespace pism
 
@@ -57,6 +57,11 @@ struct Array::Impl {
     interpolation_type = LINEAR;
 
     bsearch_accel = nullptr;
+
+    pooled = false;
+
+    single_precision = false;
+    storage_bytes = 0.0;
   }
   //! If true, report range when regridding.
   bool report_range;
@@ -111,8 +116,34 @@ struct Array::Impl {
 
   // binary search accelerator (used for interpolation in a column in 3D fields)
   gsl_interp_accel *bsearch_accel;
+
+  //! If true, get storage from the grid's pool (see Array::use_pool())
+  bool pooled;
+
+  //! If true, compact() stores values in single precision (see Array3D::compact())
+  bool single_precision;
+
+  //! Values stored in single precision by Array3D::compact(). Empty unless the array is
+  //! compacted.
+  std::vector<float> packed;
+
+  //! Memory (in bytes) used by this array, included in single_precision_storage() (see
+  //! Array3D::use_single_precision())
+  double storage_bytes;
+};
+
+//! Memory (in bytes) used by arrays with single precision storage enabled on this process.
+struct StorageUse {
+  //! memory used at the moment
+  double current;
+  //! high-water mark
+  double peak;
 };
 
+const StorageUse &single_precision_storage();
+
+void update_storage_use(double &storage_bytes, double bytes);
+
 void global_to_local(petsc::DM &dm, Vec source, Vec destination);
 
 // set default value or stop with an error message (during regridding)
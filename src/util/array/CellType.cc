@@ -18,6 +18,7 @@
  */
 
 #include "pism/util/array/CellType.hh"
+#include "pism/util/array/ActiveColumns.hh"
 #include "pism/util/Interpolation1D.hh"
 
 namespace pism {
@@ -33,6 +34,21 @@ CellType::CellType(std::shared_ptr<const Grid> grid, const std::string &name, in
   set_interpolation_type(NEAREST);
 }
 
+/*!
+ * Index of active columns (icy and next to ice) corresponding to this mask.
+ *
+ * The index is re-built if the mask changed since the last call (see
+ * Array::inc_state_counter()), so code modifying the mask has to increment its state
+ * counter. Ghosts of the mask have to be up to date.
+ */
+const ActiveColumns &CellType::active_columns() const {
+  if (m_active_columns == nullptr or
+      m_active_columns->state_counter() != state_counter()) {
+    m_active_columns = std::make_shared<ActiveColumns>(*this);
+  }
+  return *m_active_columns;
+}
+
 CellType1::CellType1(std::shared_ptr<const Grid> grid, const std::string &name)
   : CellType(grid, name, 1) {
   // empty
@@ -20,12 +20,16 @@
 #ifndef PISM_ARRAY_CELLTYPE_H
 #define PISM_ARRAY_CELLTYPE_H
 
+#include <memory>
+
 #include "pism/util/array/Scalar.hh"
 #include "pism/util/Mask.hh"
 
 namespace pism {
 namespace array {
 
+class ActiveColumns;
+
 //! "Cell type" mask. Adds convenience methods to `array::Scalar`.
 class CellType : public Scalar {
 public:
@@ -62,8 +66,12 @@ public:
   inline bool ice_free_land(int i, int j) const {
     return mask::ice_free_land(as_int(i, j));
   }
+
+  const ActiveColumns &active_columns() const;
 protected:
   CellType(std::shared_ptr<const Grid> grid, const std::string &name, int w);
+private:
+  mutable std::shared_ptr<ActiveColumns> m_active_columns;
 };
 
 /*!
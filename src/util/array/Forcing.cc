@@ -20,6 +20,8 @@
 #include <cassert>
 #include <cmath>                // std::floor
 #include <array>
+#include <chrono>
+#include <future>
 
 #include "pism/util/array/Forcing.hh"
 #include "pism/util/io/File.hh"
@@ -37,17 +39,66 @@
 #include "pism/util/VariableMetadata.hh"
 #include "pism/util/io/IO_Flags.hh"
 #include "pism/util/InputInterpolation.hh"
+#include "pism/util/io/AsyncWriter.hh"
+#include "pism/util/io/LocalInterpCtx.hh"
+#include "pism/util/petscwrappers/Vec.hh"
 
 namespace pism {
 namespace array {
 
+namespace {
+
+//! Input file used by the I/O thread.
+/*!
+ * Uses a duplicate of the grid's communicator so that MPI calls made by the I/O thread do
+ * not interfere with MPI calls made by the main thread.
+ */
+struct PrefetchFile {
+  PrefetchFile(MPI_Comm com, const std::string &filename) {
+    MPI_Comm_dup(com, &comm);
+    try {
+      file.reset(new File(comm, filename, io::PISM_GUESS, io::PISM_READONLY));
+    } catch (...) {
+      MPI_Comm_free(&comm);
+      throw;
+    }
+  }
+
+  ~PrefetchFile() {
+    // the file has to be closed before its communicator is freed
+    file.reset();
+    MPI_Comm_free(&comm);
+  }
+
+  MPI_Comm comm;
+  std::unique_ptr<File> file;
+};
+
+//! Records read (or being read) by the I/O thread.
+struct PrefetchedRecords {
+  //! in-file index of the first record
+  unsigned int first;
+  //! number of records
+  unsigned int count;
+  //! size of one record (not interpolated yet)
+  size_t record_size;
+  //! data read from the file
+  std::vector<double> data;
+  //! ready when all records are read
+  std::shared_future<void> done;
+};
+
+} // namespace
+
 struct Forcing::Data {
   Data()
     : array(nullptr),
       first(-1),
       n_records(0),
       period(0.0),
-      period_start(0.0) {
+      period_start(0.0),
+      stall_time(0.0),
+      bytes_prefetched(0) {
     // empty
   }
   //! all the times available in filename
@@ -92,6 +143,30 @@ struct Forcing::Data {
 
   //! minimum time step length in max_timestep(), in seconds
   double dt_min;
+
+  //! input file (kept open between updates)
+  std::shared_ptr<File> file;
+
+  //! horizontal interpolation from the grid used in `file`
+  std::shared_ptr<InputInterpolation> regridder;
+
+  //! I/O thread reading records in advance (null if prefetching is disabled)
+  std::shared_ptr<io::AsyncWriter> io_thread;
+
+  //! input file used by `io_thread`
+  std::shared_ptr<PrefetchFile> prefetch_file;
+
+  //! the variable read by `io_thread`
+  io::SpatialVariableInfo info;
+
+  //! the next block of records (null if not requested)
+  std::shared_ptr<PrefetchedRecords> prefetched;
+
+  //! total time (in seconds) spent waiting for `io_thread`
+  double stall_time;
+
+  //! total size of data read by `io_thread`, in bytes
+  size_t bytes_prefetched;
 };
 
 /*!
@@ -203,6 +278,10 @@ void Forcing::allocate(unsigned int buffer_size, InterpolationType interpolation
 }
 
 Forcing::~Forcing() {
+  if (m_data->prefetched != nullptr) {
+    // make sure that the prefetch file is closed by this thread
+    io::AsyncWriter::wait_all();
+  }
   delete m_data;
 }
 
@@ -241,6 +320,7 @@ void Forcing::init(const std::string &filename, bool periodic) {
     auto time = ctx->time();
 
     m_data->filename = filename;
+    close_file();
 
     File file(m_impl->grid->com, m_data->filename, io::PISM_GUESS, io::PISM_READONLY);
     auto var = file.find_variable(m_impl->metadata[0].get_name(),
@@ -524,17 +604,15 @@ void Forcing::update(unsigned int start) {
                  t->date(m_data->time[start + missing - 1]).c_str());
   }
 
-  File file(m_impl->grid->com, m_data->filename, io::PISM_GUESS, io::PISM_READONLY);
-
   auto variable = m_impl->metadata[0];
 
   try {
-    auto V = file.find_variable(variable.get_name(), variable["standard_name"]);
-
-    auto interp = grid()->get_interpolation({0.0}, file, V.name, m_impl->interpolation_type);
+    open_file();
 
     for (unsigned int j = 0; j < missing; ++j) {
-      interp->regrid(variable, file, (int)(start + j), *grid(), vec());
+      if (not read_prefetched(start + j)) {
+        m_data->regridder->regrid(variable, *m_data->file, (int)(start + j), *grid(), vec());
+      }
 
       log->message(5, " %s: reading entry #%02d, year %s...\n", m_impl->name.c_str(), start + j,
                    t->date(m_data->time[start + j]).c_str());
@@ -545,6 +623,159 @@ void Forcing::update(unsigned int start) {
     e.add_context("regridding '%s' from '%s'", this->get_name().c_str(), m_data->filename.c_str());
     throw;
   }
+
+  // records are used in sequence, so the next block starts right after the last record
+  // in the buffer
+  prefetch(start + missing);
+
+  if (m_data->io_thread != nullptr) {
+    const double MiB = 1024.0 * 1024.0;
+    log->message(3, "  %s: %.1f MiB read in advance, %.3f s spent waiting for the I/O thread\n",
+                 m_impl->name.c_str(), m_data->bytes_prefetched / MiB, m_data->stall_time);
+  }
+}
+
+/*!
+ * Open the input file and initialize horizontal interpolation (unless this was done
+ * already).
+ *
+ * If `input.forcing.prefetch` is set, also open the file used by the I/O thread to read
+ * records in advance.
+ */
+void Forcing::open_file() {
+  if (m_data->file != nullptr) {
+    return;
+  }
+
+  auto ctx      = m_impl->grid->ctx();
+  auto variable = m_impl->metadata[0];
+
+  m_data->file = std::make_shared<File>(m_impl->grid->com, m_data->filename, io::PISM_GUESS,
+                                        io::PISM_READONLY);
+
+  auto V = m_data->file->find_variable(variable.get_name(), variable["standard_name"]);
+
+  m_data->regridder =
+      grid()->get_interpolation({ 0.0 }, *m_data->file, V.name, m_impl->interpolation_type);
+
+  if (not ctx->config()->get_flag("input.forcing.prefetch")) {
+    return;
+  }
+
+  // The I/O thread reads data that are interpolated later by the main thread. This
+  // requires the "legacy" interpolation code.
+  if (std::dynamic_pointer_cast<InputInterpolation3D>(m_data->regridder) == nullptr) {
+    return;
+  }
+
+  m_data->io_thread = ctx->io_thread();
+  if (m_data->io_thread == nullptr) {
+    ctx->log()->message(2,
+                        "PISM WARNING: reading forcing in advance requires MPI_THREAD_MULTIPLE"
+                        " support.\n"
+                        "              Reading '%s' synchronously...\n",
+                        m_impl->name.c_str());
+    return;
+  }
+
+  m_data->prefetch_file = std::make_shared<PrefetchFile>(m_impl->grid->com, m_data->filename);
+  m_data->info          = io::spatial_variable_info(variable, *m_data->file);
+}
+
+//! Close input files and discard records read in advance.
+void Forcing::close_file() {
+  if (m_data->prefetched != nullptr) {
+    io::AsyncWriter::wait_all();
+  }
+
+  m_data->prefetched.reset();
+  m_data->prefetch_file.reset();
+  m_data->io_thread.reset();
+  m_data->regridder.reset();
+  m_data->file.reset();
+}
+
+/*!
+ * Ask the I/O thread to read the block of at most `buffer_size()` records starting at
+ * `first`.
+ */
+void Forcing::prefetch(unsigned int first) {
+  if (m_data->prefetch_file == nullptr) {
+    return;
+  }
+
+  auto time_size = static_cast<unsigned int>(m_data->time.size());
+
+  if (first >= time_size) {
+    // all records were read
+    m_data->prefetched.reset();
+    return;
+  }
+
+  const auto &context =
+      std::dynamic_pointer_cast<InputInterpolation3D>(m_data->regridder)->context();
+
+  auto P         = std::make_shared<PrefetchedRecords>();
+  P->first       = first;
+  P->count       = std::min(buffer_size(), time_size - first);
+  P->record_size = context.buffer_size();
+  P->data.resize(P->count * P->record_size);
+
+  auto done = std::make_shared<std::promise<void> >();
+  P->done   = done->get_future().share();
+
+  auto file = m_data->prefetch_file;
+  auto info = m_data->info;
+  // note: a copy of `context` is used by the I/O thread
+  auto task = [file, info, context, P, done]() {
+    try {
+      for (unsigned int k = 0; k < P->count; ++k) {
+        io::read_spatial_record(*file->file, info, context, (int)(P->first + k),
+                                &P->data[k * P->record_size]);
+      }
+      done->set_value();
+    } catch (...) {
+      done->set_exception(std::current_exception());
+    }
+  };
+
+  // count the buffer against the memory budget of the I/O thread
+  size_t size = P->data.size() * sizeof(double);
+
+  m_data->io_thread->enqueue(task, size);
+  m_data->prefetched = P;
+  m_data->bytes_prefetched += size;
+}
+
+/*!
+ * Interpolate the record `record` read in advance and store it in `vec()`.
+ *
+ * Waits for the I/O thread if necessary. Returns false if this record was not requested.
+ */
+bool Forcing::read_prefetched(unsigned int record) {
+  auto P = m_data->prefetched;
+
+  if (P == nullptr or record < P->first or record >= P->first + P->count) {
+    return false;
+  }
+
+  if (P->done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    auto start = std::chrono::steady_clock::now();
+    P->done.wait();
+    std::chrono::duration<double> T = std::chrono::steady_clock::now() - start;
+    m_data->stall_time += T.count();
+  }
+  // re-throws the exception thrown by the I/O thread (if any)
+  P->done.get();
+
+  const auto &context =
+      std::dynamic_pointer_cast<InputInterpolation3D>(m_data->regridder)->context();
+
+  petsc::VecArray output(vec());
+  io::interpolate_spatial_record(m_impl->metadata[0], m_data->info, *grid(), context,
+                                 &P->data[(record - P->first) * P->record_size], output.get());
+
+  return true;
 }
 
 //! Discard the first N records, shifting the rest of them towards the "beginning".
@@ -87,6 +87,10 @@ private:
   void discard(int N);
   void set_record(int n);
   void init_periodic_data(const File &file);
+  void open_file();
+  void close_file();
+  void prefetch(unsigned int first);
+  bool read_prefetched(unsigned int record);
 };
 
 } // end of namespace array
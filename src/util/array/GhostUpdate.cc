@@ -0,0 +1,317 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/array/GhostUpdate.hh"
+
+#include <array>
+#include <cstring>              // std::memcpy
+#include <memory>
+#include <vector>
+
+#include <petscdmda.h>
+
+#include "pism/util/array/Array.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/DM.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+
+namespace pism {
+namespace array {
+
+namespace {
+
+//! Number of neighbors of a sub-domain, including itself (see DMDAGetNeighbors()).
+const int N_neighbors = 9;
+
+//! Index of "this" sub-domain in the list of neighbors.
+const int self = 4;
+
+//! Tags of messages sent by GhostUpdate (one per direction).
+const int ghost_update_tag = 7000;
+
+//! Range [first, last) of indexes of owned points (along one axis) sent to the neighbor
+//! in the direction `d` (-1, 0, 1).
+std::array<int, 2> send_range(int d, int start, int size, int width) {
+  if (d < 0) {
+    return { start, start + width };
+  }
+  if (d > 0) {
+    return { start + size - width, start + size };
+  }
+  return { start, start + size };
+}
+
+//! Range [first, last) of indexes of ghost points (along one axis) received from the
+//! neighbor in the direction `d` (-1, 0, 1).
+std::array<int, 2> receive_range(int d, int start, int size, int width) {
+  if (d < 0) {
+    return { start - width, start };
+  }
+  if (d > 0) {
+    return { start + size, start + size + width };
+  }
+  return { start, start + size };
+}
+
+} // namespace
+
+struct GhostUpdate::Impl {
+  struct Field {
+    Array *array;
+    //! number of values per grid point
+    int dof;
+    //! stencil width
+    int width;
+  };
+
+  //! Copies values in the rectangle [i0, i1) x [j0, j1) between the local (ghosted)
+  //! array `data` of `field` and `buffer`. Returns the pointer to the first unused
+  //! element of `buffer`.
+  double *copy(const Field &field, double *data, const std::array<int, 2> &x,
+               const std::array<int, 2> &y, double *buffer, bool pack) const;
+
+  std::shared_ptr<const Grid> grid;
+
+  std::vector<Field> fields;
+
+  //! ranks of neighbors, in the order used by DMDAGetNeighbors()
+  std::array<int, N_neighbors> neighbors;
+
+  std::array<std::vector<double>, N_neighbors> send_buffer, receive_buffer;
+
+  std::vector<MPI_Request> requests;
+};
+
+double *GhostUpdate::Impl::copy(const Field &field, double *data, const std::array<int, 2> &x,
+                                const std::array<int, 2> &y, double *buffer, bool pack) const {
+  const int
+    w  = field.width,
+    xs = grid->xs() - w,
+    ys = grid->ys() - w,
+    xm = grid->xm() + 2 * w;
+
+  size_t row_size = (x[1] - x[0]) * field.dof;
+
+  for (int j = y[0]; j < y[1]; ++j) {
+    double *row = data + ((j - ys) * xm + (x[0] - xs)) * field.dof;
+
+    if (pack) {
+      std::memcpy(buffer, row, row_size * sizeof(double));
+    } else {
+      std::memcpy(row, buffer, row_size * sizeof(double));
+    }
+    buffer += row_size;
+  }
+
+  return buffer;
+}
+
+GhostUpdate::GhostUpdate(std::initializer_list<Array *> arrays) : m_impl(new Impl) {
+  try {
+    for (auto *a : arrays) {
+      if (a->stencil_width() == 0) {
+        // this array has no ghosts
+        continue;
+      }
+
+      if (m_impl->grid == nullptr) {
+        m_impl->grid = a->grid();
+      } else if (a->grid() != m_impl->grid) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                      "'%s' uses a different grid; cannot update its ghosts",
+                                      a->get_name().c_str());
+      }
+
+      PetscInt dof = 0, width = 0;
+      PetscErrorCode ierr = DMDAGetInfo(*a->dm(), NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                                        &dof, &width, NULL, NULL, NULL, NULL);
+      PISM_CHK(ierr, "DMDAGetInfo");
+
+      m_impl->fields.push_back({ a, (int)dof, (int)width });
+    }
+
+    if (m_impl->fields.empty()) {
+      return;
+    }
+
+    const PetscMPIInt *neighbors = nullptr;
+    PetscErrorCode ierr = DMDAGetNeighbors(*m_impl->fields[0].array->dm(), &neighbors);
+    PISM_CHK(ierr, "DMDAGetNeighbors");
+
+    for (int n = 0; n < N_neighbors; ++n) {
+      m_impl->neighbors[n] = neighbors[n];
+    }
+
+    // compute buffer sizes
+    const auto &grid = *m_impl->grid;
+    for (int n = 0; n < N_neighbors; ++n) {
+      if (n == self) {
+        continue;
+      }
+      int dx = n % 3 - 1, dy = n / 3 - 1;
+
+      size_t send_size = 0, receive_size = 0;
+      for (const auto &f : m_impl->fields) {
+        auto sx = send_range(dx, grid.xs(), grid.xm(), f.width);
+        auto sy = send_range(dy, grid.ys(), grid.ym(), f.width);
+        send_size += (sx[1] - sx[0]) * (sy[1] - sy[0]) * f.dof;
+
+        auto rx = receive_range(dx, grid.xs(), grid.xm(), f.width);
+        auto ry = receive_range(dy, grid.ys(), grid.ym(), f.width);
+        receive_size += (rx[1] - rx[0]) * (ry[1] - ry[0]) * f.dof;
+      }
+      m_impl->send_buffer[n].resize(send_size);
+      m_impl->receive_buffer[n].resize(receive_size);
+    }
+  } catch (...) {
+    delete m_impl;
+    throw;
+  }
+}
+
+GhostUpdate::~GhostUpdate() {
+  if (not m_impl->requests.empty()) {
+    // end() was not called (e.g. because of an exception): wait for communication to
+    // complete before freeing buffers
+    MPI_Waitall((int)m_impl->requests.size(), m_impl->requests.data(), MPI_STATUSES_IGNORE);
+  }
+  delete m_impl;
+}
+
+/*!
+ * Send values at owned points to neighbors and start receiving ghosts.
+ */
+void GhostUpdate::begin() {
+  if (m_impl->fields.empty()) {
+    return;
+  }
+
+  if (not m_impl->requests.empty()) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "ghost update is in progress already");
+  }
+
+  const auto &grid = *m_impl->grid;
+  MPI_Comm com     = grid.com;
+
+  for (int n = 0; n < N_neighbors; ++n) {
+    auto &buffer = m_impl->receive_buffer[n];
+    if (n == self or buffer.empty()) {
+      continue;
+    }
+    // the neighbor in the direction n sends values in the opposite direction
+    MPI_Request request;
+    MPI_Irecv(buffer.data(), (int)buffer.size(), MPI_DOUBLE, m_impl->neighbors[n],
+              ghost_update_tag + (N_neighbors - 1 - n), com, &request);
+    m_impl->requests.push_back(request);
+  }
+
+  // fields are packed in order
+  std::array<double *, N_neighbors> position{};
+  for (int n = 0; n < N_neighbors; ++n) {
+    position[n] = m_impl->send_buffer[n].data();
+  }
+
+  for (const auto &f : m_impl->fields) {
+    petsc::VecArray data(f.array->vec());
+
+    for (int n = 0; n < N_neighbors; ++n) {
+      if (n == self) {
+        continue;
+      }
+      int dx = n % 3 - 1, dy = n / 3 - 1;
+
+      auto x = send_range(dx, grid.xs(), grid.xm(), f.width);
+      auto y = send_range(dy, grid.ys(), grid.ym(), f.width);
+
+      position[n] = m_impl->copy(f, data.get(), x, y, position[n], true);
+    }
+  }
+
+  for (int n = 0; n < N_neighbors; ++n) {
+    auto &buffer = m_impl->send_buffer[n];
+    if (n == self or buffer.empty()) {
+      continue;
+    }
+    MPI_Request request;
+    MPI_Isend(buffer.data(), (int)buffer.size(), MPI_DOUBLE, m_impl->neighbors[n],
+              ghost_update_tag + n, com, &request);
+    m_impl->requests.push_back(request);
+  }
+}
+
+/*!
+ * Wait for the data sent by neighbors and set ghosts.
+ */
+void GhostUpdate::end() {
+  if (m_impl->requests.empty()) {
+    return;
+  }
+
+  MPI_Waitall((int)m_impl->requests.size(), m_impl->requests.data(), MPI_STATUSES_IGNORE);
+  m_impl->requests.clear();
+
+  const auto &grid = *m_impl->grid;
+
+  std::array<double *, N_neighbors> position{};
+  for (int n = 0; n < N_neighbors; ++n) {
+    position[n] = m_impl->receive_buffer[n].data();
+  }
+
+  for (const auto &f : m_impl->fields) {
+    petsc::VecArray data(f.array->vec());
+
+    for (int n = 0; n < N_neighbors; ++n) {
+      if (n == self) {
+        continue;
+      }
+      int dx = n % 3 - 1, dy = n / 3 - 1;
+
+      auto x = receive_range(dx, grid.xs(), grid.xm(), f.width);
+      auto y = receive_range(dy, grid.ys(), grid.ym(), f.width);
+
+      position[n] = m_impl->copy(f, data.get(), x, y, position[n], false);
+    }
+  }
+}
+
+//! Number of messages sent by begin() (on this process).
+int GhostUpdate::n_messages() const {
+  int result = 0;
+  for (int n = 0; n < N_neighbors; ++n) {
+    if (n != self and not m_impl->send_buffer[n].empty()) {
+      result += 1;
+    }
+  }
+  return result;
+}
+
+/*!
+ * Update ghosts of `arrays`, sending one message to each neighbor.
+ *
+ * Equivalent to calling `update_ghosts()` for each array.
+ */
+void update_ghosts(std::initializer_list<Array *> arrays) {
+  GhostUpdate ghosts(arrays);
+  ghosts.begin();
+  ghosts.end();
+}
+
+} // end of namespace array
+} // end of namespace pism
@@ -0,0 +1,77 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_GHOSTUPDATE_H
+#define PISM_GHOSTUPDATE_H
+
+#include <initializer_list>
+
+namespace pism {
+namespace array {
+
+class Array;
+
+//! Updates ghosts of several arrays, sending one message to each neighbor.
+/*!
+ * `Array::update_ghosts()` sends one message per array to each of the (up to 8)
+ * neighboring sub-domains. This class packs values of all the arrays in a group into one
+ * buffer per neighbor instead. Arrays may have different numbers of degrees of freedom
+ * (including 3D arrays) and different stencil widths. Arrays without ghosts are ignored.
+ *
+ * The update is split into two phases: begin() sends values at points owned by this
+ * process and end() waits for neighbors and sets ghosts. Computations that do not use
+ * ghosts of these arrays can be performed in between.
+ *
+ * Between begin() and end() ghosts of these arrays must not be used. Values at owned
+ * points may be read and modified (they are copied by begin()).
+ *
+ * All processes have to create groups containing the same arrays in the same order.
+ *
+ * Example:
+ *
+ *     array::GhostUpdate ghosts{ &W, &K, &Q };
+ *     ghosts.begin();
+ *     // computations that do not use ghosts of W, K and Q
+ *     ghosts.end();
+ */
+class GhostUpdate {
+public:
+  GhostUpdate(std::initializer_list<Array *> arrays);
+  ~GhostUpdate();
+
+  void begin();
+  void end();
+
+  int n_messages() const;
+
+private:
+  struct Impl;
+  Impl *m_impl;
+
+  // disable copy constructor and the assignment operator:
+  GhostUpdate(const GhostUpdate &other);
+  GhostUpdate &operator=(const GhostUpdate &);
+};
+
+void update_ghosts(std::initializer_list<Array *> arrays);
+
+} // end of namespace array
+} // end of namespace pism
+
+#endif /* PISM_GHOSTUPDATE_H */
@@ -0,0 +1,158 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/array/Pool.hh"
+
+#include <algorithm>            // std::max
+
+#include <petscdmda.h>
+
+#include "pism/util/Logger.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/DM.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+namespace array {
+
+namespace {
+
+//! Size of the local part of `v`, in bytes.
+size_t vec_size(Vec v) {
+  PetscInt size = 0;
+  PetscErrorCode ierr = VecGetLocalSize(v, &size);
+  PISM_CHK(ierr, "VecGetLocalSize");
+  return static_cast<size_t>(size) * sizeof(PetscScalar);
+}
+
+} // namespace
+
+Pool::Pool(MPI_Comm com) : m_com(com), m_usage({ 0, 0, 0, 0, 0 }) {
+  // empty
+}
+
+Pool::~Pool() {
+  for (auto &e : m_entries) {
+    for (auto &v : e.second.idle) {
+      PetscErrorCode ierr = VecDestroy(&v);
+      CHKERRCONTINUE(ierr);
+    }
+  }
+}
+
+Pool::Key Pool::key(const petsc::DM &dm, bool ghosted) {
+  PetscInt dof = 0, stencil_width = 0;
+  PetscErrorCode ierr = DMDAGetInfo(dm, NULL, NULL, NULL, NULL, NULL, NULL, NULL, &dof,
+                                    &stencil_width, NULL, NULL, NULL, NULL);
+  PISM_CHK(ierr, "DMDAGetInfo");
+
+  return { (int)dof, (int)stencil_width, ghosted ? 1 : 0 };
+}
+
+/*!
+ * Get a vector compatible with `dm` (a local vector if `ghosted` is true, otherwise a
+ * global one). All its entries are set to zero.
+ *
+ * The caller is responsible for returning it to the pool (using put()).
+ */
+Vec Pool::get(std::shared_ptr<petsc::DM> dm, bool ghosted) {
+  auto &entry = m_entries[key(*dm, ghosted)];
+
+  Vec result = NULL;
+  PetscErrorCode ierr = 0;
+
+  if (not entry.idle.empty()) {
+    result = entry.idle.back();
+    entry.idle.pop_back();
+
+    size_t size = vec_size(result);
+    m_usage.idle -= size;
+    m_usage.in_use += size;
+    m_usage.n_reused += 1;
+
+    ierr = VecSet(result, 0.0);
+    PISM_CHK(ierr, "VecSet");
+
+    return result;
+  }
+
+  if (entry.dm == nullptr) {
+    entry.dm = dm;
+  }
+
+  if (ghosted) {
+    ierr = DMCreateLocalVector(*entry.dm, &result);
+    PISM_CHK(ierr, "DMCreateLocalVector");
+  } else {
+    ierr = DMCreateGlobalVector(*entry.dm, &result);
+    PISM_CHK(ierr, "DMCreateGlobalVector");
+  }
+
+  m_usage.in_use += vec_size(result);
+  m_usage.n_created += 1;
+  m_usage.peak = std::max(m_usage.peak, m_usage.in_use + m_usage.idle);
+
+  return result;
+}
+
+/*!
+ * Return a vector obtained using get() to the pool.
+ *
+ * `dm` and `ghosted` have to match arguments of the corresponding get() call.
+ */
+void Pool::put(const petsc::DM &dm, bool ghosted, Vec v) {
+  if (v == NULL) {
+    return;
+  }
+
+  size_t size = vec_size(v);
+  m_usage.in_use -= size;
+  m_usage.idle += size;
+
+  m_entries[key(dm, ghosted)].idle.push_back(v);
+}
+
+Pool::Usage Pool::usage() const {
+  return m_usage;
+}
+
+/*!
+ * Report the peak and the current ("steady-state") memory use. Reports maximums over all
+ * processes.
+ *
+ * This is a collective operation.
+ */
+void Pool::report(const Logger &log) const {
+  const double MiB = 1024.0 * 1024.0;
+
+  double local[3] = { (double)m_usage.peak, (double)(m_usage.in_use + m_usage.idle),
+                      (double)m_usage.idle };
+  double result[3];
+  GlobalMax(m_com, local, result, 3);
+
+  log.message(3,
+              "Temporary array storage (max. per process): peak %.1f MiB, current %.1f MiB "
+              "(%.1f MiB idle);\n"
+              "  %d vectors created, %d re-used\n",
+              result[0] / MiB, result[1] / MiB, result[2] / MiB, m_usage.n_created,
+              m_usage.n_reused);
+}
+
+} // end of namespace array
+} // end of namespace pism
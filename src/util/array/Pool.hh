@@ -0,0 +1,126 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ARRAY_POOL_H
+#define PISM_ARRAY_POOL_H
+
+#include <array>
+#include <map>
+#include <memory>
+#include <utility>              // std::forward
+#include <vector>
+
+#include <mpi.h>
+#include <petscvec.h>
+
+namespace pism {
+
+class Grid;
+class Logger;
+
+namespace petsc {
+class DM;
+} // end of namespace petsc
+
+namespace array {
+
+//! A pool of PETSc vectors used as storage by short-lived arrays.
+/*!
+ * Diagnostics and many computations allocate temporary arrays, use them once and free
+ * them. Each allocation creates a PETSc Vec (a collective operation) and each
+ * de-allocation destroys it.
+ *
+ * Arrays that opt in (see Array::use_pool() and array::pooled()) get their storage from
+ * this pool and return it to the pool when destroyed, so that the storage can be re-used
+ * by the next array with the same number of degrees of freedom (including the number of
+ * vertical levels), stencil width and ghosting. Re-used vectors are filled with zeros,
+ * just like newly-created ones.
+ *
+ * Each grid has its own pool (see Grid::array_pool()). Vectors are not freed until the
+ * grid is destroyed.
+ *
+ * Note: like creating PETSc vectors, getting a vector from the pool has to be done on
+ * all processes in a communicator in the same order.
+ */
+class Pool {
+public:
+  Pool(MPI_Comm com);
+  ~Pool();
+
+  Vec get(std::shared_ptr<petsc::DM> dm, bool ghosted);
+  void put(const petsc::DM &dm, bool ghosted, Vec v);
+
+  //! Memory used by vectors managed by the pool, in bytes (on this process).
+  struct Usage {
+    //! storage of arrays that are currently in use
+    size_t in_use;
+    //! storage that is available for re-use
+    size_t idle;
+    //! maximum of `in_use + idle`
+    size_t peak;
+    //! number of vectors created
+    int n_created;
+    //! number of times a vector was re-used
+    int n_reused;
+  };
+
+  Usage usage() const;
+
+  void report(const Logger &log) const;
+
+private:
+  // (DM dof, stencil width, ghosted)
+  typedef std::array<int, 3> Key;
+
+  static Key key(const petsc::DM &dm, bool ghosted);
+
+  struct Entry {
+    //! The DM used to create vectors in this entry. Kept here to avoid re-creating
+    //! DMs that are used by temporary arrays only.
+    std::shared_ptr<petsc::DM> dm;
+    //! Vectors available for re-use
+    std::vector<Vec> idle;
+  };
+
+  std::map<Key, Entry> m_entries;
+
+  MPI_Comm m_com;
+  Usage m_usage;
+
+  // disable copy constructor and the assignment operator:
+  Pool(const Pool &other);
+  Pool &operator=(const Pool &);
+};
+
+/*!
+ * Allocate an array of type `T` that uses storage from the pool of the grid `grid`.
+ *
+ * Arguments after `grid` are passed to the constructor of `T`.
+ */
+template <class T, typename... Args>
+std::shared_ptr<T> pooled(std::shared_ptr<const Grid> grid, Args &&...args) {
+  auto result = std::make_shared<T>(grid, std::forward<Args>(args)...);
+  result->use_pool();
+  return result;
+}
+
+} // end of namespace array
+} // end of namespace pism
+
+#endif /* PISM_ARRAY_POOL_H */
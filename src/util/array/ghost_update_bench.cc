@@ -0,0 +1,274 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "\nPISM_GHOST_UPDATE_BENCH\n"
+  "  Compares updating ghosts of several arrays one at a time to updating them as a\n"
+  "  group (array::GhostUpdate): checks that results agree and reports numbers of\n"
+  "  messages and the time used by each.\n\n";
+
+#include <petsc.h>
+
+#include <string>
+#include <vector>
+
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/array/Array3D.hh"
+#include "pism/util/array/GhostUpdate.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/array/Staggered.hh"
+#include "pism/util/array/Vector.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+
+//! Arrays with different numbers of degrees of freedom and stencil widths.
+struct Fields {
+  Fields(std::shared_ptr<const Grid> grid, const std::vector<double> &levels)
+    : a(grid, "a"),
+      b(grid, "b"),
+      c(grid, "c"),
+      velocity(grid, "velocity"),
+      flux(grid, "flux"),
+      T(grid, "T", array::WITH_GHOSTS, levels) {
+    // empty
+  }
+
+  std::vector<array::Array *> all() {
+    return { &a, &b, &c, &velocity, &flux, &T };
+  }
+
+  array::Scalar2 a, b;
+  array::Scalar1 c;
+  array::Vector1 velocity;
+  array::Staggered1 flux;
+  array::Array3D T;
+};
+
+//! A value that depends on the field number, the grid index (i, j) and the dof `k`.
+static double value(int field, int i, int j, int k) {
+  return 1e6 * field + 1e3 * j + i + 1e-3 * k;
+}
+
+/*!
+ * Set values at owned points. Ghosts are set to -1.
+ */
+static void fill(Fields &f) {
+  auto grid = f.a.grid();
+  const unsigned int Mz = f.T.levels().size();
+
+  for (auto *v : f.all()) {
+    v->set(-1.0);
+  }
+
+  array::AccessScope list{ &f.a, &f.b, &f.c, &f.velocity, &f.flux, &f.T };
+
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    f.a(i, j)        = value(0, i, j, 0);
+    f.b(i, j)        = value(1, i, j, 0);
+    f.c(i, j)        = value(2, i, j, 0);
+    f.velocity(i, j) = { value(3, i, j, 0), value(3, i, j, 1) };
+    f.flux(i, j, 0)  = value(4, i, j, 0);
+    f.flux(i, j, 1)  = value(4, i, j, 1);
+
+    double *column = f.T.get_column(i, j);
+    for (unsigned int k = 0; k < Mz; ++k) {
+      column[k] = value(5, i, j, k);
+    }
+  }
+}
+
+//! Return the number of values (including ghosts) where `a` and `b` differ.
+static int n_different(const array::Array &a, const array::Array &b) {
+  PetscInt size_a = 0, size_b = 0;
+  PetscErrorCode ierr = VecGetLocalSize(a.vec(), &size_a);
+  PISM_CHK(ierr, "VecGetLocalSize");
+  ierr = VecGetLocalSize(b.vec(), &size_b);
+  PISM_CHK(ierr, "VecGetLocalSize");
+
+  int result = 0;
+  if (size_a != size_b) {
+    result = 1;
+  } else {
+    petsc::VecArray A(a.vec()), B(b.vec());
+    for (PetscInt k = 0; k < size_a; ++k) {
+      if (A.get()[k] != B.get()[k]) {
+        result += 1;
+      }
+    }
+  }
+  return GlobalSum(a.grid()->com, result);
+}
+
+/*!
+ * A stand-in for computations performed between GhostUpdate::begin() and
+ * GhostUpdate::end(): a number of passes over owned points of `T`.
+ */
+static double work(const array::Array3D &T, int passes) {
+  auto grid = T.grid();
+  const unsigned int Mz = T.levels().size();
+
+  array::AccessScope list{ &T };
+
+  double result = 0.0;
+  for (int n = 0; n < passes; ++n) {
+    for (auto p = grid->points(); p; p.next()) {
+      const double *column = T.get_column(p.i(), p.j());
+      for (unsigned int k = 0; k < Mz; ++k) {
+        result += column[k] * 1e-9;
+      }
+    }
+  }
+  return result;
+}
+
+} // end of namespace pism
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  try {
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_ghost_update_bench");
+    auto log = ctx->log();
+
+    std::string usage =
+      "  pism_ghost_update_bench [-Mx N] [-My N] [-Mz N] [-repeat R] [-work W]\n"
+      "where\n"
+      "  -Mx, -My   grid size (default: 1000)\n"
+      "  -Mz        number of levels in the 3D field (default: 21)\n"
+      "  -repeat    number of repetitions used for timing (default: 100)\n"
+      "  -work      number of passes over the 3D field between begin() and end()\n"
+      "             of a split-phase update (default: 1)\n";
+
+    bool stop = show_usage_check_req_opts(*log, "pism_ghost_update_bench", {}, usage);
+    if (stop) {
+      return 0;
+    }
+
+    options::Integer
+      Mx("-Mx", "grid size in the X direction", 1000),
+      My("-My", "grid size in the Y direction", 1000),
+      Mz("-Mz", "number of levels in the 3D field", 21),
+      repeat("-repeat", "number of repetitions", 100),
+      passes("-work", "number of passes over the 3D field", 1);
+
+    if (Mx < 3 or My < 3 or Mz < 1 or repeat < 1 or passes < 0) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "-Mx and -My have to be at least 3; -Mz and -repeat have to be positive");
+    }
+
+    auto grid = Grid::Shallow(ctx, 1e3 * Mx, 1e3 * My, 0.0, 0.0, Mx, My,
+                              grid::CELL_CORNER, grid::NOT_PERIODIC);
+
+    std::vector<double> levels(Mz);
+    for (int k = 0; k < Mz; ++k) {
+      levels[k] = 10.0 * k;
+    }
+
+    Fields separate(grid, levels), grouped(grid, levels);
+
+    // per-field updates
+    fill(separate);
+    double T_separate = 0.0;
+    for (int r = 0; r < repeat; ++r) {
+      MPI_Barrier(com);
+      double T0 = MPI_Wtime();
+      for (auto *v : separate.all()) {
+        v->update_ghosts();
+      }
+      T_separate += MPI_Wtime() - T0;
+    }
+
+    // grouped updates
+    fill(grouped);
+    array::GhostUpdate ghosts{ &grouped.a,        &grouped.b,    &grouped.c,
+                               &grouped.velocity, &grouped.flux, &grouped.T };
+    double T_grouped = 0.0;
+    for (int r = 0; r < repeat; ++r) {
+      MPI_Barrier(com);
+      double T0 = MPI_Wtime();
+      ghosts.begin();
+      ghosts.end();
+      T_grouped += MPI_Wtime() - T0;
+    }
+
+    // split-phase grouped updates: time spent waiting in end() after doing some work
+    double T_work = 0.0, T_wait = 0.0, sum = 0.0;
+    for (int r = 0; r < repeat; ++r) {
+      MPI_Barrier(com);
+      double T0 = MPI_Wtime();
+      ghosts.begin();
+      sum += work(grouped.T, passes);
+      double T1 = MPI_Wtime();
+      ghosts.end();
+      double T2 = MPI_Wtime();
+
+      T_work += T1 - T0;
+      T_wait += T2 - T1;
+    }
+
+    int
+      n_fields          = static_cast<int>(separate.all().size()),
+      messages_grouped  = GlobalSum(com, ghosts.n_messages()),
+      messages_separate = n_fields * messages_grouped;
+
+    log->message(1, "Grid: %d x %d (Mz = %d), %d MPI processes, %d fields\n",
+                 (int)Mx, (int)My, (int)Mz, (int)grid->size(), n_fields);
+    log->message(1, "%12s  %12s  %16s\n", "method", "messages", "time (s)");
+    log->message(1, "%12s  %12d  %16.6f\n", "separate", messages_separate,
+                 T_separate / repeat);
+    log->message(1, "%12s  %12d  %16.6f\n", "grouped", messages_grouped,
+                 T_grouped / repeat);
+    log->message(1, "Split-phase: begin() and work: %.6f s, waiting in end(): %.6f s (%g)\n",
+                 T_work / repeat, T_wait / repeat, sum);
+
+    int n_failures = 0;
+    auto all_separate = separate.all(), all_grouped = grouped.all();
+    for (int k = 0; k < n_fields; ++k) {
+      int N = n_different(*all_separate[k], *all_grouped[k]);
+      if (N != 0) {
+        log->message(1, "FAILURE: ghosts of '%s' differ (%d)\n",
+                     all_separate[k]->get_name().c_str(), N);
+        n_failures += 1;
+      }
+    }
+
+    if (n_failures > 0) {
+      return 1;
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
@@ -43,6 +43,23 @@ inline int resolve_label(const std::vector<int> &labels, int provisional_label)
   return final_label;
 }
 
+/*!
+ * Record the equivalence of labels `a` and `b`.
+ *
+ * Links representative labels of `a` and `b` (not `a` and `b` themselves) to preserve
+ * equivalences recorded earlier.
+ */
+inline void merge_labels(std::vector<int> &labels, int a, int b) {
+  a = resolve_label(labels, a);
+  b = resolve_label(labels, b);
+
+  if (a < b) {
+    labels[b] = a;
+  } else if (b < a) {
+    labels[a] = b;
+  }
+}
+
 struct Run {
   int row, col, length, label;
 };
@@ -236,7 +253,7 @@ bool label(const mask &input, bool identify_isolated_patched, int min_label,
           if (identify_isolated_patched and input.is_attached(r, c)) {
             // looking at a pixel attached to a "grounded" area
             if (L != provisional_label) {
-              labels[L] = attached_label;
+              merge_labels(labels, L, attached_label);
             }
             L = attached_label;
           }
@@ -246,13 +263,10 @@ bool label(const mask &input, bool identify_isolated_patched, int min_label,
 
           if (T != background) {
             // foreground pixel in the row above
-            if (T < L) {
-              if (L != provisional_label) {
-                labels[L] = T;
-              }
+            if (L == provisional_label) {
               L = T;
-            } else if (T > L) {
-              labels[T] = L;
+            } else {
+              merge_labels(labels, L, T);
             }
           }
         } // end of the loop over pixels in a run
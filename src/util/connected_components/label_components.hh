@@ -78,6 +78,27 @@ void label(array::Scalar1 &mask);
  */
 void label_isolated(array::Scalar1 &mask, int reachable);
 
+/*!
+ * Label connected components in a `mask`, modifying it "in place".
+ *
+ * Produces the same result as `label()`, but merges labels of patches spanning several
+ * sub-domains using the distributed union-find algorithm instead of gathering the graph
+ * of connections between patches on all ranks.
+ *
+ * Note: ghosts of `mask` are not valid upon returning from this function.
+ */
+void label_union_find(array::Scalar1 &mask);
+
+/*!
+ * Label connected components *not* connected to areas marked with `reachable`.
+ *
+ * Produces the same result as `label_isolated()`, using the distributed union-find
+ * algorithm.
+ *
+ * Note: ghosts of `mask` are not valid upon returning from this function.
+ */
+void label_isolated_union_find(array::Scalar1 &mask, int reachable);
+
 } // end of namespace connected_components
 
 } // end of namespace pism
@@ -0,0 +1,233 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+static char help[] =
+  "\nPISM_LABEL_COMPONENTS_BENCH\n"
+  "  Compares implementations of connected component labeling (serial, parallel using\n"
+  "  a gathered graph, parallel using union-find) on a synthetic mask: checks that\n"
+  "  results agree and reports the time used by each.\n\n";
+
+#include <petsc.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "pism/util/Context.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/array/Scalar.hh"
+#include "pism/util/connected_components/label_components.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/pism_utilities.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+
+namespace pism {
+
+/*!
+ * Synthetic mask: a cell is in the foreground with the probability `fraction`
+ * (independently of its neighbors). Foreground cells at the domain boundary are marked
+ * as "reachable" (2).
+ *
+ * With `fraction` close to the site percolation threshold (0.59 for 4-connected cells)
+ * the mask contains many patches of all sizes, including ones spanning many
+ * sub-domains.
+ */
+static void set_mask(double fraction, array::Scalar &mask) {
+  auto grid = mask.grid();
+
+  const int Mx = grid->Mx(), My = grid->My();
+
+  array::AccessScope list{ &mask };
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    // a hash of (i, j) used as a pseudo-random number that does not depend on the domain
+    // decomposition
+    uint32_t h = (uint32_t)i * 73856093u ^ (uint32_t)j * 19349663u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+
+    double u = (h % 10000) / 10000.0;
+
+    if (u < fraction) {
+      bool edge = (i == 0 or j == 0 or i == Mx - 1 or j == My - 1);
+      mask(i, j) = edge ? 2.0 : 1.0;
+    } else {
+      mask(i, j) = 0.0;
+    }
+  }
+}
+
+/*!
+ * Label `mask` using `method` `repeat` times and return the time per call.
+ */
+static double time_labeling(int repeat, double fraction, array::Scalar1 &mask,
+                            const std::function<void(array::Scalar1 &)> &method) {
+  double T = 0.0;
+  for (int r = 0; r < repeat; ++r) {
+    set_mask(fraction, mask);
+
+    MPI_Barrier(mask.grid()->com);
+    double T0 = MPI_Wtime();
+    method(mask);
+    MPI_Barrier(mask.grid()->com);
+    T += MPI_Wtime() - T0;
+  }
+  return T / repeat;
+}
+
+//! Return the number of grid cells where `a` and `b` differ.
+static int n_different(const array::Scalar &a, const array::Scalar &b) {
+  auto grid = a.grid();
+
+  array::AccessScope list{ &a, &b };
+
+  int result = 0;
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+    if (a(i, j) != b(i, j)) {
+      result += 1;
+    }
+  }
+  return GlobalSum(grid->com, result);
+}
+
+} // end of namespace pism
+
+int main(int argc, char *argv[]) {
+  using namespace pism;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  try {
+    std::shared_ptr<Context> ctx = context_from_options(com, "pism_label_components_bench");
+    auto log = ctx->log();
+
+    std::string usage =
+      "  pism_label_components_bench [-Mx N] [-My N] [-fraction F] [-repeat R]\n"
+      "where\n"
+      "  -Mx, -My   grid size (default: 10000)\n"
+      "  -fraction  fraction of foreground cells (default: 0.55)\n"
+      "  -repeat    number of repetitions used for timing (default: 3)\n"
+      "Note: the serial implementation gathers the mask on rank 0.\n";
+
+    bool stop = show_usage_check_req_opts(*log, "pism_label_components_bench", {}, usage);
+    if (stop) {
+      return 0;
+    }
+
+    options::Integer
+      Mx("-Mx", "grid size in the X direction", 10000),
+      My("-My", "grid size in the Y direction", 10000),
+      repeat("-repeat", "number of repetitions", 3);
+    options::Real fraction(ctx->unit_system(), "-fraction", "fraction of foreground cells",
+                           "1", 0.55);
+
+    if (Mx < 3 or My < 3 or repeat < 1) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "-Mx and -My have to be at least 3; -repeat has to be positive");
+    }
+
+    auto grid = Grid::Shallow(ctx, 1e3 * Mx, 1e3 * My, 0.0, 0.0, Mx, My,
+                              grid::CELL_CORNER, grid::NOT_PERIODIC);
+
+    array::Scalar1 graph(grid, "graph"), union_find(grid, "union_find");
+
+    const int reachable = 2;
+
+    struct Method {
+      std::string name;
+      std::function<void(array::Scalar1 &)> label, label_isolated;
+      array::Scalar1 *result, *result_isolated;
+    };
+
+    array::Scalar1 graph_isolated(grid, "graph_isolated"),
+      union_find_isolated(grid, "union_find_isolated"), serial_result(grid, "serial"),
+      serial_isolated(grid, "serial_isolated");
+
+    std::vector<Method> methods = {
+      { "serial",
+        [&](array::Scalar1 &mask) {
+          connected_components::label_serial(mask, false, reachable);
+        },
+        [&](array::Scalar1 &mask) {
+          connected_components::label_serial(mask, true, reachable);
+        },
+        &serial_result, &serial_isolated },
+      { "graph", connected_components::label,
+        [&](array::Scalar1 &mask) { connected_components::label_isolated(mask, reachable); },
+        &graph, &graph_isolated },
+      { "union-find", connected_components::label_union_find,
+        [&](array::Scalar1 &mask) {
+          connected_components::label_isolated_union_find(mask, reachable);
+        },
+        &union_find, &union_find_isolated },
+    };
+
+    log->message(1, "Grid: %d x %d, %d MPI processes, foreground fraction: %.3f\n",
+                 (int)Mx, (int)My, (int)grid->size(), (double)fraction);
+    log->message(1, "%12s  %16s  %16s\n", "method", "label (s)", "isolated (s)");
+
+    for (auto &m : methods) {
+      double
+        T_label    = time_labeling(repeat, fraction, *m.result, m.label),
+        T_isolated = time_labeling(repeat, fraction, *m.result_isolated, m.label_isolated);
+
+      log->message(1, "%12s  %16.4f  %16.4f\n", m.name.c_str(), T_label, T_isolated);
+    }
+
+    // The graph-based and union-find implementations label components in the same
+    // order. The serial implementation uses a different order, so we compare the number
+    // of components instead.
+    int n_components = static_cast<int>(array::max(graph));
+    log->message(1, "Number of components: %d\n", n_components);
+
+    int n_failures = 0;
+    auto check = [&](const char *description, int failure) {
+      if (failure != 0) {
+        log->message(1, "FAILURE: %s (%d)\n", description, failure);
+        n_failures += 1;
+      }
+    };
+
+    check("union-find and graph-based labels differ", n_different(graph, union_find));
+    check("union-find and graph-based isolated patches differ",
+          n_different(graph_isolated, union_find_isolated));
+    check("numbers of components differ",
+          n_components - static_cast<int>(array::max(serial_result)));
+    check("union-find and serial isolated patches differ",
+          n_different(serial_isolated, union_find_isolated));
+
+    if (n_failures > 0) {
+      return 1;
+    }
+  } catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,588 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/connected_components/label_components.hh"
+#include "pism/util/connected_components/connected_components_impl.hh"
+#include "pism/util/Grid.hh"
+#include "pism/util/array/Scalar.hh"
+
+#include <algorithm>
+#include <mpi.h>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/*!
+ * This file contains the *distributed* connected component labeling algorithm using the
+ * disjoint-set ("union-find") data structure.
+ *
+ * Here's the idea:
+ *
+ * 1. Label patches in each sub-domain using the serial algorithm (a two-pass algorithm
+ *    using run-length encoding, see connected_components_impl.hh) and replace local
+ *    labels with globally unique *node IDs*. Node IDs of different sub-domains are
+ *    consecutive, so the order of node IDs is the order of sub-domains, then the order of
+ *    local labels.
+ *
+ * 2. Update ghosts and inspect sub-domain edges to find pairs of nodes that touch. These
+ *    pairs are *edges* of the graph connecting patches that span several sub-domains.
+ *
+ * 3. Merge edges using a binomial tree: each rank receives edges from its children in
+ *    the tree, merges them with its own using a disjoint-set forest and sends the
+ *    resulting *forest* (pairs "node, representative node") to its parent. The
+ *    representative node of a connected component is the one with the smallest ID.
+ *
+ * 4. The root of the tree now knows the representative node of every node that touches a
+ *    sub-domain edge. This information is sent back down the tree: each rank gets the
+ *    part its sub-tree needs.
+ *
+ * 5. If we need to label components with consecutive numbers, each rank counts
+ *    representative nodes it owns and uses MPI_Exscan() to assign final labels to them.
+ *    Final labels of representative nodes are then sent up and down the tree once more
+ *    to reach ranks that have other nodes of the same components.
+ *
+ * 6. Apply final labels.
+ *
+ * All data structures are flat (sorted) vectors.
+ *
+ * The number of nodes and edges sent to a rank is proportional to the number of patches
+ * touching sub-domain edges in its sub-tree instead of the whole domain (see
+ * label_components_parallel.cc, which gathers the whole graph on all ranks). Only the
+ * root of the tree processes all edges.
+ *
+ * Components are labeled in the order of their representative nodes, i.e. results are
+ * the same as the ones produced by the implementation in label_components_parallel.cc.
+ */
+
+namespace pism {
+namespace connected_components {
+namespace details {
+
+/*!
+ * Disjoint-set forest with elements `0, ..., n-1`.
+ *
+ * The root of each tree is its smallest element.
+ */
+class DisjointSets {
+public:
+  DisjointSets(int n) : m_parent(n) {
+    std::iota(m_parent.begin(), m_parent.end(), 0);
+  }
+
+  //! Find the root of the tree containing `a` (uses path halving).
+  int find(int a) {
+    while (m_parent[a] != a) {
+      m_parent[a] = m_parent[m_parent[a]];
+      a = m_parent[a];
+    }
+    return a;
+  }
+
+  //! Merge trees containing `a` and `b`.
+  void merge(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a < b) {
+      m_parent[b] = a;
+    } else if (b < a) {
+      m_parent[a] = b;
+    }
+  }
+
+private:
+  std::vector<int> m_parent;
+};
+
+/*!
+ * Edges of the graph describing connections between patches in different sub-domains.
+ */
+struct Graph {
+  //! pairs of node IDs
+  std::vector<int> edges;
+  //! nodes that contain "attached" cells
+  std::vector<int> attached;
+};
+
+/*!
+ * Values associated with node IDs.
+ */
+struct Table {
+  //! sorted node IDs
+  std::vector<int> id;
+  std::vector<int> value;
+
+  //! Return the value corresponding to `node`. `node` has to be in the table.
+  int operator()(int node) const {
+    return value[std::lower_bound(id.begin(), id.end(), node) - id.begin()];
+  }
+
+  //! Return true if `node` is in the table.
+  bool contains(int node) const {
+    return std::binary_search(id.begin(), id.end(), node);
+  }
+
+  //! Extract the part of the table corresponding to `nodes`.
+  Table subset(const std::vector<int> &nodes) const {
+    Table result;
+    result.id = nodes;
+    result.value.resize(nodes.size());
+    for (size_t k = 0; k < nodes.size(); ++k) {
+      result.value[k] = (*this)(nodes[k]);
+    }
+    return result;
+  }
+};
+
+//! Sorted list of unique nodes in a `graph`.
+static std::vector<int> nodes(const Graph &graph) {
+  std::vector<int> result = graph.edges;
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+//! Sorted list of unique values in a `table`.
+static std::vector<int> values(const Table &table) {
+  std::vector<int> result = table.value;
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+/*!
+ * Merge connected nodes of the `graph`.
+ *
+ * Sets `representative` to the map from nodes to representative nodes of their
+ * components and `attached` to the map from nodes to the flag indicating if their
+ * components contain "attached" cells.
+ *
+ * Returns the graph with the same connected components containing the smallest number
+ * of edges.
+ */
+static Graph merge(const Graph &graph, Table &representative, Table &attached) {
+  auto ids = nodes(graph);
+  const int N = static_cast<int>(ids.size());
+
+  auto index = [&ids](int node) {
+    return static_cast<int>(std::lower_bound(ids.begin(), ids.end(), node) - ids.begin());
+  };
+
+  DisjointSets sets(N);
+  for (size_t k = 0; k < graph.edges.size() / 2; ++k) {
+    sets.merge(index(graph.edges[2 * k + 0]), index(graph.edges[2 * k + 1]));
+  }
+
+  std::vector<int> root_is_attached(N, 0);
+  for (int node : graph.attached) {
+    int n = index(node);
+    if (n < N and ids[n] == node) {
+      root_is_attached[sets.find(n)] = 1;
+    }
+  }
+
+  representative.id = ids;
+  representative.value.resize(N);
+  attached.id = ids;
+  attached.value.resize(N);
+
+  Graph result;
+  for (int n = 0; n < N; ++n) {
+    int root = sets.find(n);
+
+    representative.value[n] = ids[root];
+    attached.value[n]       = root_is_attached[root];
+
+    if (root != n) {
+      result.edges.push_back(ids[n]);
+      result.edges.push_back(ids[root]);
+    } else if (root_is_attached[n] != 0) {
+      result.attached.push_back(ids[n]);
+    }
+  }
+
+  return result;
+}
+
+//! Parent and children of an MPI rank in the binomial tree rooted at rank 0.
+struct Tree {
+  int parent;
+  std::vector<int> children;
+};
+
+static Tree binomial_tree(MPI_Comm comm) {
+  int rank = 0, size = 0;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  Tree result{-1, {}};
+  for (int mask = 1; mask < size; mask <<= 1) {
+    if ((rank & mask) != 0) {
+      result.parent = rank - mask;
+      break;
+    }
+    if (rank + mask < size) {
+      result.children.push_back(rank + mask);
+    }
+  }
+  return result;
+}
+
+static const int tag = 0;
+
+static void send(MPI_Comm comm, int destination, const std::vector<int> &message) {
+  MPI_Send(message.data(), static_cast<int>(message.size()), MPI_INT, destination, tag, comm);
+}
+
+static std::vector<int> receive(MPI_Comm comm, int source) {
+  MPI_Status status;
+  MPI_Probe(source, tag, comm, &status);
+
+  int count = 0;
+  MPI_Get_count(&status, MPI_INT, &count);
+
+  std::vector<int> result(count);
+  MPI_Recv(result.data(), count, MPI_INT, source, tag, comm, MPI_STATUS_IGNORE);
+
+  return result;
+}
+
+static void send(MPI_Comm comm, int destination, const Graph &graph) {
+  std::vector<int> message{ static_cast<int>(graph.edges.size()) };
+  message.insert(message.end(), graph.edges.begin(), graph.edges.end());
+  message.insert(message.end(), graph.attached.begin(), graph.attached.end());
+  send(comm, destination, message);
+}
+
+static void receive(MPI_Comm comm, int source, Graph &graph) {
+  auto message = receive(comm, source);
+
+  auto edges = message.begin() + 1;
+  auto attached = edges + message[0];
+
+  graph.edges.assign(edges, attached);
+  graph.attached.assign(attached, message.end());
+}
+
+static void send(MPI_Comm comm, int destination, const Table &table) {
+  std::vector<int> message = table.id;
+  message.insert(message.end(), table.value.begin(), table.value.end());
+  send(comm, destination, message);
+}
+
+static void receive(MPI_Comm comm, int source, Table &table) {
+  auto message = receive(comm, source);
+
+  auto values = message.begin() + message.size() / 2;
+
+  table.id.assign(message.begin(), values);
+  table.value.assign(values, message.end());
+}
+
+//! Append edges and attached nodes of `input` to `output`.
+static void append(const Graph &input, Graph &output) {
+  output.edges.insert(output.edges.end(), input.edges.begin(), input.edges.end());
+  output.attached.insert(output.attached.end(), input.attached.begin(), input.attached.end());
+}
+
+/*!
+ * Label patches in the sub-domain owned by this rank, replacing local labels with
+ * globally unique node IDs.
+ *
+ * Sets `first_node` to the ID of the first node owned by this rank and `n_nodes` to the
+ * number of nodes owned by this rank.
+ *
+ * The node `first_node` corresponds to patches containing "attached" cells. Other nodes
+ * correspond to patches not connected to "attached" cells in this sub-domain.
+ */
+template <typename T>
+void label_subdomain(const T &input, bool mark_isolated_patches, array::Scalar1 &output,
+                     int &first_node, int &n_nodes) {
+  auto grid = output.grid();
+
+  // Use labels 1 (patches containing "attached" cells) and 2, 4, 6, ... (other
+  // patches). These are mapped to consecutive node IDs below.
+  {
+    PISMArray out(output);
+    bool assign_final_labels = false;
+    int min_label            = 1;
+    label(input, mark_isolated_patches, min_label, assign_final_labels, out);
+  }
+
+  array::AccessScope list{ &output };
+
+  n_nodes = 1;
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (output(i, j) > 0.0) {
+      n_nodes = std::max(n_nodes, output.as_int(i, j) / 2 + 1);
+    }
+  }
+
+  int offset = 0;
+  MPI_Exscan(&n_nodes, &offset, 1, MPI_INT, MPI_SUM, grid->com);
+  // the value of `offset` is undefined on rank 0
+  first_node = 1 + (grid->rank() == 0 ? 0 : offset);
+
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (output(i, j) > 0.0) {
+      output(i, j) = first_node + output.as_int(i, j) / 2;
+    }
+  }
+}
+
+/*!
+ * Find pairs of nodes that touch across sub-domain edges.
+ */
+static Graph detect_connections(array::Scalar1 &mask, int attached_node,
+                                bool mark_isolated_patches) {
+  auto grid = mask.grid();
+
+  mask.update_ghosts();
+
+  array::AccessScope list{ &mask };
+
+  std::vector<std::pair<int, int> > edges;
+  bool attached = false;
+
+  // note: this does not wrap around periodic boundaries
+  auto add_edge = [&](int i, int j, int i_neighbor, int j_neighbor) {
+    int a = mask.as_int(i, j), b = mask.as_int(i_neighbor, j_neighbor);
+    if (a > 0 and b > 0) {
+      edges.emplace_back(a, b);
+      attached = attached or (a == attached_node);
+    }
+  };
+
+  const int
+    xs = grid->xs(),
+    xe = xs + grid->xm() - 1,
+    ys = grid->ys(),
+    ye = ys + grid->ym() - 1;
+
+  if (xs > 0) {
+    for (int j = ys; j <= ye; ++j) {
+      add_edge(xs, j, xs - 1, j);
+    }
+  }
+  if (xe < (int)grid->Mx() - 1) {
+    for (int j = ys; j <= ye; ++j) {
+      add_edge(xe, j, xe + 1, j);
+    }
+  }
+  if (ys > 0) {
+    for (int i = xs; i <= xe; ++i) {
+      add_edge(i, ys, i, ys - 1);
+    }
+  }
+  if (ye < (int)grid->My() - 1) {
+    for (int i = xs; i <= xe; ++i) {
+      add_edge(i, ye, i, ye + 1);
+    }
+  }
+
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  Graph result;
+  result.edges.reserve(2 * edges.size());
+  for (const auto &e : edges) {
+    result.edges.push_back(e.first);
+    result.edges.push_back(e.second);
+  }
+
+  if (mark_isolated_patches and attached) {
+    result.attached.push_back(attached_node);
+  }
+
+  return result;
+}
+
+/*!
+ * Labels connected components in parallel using the union-find algorithm.
+ *
+ * The type `T` has to implement `is_foreground(row, col)` and `is_attached(row, col)`.
+ *
+ * See the comment at the beginning of this file for details.
+ */
+template <typename T>
+void label_union_find_impl(const T &input, bool mark_isolated_patches, array::Scalar1 &output) {
+  auto grid = output.grid();
+  MPI_Comm comm = grid->com;
+
+  // 1. Label patches in each sub-domain.
+  int first_node = 0, n_nodes = 0;
+  label_subdomain(input, mark_isolated_patches, output, first_node, n_nodes);
+
+  // 2. Find connections between patches in different sub-domains.
+  Graph local = detect_connections(output, first_node, mark_isolated_patches);
+  auto local_nodes = nodes(local);
+
+  Tree tree = binomial_tree(comm);
+
+  // 3. Merge edges going up the tree.
+  std::vector<std::vector<int> > child_nodes;
+  Table representative, attached;
+  {
+    Graph graph = local;
+    for (int child : tree.children) {
+      Graph g;
+      receive(comm, child, g);
+      child_nodes.push_back(nodes(g));
+      append(g, graph);
+    }
+
+    Graph forest = merge(graph, representative, attached);
+
+    if (tree.parent >= 0) {
+      send(comm, tree.parent, forest);
+    }
+  }
+
+  // 4. Send representative nodes (or the "attached" flag) down the tree.
+  //
+  // Nodes that are not in `shared` are not connected to nodes in other sub-domains.
+  Table &shared = mark_isolated_patches ? attached : representative;
+  {
+    if (tree.parent >= 0) {
+      receive(comm, tree.parent, shared);
+    }
+
+    for (size_t c = 0; c < tree.children.size(); ++c) {
+      send(comm, tree.children[c], shared.subset(child_nodes[c]));
+    }
+  }
+
+  // 5. Compute final labels of nodes owned by this rank.
+  std::vector<int> final_label(n_nodes, 0);
+  if (mark_isolated_patches) {
+    // patches containing "attached" cells are marked with 0, the rest with 1
+    for (int k = 0; k < n_nodes; ++k) {
+      int node = first_node + k;
+      final_label[k] = shared.contains(node) ? 1 - shared(node) : (k == 0 ? 0 : 1);
+    }
+  } else {
+    // Label components using consecutive integers starting from 1, in the order of their
+    // representative nodes.
+    //
+    // Note: the node `first_node` (k == 0) is not used because there are no "attached"
+    // cells.
+    std::vector<int> rep(n_nodes);
+    int n_roots = 0;
+    for (int k = 1; k < n_nodes; ++k) {
+      int node = first_node + k;
+      rep[k] = shared.contains(node) ? shared(node) : node;
+      n_roots += (rep[k] == node) ? 1 : 0;
+    }
+
+    int offset = 0;
+    MPI_Exscan(&n_roots, &offset, 1, MPI_INT, MPI_SUM, comm);
+    // the value of `offset` is undefined on rank 0
+    int label = 1 + (grid->rank() == 0 ? 0 : offset);
+
+    Table root_labels;
+    for (int k = 1; k < n_nodes; ++k) {
+      int node = first_node + k;
+      if (rep[k] == node) {
+        final_label[k] = label++;
+
+        if (shared.contains(node)) {
+          root_labels.id.push_back(node);
+          root_labels.value.push_back(final_label[k]);
+        }
+      }
+    }
+
+    // Send final labels of representative nodes up the tree...
+    for (int child : tree.children) {
+      Table t;
+      receive(comm, child, t);
+      root_labels.id.insert(root_labels.id.end(), t.id.begin(), t.id.end());
+      root_labels.value.insert(root_labels.value.end(), t.value.begin(), t.value.end());
+    }
+
+    if (tree.parent >= 0) {
+      send(comm, tree.parent, root_labels);
+    } else {
+      // sort by node ID
+      std::vector<int> order(root_labels.id.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(),
+                [&](int a, int b) { return root_labels.id[a] < root_labels.id[b]; });
+
+      Table sorted;
+      for (int k : order) {
+        sorted.id.push_back(root_labels.id[k]);
+        sorted.value.push_back(root_labels.value[k]);
+      }
+      root_labels = sorted;
+    }
+
+    // ... and back down to ranks that need them.
+    if (tree.parent >= 0) {
+      receive(comm, tree.parent, root_labels);
+    }
+
+    for (size_t c = 0; c < tree.children.size(); ++c) {
+      auto needed = values(shared.subset(child_nodes[c]));
+      send(comm, tree.children[c], root_labels.subset(needed));
+    }
+
+    for (int k = 1; k < n_nodes; ++k) {
+      if (rep[k] != first_node + k) {
+        final_label[k] = root_labels(rep[k]);
+      }
+    }
+  }
+
+  // 6. Apply final labels. Does not touch background grid cells.
+  array::AccessScope list{ &output };
+  for (auto p = grid->points(); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    if (output(i, j) > 0.0) {
+      output(i, j) = final_label[output.as_int(i, j) - first_node];
+    }
+  }
+}
+
+} // end of namespace details
+
+using Mask = details::Mask<details::PISMArray>;
+
+void label_union_find(array::Scalar1 &mask) {
+
+  details::PISMArray input(mask);
+
+  bool mark_isolated_patches = false;
+  details::label_union_find_impl(Mask(input, -1), mark_isolated_patches, mask);
+}
+
+void label_isolated_union_find(array::Scalar1 &mask, int reachable) {
+
+  details::PISMArray input(mask);
+
+  bool mark_isolated_patches = true;
+  details::label_union_find_impl(Mask(input, reachable), mark_isolated_patches, mask);
+}
+
+} // end of namespace connected_components
+} // end of namespace pism
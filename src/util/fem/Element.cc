@@ -411,6 +411,7 @@ Q1Element3::Q1Element3(const DMDALocalInfo &grid_info,
     m_w(quadrature.weights()) {
 
   m_weights.resize(m_Nq);
+  m_geometry.resize(m_Nq);
 
   m_i_offset = {0, 1, 1, 0, 0, 1, 1, 0};
   m_j_offset = {0, 0, 1, 1, 0, 0, 1, 1};
@@ -434,6 +435,7 @@ Q1Element3::Q1Element3(const Grid &grid, const Quadrature &quadrature)
     m_w(quadrature.weights()) {
 
   m_weights.resize(m_Nq);
+  m_geometry.resize(m_Nq);
 
   m_i_offset = {0, 1, 1, 0, 0, 1, 1, 0};
   m_j_offset = {0, 0, 1, 1, 0, 0, 1, 1};
@@ -458,6 +460,59 @@ Q1Element3::Q1Element3(const Grid &grid, const Quadrature &quadrature)
  * @param[in] z z-coordinates of the nodes of this element
  */
 void Q1Element3::reset(int i, int j, int k, const double *z) {
+  set_element(i, j, k, z);
+
+  // Compute entries of J^{-1} that depend on z and quadrature weights:
+  for (unsigned int q = 0; q < m_Nq; q++) {
+
+    Vector3 dz{0.0, 0.0, 0.0};
+    for (unsigned int n = 0; n < m_n_chi; ++n) {
+      auto &chi = m_chi[q * m_n_chi + n];
+      dz.x += chi.dx * z[n];
+      dz.y += chi.dy * z[n];
+      dz.z += chi.dz * z[n];
+    }
+
+    double J[3][3] = {{m_dx / 2.0,        0.0, dz.x},
+                      {       0.0, m_dy / 2.0, dz.y},
+                      {       0.0,        0.0, dz.z}};
+
+    double J_det = J[0][0] * J[1][1] * J[2][2];
+
+    assert(J_det != 0.0);
+
+    m_geometry[q] = {-J[0][2] / (J[0][0] * J[2][2]),
+                     -J[1][2] / (J[1][1] * J[2][2]),
+                     1.0 / J[2][2],
+                     J_det * m_w[q]};
+  }
+
+  compute_germs();
+}
+
+/*! Initialize the element `i,j,k` using geometric factors computed earlier.
+ *
+ * This is equivalent to reset(i, j, k, z) if `geometry` contains values returned by
+ * geometry() after a call to reset(i, j, k, z), but it is cheaper.
+ *
+ * @param[in] i i-index of the lower left node
+ * @param[in] j j-index of the lower left node
+ * @param[in] k k-index of the lower left node
+ * @param[in] z z-coordinates of the nodes of this element
+ * @param[in] geometry geometric factors at all quadrature points
+ */
+void Q1Element3::reset(int i, int j, int k, const double *z, const Geometry *geometry) {
+  set_element(i, j, k, z);
+
+  for (unsigned int q = 0; q < m_Nq; q++) {
+    m_geometry[q] = geometry[q];
+  }
+
+  compute_germs();
+}
+
+//! Set indices and nodal z coordinates of the current element.
+void Q1Element3::set_element(int i, int j, int k, const double *z) {
   // Record i,j,k corresponding to the current element:
   m_i = i;
   m_j = j;
@@ -485,40 +540,28 @@ void Q1Element3::reset(int i, int j, int k, const double *z) {
       mark_row_invalid(n);
     }
   }
+}
 
-  // Compute J^{-1} and use it to compute m_germs and m_weights:
-  for (unsigned int q = 0; q < m_Nq; q++) {
-
-    Vector3 dz{0.0, 0.0, 0.0};
-    for (unsigned int n = 0; n < m_n_chi; ++n) {
-      auto &chi = m_chi[q * m_n_chi + n];
-      dz.x += chi.dx * z[n];
-      dz.y += chi.dy * z[n];
-      dz.z += chi.dz * z[n];
-    }
-
-    double J[3][3] = {{m_dx / 2.0,        0.0, dz.x},
-                      {       0.0, m_dy / 2.0, dz.y},
-                      {       0.0,        0.0, dz.z}};
-
-    double J_det = J[0][0] * J[1][1] * J[2][2];
-
-    assert(J_det != 0.0);
+//! Use geometric factors in m_geometry to compute m_germs and m_weights.
+void Q1Element3::compute_germs() {
+  // entries of J^{-1} that do not depend on z
+  double
+    J_inv_xx = 1.0 / (m_dx / 2.0),
+    J_inv_yy = 1.0 / (m_dy / 2.0);
 
-    double J_inv[3][3] = {{1.0 / J[0][0],           0.0, -J[0][2] / (J[0][0] * J[2][2])},
-                          {0.0,           1.0 / J[1][1], -J[1][2] / (J[1][1] * J[2][2])},
-                          {0.0,                     0.0,                 1.0 / J[2][2]}};
+  for (unsigned int q = 0; q < m_Nq; q++) {
+    const auto &G = m_geometry[q];
 
-    m_weights[q] = J_det * m_w[q];
+    m_weights[q] = G.weight;
 
     for (unsigned int n = 0; n < m_n_chi; n++) {
       auto &chi = m_chi[q * m_n_chi + n];
       // FIXME: I should be able to use multiply() defined above, but there must be a bug
       // there...
       m_germs[q * m_n_chi + n] = {chi.val,
-                                  J_inv[0][0] * chi.dx + J_inv[0][1] * chi.dy + J_inv[0][2] * chi.dz,
-                                  J_inv[1][0] * chi.dx + J_inv[1][1] * chi.dy + J_inv[1][2] * chi.dz,
-                                  J_inv[2][0] * chi.dx + J_inv[2][1] * chi.dy + J_inv[2][2] * chi.dz};
+                                  J_inv_xx * chi.dx + G.J_inv_xz * chi.dz,
+                                  J_inv_yy * chi.dy + G.J_inv_yz * chi.dz,
+                                  G.J_inv_zz * chi.dz};
     }
   }
 }
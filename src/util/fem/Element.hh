@@ -365,8 +365,25 @@ public:
              double y_min);
   Q1Element3(const Grid &grid, const Quadrature &quadrature);
 
+  //! Geometric factors of a physical element at a quadrature point: entries of the
+  //! inverse of the Jacobian of the map from the reference element that depend on z
+  //! coordinates of nodes and the quadrature weight.
+  struct Geometry {
+    double J_inv_xz;
+    double J_inv_yz;
+    double J_inv_zz;
+    double weight;
+  };
+
   void reset(int i, int j, int k, const double *z);
 
+  void reset(int i, int j, int k, const double *z, const Geometry *geometry);
+
+  //! Geometric factors of the current element (one per quadrature point).
+  const std::vector<Geometry> &geometry() const {
+    return m_geometry;
+  }
+
   // return the x coordinate of node n
   double x(int n) const {
     return m_x_min + m_dx * (m_i + m_i_offset[n]);
@@ -400,6 +417,12 @@ private:
 
   // quadrature weights (on the reference element)
   std::vector<double> m_w;
+
+  // geometric factors of the current element at all quadrature points
+  std::vector<Geometry> m_geometry;
+
+  void set_element(int i, int j, int k, const double *z);
+  void compute_germs();
 };
 
 
@@ -0,0 +1,269 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/io/AsyncWriter.hh"
+
+#include <chrono>
+#include <cstdio>             // fprintf
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <mpi.h>
+
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace io {
+
+namespace {
+//! true in I/O threads
+thread_local bool io_thread = false;
+
+//! all AsyncWriter instances in this process
+std::set<AsyncWriter *> writers;
+//! protects `writers`
+std::mutex writers_mutex;
+} // namespace
+
+struct AsyncWriter::Impl {
+  struct Task {
+    std::function<void()> run;
+    size_t size;
+  };
+
+  void worker();
+  void check_error();
+
+  // protects all data members below
+  std::mutex mutex;
+  // signals that there are new tasks or that the worker has to stop
+  std::condition_variable task_added;
+  // signals that a task was completed
+  std::condition_variable task_done;
+
+  std::deque<Task> queue;
+  // total size of data held by tasks that are not completed yet
+  size_t buffered;
+  // true if the worker is running a task
+  bool busy;
+  bool stop;
+  // error message produced by a failed task
+  std::string error;
+  // true if `error` was reported by check_error()
+  bool error_reported;
+
+  size_t memory_budget;
+  double stall_time;
+
+  std::thread thread;
+};
+
+void AsyncWriter::Impl::worker() {
+  io_thread = true;
+
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    task_added.wait(lock, [this]() { return stop or not queue.empty(); });
+
+    if (queue.empty()) {
+      // stop was requested and there is nothing left to do
+      break;
+    }
+
+    Task task = std::move(queue.front());
+    queue.pop_front();
+    busy = true;
+
+    if (error.empty()) {
+      lock.unlock();
+      std::string message;
+      try {
+        task.run();
+      } catch (std::exception &e) {
+        message = e.what();
+        if (message.empty()) {
+          message = "unknown error";
+        }
+      }
+      // release data held by the task before reporting that it is done
+      task.run = nullptr;
+      lock.lock();
+
+      if (not message.empty() and error.empty()) {
+        error = message;
+      }
+    }
+
+    buffered -= task.size;
+    busy = false;
+    task_done.notify_all();
+  }
+}
+
+//! Throw an exception if a task failed. Call with the mutex locked.
+void AsyncWriter::Impl::check_error() {
+  if (not error.empty()) {
+    error_reported = true;
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "asynchronous output failed: %s",
+                                  error.c_str());
+  }
+}
+
+/*!
+ * @param[in] memory_budget maximum total size (in bytes) of data held by tasks that are
+ *                          not completed yet
+ */
+AsyncWriter::AsyncWriter(size_t memory_budget) : m_impl(new Impl) {
+  m_impl->buffered       = 0;
+  m_impl->busy           = false;
+  m_impl->error_reported = false;
+  m_impl->stop           = false;
+  m_impl->memory_budget  = memory_budget;
+  m_impl->stall_time     = 0.0;
+
+  m_impl->thread = std::thread([this]() { m_impl->worker(); });
+
+  std::lock_guard<std::mutex> lock(writers_mutex);
+  writers.insert(this);
+}
+
+AsyncWriter::~AsyncWriter() {
+  {
+    std::lock_guard<std::mutex> lock(writers_mutex);
+    writers.erase(this);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    m_impl->stop = true;
+  }
+  m_impl->task_added.notify_all();
+
+  // the worker completes all the remaining tasks before stopping
+  m_impl->thread.join();
+
+  // Destructors cannot throw: make sure that errors in tasks completed after the last
+  // call of wait() (e.g. closing files) are not lost.
+  if (not m_impl->error.empty() and not m_impl->error_reported) {
+    fprintf(stderr, "PISM ERROR: asynchronous output failed: %s\n", m_impl->error.c_str());
+  }
+}
+
+/*!
+ * Add a `task` to the queue.
+ *
+ * @param[in] task an I/O operation
+ * @param[in] size size (in bytes) of the data held by `task`
+ */
+void AsyncWriter::enqueue(std::function<void()> task, size_t size) {
+  std::unique_lock<std::mutex> lock(m_impl->mutex);
+
+  m_impl->check_error();
+
+  auto fits = [this, size]() {
+    return m_impl->buffered + size <= m_impl->memory_budget or
+           (m_impl->queue.empty() and not m_impl->busy) or not m_impl->error.empty();
+  };
+
+  if (not fits()) {
+    auto start = std::chrono::steady_clock::now();
+    m_impl->task_done.wait(lock, fits);
+    std::chrono::duration<double> T = std::chrono::steady_clock::now() - start;
+    m_impl->stall_time += T.count();
+
+    m_impl->check_error();
+  }
+
+  m_impl->queue.push_back({ std::move(task), size });
+  m_impl->buffered += size;
+
+  lock.unlock();
+  m_impl->task_added.notify_one();
+}
+
+//! Wait until all tasks are completed.
+void AsyncWriter::wait() {
+  std::unique_lock<std::mutex> lock(m_impl->mutex);
+
+  auto done = [this]() { return m_impl->queue.empty() and not m_impl->busy; };
+
+  if (not done()) {
+    auto start = std::chrono::steady_clock::now();
+    m_impl->task_done.wait(lock, done);
+    std::chrono::duration<double> T = std::chrono::steady_clock::now() - start;
+    m_impl->stall_time += T.count();
+  }
+
+  m_impl->check_error();
+}
+
+//! Total time (in seconds) the calling thread spent waiting for the I/O thread.
+double AsyncWriter::stall_time() const {
+  std::lock_guard<std::mutex> lock(m_impl->mutex);
+  return m_impl->stall_time;
+}
+
+size_t AsyncWriter::memory_budget() const {
+  return m_impl->memory_budget;
+}
+
+/*!
+ * Wait until all I/O threads in this process are idle.
+ *
+ * Does nothing if called by an I/O thread. Errors are reported by `enqueue()` and `wait()`
+ * of the writer that failed. Time spent waiting is added to `stall_time()` of the writer
+ * that was busy.
+ */
+void AsyncWriter::wait_all() {
+  if (io_thread) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> registry_lock(writers_mutex);
+  for (auto *w : writers) {
+    auto &impl = *w->m_impl;
+    std::unique_lock<std::mutex> lock(impl.mutex);
+
+    auto done = [&impl]() { return impl.queue.empty() and not impl.busy; };
+
+    if (not done()) {
+      auto start = std::chrono::steady_clock::now();
+      impl.task_done.wait(lock, done);
+      std::chrono::duration<double> T = std::chrono::steady_clock::now() - start;
+      impl.stall_time += T.count();
+    }
+  }
+}
+
+//! True if MPI supports tasks making MPI calls from the I/O thread.
+bool AsyncWriter::thread_support() {
+  int provided = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&provided);
+  return provided == MPI_THREAD_MULTIPLE;
+}
+
+} // end of namespace io
+} // end of namespace pism
@@ -0,0 +1,80 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_ASYNCWRITER_H
+#define PISM_ASYNCWRITER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace pism {
+namespace io {
+
+//! A background thread performing I/O operations in the order they were submitted.
+/*!
+ * Each task is submitted together with the size of the data it holds (in bytes). The
+ * total size of data held by tasks that are not completed yet is limited by the memory
+ * budget: `enqueue()` blocks until enough tasks are completed. A task larger than the
+ * budget is accepted once the queue is empty.
+ *
+ * Time spent waiting for the I/O thread (in `enqueue()`, `wait()` and `wait_all()`) is
+ * reported by `stall_time()`.
+ *
+ * Tasks are performed by the same thread in the order they were submitted, so tasks
+ * using MPI collectives are called in the same order on all ranks as long as all ranks
+ * submit the same sequence of tasks. Such tasks have to use a communicator that is not
+ * used by the main thread and require MPI_THREAD_MULTIPLE.
+ *
+ * If a task fails, the rest of the queue is discarded and the next call of `enqueue()`
+ * or `wait()` throws RuntimeError. The destructor prints errors that were not reported
+ * this way.
+ *
+ * NetCDF libraries are not thread-safe, so `NCFile` calls `wait_all()` to make sure that
+ * I/O threads are idle before it is used by any other thread.
+ */
+class AsyncWriter {
+public:
+  AsyncWriter(size_t memory_budget);
+  ~AsyncWriter();
+
+  void enqueue(std::function<void()> task, size_t size);
+
+  void wait();
+
+  double stall_time() const;
+
+  size_t memory_budget() const;
+
+  static bool thread_support();
+
+  static void wait_all();
+private:
+  struct Impl;
+  std::unique_ptr<Impl> m_impl;
+
+  // disable copying and assignments
+  AsyncWriter(const AsyncWriter &other);
+  AsyncWriter & operator=(const AsyncWriter &);
+};
+
+} // end of namespace io
+} // end of namespace pism
+
+#endif /* PISM_ASYNCWRITER_H */
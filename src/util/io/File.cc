@@ -28,6 +28,9 @@
 #include "pism/util/Grid.hh"
 #include "pism/util/io/NC_Serial.hh"
 #include "pism/util/io/NC4_Serial.hh"
+#include "pism/util/io/NC_Async.hh"
+#include "pism/util/io/NC_Aggregated.hh"
+#include "pism/util/io/AsyncWriter.hh"
 
 #include "pism/pism_config.hh"
 
@@ -49,6 +52,8 @@ namespace pism {
 struct File::Impl {
   MPI_Comm com;
   std::shared_ptr<io::NCFile> nc;
+  // null unless the file is written asynchronously
+  std::shared_ptr<io::AsyncWriter> writer;
 
   std::set<std::string> written_variables;
 };
@@ -152,6 +157,23 @@ static std::shared_ptr<io::NCFile> create_backend(MPI_Comm com, io::Backend back
 }
 
 File::File(MPI_Comm com, const std::string &filename, io::Backend backend, io::Mode mode)
+  : File(com, filename, backend, mode, nullptr, 0) {
+  // empty
+}
+
+/*!
+ * If `writer` is not null, operations modifying the file are performed asynchronously
+ * by the I/O thread of `writer` (see `io::NC_Async`).
+ *
+ * Data passed to `write_variable()` and `write_distributed_array()` is copied, so the
+ * caller can modify it as soon as these methods return. Errors may be reported by a
+ * later call using the same `writer`.
+ *
+ * If `n_aggregators` is positive, only `n_aggregators` ranks access the file; other ranks
+ * send data to them (see `io::NC_Aggregated`).
+ */
+File::File(MPI_Comm com, const std::string &filename, io::Backend backend, io::Mode mode,
+           std::shared_ptr<io::AsyncWriter> writer, int n_aggregators)
   : m_impl(new Impl) {
 
   if (filename.empty()) {
@@ -163,8 +185,26 @@ File::File(MPI_Comm com, const std::string &filename, io::Backend backend, io::M
     backend = choose_backend(com, filename);
   }
 
-  m_impl->com = com;
-  m_impl->nc  = create_backend(m_impl->com, backend);
+  m_impl->com    = com;
+  m_impl->writer = writer;
+
+  auto create = [backend, n_aggregators](MPI_Comm c) -> std::shared_ptr<io::NCFile> {
+    if (n_aggregators > 0) {
+      return std::make_shared<io::NC_Aggregated>(
+          c, n_aggregators, [backend](MPI_Comm a) { return create_backend(a, backend); });
+    }
+    return create_backend(c, backend);
+  };
+
+  if (writer) {
+    // the backend uses its own communicator because it is used by the I/O thread
+    MPI_Comm backend_com = MPI_COMM_NULL;
+    MPI_Comm_dup(com, &backend_com);
+
+    m_impl->nc = std::make_shared<io::NC_Async>(com, backend_com, create(backend_com), writer);
+  } else {
+    m_impl->nc = create(m_impl->com);
+  }
 
   this->open(filename, mode);
 }
@@ -200,6 +240,11 @@ void File::open(const std::string &filename, io::Mode mode) {
 
     } else if (mode == io::PISM_READWRITE_CLOBBER or mode == io::PISM_READWRITE_MOVE) {
 
+      if (m_impl->writer) {
+        // the I/O thread may be writing to a file with this name
+        m_impl->writer->wait();
+      }
+
       if (mode == io::PISM_READWRITE_MOVE) {
         io::move_if_exists(m_impl->com, filename);
       } else {
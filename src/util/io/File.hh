@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <mpi.h>
 
 #include "pism/util/Units.hh"
@@ -33,6 +34,7 @@ namespace io {
 enum Type : int;
 enum Backend : int;
 enum Mode : int;
+class AsyncWriter;
 } // namespace io
 
 class Grid;
@@ -55,6 +57,8 @@ class File
 {
 public:
   File(MPI_Comm com, const std::string &filename, io::Backend backend, io::Mode mode);
+  File(MPI_Comm com, const std::string &filename, io::Backend backend, io::Mode mode,
+       std::shared_ptr<io::AsyncWriter> writer, int n_aggregators = 0);
   ~File();
 
   MPI_Comm com() const;
@@ -19,6 +19,7 @@
 #include "pism/util/io/NCFile.hh"
 
 #include <cstdio>               // fprintf, stderr, rename, remove
+#include "pism/util/io/AsyncWriter.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/Grid.hh"
 
@@ -33,7 +34,20 @@ namespace pism {
 namespace io {
 
 NCFile::NCFile(MPI_Comm c)
-  : m_com(c), m_file_id(-1), m_define_mode(false) {
+  : m_com(c), m_file_id(-1), m_asynchronous(false), m_define_mode(false) {
+}
+
+/*!
+ * NetCDF libraries are not thread-safe, so we wait for I/O threads (if any) to finish
+ * before calling one.
+ *
+ * Implementations that do not call NetCDF directly (and use I/O threads themselves) set
+ * `m_asynchronous` to skip this.
+ */
+void NCFile::wait_for_io_threads() const {
+  if (not m_asynchronous) {
+    AsyncWriter::wait_all();
+  }
 }
 
 std::string NCFile::filename() const {
@@ -41,6 +55,7 @@ std::string NCFile::filename() const {
 }
 
 void NCFile::set_compression_level(int level) const {
+  wait_for_io_threads();
   set_compression_level_impl(level);
 }
 
@@ -58,12 +73,14 @@ void NCFile::def_var_chunking_impl(const std::string &name,
 
 
 void NCFile::open(const std::string &filename, io::Mode mode) {
+  wait_for_io_threads();
   this->open_impl(filename, mode);
   m_filename = filename;
   m_define_mode = false;
 }
 
 void NCFile::create(const std::string &filename) {
+  wait_for_io_threads();
   this->create_impl(filename);
   m_filename = filename;
   m_define_mode = true;
@@ -71,10 +88,12 @@ void NCFile::create(const std::string &filename) {
 
 void NCFile::sync() const {
   enddef();
+  wait_for_io_threads();
   this->sync_impl();
 }
 
 void NCFile::close() {
+  wait_for_io_threads();
   this->close_impl();
   m_filename.clear();
   m_file_id = -1;
@@ -82,6 +101,7 @@ void NCFile::close() {
 
 void NCFile::enddef() const {
   if (m_define_mode) {
+    wait_for_io_threads();
     this->enddef_impl();
     m_define_mode = false;
   }
@@ -89,6 +109,7 @@ void NCFile::enddef() const {
 
 void NCFile::redef() const {
   if (not m_define_mode) {
+    wait_for_io_threads();
     this->redef_impl();
     m_define_mode = true;
   }
@@ -96,29 +117,35 @@ void NCFile::redef() const {
 
 void NCFile::def_dim(const std::string &name, size_t length) const {
   redef();
+  wait_for_io_threads();
   this->def_dim_impl(name, length);
 }
 
 void NCFile::inq_dimid(const std::string &dimension_name, bool &exists) const {
+  wait_for_io_threads();
   this->inq_dimid_impl(dimension_name,exists);
 }
 
 void NCFile::inq_dimlen(const std::string &dimension_name, unsigned int &result) const {
+  wait_for_io_threads();
   this->inq_dimlen_impl(dimension_name,result);
 }
 
 void NCFile::inq_unlimdim(std::string &result) const {
+  wait_for_io_threads();
   this->inq_unlimdim_impl(result);
 }
 
 void NCFile::def_var(const std::string &name, io::Type nctype,
                     const std::vector<std::string> &dims) const {
   redef();
+  wait_for_io_threads();
   this->def_var_impl(name, nctype, dims);
 }
 
 void NCFile::def_var_chunking(const std::string &name,
                               std::vector<size_t> &dimensions) const {
+  wait_for_io_threads();
   this->def_var_chunking_impl(name, dimensions);
 }
 
@@ -135,6 +162,7 @@ void NCFile::get_vara_double(const std::string &variable_name,
 #endif
 
   enddef();
+  wait_for_io_threads();
   this->get_vara_double_impl(variable_name, start, count, ip);
 }
 
@@ -150,6 +178,7 @@ void NCFile::put_vara_double(const std::string &variable_name,
 #endif
 
   enddef();
+  wait_for_io_threads();
   this->put_vara_double_impl(variable_name, start, count, op);
 }
 
@@ -161,6 +190,7 @@ void NCFile::write_darray(const std::string &variable_name,
                           unsigned int record,
                           const double *input) {
   enddef();
+  wait_for_io_threads();
   this->write_darray_impl(variable_name, grid, z_count, time_dependent, record, input);
 }
 
@@ -187,34 +217,41 @@ void NCFile::write_darray_impl(const std::string &variable_name,
 }
 
 void NCFile::inq_nvars(int &result) const {
+  wait_for_io_threads();
   this->inq_nvars_impl(result);
 }
 
 void NCFile::inq_vardimid(const std::string &variable_name, std::vector<std::string> &result) const {
+  wait_for_io_threads();
   this->inq_vardimid_impl(variable_name, result);
 }
 
 void NCFile::inq_varnatts(const std::string &variable_name, int &result) const {
+  wait_for_io_threads();
   this->inq_varnatts_impl(variable_name, result);
 }
 
 void NCFile::inq_varid(const std::string &variable_name, bool &result) const {
+  wait_for_io_threads();
   this->inq_varid_impl(variable_name, result);
 }
 
 void NCFile::inq_varname(unsigned int j, std::string &result) const {
+  wait_for_io_threads();
   this->inq_varname_impl(j, result);
 }
 
 void NCFile::get_att_double(const std::string &variable_name,
                             const std::string &att_name,
                             std::vector<double> &result) const {
+  wait_for_io_threads();
   this->get_att_double_impl(variable_name, att_name, result);
 }
 
 void NCFile::get_att_text(const std::string &variable_name,
                           const std::string &att_name,
                           std::string &result) const {
+  wait_for_io_threads();
   this->get_att_text_impl(variable_name, att_name, result);
 }
 
@@ -222,33 +259,39 @@ void NCFile::put_att_double(const std::string &variable_name,
                             const std::string &att_name,
                             io::Type xtype,
                             const std::vector<double> &data) const {
+  wait_for_io_threads();
   this->put_att_double_impl(variable_name, att_name, xtype, data);
 }
 
 void NCFile::put_att_text(const std::string &variable_name,
                           const std::string &att_name,
                           const std::string &value) const {
+  wait_for_io_threads();
   this->put_att_text_impl(variable_name, att_name, value);
 }
 
 void NCFile::inq_attname(const std::string &variable_name,
                          unsigned int n,
                          std::string &result) const {
+  wait_for_io_threads();
   this->inq_attname_impl(variable_name, n, result);
 }
 
 void NCFile::inq_atttype(const std::string &variable_name,
                          const std::string &att_name,
                          io::Type &result) const {
+  wait_for_io_threads();
   this->inq_atttype_impl(variable_name, att_name, result);
 }
 
 void NCFile::set_fill(int fillmode, int &old_modep) const {
   redef();
+  wait_for_io_threads();
   this->set_fill_impl(fillmode, old_modep);
 }
 
 void NCFile::del_att(const std::string &variable_name, const std::string &att_name) const {
+  wait_for_io_threads();
   this->del_att_impl(variable_name, att_name);
 }
 
@@ -221,7 +221,11 @@ protected:                      // data members
   MPI_Comm m_com;
   int m_file_id;
   std::string m_filename;
+  //! true if this implementation does not call NetCDF in the calling thread
+  bool m_asynchronous;
 private:
+  void wait_for_io_threads() const;
+
   mutable bool m_define_mode;
 };
 
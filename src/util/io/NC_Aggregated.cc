@@ -0,0 +1,509 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/io/NC_Aggregated.hh"
+
+#include <algorithm>            // std::min, std::max
+#include <exception>
+
+#include "pism/util/io/IO_Flags.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace io {
+
+//! Index of the group containing `rank`.
+static int group(int rank, int size, int n_groups) {
+  return static_cast<int>((static_cast<long>(rank) * n_groups) / size);
+}
+
+/*!
+ * @param[in] com communicator
+ * @param[in] n_aggregators number of ranks accessing the file (clipped to [1, size of `com`])
+ * @param[in] create_backend function creating a backend using a given communicator
+ */
+NC_Aggregated::NC_Aggregated(MPI_Comm com, int n_aggregators,
+                             std::function<std::shared_ptr<NCFile>(MPI_Comm)> create_backend)
+  : NCFile(com), m_aggregator(0), m_max_group_size(1), m_aggregator_com(MPI_COMM_NULL) {
+
+  int rank = 0, size = 1;
+  MPI_Comm_rank(m_com, &rank);
+  MPI_Comm_size(m_com, &size);
+
+  n_aggregators = std::max(1, std::min(n_aggregators, size));
+
+  const int my_group = group(rank, size, n_aggregators);
+
+  // find the aggregator of this group (the first rank in it) and sizes of all groups
+  std::vector<int> group_size(n_aggregators, 0);
+  m_aggregator = -1;
+  for (int r = 0; r < size; ++r) {
+    int g = group(r, size, n_aggregators);
+    group_size[g] += 1;
+
+    if (g == my_group) {
+      if (m_aggregator < 0) {
+        m_aggregator = r;
+      } else if (rank == m_aggregator) {
+        m_clients.push_back(r);
+      }
+    }
+  }
+  m_max_group_size = *std::max_element(group_size.begin(), group_size.end());
+
+  const bool aggregator = (rank == m_aggregator);
+
+  MPI_Comm_split(m_com, aggregator ? 0 : MPI_UNDEFINED, rank, &m_aggregator_com);
+
+  if (aggregator) {
+    m_backend = create_backend(m_aggregator_com);
+  }
+}
+
+NC_Aggregated::~NC_Aggregated() {
+  // the backend has to be destroyed before its communicator is freed
+  m_backend.reset();
+  if (m_aggregator_com != MPI_COMM_NULL) {
+    MPI_Comm_free(&m_aggregator_com);
+  }
+}
+
+/*!
+ * Perform an `operation` on aggregators and make sure that all ranks throw an exception
+ * if it failed on any aggregator.
+ *
+ * All ranks report the error message from the lowest-numbered rank that failed.
+ */
+void NC_Aggregated::run(const std::function<void(NCFile &)> &operation) const {
+  int rank = 0, size = 0;
+  MPI_Comm_rank(m_com, &rank);
+  MPI_Comm_size(m_com, &size);
+
+  std::string message;
+
+  if (m_backend) {
+    try {
+      operation(*m_backend);
+    } catch (std::exception &e) {
+      message = e.what();
+      if (message.empty()) {
+        message = "unknown error";
+      }
+    }
+  }
+
+  // find the lowest-numbered rank that failed (`size` if none did)
+  int failed_rank = message.empty() ? size : rank;
+  int first_failed = size;
+  MPI_Allreduce(&failed_rank, &first_failed, 1, MPI_INT, MPI_MIN, m_com);
+
+  if (first_failed == size) {
+    return;
+  }
+
+  broadcast(message, first_failed);
+
+  throw RuntimeError(PISM_ERROR_LOCATION, message);
+}
+
+void NC_Aggregated::broadcast(int &value, int root) const {
+  MPI_Bcast(&value, 1, MPI_INT, root, m_com);
+}
+
+void NC_Aggregated::broadcast(std::string &value, int root) const {
+  int length = static_cast<int>(value.size());
+  broadcast(length, root);
+
+  std::vector<char> buffer(value.begin(), value.end());
+  buffer.resize(length);
+  MPI_Bcast(buffer.data(), length, MPI_CHAR, root, m_com);
+
+  value.assign(buffer.begin(), buffer.end());
+}
+
+void NC_Aggregated::broadcast(std::vector<std::string> &value) const {
+  int length = static_cast<int>(value.size());
+  broadcast(length);
+
+  value.resize(length);
+  for (auto &v : value) {
+    broadcast(v);
+  }
+}
+
+void NC_Aggregated::broadcast(std::vector<double> &value) const {
+  int length = static_cast<int>(value.size());
+  broadcast(length);
+
+  value.resize(length);
+  MPI_Bcast(value.data(), length, MPI_DOUBLE, 0, m_com);
+}
+
+// open/create/close
+
+void NC_Aggregated::open_impl(const std::string &filename, io::Mode mode) {
+  run([&](NCFile &file) { file.open(filename, mode); });
+}
+
+void NC_Aggregated::create_impl(const std::string &filename) {
+  run([&](NCFile &file) { file.create(filename); });
+}
+
+void NC_Aggregated::sync_impl() const {
+  run([](NCFile &file) { file.sync(); });
+}
+
+void NC_Aggregated::close_impl() {
+  run([](NCFile &file) { file.close(); });
+}
+
+// redef/enddef
+
+void NC_Aggregated::enddef_impl() const {
+  run([](NCFile &file) { file.enddef(); });
+}
+
+void NC_Aggregated::redef_impl() const {
+  run([](NCFile &file) { file.redef(); });
+}
+
+// dim
+
+void NC_Aggregated::def_dim_impl(const std::string &name, size_t length) const {
+  run([&](NCFile &file) { file.def_dim(name, length); });
+}
+
+void NC_Aggregated::inq_dimid_impl(const std::string &dimension_name, bool &exists) const {
+  int flag = 0;
+  run([&](NCFile &file) {
+    bool result = false;
+    file.inq_dimid(dimension_name, result);
+    flag = result ? 1 : 0;
+  });
+  broadcast(flag);
+  exists = (flag == 1);
+}
+
+void NC_Aggregated::inq_dimlen_impl(const std::string &dimension_name,
+                                    unsigned int &result) const {
+  int length = 0;
+  run([&](NCFile &file) {
+    unsigned int L = 0;
+    file.inq_dimlen(dimension_name, L);
+    length = static_cast<int>(L);
+  });
+  broadcast(length);
+  result = static_cast<unsigned int>(length);
+}
+
+void NC_Aggregated::inq_unlimdim_impl(std::string &result) const {
+  run([&](NCFile &file) { file.inq_unlimdim(result); });
+  broadcast(result);
+}
+
+// var
+
+void NC_Aggregated::def_var_impl(const std::string &name, io::Type nctype,
+                                 const std::vector<std::string> &dims) const {
+  run([&](NCFile &file) { file.def_var(name, nctype, dims); });
+}
+
+void NC_Aggregated::def_var_chunking_impl(const std::string &name,
+                                          std::vector<size_t> &dimensions) const {
+  run([&](NCFile &file) { file.def_var_chunking(name, dimensions); });
+}
+
+/*!
+ * Receive `start` and `count` arrays from clients of this aggregator.
+ *
+ * Returns start and count of client `c` in `[2 * ndims * c, 2 * ndims * c + ndims)` and
+ * `[2 * ndims * c + ndims, 2 * ndims * (c + 1))`.
+ */
+static std::vector<unsigned int> receive_headers(MPI_Comm com, const std::vector<int> &clients,
+                                                 int ndims, int tag) {
+  const int n_clients = static_cast<int>(clients.size());
+
+  std::vector<unsigned int> headers(2 * ndims * n_clients);
+  std::vector<MPI_Request> requests(n_clients);
+  for (int c = 0; c < n_clients; ++c) {
+    MPI_Irecv(headers.data() + 2 * ndims * c, 2 * ndims, MPI_UNSIGNED, clients[c], tag, com,
+              &requests[c]);
+  }
+  MPI_Waitall(n_clients, requests.data(), MPI_STATUSES_IGNORE);
+
+  return headers;
+}
+
+static size_t chunk_size(const unsigned int *count, int ndims) {
+  size_t result = 1;
+  for (int k = 0; k < ndims; ++k) {
+    result *= count[k];
+  }
+  return result;
+}
+
+/*!
+ * Aggregators read chunks requested by all ranks in their groups and send them using
+ * non-blocking MPI calls.
+ */
+void NC_Aggregated::get_vara_double_impl(const std::string &variable_name,
+                                         const std::vector<unsigned int> &start,
+                                         const std::vector<unsigned int> &count,
+                                         double *ip) const {
+  const int header_tag = 1, data_tag = 2;
+  const int ndims = static_cast<int>(start.size());
+
+  if (not m_backend) {
+    std::vector<unsigned int> header(start);
+    header.insert(header.end(), count.begin(), count.end());
+
+    MPI_Request requests[2];
+    MPI_Isend(header.data(), 2 * ndims, MPI_UNSIGNED, m_aggregator, header_tag, m_com,
+              &requests[0]);
+    MPI_Irecv(ip, static_cast<int>(chunk_size(count.data(), ndims)), MPI_DOUBLE, m_aggregator,
+              data_tag, m_com, &requests[1]);
+    MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+
+    run([](NCFile &) {});
+    return;
+  }
+
+  const int n_clients = static_cast<int>(m_clients.size());
+  auto headers = receive_headers(m_com, m_clients, ndims, header_tag);
+
+  std::vector<std::vector<double> > buffers(n_clients);
+  for (int c = 0; c < n_clients; ++c) {
+    buffers[c].resize(chunk_size(headers.data() + 2 * ndims * c + ndims, ndims));
+  }
+
+  // Note: all aggregators have to make the same number of get_vara_double() calls because
+  // some backends use collective calls. Aggregators of smaller groups read empty chunks.
+  std::vector<unsigned int> empty(ndims, 0);
+  double dummy = 0.0;
+
+  std::string message;
+  try {
+    m_backend->get_vara_double(variable_name, start, count, ip);
+
+    for (int c = 0; c < n_clients; ++c) {
+      std::vector<unsigned int>
+        c_start(headers.data() + 2 * ndims * c, headers.data() + 2 * ndims * c + ndims),
+        c_count(headers.data() + 2 * ndims * c + ndims, headers.data() + 2 * ndims * (c + 1));
+
+      m_backend->get_vara_double(variable_name, c_start, c_count, buffers[c].data());
+    }
+
+    for (int k = n_clients + 1; k < m_max_group_size; ++k) {
+      m_backend->get_vara_double(variable_name, empty, empty, &dummy);
+    }
+  } catch (std::exception &e) {
+    message = e.what();
+    if (message.empty()) {
+      message = "unknown error";
+    }
+  }
+
+  // send data to clients (even if reading failed: they are waiting for it)
+  std::vector<MPI_Request> requests(n_clients);
+  for (int c = 0; c < n_clients; ++c) {
+    MPI_Isend(buffers[c].data(), static_cast<int>(buffers[c].size()), MPI_DOUBLE,
+              m_clients[c], data_tag, m_com, &requests[c]);
+  }
+  MPI_Waitall(n_clients, requests.data(), MPI_STATUSES_IGNORE);
+
+  run([&](NCFile &) {
+    if (not message.empty()) {
+      throw RuntimeError(PISM_ERROR_LOCATION, message);
+    }
+  });
+}
+
+/*!
+ * All ranks send chunks to their aggregators using non-blocking MPI calls. Aggregators
+ * write their own chunks while data from other ranks are being received and then write
+ * the rest in the order in which they arrive.
+ */
+void NC_Aggregated::put_vara_double_impl(const std::string &variable_name,
+                                         const std::vector<unsigned int> &start,
+                                         const std::vector<unsigned int> &count,
+                                         const double *op) const {
+  const int header_tag = 3, data_tag = 4;
+  const int ndims = static_cast<int>(start.size());
+
+  if (not m_backend) {
+    std::vector<unsigned int> header(start);
+    header.insert(header.end(), count.begin(), count.end());
+
+    MPI_Request requests[2];
+    MPI_Isend(header.data(), 2 * ndims, MPI_UNSIGNED, m_aggregator, header_tag, m_com,
+              &requests[0]);
+    MPI_Isend(const_cast<double *>(op), static_cast<int>(chunk_size(count.data(), ndims)),
+              MPI_DOUBLE, m_aggregator, data_tag, m_com, &requests[1]);
+    MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+
+    run([](NCFile &) {});
+    return;
+  }
+
+  const int n_clients = static_cast<int>(m_clients.size());
+  auto headers = receive_headers(m_com, m_clients, ndims, header_tag);
+
+  std::vector<std::vector<double> > buffers(n_clients);
+  std::vector<MPI_Request> requests(n_clients);
+  for (int c = 0; c < n_clients; ++c) {
+    buffers[c].resize(chunk_size(headers.data() + 2 * ndims * c + ndims, ndims));
+    MPI_Irecv(buffers[c].data(), static_cast<int>(buffers[c].size()), MPI_DOUBLE, m_clients[c],
+              data_tag, m_com, &requests[c]);
+  }
+
+  // Note: all aggregators have to make the same number of put_vara_double() calls because
+  // some backends use collective calls. Aggregators of smaller groups write empty chunks.
+  std::vector<unsigned int> empty(ndims, 0);
+  double dummy = 0.0;
+
+  std::string message;
+  try {
+    m_backend->put_vara_double(variable_name, start, count, op);
+
+    for (int k = 0; k < n_clients; ++k) {
+      int c = 0;
+      MPI_Waitany(n_clients, requests.data(), &c, MPI_STATUS_IGNORE);
+
+      std::vector<unsigned int>
+        c_start(headers.data() + 2 * ndims * c, headers.data() + 2 * ndims * c + ndims),
+        c_count(headers.data() + 2 * ndims * c + ndims, headers.data() + 2 * ndims * (c + 1));
+
+      m_backend->put_vara_double(variable_name, c_start, c_count, buffers[c].data());
+    }
+
+    for (int k = n_clients + 1; k < m_max_group_size; ++k) {
+      m_backend->put_vara_double(variable_name, empty, empty, &dummy);
+    }
+  } catch (std::exception &e) {
+    message = e.what();
+    if (message.empty()) {
+      message = "unknown error";
+    }
+  }
+
+  // make sure all receives are complete (even if writing failed)
+  MPI_Waitall(n_clients, requests.data(), MPI_STATUSES_IGNORE);
+
+  run([&](NCFile &) {
+    if (not message.empty()) {
+      throw RuntimeError(PISM_ERROR_LOCATION, message);
+    }
+  });
+}
+
+void NC_Aggregated::inq_nvars_impl(int &result) const {
+  run([&](NCFile &file) { file.inq_nvars(result); });
+  broadcast(result);
+}
+
+void NC_Aggregated::inq_vardimid_impl(const std::string &variable_name,
+                                      std::vector<std::string> &result) const {
+  run([&](NCFile &file) { file.inq_vardimid(variable_name, result); });
+  broadcast(result);
+}
+
+void NC_Aggregated::inq_varnatts_impl(const std::string &variable_name, int &result) const {
+  run([&](NCFile &file) { file.inq_varnatts(variable_name, result); });
+  broadcast(result);
+}
+
+void NC_Aggregated::inq_varid_impl(const std::string &variable_name, bool &exists) const {
+  int flag = 0;
+  run([&](NCFile &file) {
+    bool result = false;
+    file.inq_varid(variable_name, result);
+    flag = result ? 1 : 0;
+  });
+  broadcast(flag);
+  exists = (flag == 1);
+}
+
+void NC_Aggregated::inq_varname_impl(unsigned int j, std::string &result) const {
+  run([&](NCFile &file) { file.inq_varname(j, result); });
+  broadcast(result);
+}
+
+void NC_Aggregated::set_compression_level_impl(int level) const {
+  run([&](NCFile &file) { file.set_compression_level(level); });
+}
+
+// att
+
+void NC_Aggregated::get_att_double_impl(const std::string &variable_name,
+                                        const std::string &att_name,
+                                        std::vector<double> &result) const {
+  run([&](NCFile &file) { file.get_att_double(variable_name, att_name, result); });
+  broadcast(result);
+}
+
+void NC_Aggregated::get_att_text_impl(const std::string &variable_name,
+                                      const std::string &att_name, std::string &result) const {
+  run([&](NCFile &file) { file.get_att_text(variable_name, att_name, result); });
+  broadcast(result);
+}
+
+void NC_Aggregated::put_att_double_impl(const std::string &variable_name,
+                                        const std::string &att_name, io::Type xtype,
+                                        const std::vector<double> &data) const {
+  run([&](NCFile &file) { file.put_att_double(variable_name, att_name, xtype, data); });
+}
+
+void NC_Aggregated::put_att_text_impl(const std::string &variable_name,
+                                      const std::string &att_name,
+                                      const std::string &value) const {
+  run([&](NCFile &file) { file.put_att_text(variable_name, att_name, value); });
+}
+
+void NC_Aggregated::inq_attname_impl(const std::string &variable_name, unsigned int n,
+                                     std::string &result) const {
+  run([&](NCFile &file) { file.inq_attname(variable_name, n, result); });
+  broadcast(result);
+}
+
+void NC_Aggregated::inq_atttype_impl(const std::string &variable_name,
+                                     const std::string &att_name, io::Type &result) const {
+  int type = PISM_NAT;
+  run([&](NCFile &file) {
+    io::Type T = PISM_NAT;
+    file.inq_atttype(variable_name, att_name, T);
+    type = T;
+  });
+  broadcast(type);
+  result = static_cast<io::Type>(type);
+}
+
+// misc
+
+void NC_Aggregated::set_fill_impl(int fillmode, int &old_modep) const {
+  run([&](NCFile &file) { file.set_fill(fillmode, old_modep); });
+  broadcast(old_modep);
+}
+
+void NC_Aggregated::del_att_impl(const std::string &variable_name,
+                                 const std::string &att_name) const {
+  run([&](NCFile &file) { file.del_att(variable_name, att_name); });
+}
+
+} // end of namespace io
+} // end of namespace pism
@@ -0,0 +1,153 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_NC_AGGREGATED_H
+#define PISM_NC_AGGREGATED_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pism/util/io/NCFile.hh"
+
+namespace pism {
+namespace io {
+
+//! I/O using a subset of ranks ("aggregators") to access the file.
+/*!
+ * Ranks of `com` are split into `n_aggregators` groups of consecutive ranks. The first
+ * rank of each group is its aggregator. Aggregators open the file using a backend created
+ * (by `create_backend`) on a communicator containing aggregators only; other ranks do not
+ * access the file.
+ *
+ * Other ranks send data to their aggregators using non-blocking MPI calls and
+ * aggregators write them. Reading works the same way in the opposite direction. Results
+ * of queries are broadcast from rank 0 (which is always an aggregator); errors are
+ * broadcast from the lowest-numbered aggregator that failed.
+ *
+ * This makes it possible to choose the number of processes writing to a file
+ * independently of the domain decomposition.
+ */
+class NC_Aggregated : public NCFile
+{
+public:
+  NC_Aggregated(MPI_Comm com, int n_aggregators,
+                std::function<std::shared_ptr<NCFile>(MPI_Comm)> create_backend);
+  virtual ~NC_Aggregated();
+
+protected:
+  // open/create/close
+  void open_impl(const std::string &filename, io::Mode mode);
+
+  void create_impl(const std::string &filename);
+
+  void sync_impl() const;
+
+  void close_impl();
+
+  // redef/enddef
+  void enddef_impl() const;
+
+  void redef_impl() const;
+
+  // dim
+  void def_dim_impl(const std::string &name, size_t length) const;
+
+  void inq_dimid_impl(const std::string &dimension_name, bool &exists) const;
+
+  void inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const;
+
+  void inq_unlimdim_impl(std::string &result) const;
+
+  // var
+  void def_var_impl(const std::string &name, io::Type nctype,
+                    const std::vector<std::string> &dims) const;
+
+  void def_var_chunking_impl(const std::string &name, std::vector<size_t> &dimensions) const;
+
+  void get_vara_double_impl(const std::string &variable_name,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count, double *ip) const;
+
+  void put_vara_double_impl(const std::string &variable_name,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count, const double *op) const;
+
+  void inq_nvars_impl(int &result) const;
+
+  void inq_vardimid_impl(const std::string &variable_name, std::vector<std::string> &result) const;
+
+  void inq_varnatts_impl(const std::string &variable_name, int &result) const;
+
+  void inq_varid_impl(const std::string &variable_name, bool &exists) const;
+
+  void inq_varname_impl(unsigned int j, std::string &result) const;
+
+  void set_compression_level_impl(int level) const;
+
+  // att
+  void get_att_double_impl(const std::string &variable_name, const std::string &att_name,
+                           std::vector<double> &result) const;
+
+  void get_att_text_impl(const std::string &variable_name, const std::string &att_name,
+                         std::string &result) const;
+
+  void put_att_double_impl(const std::string &variable_name, const std::string &att_name,
+                           io::Type xtype, const std::vector<double> &data) const;
+
+  void put_att_text_impl(const std::string &variable_name, const std::string &att_name,
+                         const std::string &value) const;
+
+  void inq_attname_impl(const std::string &variable_name, unsigned int n,
+                        std::string &result) const;
+
+  void inq_atttype_impl(const std::string &variable_name, const std::string &att_name,
+                        io::Type &result) const;
+
+  // misc
+  void set_fill_impl(int fillmode, int &old_modep) const;
+
+  void del_att_impl(const std::string &variable_name, const std::string &att_name) const;
+
+private:
+  void run(const std::function<void(NCFile &)> &operation) const;
+
+  void broadcast(int &value, int root = 0) const;
+  void broadcast(std::string &value, int root = 0) const;
+  void broadcast(std::vector<std::string> &value) const;
+  void broadcast(std::vector<double> &value) const;
+
+  //! rank of the aggregator of this rank's group
+  int m_aggregator;
+  //! other ranks in the group (empty unless this rank is an aggregator)
+  std::vector<int> m_clients;
+  //! maximum number of ranks in a group
+  int m_max_group_size;
+
+  //! communicator containing aggregators (MPI_COMM_NULL on other ranks)
+  MPI_Comm m_aggregator_com;
+  //! backend used by aggregators (null on other ranks)
+  std::shared_ptr<NCFile> m_backend;
+};
+
+} // end of namespace io
+} // end of namespace pism
+
+#endif /* PISM_NC_AGGREGATED_H */
@@ -0,0 +1,341 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/io/NC_Async.hh"
+
+#include <algorithm>            // std::max, std::find
+
+#include "pism/util/io/AsyncWriter.hh"
+#include "pism/util/io/IO_Flags.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace io {
+
+struct NC_Async::Backend {
+  Backend(MPI_Comm c, std::shared_ptr<NCFile> f) : com(c), file(f) {
+    // empty
+  }
+
+  ~Backend() {
+    // the backend has to be destroyed before its communicator is freed
+    file.reset();
+    MPI_Comm_free(&com);
+  }
+
+  MPI_Comm com;
+  std::shared_ptr<NCFile> file;
+};
+
+NC_Async::NC_Async(MPI_Comm com, MPI_Comm backend_com, std::shared_ptr<NCFile> backend,
+                   std::shared_ptr<AsyncWriter> writer)
+  : NCFile(com),
+    m_backend(std::make_shared<Backend>(backend_com, backend)),
+    m_writer(writer) {
+  // this class calls the backend using the I/O thread
+  m_asynchronous = true;
+}
+
+NC_Async::~NC_Async() {
+  // Tasks that are not completed yet keep the backend alive, so there is nothing to do
+  // here.
+}
+
+NCFile &NC_Async::backend() const {
+  return *m_backend->file;
+}
+
+/*!
+ * Submit `task` to the I/O thread. The `size` (in bytes) of the data held by `task` is
+ * counted towards the memory budget.
+ */
+void NC_Async::submit(std::function<void(NCFile &)> task, size_t size) const {
+  auto B = m_backend;
+  m_writer->enqueue([B, task]() { task(*B->file); }, size);
+}
+
+//! Get the list of variables in a file that was just opened.
+void NC_Async::read_metadata() {
+  m_metadata = Metadata();
+
+  int n_variables = 0;
+  backend().inq_nvars(n_variables);
+  for (int k = 0; k < n_variables; ++k) {
+    std::string name;
+    backend().inq_varname(k, name);
+    m_metadata.variables.push_back(name);
+  }
+
+  backend().inq_unlimdim(m_metadata.unlimited_dimension);
+}
+
+const std::vector<std::string> &NC_Async::dimensions(const std::string &variable_name) const {
+  auto it = m_metadata.variable_dimensions.find(variable_name);
+  if (it != m_metadata.variable_dimensions.end()) {
+    return it->second;
+  }
+
+  m_writer->wait();
+  std::vector<std::string> result;
+  backend().inq_vardimid(variable_name, result);
+
+  return m_metadata.variable_dimensions[variable_name] = result;
+}
+
+unsigned int NC_Async::dimension_length(const std::string &dimension_name) const {
+  auto it = m_metadata.dimensions.find(dimension_name);
+  if (it != m_metadata.dimensions.end()) {
+    return it->second;
+  }
+
+  m_writer->wait();
+  unsigned int result = 0;
+  backend().inq_dimlen(dimension_name, result);
+
+  return m_metadata.dimensions[dimension_name] = result;
+}
+
+// open/create/close
+
+void NC_Async::open_impl(const std::string &filename, io::Mode mode) {
+  m_writer->wait();
+  backend().open(filename, mode);
+  read_metadata();
+}
+
+void NC_Async::create_impl(const std::string &filename) {
+  m_writer->wait();
+  backend().create(filename);
+  m_metadata = Metadata();
+}
+
+void NC_Async::sync_impl() const {
+  submit([](NCFile &file) { file.sync(); });
+}
+
+void NC_Async::close_impl() {
+  submit([](NCFile &file) { file.close(); });
+  m_metadata = Metadata();
+}
+
+// redef/enddef
+
+void NC_Async::enddef_impl() const {
+  submit([](NCFile &file) { file.enddef(); });
+}
+
+void NC_Async::redef_impl() const {
+  submit([](NCFile &file) { file.redef(); });
+}
+
+// dim
+
+void NC_Async::def_dim_impl(const std::string &name, size_t length) const {
+  m_metadata.dimensions[name] = static_cast<unsigned int>(length);
+  if (length == PISM_UNLIMITED) {
+    m_metadata.unlimited_dimension = name;
+  }
+
+  submit([name, length](NCFile &file) { file.def_dim(name, length); });
+}
+
+void NC_Async::inq_dimid_impl(const std::string &dimension_name, bool &exists) const {
+  if (m_metadata.dimensions.find(dimension_name) != m_metadata.dimensions.end()) {
+    exists = true;
+    return;
+  }
+
+  m_writer->wait();
+  backend().inq_dimid(dimension_name, exists);
+
+  if (exists) {
+    // remember its length to avoid waiting for the I/O thread next time
+    dimension_length(dimension_name);
+  }
+}
+
+void NC_Async::inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const {
+  result = dimension_length(dimension_name);
+}
+
+void NC_Async::inq_unlimdim_impl(std::string &result) const {
+  result = m_metadata.unlimited_dimension;
+}
+
+// var
+
+void NC_Async::def_var_impl(const std::string &name, io::Type nctype,
+                            const std::vector<std::string> &dims) const {
+  m_metadata.variables.push_back(name);
+  m_metadata.variable_dimensions[name] = dims;
+
+  submit([name, nctype, dims](NCFile &file) { file.def_var(name, nctype, dims); });
+}
+
+void NC_Async::def_var_chunking_impl(const std::string &name,
+                                     std::vector<size_t> &dimensions) const {
+  auto chunk_size = dimensions;
+  submit([name, chunk_size](NCFile &file) mutable { file.def_var_chunking(name, chunk_size); });
+}
+
+void NC_Async::get_vara_double_impl(const std::string &variable_name,
+                                    const std::vector<unsigned int> &start,
+                                    const std::vector<unsigned int> &count, double *ip) const {
+  m_writer->wait();
+  backend().get_vara_double(variable_name, start, count, ip);
+}
+
+void NC_Async::put_vara_double_impl(const std::string &variable_name,
+                                    const std::vector<unsigned int> &start,
+                                    const std::vector<unsigned int> &count,
+                                    const double *op) const {
+  size_t N = 1;
+  for (auto c : count) {
+    N *= c;
+  }
+
+  // writing to a time-dependent variable may extend the unlimited dimension
+  const auto &dims = dimensions(variable_name);
+  const auto &T = m_metadata.unlimited_dimension;
+  if (not T.empty() and not dims.empty() and dims[0] == T and not start.empty()) {
+    unsigned int length = dimension_length(T);
+    m_metadata.dimensions[T] = std::max(length, start[0] + count[0]);
+  }
+
+  // copy data to the staging buffer (shared to avoid copying it again)
+  auto data = std::make_shared<std::vector<double> >(op, op + N);
+  auto task = [variable_name, start, count, data](NCFile &file) {
+    file.put_vara_double(variable_name, start, count, data->data());
+  };
+  submit(task, N * sizeof(double));
+}
+
+void NC_Async::inq_nvars_impl(int &result) const {
+  result = static_cast<int>(m_metadata.variables.size());
+}
+
+void NC_Async::inq_vardimid_impl(const std::string &variable_name,
+                                 std::vector<std::string> &result) const {
+  result = dimensions(variable_name);
+}
+
+void NC_Async::inq_varnatts_impl(const std::string &variable_name, int &result) const {
+  m_writer->wait();
+  backend().inq_varnatts(variable_name, result);
+}
+
+void NC_Async::inq_varid_impl(const std::string &variable_name, bool &exists) const {
+  const auto &V = m_metadata.variables;
+  exists = std::find(V.begin(), V.end(), variable_name) != V.end();
+}
+
+void NC_Async::inq_varname_impl(unsigned int j, std::string &result) const {
+  if (j < m_metadata.variables.size()) {
+    result = m_metadata.variables[j];
+    return;
+  }
+
+  m_writer->wait();
+  backend().inq_varname(j, result);
+}
+
+void NC_Async::set_compression_level_impl(int level) const {
+  submit([level](NCFile &file) { file.set_compression_level(level); });
+}
+
+// att
+
+void NC_Async::get_att_double_impl(const std::string &variable_name,
+                                   const std::string &att_name,
+                                   std::vector<double> &result) const {
+  auto &attributes = m_metadata.double_attributes[variable_name];
+  auto it = attributes.find(att_name);
+  if (it != attributes.end()) {
+    result = it->second;
+    return;
+  }
+
+  m_writer->wait();
+  backend().get_att_double(variable_name, att_name, result);
+  attributes[att_name] = result;
+}
+
+void NC_Async::get_att_text_impl(const std::string &variable_name, const std::string &att_name,
+                                 std::string &result) const {
+  auto &attributes = m_metadata.text_attributes[variable_name];
+  auto it = attributes.find(att_name);
+  if (it != attributes.end()) {
+    result = it->second;
+    return;
+  }
+
+  m_writer->wait();
+  backend().get_att_text(variable_name, att_name, result);
+  attributes[att_name] = result;
+}
+
+void NC_Async::put_att_double_impl(const std::string &variable_name,
+                                   const std::string &att_name, io::Type xtype,
+                                   const std::vector<double> &data) const {
+  m_metadata.double_attributes[variable_name][att_name] = data;
+  m_metadata.text_attributes[variable_name].erase(att_name);
+
+  submit([variable_name, att_name, xtype, data](NCFile &file) {
+    file.put_att_double(variable_name, att_name, xtype, data);
+  });
+}
+
+void NC_Async::put_att_text_impl(const std::string &variable_name, const std::string &att_name,
+                                 const std::string &value) const {
+  m_metadata.text_attributes[variable_name][att_name] = value;
+  m_metadata.double_attributes[variable_name].erase(att_name);
+
+  submit([variable_name, att_name, value](NCFile &file) {
+    file.put_att_text(variable_name, att_name, value);
+  });
+}
+
+void NC_Async::inq_attname_impl(const std::string &variable_name, unsigned int n,
+                                std::string &result) const {
+  m_writer->wait();
+  backend().inq_attname(variable_name, n, result);
+}
+
+void NC_Async::inq_atttype_impl(const std::string &variable_name, const std::string &att_name,
+                                io::Type &result) const {
+  m_writer->wait();
+  backend().inq_atttype(variable_name, att_name, result);
+}
+
+// misc
+
+void NC_Async::set_fill_impl(int fillmode, int &old_modep) const {
+  m_writer->wait();
+  backend().set_fill(fillmode, old_modep);
+}
+
+void NC_Async::del_att_impl(const std::string &variable_name, const std::string &att_name) const {
+  m_metadata.double_attributes[variable_name].erase(att_name);
+  m_metadata.text_attributes[variable_name].erase(att_name);
+
+  submit([variable_name, att_name](NCFile &file) { file.del_att(variable_name, att_name); });
+}
+
+} // end of namespace io
+} // end of namespace pism
@@ -0,0 +1,162 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_NC_ASYNC_H
+#define PISM_NC_ASYNC_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "pism/util/io/NCFile.hh"
+
+namespace pism {
+namespace io {
+
+class AsyncWriter;
+
+//! Asynchronous wrapper around an I/O backend.
+/*!
+ * Operations modifying a file (defining dimensions and variables, writing attributes and
+ * data, etc) copy their arguments and are performed by the I/O thread of an
+ * `AsyncWriter`.
+ *
+ * Queries are answered using a copy of the file's metadata (dimensions, variables and
+ * attributes) that is updated by operations submitted to the I/O thread. Queries that
+ * cannot be answered this way wait for the I/O thread and use the backend directly.
+ *
+ * The `backend` has to use a communicator `backend_com` that is not used by the rest of
+ * the code (a duplicate of `com`), so that MPI calls made by the I/O thread do not
+ * interfere with MPI calls made by the main thread. `NC_Async` takes ownership of
+ * `backend_com`.
+ */
+class NC_Async : public NCFile
+{
+public:
+  NC_Async(MPI_Comm com, MPI_Comm backend_com, std::shared_ptr<NCFile> backend,
+           std::shared_ptr<AsyncWriter> writer);
+  virtual ~NC_Async();
+
+protected:
+  // open/create/close
+  void open_impl(const std::string &filename, io::Mode mode);
+
+  void create_impl(const std::string &filename);
+
+  void sync_impl() const;
+
+  void close_impl();
+
+  // redef/enddef
+  void enddef_impl() const;
+
+  void redef_impl() const;
+
+  // dim
+  void def_dim_impl(const std::string &name, size_t length) const;
+
+  void inq_dimid_impl(const std::string &dimension_name, bool &exists) const;
+
+  void inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const;
+
+  void inq_unlimdim_impl(std::string &result) const;
+
+  // var
+  void def_var_impl(const std::string &name, io::Type nctype,
+                    const std::vector<std::string> &dims) const;
+
+  void def_var_chunking_impl(const std::string &name, std::vector<size_t> &dimensions) const;
+
+  void get_vara_double_impl(const std::string &variable_name,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count, double *ip) const;
+
+  void put_vara_double_impl(const std::string &variable_name,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count, const double *op) const;
+
+  void inq_nvars_impl(int &result) const;
+
+  void inq_vardimid_impl(const std::string &variable_name, std::vector<std::string> &result) const;
+
+  void inq_varnatts_impl(const std::string &variable_name, int &result) const;
+
+  void inq_varid_impl(const std::string &variable_name, bool &exists) const;
+
+  void inq_varname_impl(unsigned int j, std::string &result) const;
+
+  void set_compression_level_impl(int level) const;
+
+  // att
+  void get_att_double_impl(const std::string &variable_name, const std::string &att_name,
+                           std::vector<double> &result) const;
+
+  void get_att_text_impl(const std::string &variable_name, const std::string &att_name,
+                         std::string &result) const;
+
+  void put_att_double_impl(const std::string &variable_name, const std::string &att_name,
+                           io::Type xtype, const std::vector<double> &data) const;
+
+  void put_att_text_impl(const std::string &variable_name, const std::string &att_name,
+                         const std::string &value) const;
+
+  void inq_attname_impl(const std::string &variable_name, unsigned int n,
+                        std::string &result) const;
+
+  void inq_atttype_impl(const std::string &variable_name, const std::string &att_name,
+                        io::Type &result) const;
+
+  // misc
+  void set_fill_impl(int fillmode, int &old_modep) const;
+
+  void del_att_impl(const std::string &variable_name, const std::string &att_name) const;
+
+private:
+  struct Backend;
+  //! the backend and its communicator (shared with tasks submitted to the I/O thread)
+  std::shared_ptr<Backend> m_backend;
+
+  std::shared_ptr<AsyncWriter> m_writer;
+
+  //! Copy of the metadata of the file.
+  struct Metadata {
+    std::map<std::string, unsigned int> dimensions;
+    // name of the unlimited dimension; empty if not known
+    std::string unlimited_dimension;
+    // names of all variables, in the order they were defined
+    std::vector<std::string> variables;
+    std::map<std::string, std::vector<std::string> > variable_dimensions;
+    std::map<std::string, std::map<std::string, std::vector<double> > > double_attributes;
+    std::map<std::string, std::map<std::string, std::string> > text_attributes;
+  };
+  mutable Metadata m_metadata;
+
+  void read_metadata();
+  const std::vector<std::string> &dimensions(const std::string &variable_name) const;
+  unsigned int dimension_length(const std::string &dimension_name) const;
+  void submit(std::function<void(NCFile &)> task, size_t size = 0) const;
+  NCFile &backend() const;
+};
+
+} // end of namespace io
+} // end of namespace pism
+
+#endif /* PISM_NC_ASYNC_H */
@@ -812,31 +812,92 @@ void regrid_spatial_variable(const SpatialVariableMetadata &variable,
                              const LocalInterpCtx &interp_context, const File &file,
                              double *output) {
 
-  auto var = file.find_variable(variable.get_name(), variable["standard_name"]);
+  auto info = spatial_variable_info(variable, file);
 
   const Profiling &profiling = target_grid.ctx()->profiling();
 
   profiling.begin("io.regridding.read");
   std::vector<double> buffer(interp_context.buffer_size());
-  read_distributed_array(file, var.name, variable.unit_system(), interp_context.start,
-                         interp_context.count, buffer.data());
+  read_spatial_record(file, info, interp_context, interp_context.start[T_AXIS], buffer.data());
   profiling.end("io.regridding.read");
 
-  // interpolate
+  // interpolate and convert units
   profiling.begin("io.regridding.interpolate");
-  interpolate(target_grid, interp_context, buffer.data(), output);
+  interpolate_spatial_record(variable, info, target_grid, interp_context, buffer.data(), output);
   profiling.end("io.regridding.interpolate");
+}
+
+/*!
+ * Get the information about `variable` in `file` needed by read_spatial_record().
+ */
+SpatialVariableInfo spatial_variable_info(const SpatialVariableMetadata &variable,
+                                          const File &file) {
+  SpatialVariableInfo result;
+
+  auto var = file.find_variable(variable.get_name(), variable["standard_name"]);
+
+  result.name            = var.name;
+  result.dimension_types = dimension_types(file, var.name, variable.unit_system());
+  result.units           = file.read_text_attribute(var.name, "units");
+
+  return result;
+}
+
+/*!
+ * Read the part of the record `record` of a variable described by `info` needed to
+ * interpolate it using `interp_context`.
+ *
+ * This function does not use PETSc or UDUNITS, so it can be called by an I/O thread (see
+ * `AsyncWriter`).
+ */
+void read_spatial_record(const File &file, const SpatialVariableInfo &info,
+                         const LocalInterpCtx &interp_context, int record, double *buffer) {
+  try {
+    auto dim_types = info.dimension_types;
+
+    auto start = interp_context.start;
+    start[T_AXIS] = record;
+
+    const auto &count = interp_context.count;
+
+    auto sc = compute_start_and_count(dim_types, start, count);
+
+    auto size = count[X_AXIS] * count[Y_AXIS] * count[Z_AXIS];
+
+    if (transpose(dim_types)) {
+      std::vector<double> tmp(size);
+      file.read_variable(info.name, sc.start, sc.count, tmp.data());
+      transpose(tmp.data(), dim_types, count, buffer);
+    } else {
+      file.read_variable(info.name, sc.start, sc.count, buffer);
+    }
+
+    // Stop with an error message if some values match the _FillValue attribute:
+    check_for_missing_values(file, info.name, 1e-12, buffer, size);
+
+  } catch (RuntimeError &e) {
+    e.add_context("reading variable '%s' from '%s'", info.name.c_str(), file.name().c_str());
+    throw;
+  }
+}
+
+/*!
+ * Interpolate data read by read_spatial_record() and convert to internal units.
+ */
+void interpolate_spatial_record(const SpatialVariableMetadata &variable,
+                                const SpatialVariableInfo &info, const Grid &target_grid,
+                                const LocalInterpCtx &interp_context, const double *buffer,
+                                double *output) {
+  interpolate(target_grid, interp_context, buffer, output);
 
-  // Get the units string from the file and convert the units:
+  // Convert units:
   {
-    std::string input_units    = file.read_text_attribute(var.name, "units");
     std::string internal_units = variable["units"];
 
-    input_units = check_units(variable, input_units, *target_grid.ctx()->log());
+    auto input_units = check_units(variable, info.units, *target_grid.ctx()->log());
 
     const size_t data_size = target_grid.xm() * target_grid.ym() * interp_context.z->n_output();
 
-    // Convert data:
     units::Converter(variable.unit_system(), input_units, internal_units)
         .convert_doubles(output, data_size);
   }
@@ -61,6 +61,27 @@ void regrid_spatial_variable(const SpatialVariableMetadata &variable,
                              const File &file,
                              double *output);
 
+//! Information needed to read records of a spatial variable (see read_spatial_record()).
+struct SpatialVariableInfo {
+  //! name of the variable in the file
+  std::string name;
+  //! types of its dimensions
+  std::vector<AxisType> dimension_types;
+  //! units used in the file
+  std::string units;
+};
+
+SpatialVariableInfo spatial_variable_info(const SpatialVariableMetadata &variable,
+                                          const File &file);
+
+void read_spatial_record(const File &file, const SpatialVariableInfo &info,
+                         const LocalInterpCtx &lic, int record, double *buffer);
+
+void interpolate_spatial_record(const SpatialVariableMetadata &variable,
+                                const SpatialVariableInfo &info, const Grid &grid,
+                                const LocalInterpCtx &lic, const double *buffer,
+                                double *output);
+
 void read_spatial_variable(const SpatialVariableMetadata &variable,
                            const Grid& grid, const File &file,
                            unsigned int time, double *output);
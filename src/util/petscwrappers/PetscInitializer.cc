@@ -22,6 +22,7 @@
 #include <petscsys.h>
 #include <mpi.h>
 #include <cstdio>
+#include <cstring>
 
 #include "pism/util/error_handling.hh"
 
@@ -32,6 +33,26 @@
 namespace pism {
 namespace petsc {
 
+/*!
+ * Returns true if the command line enables asynchronous output (see
+ * `output.async.enabled`) or reading forcing in advance (`input.forcing.prefetch`), which
+ * need MPI_THREAD_MULTIPLE.
+ *
+ * We have to check this before the configuration database is available because the
+ * thread support level has to be requested when MPI is initialized.
+ */
+static bool async_output_requested(int argc, char **argv) {
+  for (int k = 1; k < argc; ++k) {
+    if (strcmp(argv[k], "-output.async.enabled") == 0 or
+        strcmp(argv[k], "-async_output") == 0 or
+        strcmp(argv[k], "-input.forcing.prefetch") == 0 or
+        strcmp(argv[k], "-forcing_prefetch") == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 Initializer::Initializer(int argc, char **argv, const char *help) {
 
   PetscErrorCode ierr = 0;
@@ -41,6 +62,10 @@ Initializer::Initializer(int argc, char **argv, const char *help) {
   PISM_CHK(ierr, "PetscInitialized");
 
   if (initialized == PETSC_FALSE) {
+    if (async_output_requested(argc, argv)) {
+      PETSC_MPI_THREAD_REQUIRED = MPI_THREAD_MULTIPLE;
+    }
+
     ierr = PetscInitialize(&argc, &argv, NULL, help);
     PISM_CHK(ierr, "PetscInitialize");
 
@@ -261,6 +261,10 @@ std::string version() {
   result += pism::printf("Jansson %s.\n", JANSSON_VERSION);
 #endif
 
+#if (Pism_USE_OPENMP==1)
+  result += pism::printf("OpenMP %d.\n", _OPENMP);
+#endif
+
 #if (Pism_BUILD_PYTHON_BINDINGS==1)
   result += pism::printf("SWIG %s.\n", pism::swig_version);
   result += pism::printf("petsc4py %s.\n", pism::petsc4py_version);
@@ -0,0 +1,44 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "pism/util/threading.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/pism_parameters.hh"
+
+namespace pism {
+
+/*!
+ * Number of threads used by for_each_point(), set using `grid.threads`.
+ *
+ * Always 1 if PISM was built without OpenMP.
+ */
+int max_threads(const Config &config) {
+#if (Pism_USE_OPENMP==1)
+  if (config.frozen()) {
+    // this is called often: avoid looking up the parameter by name
+    return config.parameters().grid.threads;
+  }
+  return static_cast<int>(config.get_number("grid.threads"));
+#else
+  (void) config;
+  return 1;
+#endif
+}
+
+} // end of namespace pism
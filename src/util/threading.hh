@@ -0,0 +1,200 @@
+/* Copyright (C) 2026 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PISM_THREADING_H
+#define PISM_THREADING_H
+
+#include "pism/pism_config.hh"  // Pism_USE_OPENMP
+#include "pism/util/Grid.hh"
+#include "pism/util/array/ActiveColumns.hh"
+#include "pism/util/error_handling.hh"
+
+#include <algorithm>            // std::min, std::max
+#include <vector>
+
+#if (Pism_USE_OPENMP==1)
+#include <omp.h>
+#endif
+
+namespace pism {
+
+class Config;
+
+int max_threads(const Config &config);
+
+/*!
+ * Calls `item(n, thread)` for `n = 0, ..., N - 1`, using up to `n_threads` OpenMP
+ * threads. Work items are handed to threads in chunks of `chunk_size` (use 0 to give each
+ * thread one contiguous chunk of about `N / n_threads` items).
+ *
+ * `thread` (`0 <= thread < n_threads`) is the index of the calling thread: use it to
+ * select per-thread scratch storage. Without OpenMP all items are processed by thread 0
+ * in order.
+ *
+ * Exceptions thrown by `item` are reported using `loop.failed()`; each thread stops
+ * processing work items after its first failure. The caller should call `loop.check()`
+ * once this function returns.
+ */
+template <typename F>
+void parallel_for(int N, int chunk_size, int n_threads, ParallelSection &loop, F &&item) {
+#if (Pism_USE_OPENMP==1)
+  n_threads = std::max(n_threads, 1);
+
+  const int chunk = chunk_size > 0 ? chunk_size : std::max((N + n_threads - 1) / n_threads, 1);
+
+#pragma omp parallel num_threads(n_threads)
+  {
+    const int thread = omp_get_thread_num();
+    bool thread_failed = false;
+
+#pragma omp for schedule(dynamic, chunk)
+    for (int n = 0; n < N; ++n) {
+      if (thread_failed) {
+        continue;
+      }
+
+      try {
+        item(n, thread);
+      } catch (...) {
+        loop.failed();
+        thread_failed = true;
+      }
+    }
+  }
+#else
+  (void) chunk_size;
+  (void) n_threads;
+  try {
+    for (int n = 0; n < N; ++n) {
+      item(n, 0);
+    }
+  } catch (...) {
+    loop.failed();
+  }
+#endif
+}
+
+/*!
+ * Calls `body(i, j, thread)` for all grid points in the sub-domain owned by this rank
+ * (including `stencil_width` ghost points), using up to `n_threads` OpenMP threads.
+ *
+ * Without OpenMP all points are processed in the order used by Grid::points().
+ *
+ * `body` may be called by several threads at the same time, so it should only write to
+ * the column `(i, j)` of output arrays and to its per-thread storage.
+ *
+ * See parallel_for() for the meaning of `thread` and the treatment of exceptions.
+ *
+ * Usage:
+ *
+ * ~~~ c++
+ * ParallelSection loop(grid.com);
+ * for_each_point(grid, 0, n_threads, loop, [&](int i, int j, int thread) { ... });
+ * loop.check();
+ * ~~~
+ */
+template <typename F>
+void for_each_point(const Grid &grid, unsigned int stencil_width, int n_threads,
+                    ParallelSection &loop, F &&body) {
+  const int
+    W       = static_cast<int>(stencil_width),
+    i_first = grid.xs() - W,
+    j_first = grid.ys() - W,
+    Nx      = grid.xm() + 2 * W,
+    N       = Nx * (grid.ym() + 2 * W);
+
+  parallel_for(N, 0, n_threads, loop, [&](int n, int thread) {
+    body(i_first + n % Nx, j_first + n / Nx, thread);
+  });
+}
+
+/*!
+ * Calls `body(i_start, i_end, j, thread)` for blocks of up to `block_size` adjacent grid
+ * points `(i_start, j), ..., (i_end - 1, j)` covering the sub-domain owned by this rank
+ * (without ghosts), using up to `n_threads` OpenMP threads.
+ *
+ * Use this instead of for_each_point() to process several columns at once (e.g. using
+ * TridiagonalSystemBatch).
+ *
+ * See parallel_for() for the meaning of `thread` and the treatment of exceptions.
+ */
+template <typename F>
+void for_each_block(const Grid &grid, unsigned int block_size, int n_threads,
+                    ParallelSection &loop, F &&body) {
+  const int
+    B        = static_cast<int>(block_size),
+    xs       = grid.xs(),
+    xm       = grid.xm(),
+    ys       = grid.ys(),
+    n_blocks = (xm + B - 1) / B,
+    N        = n_blocks * grid.ym();
+
+  parallel_for(N, 0, n_threads, loop, [&](int n, int thread) {
+    const int
+      i_start = xs + (n % n_blocks) * B,
+      i_end   = std::min(i_start + B, xs + xm);
+    body(i_start, i_end, ys + n / n_blocks, thread);
+  });
+}
+
+/*!
+ * Calls `body(i, j, thread)` for all columns in `runs` (usually runs of active columns,
+ * see array::CellType::active_columns()), using up to `n_threads` OpenMP threads.
+ *
+ * See parallel_for() for the meaning of `thread` and the treatment of exceptions.
+ */
+template <typename F>
+void for_each_point(const std::vector<array::ColumnRun> &runs, int n_threads,
+                    ParallelSection &loop, F &&body) {
+  // runs have different lengths, so threads take them one at a time
+  parallel_for(static_cast<int>(runs.size()), 1, n_threads, loop, [&](int n, int thread) {
+    const auto &r = runs[n];
+    for (int i = r.i_start; i < r.i_end; ++i) {
+      body(i, r.j, thread);
+    }
+  });
+}
+
+/*!
+ * Calls `body(i_start, i_end, j, thread)` for blocks of up to `block_size` adjacent
+ * columns covering `runs` (see array::CellType::active_columns()), using up to
+ * `n_threads` OpenMP threads.
+ *
+ * See parallel_for() for the meaning of `thread` and the treatment of exceptions.
+ */
+template <typename F>
+void for_each_block(const std::vector<array::ColumnRun> &runs, unsigned int block_size,
+                    int n_threads, ParallelSection &loop, F &&body) {
+  const int B = static_cast<int>(block_size);
+
+  std::vector<array::ColumnRun> blocks;
+  for (const auto &r : runs) {
+    for (int i = r.i_start; i < r.i_end; i += B) {
+      blocks.push_back({ r.j, i, std::min(i + B, r.i_end) });
+    }
+  }
+
+  parallel_for(static_cast<int>(blocks.size()), 0, n_threads, loop, [&](int n, int thread) {
+    body(blocks[n].i_start, blocks[n].i_end, blocks[n].j, thread);
+  });
+}
+
+} // end of namespace pism
+
+#endif /* PISM_THREADING_H */
@@ -550,8 +550,8 @@ class TestCFBC(TestCase):
 
         return exact
 
-    def error_norm(self, N):
-        "Return the infinity norm of errors for the u component."
+    def compute(self, N):
+        "Run the solver and return the model and the geometry it used."
         geometry, enthalpy, yield_stress = self.inputs(N)
 
         grid = enthalpy.grid()
@@ -572,6 +572,14 @@ class TestCFBC(TestCase):
         # run the solver
         model.update(inputs, True)
 
+        return model, geometry
+
+    def error_norm(self, N):
+        "Return the infinity norm of errors for the u component."
+        model, geometry = self.compute(N)
+
+        grid = model.grid()
+
         u_model_z = model.velocity_u_sigma().levels()
 
         u_model = PISM.Array3D(grid, "u_model", PISM.WITHOUT_GHOSTS, u_model_z)
@@ -956,3 +964,43 @@ if __name__ == "__main__":
                  TestXZvanderVeen(),
                  TestXZHalfar()]:
         test.plot()
+
+class TestMatrixFreeJacobian(TestCase):
+    """Check that the matrix-free Jacobian (its action and its diagonal) matches the
+    assembled one.
+
+    Uses the XZ-CFBC and XZ-Halfar setups: both override jacobian_basal().
+    """
+    def setUp(self):
+        config.set_string("stress_balance.blatter.jacobian", "matrix_free_operator")
+
+    def tearDown(self):
+        config.import_from(config_clean)
+
+    def check(self, model):
+        mult, diagonal = model.jacobian_difference()
+
+        print("Relative differences: J*w: {}, diagonal: {}".format(mult, diagonal))
+
+        assert mult < 1e-10
+        assert diagonal < 1e-10
+
+    def test_cfbc(self):
+        "Matrix-free Jacobian: XZ-CFBC"
+        case = TestCFBC("test")
+        case.setUp()
+        try:
+            model, _ = case.compute(11)
+            self.check(model)
+        finally:
+            case.tearDown()
+
+    def test_halfar(self):
+        "Matrix-free Jacobian: XZ-Halfar"
+        case = TestXZHalfar("test")
+        case.setUp()
+        try:
+            model = case.compute(case.grid_center(51), 5, 2)
+            self.check(model)
+        finally:
+            case.tearDown()
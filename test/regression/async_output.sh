@@ -0,0 +1,62 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+echo "Test: asynchronous output produces the same files as synchronous output."
+files="sync.nc async.nc sync_ex.nc async_ex.nc sync_snap.nc async_snap.nc async.log
+       sync_cp.nc async_cp.nc sync_cp.nc~ async_cp.nc~ sync_cp_out.nc async_cp_out.nc"
+
+rm -f $files
+
+set -e -x
+
+options="-eisII A -Mx 31 -My 31 -Mz 31 -Lz 5000 -y 3000 -energy enthalpy \
+         -extra_times 0:500:3000 -extra_vars thk,temppabase,velsurf_mag,tendency_of_ice_mass \
+         -save_times 1000:1000:3000"
+
+# Write all output synchronously:
+$MPIEXEC -n 3 $PISM_PATH/pism $options -verbose 1 \
+         -o sync.nc -extra_file sync_ex.nc -save_file sync_snap.nc
+
+# Write snapshots and spatial time-series asynchronously, using the smallest allowed memory
+# budget:
+$MPIEXEC -n 3 $PISM_PATH/pism $options -verbose 2 \
+         -o async.nc -extra_file async_ex.nc -save_file async_snap.nc \
+         -async_output -output.async.memory_budget 1 > async.log
+
+set +e +x
+
+# Make sure that the second run did not fall back to synchronous output. (The message
+# below matches the SKIP_REGULAR_EXPRESSION of this test.)
+if grep -q "requires MPI_THREAD_MULTIPLE" async.log; then
+  echo "SKIPPED: asynchronous output requires MPI_THREAD_MULTIPLE support"
+  rm -f $files; exit 1
+fi
+
+if ! grep -q "checkpoints asynchronously" async.log; then
+  echo "FAILED: asynchronous output was not enabled"
+  cat async.log
+  rm -f $files; exit 1
+fi
+
+set -e -x
+
+# Write a checkpoint after every time step. (Checkpoints are triggered by wall-clock time,
+# so this is the only way to make the last checkpoint reproducible.)
+cp_options="-eisII A -Mx 31 -My 31 -Mz 31 -Lz 5000 -y 100 -energy enthalpy -verbose 1 \
+            -checkpoint_interval 0 -checkpoint_size medium"
+
+$MPIEXEC -n 3 $PISM_PATH/pism $cp_options -o sync_cp_out.nc -output.checkpoint.file sync_cp.nc
+
+$MPIEXEC -n 3 $PISM_PATH/pism $cp_options -o async_cp_out.nc -output.checkpoint.file async_cp.nc \
+         -async_output -output.async.memory_budget 1
+
+set +e
+
+# Compare:
+$PISM_PATH/pism_nccmp -x -v timestamp sync_ex.nc async_ex.nc || exit 1
+$PISM_PATH/pism_nccmp -x -v timestamp sync_snap.nc async_snap.nc || exit 1
+$PISM_PATH/pism_nccmp -x -v timestamp sync_cp.nc async_cp.nc || exit 1
+
+rm -f $files; exit 0
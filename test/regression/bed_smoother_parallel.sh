@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# Checks that the bed smoother (used by the SIA solver) produces the same smoothed bed and
+# coefficients of the bed roughness parameterization regardless of the number of MPI
+# processes. Uses a smoothing range that is wider than the sub-domain owned by a process,
+# so that the patch of the bed needed by a process extends beyond its neighbors.
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+if [ $# -ge 4 ] && [ "$4" == "-python" ]
+then
+  PYTHONEXEC=$5
+  export PYTHONPATH=${PISM_PATH}/site-packages:${PYTHONPATH}
+else
+  exit 1
+fi
+
+script=${PISM_SOURCE_DIR}/test/bed_smoother.py
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-test-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+# Make sure PISM can find the configuration file
+echo "
+-config ${PISM_PATH}/pism_config.nc
+" > .petscrc
+
+set -e
+set -u
+set -x
+
+# 81*81 grid, 15 km grid spacing: the smoothing range of 400 km corresponds to 27 grid
+# points, while sub-domains are 20 or 21 grid points wide
+options="-stress_balance.sia.bed_smoother.range 400e3"
+
+for N in 1 2 4;
+do
+  mkdir -p run-$N
+  (cd run-$N && cp ../.petscrc . && \
+     $MPIEXEC -n $N ${PYTHONEXEC} ${script} ${options} -grid.Nx $N -grid.Ny 1)
+done
+
+for N in 2 4;
+do
+  for field in topg_smoothed theta;
+  do
+    $PISM_PATH/pism_nccmp run-1/bed_smoother_${field}.nc run-$N/bed_smoother_${field}.nc
+  done
+done
@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+
+""" Sets up and runs the Lingle-Clark bed deformation model using serial and distributed
+implementations.
+
+Compares viscous, elastic and total displacements after bootstrapping and after two time
+steps.
+
+Used as a regression test for PISM.LingleClark with bed_deformation.lc.parallel set and
+for the load response matrix cache (bed_deformation.lc.lrm_cache_directory). See also
+beddef_lc_parallel.sh, which runs these tests on several MPI processes.
+"""
+
+import PISM
+from PISM.util import convert
+import numpy as np
+
+ctx = PISM.Context()
+
+# silence initialization messages
+ctx.log.set_threshold(1)
+
+# disc load parameters
+disc_radius = convert(1000, "km", "m")
+disc_thickness = 1000.0         # meters
+# domain size
+Lx = 2 * disc_radius
+Ly = Lx
+Mx = 31
+My = 2 * Mx - 1                 # non-square grid
+
+dt = convert(1000.0, "years", "seconds")
+
+def add_disc_load(ice_thickness, radius, thickness):
+    "Add a disc load with a given radius and thickness."
+    grid = ice_thickness.grid()
+
+    with PISM.vec.Access(nocomm=ice_thickness):
+        for (i, j) in grid.points():
+            r = PISM.radius(grid, i, j)
+            if r <= radius:
+                ice_thickness[i, j] = thickness
+
+def compare(a, b):
+    "Compare results of two runs. Results are available on rank 0 only."
+    if a is not None:
+        np.testing.assert_allclose(a, b, rtol=1e-10, atol=1e-8)
+
+def run(parallel):
+    "Bootstrap the model and take two time steps."
+
+    ctx.config.set_flag("bed_deformation.lc.parallel", parallel)
+
+    grid = PISM.Grid.Shallow(ctx.ctx, Lx, Ly, 0, 0, Mx, My,
+                             PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+    model = PISM.LingleClark(grid)
+
+    geometry = PISM.Geometry(grid)
+
+    bed_uplift = PISM.Scalar(grid, "uplift")
+
+    # start with a flat bed, a disc load, and non-zero uplift
+    geometry.bed_elevation.set(0.0)
+    geometry.ice_thickness.set(0.0)
+    geometry.sea_level_elevation.set(-1000.0)
+    add_disc_load(geometry.ice_thickness, 0.5 * disc_radius, disc_thickness)
+    geometry.ensure_consistency(0.0)
+
+    bed_uplift.set(convert(-1.0, "mm / year", "m / s"))
+
+    model.bootstrap(geometry.bed_elevation, bed_uplift, geometry.ice_thickness,
+                    geometry.sea_level_elevation)
+
+    result = [model.total_displacement().to_numpy()]
+
+    # add the disc load
+    add_disc_load(geometry.ice_thickness, disc_radius, disc_thickness)
+
+    for k in range(2):
+        model.step(geometry.ice_thickness, dt)
+
+    result += [model.viscous_displacement().to_numpy(),
+               model.elastic_displacement().to_numpy(),
+               model.total_displacement().to_numpy(),
+               model.elastic_load_response_matrix().to_numpy()]
+
+    return result
+
+def lingle_clark_parallel_test():
+    "Compare serial and distributed implementations of the Lingle-Clark model."
+    parallel = ctx.config.get_flag("bed_deformation.lc.parallel")
+    size_factor = ctx.config.get_number("bed_deformation.lc.grid_size_factor")
+    try:
+        ctx.config.set_number("bed_deformation.lc.grid_size_factor", 2)
+
+        serial = run(parallel=False)
+        distributed = run(parallel=True)
+
+        for a, b in zip(serial, distributed):
+            compare(a, b)
+    finally:
+        ctx.config.set_flag("bed_deformation.lc.parallel", parallel)
+        ctx.config.set_number("bed_deformation.lc.grid_size_factor", size_factor)
+
+def lingle_clark_lrm_cache_test(directory=None):
+    """Check that cached load response matrices match re-computed ones.
+
+    `directory` has to be empty and shared by all MPI processes. If it is not set, a
+    temporary directory is used (single-process runs only).
+    """
+    import glob
+    import os
+    import tempfile
+
+    def cached_files(directory):
+        "Cache files in 'directory' with their inode numbers and modification times."
+        result = {}
+        for f in glob.glob(os.path.join(directory, "pism_lc_lrm_*.bin")):
+            info = os.stat(f)
+            result[f] = (info.st_ino, info.st_mtime_ns)
+        return result
+
+    def check(directory):
+        ctx.config.set_string("bed_deformation.lc.lrm_cache_directory", directory)
+
+        # the first run saves the matrix, the rest use the cached copy
+        computed = run(parallel=False)[-1]
+
+        saved = cached_files(directory)
+        assert len(saved) == 1, "the load response matrix was not saved"
+
+        for p in [False, True]:
+            cached = run(parallel=p)[-1]
+            # a cache miss would replace the cache file
+            assert cached_files(directory) == saved, "load response matrix cache miss"
+            compare(computed, cached)
+
+    parallel = ctx.config.get_flag("bed_deformation.lc.parallel")
+    cache_directory = ctx.config.get_string("bed_deformation.lc.lrm_cache_directory")
+    try:
+        if directory is None:
+            with tempfile.TemporaryDirectory() as tmp:
+                check(tmp)
+        else:
+            check(directory)
+    finally:
+        ctx.config.set_flag("bed_deformation.lc.parallel", parallel)
+        ctx.config.set_string("bed_deformation.lc.lrm_cache_directory", cache_directory)
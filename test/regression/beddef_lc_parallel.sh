@@ -0,0 +1,41 @@
+#!/bin/bash
+
+# Compares serial and distributed implementations of the Lingle-Clark bed deformation
+# model and checks the load response matrix cache on several MPI processes. (The nose test
+# bed_deformation:LC:parallel runs the same comparisons on one process only.)
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+if [ $# -ge 4 ] && [ "$4" == "-python" ]
+then
+  PYTHONEXEC=$5
+  export PYTHONPATH=${PISM_PATH}/site-packages:${PISM_SOURCE_DIR}/test/regression:${PYTHONPATH}
+else
+  exit 1
+fi
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-test-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+# Make sure PISM can find the configuration file
+echo "
+-config ${PISM_PATH}/pism_config.nc
+" > .petscrc
+
+set -e
+set -u
+set -x
+
+for N in 2 3;
+do
+  # the cache directory has to be shared by all processes
+  mkdir -p lrm-cache-$N
+  $MPIEXEC -n $N ${PYTHONEXEC} -c \
+           "import beddef_lc_parallel as t; \
+            t.lingle_clark_parallel_test(); \
+            t.lingle_clark_lrm_cache_test('lrm-cache-$N')"
+done
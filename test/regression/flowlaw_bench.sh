@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Checks that batched and scalar implementations of ice flow laws agree (see
+# src/rheology/flowlaw_bench.cc).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+set -e -x
+
+# Glen exponent n = 3 uses a specialized code path
+$PISM_PATH/pism_flowlaw_bench -repeat 10 -max_ulps 32
+
+# the general case
+$PISM_PATH/pism_flowlaw_bench -repeat 10 -max_ulps 32 -sia_n 4
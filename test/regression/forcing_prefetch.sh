@@ -0,0 +1,31 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+echo "Test: reading forcing in advance does not change results."
+files="input.nc forcing.nc sync.nc prefetch.nc"
+
+rm -f $files
+
+set -e -x
+
+# Create the initial state and a file containing 30 records of climate forcing:
+$MPIEXEC -n 2 $PISM_PATH/pism -eisII A -Mx 31 -My 31 -Mz 31 -Lz 5000 -y 3000 -verbose 1 \
+         -o input.nc -extra_file forcing.nc -extra_times 100:100:3000 \
+         -extra_vars climatic_mass_balance,ice_surface_temp
+
+# Use a small buffer to make sure that it is refilled many times:
+options="-i input.nc -surface given -surface_given_file forcing.nc -ys 500 -ye 2500 \
+         -input.forcing.buffer_size 4 -verbose 1"
+
+$MPIEXEC -n 3 $PISM_PATH/pism $options -o sync.nc
+
+$MPIEXEC -n 3 $PISM_PATH/pism $options -o prefetch.nc -forcing_prefetch
+
+set +e
+
+# Compare:
+$PISM_PATH/pism_nccmp -x -v timestamp sync.nc prefetch.nc || exit 1
+
+rm -f $files; exit 0
@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# Checks that updating ghosts of several arrays as a group gives the same results as
+# updating them one at a time (see src/util/array/ghost_update_bench.cc).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+set -e -x
+
+for N in 1 2 3 4 6; do
+  $MPIEXEC -n $N $PISM_PATH/pism_ghost_update_bench -Mx 61 -My 47 -Mz 5 -repeat 2
+done
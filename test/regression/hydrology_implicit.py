@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Compare explicit and implicit time stepping in the distributed and routing hydrology
+models using the setup of test_29.py (Test P)."""
+
+import subprocess
+import shutil
+import shlex
+import os
+import re
+import time
+from sys import exit
+from netCDF4 import Dataset as NC
+import numpy as np
+
+
+def process_arguments():
+    from argparse import ArgumentParser
+    parser = ArgumentParser()
+    parser.add_argument("PISM_PATH")
+    parser.add_argument("MPIEXEC")
+    parser.add_argument("PISM_SOURCE_DIR")
+
+    return parser.parse_args()
+
+
+def copy_input(opts):
+    shutil.copy(os.path.join(opts.PISM_SOURCE_DIR, "test/test_hydrology/inputforP_regression.nc"), ".")
+
+
+def generate_config():
+    """Generates the config file with custom ice softness and hydraulic conductivity."""
+
+    nc = NC("testPconfig.nc", 'w')
+    pism_overrides = nc.createVariable("pism_overrides", 'b')
+
+    attrs = {
+        "constants.standard_gravity": 9.81,
+        "constants.fresh_water.density": 1000.0,
+        "flow_law.isothermal_Glen.ice_softness": 3.1689e-24,
+        "hydrology.hydraulic_conductivity": 1.0e-2 / (1000.0 * 9.81),
+        "hydrology.tillwat_max": 0.0,
+        "hydrology.thickness_power_in_flux": 1.0,
+        "hydrology.gradient_power_in_flux": 2.0,
+        "hydrology.roughness_scale": 1.0,
+        "hydrology.regularizing_porosity": 0.01,
+        "basal_yield_stress.model": "constant",
+        "basal_yield_stress.constant.value": 1e6,
+    }
+
+    for k, v in list(attrs.items()):
+        pism_overrides.setncattr(k, v)
+
+    nc.close()
+
+
+def run_pism(opts, model, method, output):
+    cmd = ("{pism_path}/pism -config_override testPconfig.nc -i inputforP_regression.nc -bootstrap"
+           " -Mx 21 -My 21 -Mz 11 -Lz 4000 -hydrology {model} -y 0.08333333333333 -max_dt 0.01"
+           " -no_mass -energy none -stress_balance ssa+sia -ssa_dirichlet_bc"
+           " -hydrology_time_stepping {method} -o {output} -verbose 2").format(pism_path=opts.PISM_PATH,
+                                                                               model=model,
+                                                                               method=method,
+                                                                               output=output)
+    print(cmd)
+
+    start = time.time()
+    log = subprocess.run(shlex.split(cmd), check=True, stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    wall_time = time.time() - start
+
+    steps = sum(int(n) for n in re.findall(r"took (\d+) hydrology sub-steps", log))
+
+    print("{} ({}): {} hydrology steps, {:.2f} seconds".format(model, method, steps, wall_time))
+    for line in log.split("\n"):
+        if "implicit hydrology steps" in line or "Picard" in line:
+            print(line)
+
+    return steps
+
+
+def compare(file1, file2, variables):
+    nc1 = NC(file1)
+    nc2 = NC(file2)
+
+    for name, tolerance in variables:
+        var1 = np.squeeze(nc1.variables[name][:])
+        var2 = np.squeeze(nc2.variables[name][:])
+
+        # relative to the maximum of the explicit solution
+        diff = np.max(np.abs(var1 - var2)) / np.max(np.abs(var1))
+        print("{}: relative difference {}".format(name, diff))
+
+        if diff > tolerance:
+            print("Explicit and implicit results differ too much: {} > {}".format(diff, tolerance))
+            exit(1)
+
+    nc1.close()
+    nc2.close()
+
+
+def cleanup():
+    for fname in ("inputforP_regression.nc", "testPconfig.nc", "explicit.nc", "implicit.nc"):
+        os.remove(fname)
+
+
+if __name__ == "__main__":
+    opts = process_arguments()
+
+    copy_input(opts)
+    generate_config()
+
+    # the routing model does not have the water pressure as a state variable
+    for model, variables in (("distributed", (("bwat", 0.05), ("bwp", 0.05))),
+                             ("routing", (("bwat", 0.05),))):
+        explicit_steps = run_pism(opts, model, "explicit", "explicit.nc")
+        implicit_steps = run_pism(opts, model, "implicit", "implicit.nc")
+
+        if implicit_steps >= explicit_steps:
+            print("{}: implicit time stepping did not reduce the number of steps: {} >= {}".format(model,
+                                                                                                  implicit_steps,
+                                                                                                  explicit_steps))
+            exit(1)
+
+        compare("explicit.nc", "implicit.nc", variables)
+
+    cleanup()
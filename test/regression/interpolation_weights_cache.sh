@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# Checks that interpolation weights cached by one run are re-used by the next one (using a
+# different number of processes) and give the same results.
+
+set -e
+set -u
+set -x
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+pism=${PISM_PATH}/pism
+
+input=${PISM_SOURCE_DIR}/test/regression/pico_split/bedmap2_schmidtko14_50km.nc
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-interpolation-cache-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+mkdir cache
+
+# Use a grid that differs from the one in ${input} to make sure that inputs are interpolated.
+common_options="
+-config ${PISM_PATH}/pism_config.nc
+-atmosphere uniform
+-bootstrap
+-energy none
+-i ${input}
+-Mx 97 -My 97
+-no_mass
+-regrid_file ${input}
+-regrid_vars topg
+-stress_balance none
+-surface simple
+-y 1s
+"
+
+# no cache
+${pism} ${common_options} -o reference.nc
+
+# cache miss
+${MPIEXEC} -n 1 ${pism} ${common_options} -interpolation_cache cache -o miss.nc > miss.log
+grep "interpolation weights cache miss" miss.log
+grep "(saved)" miss.log
+
+# cache hit
+${MPIEXEC} -n 2 ${pism} ${common_options} -interpolation_cache cache -o hit.nc > hit.log
+grep "interpolation weights cache hit" hit.log
+
+${PISM_PATH}/pism_nccmp -v topg reference.nc miss.nc
+# results may differ by round-off because the number of processes is different
+${PISM_PATH}/pism_nccmp -t 1e-6 -v topg reference.nc hit.nc
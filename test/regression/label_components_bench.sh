@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Checks that serial, graph-based and union-find implementations of connected component
+# labeling agree (see src/util/connected_components/label_components_bench.cc).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+set -e -x
+
+# a fraction of foreground cells below, near and above the percolation threshold
+for fraction in 0.3 0.58 0.7; do
+  for N in 1 3 4; do
+    $MPIEXEC -n $N $PISM_PATH/pism_label_components_bench -Mx 203 -My 157 -repeat 1 \
+             -fraction $fraction
+  done
+done
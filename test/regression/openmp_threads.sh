@@ -0,0 +1,33 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+echo "Test: PISM results do not depend on the number of OpenMP threads (EISMINT II experiment A)."
+files="threads1.nc threads2.nc threads3.nc"
+
+set -e -x
+
+TRANGE="1 2 3"
+
+# Create the files (energy balance, age and SIA use threads):
+for T in $TRANGE;
+do
+    $MPIEXEC -n 2 $PISM_PATH/pism -eisII A -Mx 31 -My 31 -Mz 31 -Lz 5000 -y 3000 \
+             -energy enthalpy -age -o_size big -verbose 1 \
+             -threads $T -o threads$T.nc
+done
+
+set +e
+
+# Compare:
+for T in $TRANGE;
+do
+    $PISM_PATH/pism_nccmp -x -v timestamp threads1.nc threads$T.nc
+    if [ $? != 0 ];
+    then
+        exit 1
+    fi
+done
+
+rm -f $files; exit 0
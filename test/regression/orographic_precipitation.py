@@ -115,8 +115,13 @@ def run_model(grid, orography):
     config = PISM.Context().config
     water_density = config.get_number("constants.fresh_water.density")
 
+    # precipitation is gathered on rank 0; other ranks get None
+    P = model.precipitation().to_numpy()
+    if P is None:
+        return None
+
     # convert from kg / (m^2 s) to mm/s
-    return model.precipitation().to_numpy() / (1e-3 * water_density)
+    return P / (1e-3 * water_density)
 
 def max_error(spacing, wind_direction, flowline=True):
     """Compute the maximum error given a grid spacing and wind direction.
@@ -224,6 +229,66 @@ def ltop_flowline_test(dxs=[2000, 1000, 500], plot=False):
 
     check(flowline=True, dxs=dxs, plot=plot)
 
+def ltop_parallel_test():
+    """Orographic precipitation: compare serial and distributed implementations
+
+    Also used by orographic_precipitation_parallel.sh to run this comparison on several
+    MPI processes.
+    """
+    import tempfile
+
+    def compare(a, b):
+        # results are available on rank 0 only
+        if a is not None:
+            np.testing.assert_allclose(a, b, rtol=1e-10, atol=1e-12)
+
+    config = PISM.Context().config
+
+    parallel = config.get_flag("atmosphere.orographic_precipitation.parallel")
+    sigma = config.get_number("atmosphere.orographic_precipitation.smoothing_standard_deviation")
+    wisdom_file = config.get_string("atmosphere.orographic_precipitation.fftw_wisdom_file")
+    try:
+        # use a non-square grid, a wind direction that is not aligned with grid axes and
+        # enable smoothing to exercise all parts of the model
+        config.set_number("atmosphere.orographic_precipitation.wind_direction", 30.0)
+        config.set_number("atmosphere.orographic_precipitation.smoothing_standard_deviation", 4e3)
+
+        grid = grid_square(dx=4e3, dy=5e3)
+        x = np.array(grid.x())
+        y = np.array(grid.y())
+        orography = triangle_ridge(np.sqrt(x[np.newaxis, :]**2 + y[:, np.newaxis]**2))
+
+        config.set_flag("atmosphere.orographic_precipitation.parallel", False)
+        serial = run_model(grid, orography)
+
+        config.set_flag("atmosphere.orographic_precipitation.parallel", True)
+        distributed = run_model(grid, orography)
+
+        compare(serial, distributed)
+
+        # the first run saves FFTW wisdom, the second one uses it
+        with tempfile.TemporaryDirectory() as directory:
+            config.set_string("atmosphere.orographic_precipitation.fftw_wisdom_file",
+                              directory + "/wisdom.txt")
+            for k in range(2):
+                P = run_model(grid, orography)
+                compare(serial, P)
+    finally:
+        config.set_flag("atmosphere.orographic_precipitation.parallel", parallel)
+        config.set_number("atmosphere.orographic_precipitation.smoothing_standard_deviation", sigma)
+        config.set_string("atmosphere.orographic_precipitation.fftw_wisdom_file", wisdom_file)
+
+def ltop_parallel_flowline_test(dxs=[2000, 1000, 500]):
+    "Orographic precipitation (triangle ridge test case) (flow-line, distributed)"
+
+    config = PISM.Context().config
+    parallel = config.get_flag("atmosphere.orographic_precipitation.parallel")
+    try:
+        config.set_flag("atmosphere.orographic_precipitation.parallel", True)
+        check(flowline=True, dxs=dxs, plot=False)
+    finally:
+        config.set_flag("atmosphere.orographic_precipitation.parallel", parallel)
+
 if __name__ == "__main__":
     ltop_test(dxs=[2000, 1000, 500, 250, 125], plot=True)
     ltop_flowline_test(dxs=[4000, 2000, 1000, 500, 250, 125, 62.5], plot=True)
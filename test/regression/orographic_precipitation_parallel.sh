@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Compares serial and distributed implementations of the orographic precipitation (LTOP)
+# model on several MPI processes. (The nose test atmosphere:LTOP runs the same comparison
+# on one process only.)
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+if [ $# -ge 4 ] && [ "$4" == "-python" ]
+then
+  PYTHONEXEC=$5
+  export PYTHONPATH=${PISM_PATH}/site-packages:${PISM_SOURCE_DIR}/test/regression:${PYTHONPATH}
+else
+  exit 1
+fi
+
+# create a temporary directory and set up automatic cleanup
+temp_dir=$(mktemp -d --tmpdir pism-test-XXXX)
+trap 'rm -rf "$temp_dir"' EXIT
+cd $temp_dir
+
+# Make sure PISM can find the configuration file
+echo "
+-config ${PISM_PATH}/pism_config.nc
+" > .petscrc
+
+set -e
+set -u
+set -x
+
+for N in 2 3;
+do
+  $MPIEXEC -n $N ${PYTHONEXEC} -c \
+           "import orographic_precipitation as t; t.ltop_parallel_test()"
+done
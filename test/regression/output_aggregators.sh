@@ -0,0 +1,34 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+echo "Test: output written by a subset of MPI processes is the same as the regular output."
+files="o0.nc o1.nc o2.nc ex0.nc ex1.nc ex2.nc"
+
+rm -f $files
+
+set -e -x
+
+options="-eisII A -Mx 31 -My 31 -Mz 31 -Lz 5000 -y 3000 -energy enthalpy -verbose 1 \
+         -extra_times 0:500:3000 -extra_vars thk,temppabase,velsurf_mag,tendency_of_ice_mass"
+
+# All processes take part in the output:
+$MPIEXEC -n 3 $PISM_PATH/pism $options -o o0.nc -extra_file ex0.nc
+
+# One process writes everything:
+$MPIEXEC -n 3 $PISM_PATH/pism $options -o o1.nc -extra_file ex1.nc -output.aggregators 1
+
+# Two processes (one writing its own data, another writing data from two processes):
+$MPIEXEC -n 3 $PISM_PATH/pism $options -o o2.nc -extra_file ex2.nc -output.aggregators 2
+
+set +e
+
+# Compare:
+for n in 1 2;
+do
+  $PISM_PATH/pism_nccmp -x -v timestamp o0.nc o${n}.nc || exit 1
+  $PISM_PATH/pism_nccmp -x -v timestamp ex0.nc ex${n}.nc || exit 1
+done
+
+rm -f $files; exit 0
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Compares batched and scalar implementations of the PDD model (see
+# src/coupler/surface/pdd_bench.cc).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+set -e -x
+
+# the tabulated Calov-Greve integrand has to be within its error bound
+$PISM_PATH/pism_pdd_bench -n 1000 -repeat 2
+
+# ... including with a partially filled last batch and a coarse table
+$PISM_PATH/pism_pdd_bench -n 1001 -repeat 2 -surface.pdd.batch_size 7 \
+                          -surface.pdd.calov_greve_max_error 1e-4
+
+# with the integrand evaluated exactly results have to be identical
+$PISM_PATH/pism_pdd_bench -n 1000 -repeat 2 -surface.pdd.calov_greve_max_error 0
@@ -0,0 +1,17 @@
+#!/bin/bash
+
+# Checks that the sweep-based and BFS-based implementations of the distance computation
+# used by PICO agree (see src/coupler/ocean/eikonal_bench.cc) using the geometry from the
+# PICO split-and-merge test.
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+set -e -x
+
+input_file=${PISM_SOURCE_DIR}/test/regression/pico_split/bedmap2_schmidtko14_50km.nc
+
+for N in 1 2 4 7; do
+  $MPIEXEC -n $N $PISM_PATH/pism_eikonal_bench -i $input_file -repeat 1
+done
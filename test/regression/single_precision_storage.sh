@@ -0,0 +1,45 @@
+#!/bin/bash
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+echo "Test: storing 3D fields in single precision between uses changes results very little."
+files="double.nc single.nc single.log"
+
+rm -f $files
+
+grid="-Mx 31 -My 31 -Mz 101 -Lz 5000"
+
+# Setups: EISMINT II experiments A and B (warmer surface), and experiment A using the
+# SSA+SIA hybrid (the 3D velocity includes sliding).
+setups=("-eisII A"
+        "-eisII B"
+        "-eisII A -stress_balance ssa+sia -ssa_method fd -yield_stress constant -tauc 1e5 -pseudo_plastic")
+
+for setup in "${setups[@]}";
+do
+  options="$setup $grid -y 3000 -energy enthalpy -age -o_size big"
+
+  set -e -x
+
+  # Double precision (the baseline):
+  $MPIEXEC -n 2 $PISM_PATH/pism $options -verbose 1 -o double.nc
+
+  # Single precision storage of all supported 3D fields; -verbose 3 reports memory use:
+  $MPIEXEC -n 2 $PISM_PATH/pism $options -verbose 3 -o single.nc \
+           -single_precision_fields enthalpy,age,velocity,strain_heating > single.log
+
+  set +e +x
+
+  if ! grep -A1 "3D fields stored in single precision" single.log | grep "peak"; then
+    echo "FAILED: memory use was not reported"
+    cat single.log
+    exit 1
+  fi
+
+  # Compare (prints relative differences):
+  $PISM_PATH/pism_nccmp -r -t 1e-4 -v thk,enthalpy,temp,age,uvel,vvel,wvel_rel,velsurf_mag \
+                        double.nc single.nc || exit 1
+done
+
+rm -f $files; exit 0
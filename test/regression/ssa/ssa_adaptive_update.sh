@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Adaptive stress balance update: check that SSA solves are skipped and that results
+# match a run solving the SSA at every time step.
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+files="ssa-adaptive-ref.nc ssa-adaptive.nc ssa-adaptive.log"
+
+rm -f $files
+
+set -e
+set -x
+
+OPTS="-eisII A -Mx 31 -My 31 -Mz 11 -Lz 5000 -y 200 -energy none \
+      -stress_balance ssa+sia -ssa_method fd -yield_stress constant -tauc 1e5 -pseudo_plastic"
+
+$MPIEXEC_COMMAND $PISM_PATH/pism $OPTS -verbose 1 -o ssa-adaptive-ref.nc
+
+$MPIEXEC_COMMAND $PISM_PATH/pism $OPTS -verbose 2 -o ssa-adaptive.nc \
+                 -stress_balance_adaptive_update \
+                 -stress_balance.adaptive_update.relative_residual 1e-2 \
+                 -stress_balance.adaptive_update.max_skipped 5 > ssa-adaptive.log
+
+set +e +x
+
+skipped=$(grep -c "SSA: skipped" ssa-adaptive.log)
+solved=$(grep -c "SSA:.*outer iterations" ssa-adaptive.log)
+
+echo "SSA solves: ${solved} solved, ${skipped} skipped"
+
+if [ "$skipped" -eq 0 ] || [ "$solved" -eq 0 ]; then
+  echo "FAILED: expected both skipped and completed SSA solves"
+  cat ssa-adaptive.log
+  exit 1
+fi
+
+# Ice thickness should stay close to the one computed solving the SSA at every step:
+$PISM_PATH/pism_nccmp -t 1.0 -v thk ssa-adaptive-ref.nc ssa-adaptive.nc || exit 1
+
+rm -f $files; exit 0
@@ -0,0 +1,61 @@
+#!/bin/bash
+
+# Extrapolation of SSA initial guesses in time: check that predicted initial guesses are
+# accepted, that they reduce the total number of Picard iterations and that results match
+# a run without extrapolation.
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+reference=`mktemp pism-ssa-extrap-ref.XXXX` || exit 1
+predicted=`mktemp pism-ssa-extrap-pred.XXXX` || exit 1
+reference_log=`mktemp pism-ssa-extrap-ref-log.XXXX` || exit 1
+predicted_log=`mktemp pism-ssa-extrap-pred-log.XXXX` || exit 1
+
+set -e
+set -x
+
+OPTS="-eisII A -Mx 31 -My 31 -Mz 11 -Lz 5000 -y 200 -energy none \
+      -stress_balance ssa+sia -ssa_method fd -yield_stress constant -tauc 1e5 -pseudo_plastic"
+
+# -verbose 2 prints the SSA summary after each solve
+$MPIEXEC_COMMAND $PISM_PATH/pism $OPTS -verbose 2 -o ${reference} > ${reference_log}
+
+$MPIEXEC_COMMAND $PISM_PATH/pism $OPTS -verbose 2 -o ${predicted} \
+                 -stress_balance_extrapolation quadratic > ${predicted_log}
+
+set +e +x
+
+# Total number of Picard iterations in a run:
+picard() {
+  grep -o "[0-9]\+ outer iterations" $1 | awk '{ total += $1 } END { print total + 0 }'
+}
+
+outer_reference=$(picard ${reference_log})
+outer=$(picard ${predicted_log})
+
+# The last SSA summary line reports cumulative counts:
+counts=$(grep -o "[0-9]* of [0-9]* predicted guesses accepted" ${predicted_log} | tail -1)
+accepted=$(echo $counts | cut -d" " -f1)
+n_predicted=$(echo $counts | cut -d" " -f3)
+
+echo "Predicted initial guesses: ${accepted:-none} of ${n_predicted:-none} accepted;" \
+     "Picard iterations: ${outer} (${outer_reference} without extrapolation)"
+
+if [ -z "$n_predicted" ] || [ "$n_predicted" -eq 0 ] || [ "$accepted" -eq 0 ]; then
+  echo "FAILED: predicted initial guesses were not used"
+  cat ${predicted_log}
+  exit 1
+fi
+
+if [ "$outer_reference" -eq 0 ] || [ "$outer" -ge "$outer_reference" ]; then
+  echo "FAILED: extrapolation did not reduce the number of Picard iterations"
+  cat ${reference_log} ${predicted_log}
+  exit 1
+fi
+
+# Ice thickness should match the run without extrapolation up to solver tolerances:
+$PISM_PATH/pism_nccmp -t 0.1 -v thk ${reference} ${predicted} || exit 1
+
+rm -f ${reference} ${predicted} ${reference_log} ${predicted_log}; exit 0
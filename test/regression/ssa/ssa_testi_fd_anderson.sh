@@ -0,0 +1,75 @@
+#!/bin/bash
+
+# SSAFD verification test I regression test using Anderson acceleration of Picard
+# iterations and a re-used preconditioner. Results should match ssa_testi_fd.sh and
+# acceleration should reduce the number of Picard iterations.
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+PISM_SOURCE_DIR=$3
+
+output=`mktemp pism-test-i-anderson.XXXX` || exit 1
+baseline=`mktemp pism-test-i-baseline.XXXX` || exit 1
+accelerated=`mktemp pism-test-i-accelerated.XXXX` || exit 1
+
+set -e
+set -x
+
+OPTS="-ssa_method fd -o_size none -ssafd_picard_rtol 5e-07 -ssafd_ksp_rtol 1e-12 -Mx 5"
+
+ANDERSON="-ssafd_anderson_depth 3 -ssafd_reuse_preconditioner"
+
+# do stuff
+$MPIEXEC_COMMAND $PISM_PATH/pism_ssa_test_i -My 61 $OPTS $ANDERSON -verbose 1 > ${output}
+$MPIEXEC_COMMAND $PISM_PATH/pism_ssa_test_i -My 121 $OPTS $ANDERSON -verbose 1 >> ${output}
+
+# get SSA summaries with and without acceleration
+$MPIEXEC_COMMAND $PISM_PATH/pism_ssa_test_i -My 121 $OPTS -verbose 3 > ${baseline}
+$MPIEXEC_COMMAND $PISM_PATH/pism_ssa_test_i -My 121 $OPTS $ANDERSON -verbose 3 > ${accelerated}
+
+set +e
+
+# Check results:
+diff ${output} -  <<END-OF-OUTPUT
+NUMERICAL ERRORS in velocity relative to exact solution:
+velocity  :  maxvector   prcntavvec      maxu      maxv       avu       avv
+                4.7417      0.05219    4.7417    0.1976    0.4041    0.0087
+NUM ERRORS DONE
+NUMERICAL ERRORS in velocity relative to exact solution:
+velocity  :  maxvector   prcntavvec      maxu      maxv       avu       avv
+                1.3907      0.01351    1.3907    0.0385    0.1050    0.0018
+NUM ERRORS DONE
+END-OF-OUTPUT
+
+if [ $? != 0 ];
+then
+  cat ${output}
+  exit 1
+fi
+
+set +x
+
+# Check that the summary reports both features and that acceleration helps:
+count() {
+  grep -o "[0-9]\+ $1" $2 | tail -1 | cut -d" " -f1
+}
+
+outer_baseline=$(count "outer iterations" ${baseline})
+outer=$(count "outer iterations" ${accelerated})
+n_accelerated=$(count "accelerated" ${accelerated})
+pc_setups=$(count "PC set-ups" ${accelerated})
+
+echo "Picard iterations: ${outer} (${outer_baseline} without acceleration)," \
+     "${n_accelerated} accelerated, ${pc_setups} PC set-ups"
+
+if [ -z "${n_accelerated}" ] || [ -z "${pc_setups}" ] || [ -z "${outer_baseline}" ] ||
+     [ "${n_accelerated}" -eq 0 ] || [ "${outer}" -ge "${outer_baseline}" ];
+then
+  cat ${baseline} ${accelerated}
+  exit 1
+fi
+
+rm -f ${output} ${baseline} ${accelerated}
+
+exit 0
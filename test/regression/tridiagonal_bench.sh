@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Checks that batched and column-by-column tridiagonal solvers produce identical results
+# (see src/energy/tridiagonal_bench.cc).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+set -e -x
+
+for Mz in 101 401; do
+  # the default batch size and a batch size that does not divide the number of columns
+  $PISM_PATH/pism_tridiagonal_bench -Mz $Mz -columns 1000 -repeat 2
+  $PISM_PATH/pism_tridiagonal_bench -Mz $Mz -columns 1000 -repeat 2 -batch_size 7
+done